@@ -0,0 +1,766 @@
+/*******************************************************************************
+* Title                 :   GPS Parser Benchmark
+* Filename              :   gps_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_bench.c
+ * @brief Replays NMEA corpora through gps_put / gps_parse and reports
+ * throughput and per sentence latency.
+ *
+ * Each corpus is loaded into memory first so that file I/O is not part of
+ * the measurement.  Two passes are made over the data:
+ *  - a throughput pass with no instrumentation in the loop
+ *  - a latency pass timing every sentence from its first byte to the
+ *    return of gps_parse
+ *
+ * When the parser is built with GPS_TRACE the throughput pass also reports
+ * the per stage breakdown in GPS_TRACE_UNIT.  With GPS_TIMESTAMPS the
+ * latency pass stamps each sentence with its start time and reports how
+ * long after its last sentence every epoch was published.
+ *
+ * @code
+ * gps_bench [-r repeat] [-f text|json|csv] [-o file] corpus.nmea ...
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <getopt.h>
+#include "gps_parser.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define BENCH_SCHEMA        1
+#define MAX_TYPES           32
+/* Latency histogram: exact below 64ns then 32 sub buckets per power of 2 */
+#define HIST_LINEAR         64
+#define HIST_SUB_BITS       5
+#define HIST_SUB            ( 1 << HIST_SUB_BITS )
+#define HIST_BUCKETS        ( HIST_LINEAR + ( 40 - 6 ) * HIST_SUB )
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef enum
+{
+    FORMAT_TEXT,
+    FORMAT_JSON,
+    FORMAT_CSV
+} format_t;
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t total;
+    uint64_t max;
+    uint32_t buckets[ HIST_BUCKETS ];
+} histogram_t;
+
+typedef struct
+{
+    char name[ 4 ];
+    uint64_t bytes;
+    histogram_t latency;
+} type_stats_t;
+
+typedef struct
+{
+    char *data;
+    size_t size;
+    const char *path;
+} corpus_t;
+
+#ifdef GPS_TRACE
+typedef struct
+{
+    uint64_t count;
+    uint64_t total;
+    gps_cycles_t min;
+    gps_cycles_t max;
+    uint64_t buckets[ GPS_TRACE_BUCKETS ];
+} stage_totals_t;
+#endif
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static type_stats_t types[ MAX_TYPES ];
+static int num_types;
+static histogram_t all_latency;
+#ifdef GPS_TIMESTAMPS
+static histogram_t epoch_latency;
+#endif
+#ifdef GPS_STATS
+static gps_stats_t parser_stats;
+#endif
+#ifdef GPS_TRACE
+static stage_totals_t stage_totals[ GPS_TRACE_STAGES ];
+#endif
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void hist_add( histogram_t *h, uint64_t ns );
+static uint64_t hist_percentile( const histogram_t *h, double pct );
+static type_stats_t *type_lookup( const char *line, size_t len );
+static int load_corpus( const char *path, corpus_t *corpus );
+static uint64_t run_throughput( const corpus_t *corpus );
+static void run_latency( const corpus_t *corpus );
+#ifdef GPS_STATS
+static void stats_accumulate( void );
+static void stats_print( FILE *out, format_t format );
+#endif
+#ifdef GPS_TRACE
+static void trace_accumulate( void );
+static uint64_t trace_percentile( const stage_totals_t *st, double pct );
+static void trace_print( FILE *out, format_t format );
+#endif
+static void usage( const char *name );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void hist_add( histogram_t *h, uint64_t ns )
+{
+    int idx;
+
+    if( ns < HIST_LINEAR )
+    {
+        idx = ( int )ns;
+    }
+    else
+    {
+        int e = 63 - __builtin_clzll( ns );
+
+        idx = HIST_LINEAR + ( e - 6 ) * HIST_SUB +
+              ( int )( ( ns >> ( e - HIST_SUB_BITS ) ) & ( HIST_SUB - 1 ) );
+
+        if( idx >= HIST_BUCKETS )
+            idx = HIST_BUCKETS - 1;
+    }
+
+    h->buckets[ idx ]++;
+    h->count++;
+    h->total += ns;
+
+    if( ns > h->max )
+        h->max = ns;
+}
+
+/* Returns the lower bound of the bucket holding the requested percentile */
+static uint64_t hist_percentile( const histogram_t *h, double pct )
+{
+    uint64_t target, seen = 0;
+    int i;
+
+    if( h->count == 0 )
+        return 0;
+
+    target = ( uint64_t )( h->count * pct / 100.0 );
+
+    if( target >= h->count )
+        target = h->count - 1;
+
+    for( i = 0; i < HIST_BUCKETS; i++ )
+    {
+        seen += h->buckets[ i ];
+
+        if( seen > target )
+        {
+            int e, sub;
+
+            if( i < HIST_LINEAR )
+                return i;
+
+            e = ( i - HIST_LINEAR ) / HIST_SUB + 6;
+            sub = ( i - HIST_LINEAR ) % HIST_SUB;
+
+            return ( 1ull << e ) + ( ( uint64_t )sub << ( e - HIST_SUB_BITS ) );
+        }
+    }
+
+    return h->max;
+}
+
+/* Sentence type is the three letters following the talker ID */
+static type_stats_t *type_lookup( const char *line, size_t len )
+{
+    char name[ 4 ] = "???";
+    int i;
+
+    if( len >= 6 && line[ 0 ] == '$' )
+    {
+        memcpy( name, &line[ 3 ], 3 );
+        name[ 3 ] = '\0';
+    }
+
+    for( i = 0; i < num_types; i++ )
+    {
+        if( !memcmp( types[ i ].name, name, 4 ) )
+            return &types[ i ];
+    }
+
+    if( num_types == MAX_TYPES )
+        return &types[ MAX_TYPES - 1 ];
+
+    memcpy( types[ num_types ].name, name, 4 );
+
+    return &types[ num_types++ ];
+}
+
+static int load_corpus( const char *path, corpus_t *corpus )
+{
+    FILE *fp = strcmp( path, "-" ) ? fopen( path, "rb" ) : stdin;
+    size_t capacity = 1 << 20;
+
+    if( fp == NULL )
+    {
+        perror( path );
+        return -1;
+    }
+
+    corpus->path = path;
+    corpus->size = 0;
+    corpus->data = malloc( capacity );
+
+    while( corpus->data != NULL )
+    {
+        size_t n = fread( corpus->data + corpus->size, 1,
+                          capacity - corpus->size, fp );
+
+        corpus->size += n;
+
+        if( corpus->size < capacity )
+            break;
+
+        capacity *= 2;
+        corpus->data = realloc( corpus->data, capacity );
+    }
+
+    if( fp != stdin )
+        fclose( fp );
+
+    if( corpus->data == NULL )
+    {
+        fprintf( stderr, "%s: out of memory\n", path );
+        return -1;
+    }
+
+    return 0;
+}
+
+static uint64_t run_throughput( const corpus_t *corpus )
+{
+    const char *p = corpus->data;
+    const char *end = corpus->data + corpus->size;
+    uint64_t start = gps_clock_ns();
+
+    while( p < end )
+    {
+        char c = *p++;
+
+        gps_put( c );
+
+        if( c == '\n' )
+            gps_parse();
+    }
+
+    return gps_clock_ns() - start;
+}
+
+static void run_latency( const corpus_t *corpus )
+{
+    const char *p = corpus->data;
+    const char *end = corpus->data + corpus->size;
+#ifdef GPS_TIMESTAMPS
+    uint64_t pass_start = gps_clock_ns();
+#endif
+
+    while( p < end )
+    {
+        const char *line = p;
+        const char *eol = memchr( p, '\n', end - p );
+        type_stats_t *type;
+        uint64_t start, elapsed;
+
+        if( eol == NULL )
+            eol = end - 1;
+
+        start = gps_clock_ns();
+
+#ifdef GPS_TIMESTAMPS
+        while( p <= eol )
+            gps_put_ts( *p++, start );
+#else
+        while( p <= eol )
+            gps_put( *p++ );
+#endif
+
+        gps_parse();
+        elapsed = gps_clock_ns() - start;
+
+#ifdef GPS_TIMESTAMPS
+        {
+            static uint32_t seen;
+            gps_epoch_t epoch;
+
+            /* Skip epochs left open by the throughput pass */
+            if( gps_last_epoch( &epoch ) != seen )
+            {
+                seen = epoch.epoch;
+
+                if( epoch.last_byte >= pass_start )
+                    hist_add( &epoch_latency, epoch.decoded - epoch.last_byte );
+            }
+        }
+#endif
+
+        type = type_lookup( line, eol - line );
+        type->bytes += eol - line + 1;
+        hist_add( &type->latency, elapsed );
+        hist_add( &all_latency, elapsed );
+    }
+}
+
+#ifdef GPS_STATS
+/* Parser counters are 32 bit, so they are collected after every corpus */
+static void stats_accumulate()
+{
+    gps_stats_t s;
+    int i;
+
+    gps_stats_get( &s );
+    gps_stats_reset();
+
+    parser_stats.bytes += s.bytes;
+    parser_stats.overflows += s.overflows;
+    parser_stats.unknown += s.unknown;
+
+    if( s.max_length > parser_stats.max_length )
+        parser_stats.max_length = s.max_length;
+
+    for( i = 0; i < GPS_SENTENCE_COUNT; i++ )
+    {
+        parser_stats.parsed[ i ] += s.parsed[ i ];
+        parser_stats.failed[ i ] += s.failed[ i ];
+        parser_stats.dropped[ i ] += s.dropped[ i ];
+    }
+}
+
+static void stats_print( FILE *out, format_t format )
+{
+    const gps_stats_t *s = &parser_stats;
+    int i;
+
+    switch( format )
+    {
+    case FORMAT_JSON:
+        fprintf( out, ",\"parser\":{\"bytes\":%lu,\"overflows\":%lu,\"unknown\":%lu,"
+                 "\"max_length\":%u,\"sentences\":{",
+                 ( unsigned long )s->bytes, ( unsigned long )s->overflows,
+                 ( unsigned long )s->unknown, s->max_length );
+
+        for( i = 0; i < GPS_SENTENCE_COUNT; i++ )
+        {
+            fprintf( out, "%s\"%s\":{\"parsed\":%lu,\"failed\":%lu,\"dropped\":%lu}",
+                     i ? "," : "", gps_sentence_name( ( gps_sentence_t )i ),
+                     ( unsigned long )s->parsed[ i ], ( unsigned long )s->failed[ i ],
+                     ( unsigned long )s->dropped[ i ] );
+        }
+
+        fprintf( out, "}}" );
+        break;
+
+    case FORMAT_CSV:
+        fprintf( out, "\nsentence,parsed,failed,dropped\n" );
+
+        for( i = 0; i < GPS_SENTENCE_COUNT; i++ )
+        {
+            fprintf( out, "%s,%lu,%lu,%lu\n", gps_sentence_name( ( gps_sentence_t )i ),
+                     ( unsigned long )s->parsed[ i ], ( unsigned long )s->failed[ i ],
+                     ( unsigned long )s->dropped[ i ] );
+        }
+        break;
+
+    default:
+        fprintf( out, "\nparser:       %lu bytes, %lu overflows, %lu unknown, longest line %u\n",
+                 ( unsigned long )s->bytes, ( unsigned long )s->overflows,
+                 ( unsigned long )s->unknown, s->max_length );
+        fprintf( out, "%-5s %12s %10s %10s\n", "type", "parsed", "failed", "dropped" );
+
+        for( i = 0; i < GPS_SENTENCE_COUNT; i++ )
+        {
+            if( s->parsed[ i ] || s->failed[ i ] || s->dropped[ i ] )
+                fprintf( out, "%-5s %12lu %10lu %10lu\n", gps_sentence_name( ( gps_sentence_t )i ),
+                         ( unsigned long )s->parsed[ i ], ( unsigned long )s->failed[ i ],
+                         ( unsigned long )s->dropped[ i ] );
+        }
+        break;
+    }
+}
+#endif
+
+#ifdef GPS_TRACE
+/* Stage counters are 32 bit, so they are collected after every corpus */
+static void trace_accumulate()
+{
+    gps_trace_t t;
+    int i, b;
+
+    gps_trace_get( &t );
+    gps_trace_reset();
+
+    for( i = 0; i < GPS_TRACE_STAGES; i++ )
+    {
+        const gps_trace_stage_t *src = &t.stage[ i ];
+        stage_totals_t *dst = &stage_totals[ i ];
+
+        if( src->count == 0 )
+            continue;
+
+        if( dst->count == 0 || src->min < dst->min )
+            dst->min = src->min;
+        if( src->max > dst->max )
+            dst->max = src->max;
+
+        dst->count += src->count;
+        dst->total += src->total;
+
+        for( b = 0; b < GPS_TRACE_BUCKETS; b++ )
+            dst->buckets[ b ] += src->buckets[ b ];
+    }
+}
+
+/* Upper bound of the log2 bucket holding the percentile, capped by max */
+static uint64_t trace_percentile( const stage_totals_t *st, double pct )
+{
+    uint64_t rank = ( uint64_t )( st->count * pct / 100.0 );
+    uint64_t seen = 0;
+    int b;
+
+    for( b = 0; b < GPS_TRACE_BUCKETS - 1; b++ )
+    {
+        seen += st->buckets[ b ];
+
+        if( seen > rank )
+        {
+            uint64_t limit = ( 1ull << ( GPS_TRACE_BUCKET_SHIFT + b ) ) - 1;
+
+            return ( limit < st->max ) ? limit : st->max;
+        }
+    }
+
+    return st->max;
+}
+
+static void trace_print( FILE *out, format_t format )
+{
+    int i, first = 1;
+
+    switch( format )
+    {
+    case FORMAT_JSON:
+        fprintf( out, ",\"trace\":{\"unit\":\"%s\",\"stages\":{", GPS_TRACE_UNIT );
+        break;
+    case FORMAT_CSV:
+        fprintf( out, "\nstage,count,min,mean,p50_le,p99_le,max\n" );
+        break;
+    default:
+        fprintf( out, "\n%-12s %12s %8s %8s %8s %8s %8s  ( %s )\n", "stage", "count",
+                 "min", "mean", "p50<=", "p99<=", "max", GPS_TRACE_UNIT );
+        break;
+    }
+
+    for( i = 0; i < GPS_TRACE_STAGES; i++ )
+    {
+        const stage_totals_t *st = &stage_totals[ i ];
+        const char *name = gps_trace_stage_name( i );
+        double mean;
+
+        if( st->count == 0 )
+            continue;
+
+        mean = ( double )st->total / st->count;
+
+        switch( format )
+        {
+        case FORMAT_JSON:
+            fprintf( out, "%s\"%s\":{\"count\":%llu,\"min\":%lu,\"mean\":%.1f,"
+                     "\"p50_le\":%llu,\"p99_le\":%llu,\"max\":%lu}",
+                     first ? "" : ",", name, ( unsigned long long )st->count,
+                     ( unsigned long )st->min, mean,
+                     ( unsigned long long )trace_percentile( st, 50 ),
+                     ( unsigned long long )trace_percentile( st, 99 ),
+                     ( unsigned long )st->max );
+            break;
+        case FORMAT_CSV:
+            fprintf( out, "%s,%llu,%lu,%.1f,%llu,%llu,%lu\n", name,
+                     ( unsigned long long )st->count, ( unsigned long )st->min, mean,
+                     ( unsigned long long )trace_percentile( st, 50 ),
+                     ( unsigned long long )trace_percentile( st, 99 ),
+                     ( unsigned long )st->max );
+            break;
+        default:
+            fprintf( out, "%-12s %12llu %8lu %8.1f %8llu %8llu %8lu\n", name,
+                     ( unsigned long long )st->count, ( unsigned long )st->min, mean,
+                     ( unsigned long long )trace_percentile( st, 50 ),
+                     ( unsigned long long )trace_percentile( st, 99 ),
+                     ( unsigned long )st->max );
+            break;
+        }
+
+        first = 0;
+    }
+
+    if( format == FORMAT_JSON )
+        fprintf( out, "}}" );
+}
+#endif
+
+static void usage( const char *name )
+{
+    fprintf( stderr,
+             "usage: %s [options] corpus ...\n"
+             "  -r, --repeat N     replay each corpus N times ( default 1 )\n"
+             "  -f, --format FMT   text, json or csv ( default text )\n"
+             "  -o, --output FILE  write the report to FILE\n"
+             "Use - to read a corpus from stdin.\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    static const struct option long_opts[] =
+    {
+        { "repeat", required_argument, 0, 'r' },
+        { "format", required_argument, 0, 'f' },
+        { "output", required_argument, 0, 'o' },
+        { "help",   no_argument,       0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+    format_t format = FORMAT_TEXT;
+    FILE *out = stdout;
+    long repeat = 1;
+    uint64_t bytes = 0, elapsed = 0;
+    double seconds;
+    int opt, i;
+    long r;
+
+    while( ( opt = getopt_long( argc, argv, "r:f:o:h", long_opts, NULL ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'r':
+            repeat = strtol( optarg, NULL, 10 );
+            break;
+        case 'f':
+            if( !strcmp( optarg, "json" ) )
+                format = FORMAT_JSON;
+            else if( !strcmp( optarg, "csv" ) )
+                format = FORMAT_CSV;
+            else if( !strcmp( optarg, "text" ) )
+                format = FORMAT_TEXT;
+            else
+            {
+                usage( argv[ 0 ] );
+                return 2;
+            }
+            break;
+        case 'o':
+            out = fopen( optarg, "w" );
+            if( out == NULL )
+            {
+                perror( optarg );
+                return 1;
+            }
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind >= argc || repeat < 1 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    for( i = optind; i < argc; i++ )
+    {
+        corpus_t corpus;
+
+        if( load_corpus( argv[ i ], &corpus ) )
+            return 1;
+
+#ifdef GPS_STATS
+        gps_stats_reset();
+#endif
+#ifdef GPS_TRACE
+        gps_trace_reset();
+#endif
+
+        for( r = 0; r < repeat; r++ )
+        {
+            elapsed += run_throughput( &corpus );
+            bytes += corpus.size;
+        }
+
+#ifdef GPS_STATS
+        stats_accumulate();
+#endif
+#ifdef GPS_TRACE
+        trace_accumulate();
+#endif
+
+        for( r = 0; r < repeat; r++ )
+            run_latency( &corpus );
+
+        free( corpus.data );
+    }
+
+    seconds = elapsed / 1e9;
+
+    if( seconds <= 0.0 )
+        seconds = 1e-9;
+
+    switch( format )
+    {
+    case FORMAT_JSON:
+        fprintf( out, "{\"schema\":%d,\"bytes\":%llu,\"sentences\":%llu,"
+                 "\"elapsed_s\":%.6f,\"sentences_per_s\":%.1f,\"mb_per_s\":%.3f,"
+                 "\"latency_ns\":{\"mean\":%.1f,\"p50\":%llu,\"p99\":%llu,\"max\":%llu},"
+                 "\"types\":{",
+                 BENCH_SCHEMA, ( unsigned long long )bytes,
+                 ( unsigned long long )all_latency.count, seconds,
+                 all_latency.count / seconds, bytes / seconds / 1e6,
+                 all_latency.count ? ( double )all_latency.total / all_latency.count : 0.0,
+                 ( unsigned long long )hist_percentile( &all_latency, 50 ),
+                 ( unsigned long long )hist_percentile( &all_latency, 99 ),
+                 ( unsigned long long )all_latency.max );
+
+        for( i = 0; i < num_types; i++ )
+        {
+            const histogram_t *h = &types[ i ].latency;
+
+            fprintf( out, "%s\"%s\":{\"count\":%llu,\"bytes\":%llu,\"mean_ns\":%.1f,"
+                     "\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu}",
+                     i ? "," : "", types[ i ].name,
+                     ( unsigned long long )h->count,
+                     ( unsigned long long )types[ i ].bytes,
+                     ( double )h->total / h->count,
+                     ( unsigned long long )hist_percentile( h, 50 ),
+                     ( unsigned long long )hist_percentile( h, 99 ),
+                     ( unsigned long long )h->max );
+        }
+
+        fprintf( out, "}" );
+#ifdef GPS_TIMESTAMPS
+        fprintf( out, ",\"epoch_latency_ns\":{\"count\":%llu,\"mean\":%.1f,"
+                 "\"p50\":%llu,\"p99\":%llu,\"max\":%llu}",
+                 ( unsigned long long )epoch_latency.count,
+                 epoch_latency.count ? ( double )epoch_latency.total / epoch_latency.count : 0.0,
+                 ( unsigned long long )hist_percentile( &epoch_latency, 50 ),
+                 ( unsigned long long )hist_percentile( &epoch_latency, 99 ),
+                 ( unsigned long long )epoch_latency.max );
+#endif
+#ifdef GPS_STATS
+        stats_print( out, format );
+#endif
+#ifdef GPS_TRACE
+        trace_print( out, format );
+#endif
+        fprintf( out, "}\n" );
+        break;
+
+    case FORMAT_CSV:
+        fprintf( out, "type,count,bytes,mean_ns,p50_ns,p99_ns,max_ns\n" );
+        fprintf( out, "ALL,%llu,%llu,%.1f,%llu,%llu,%llu\n",
+                 ( unsigned long long )all_latency.count,
+                 ( unsigned long long )bytes,
+                 all_latency.count ? ( double )all_latency.total / all_latency.count : 0.0,
+                 ( unsigned long long )hist_percentile( &all_latency, 50 ),
+                 ( unsigned long long )hist_percentile( &all_latency, 99 ),
+                 ( unsigned long long )all_latency.max );
+
+        for( i = 0; i < num_types; i++ )
+        {
+            const histogram_t *h = &types[ i ].latency;
+
+            fprintf( out, "%s,%llu,%llu,%.1f,%llu,%llu,%llu\n", types[ i ].name,
+                     ( unsigned long long )h->count,
+                     ( unsigned long long )types[ i ].bytes,
+                     ( double )h->total / h->count,
+                     ( unsigned long long )hist_percentile( h, 50 ),
+                     ( unsigned long long )hist_percentile( h, 99 ),
+                     ( unsigned long long )h->max );
+        }
+#ifdef GPS_TIMESTAMPS
+        fprintf( out, "EPOCH,%llu,,%.1f,%llu,%llu,%llu\n",
+                 ( unsigned long long )epoch_latency.count,
+                 epoch_latency.count ? ( double )epoch_latency.total / epoch_latency.count : 0.0,
+                 ( unsigned long long )hist_percentile( &epoch_latency, 50 ),
+                 ( unsigned long long )hist_percentile( &epoch_latency, 99 ),
+                 ( unsigned long long )epoch_latency.max );
+#endif
+        break;
+
+    default:
+        fprintf( out, "bytes:        %llu\n", ( unsigned long long )bytes );
+        fprintf( out, "sentences:    %llu\n", ( unsigned long long )all_latency.count );
+        fprintf( out, "elapsed:      %.6f s\n", seconds );
+        fprintf( out, "throughput:   %.0f sentences/s, %.2f MB/s\n",
+                 all_latency.count / seconds, bytes / seconds / 1e6 );
+        fprintf( out, "latency:      p50 %llu ns, p99 %llu ns, max %llu ns\n",
+                 ( unsigned long long )hist_percentile( &all_latency, 50 ),
+                 ( unsigned long long )hist_percentile( &all_latency, 99 ),
+                 ( unsigned long long )all_latency.max );
+#ifdef GPS_TIMESTAMPS
+        fprintf( out, "epoch:        %llu published, p50 %llu ns, p99 %llu ns, max %llu ns"
+                 " after the last byte\n",
+                 ( unsigned long long )epoch_latency.count,
+                 ( unsigned long long )hist_percentile( &epoch_latency, 50 ),
+                 ( unsigned long long )hist_percentile( &epoch_latency, 99 ),
+                 ( unsigned long long )epoch_latency.max );
+#endif
+        fprintf( out, "\n%-5s %12s %10s %10s %10s %10s\n",
+                 "type", "count", "mean ns", "p50 ns", "p99 ns", "max ns" );
+
+        for( i = 0; i < num_types; i++ )
+        {
+            const histogram_t *h = &types[ i ].latency;
+
+            fprintf( out, "%-5s %12llu %10.1f %10llu %10llu %10llu\n", types[ i ].name,
+                     ( unsigned long long )h->count,
+                     ( double )h->total / h->count,
+                     ( unsigned long long )hist_percentile( h, 50 ),
+                     ( unsigned long long )hist_percentile( h, 99 ),
+                     ( unsigned long long )h->max );
+        }
+        break;
+    }
+
+#ifdef GPS_STATS
+    if( format != FORMAT_JSON )
+        stats_print( out, format );
+#endif
+#ifdef GPS_TRACE
+    if( format != FORMAT_JSON )
+        trace_print( out, format );
+#endif
+
+    if( out != stdout )
+        fclose( out );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
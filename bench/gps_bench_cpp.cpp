@@ -0,0 +1,452 @@
+/*******************************************************************************
+* Title                 :   GPS Parser C++ Benchmark
+* Filename              :   gps_bench_cpp.cpp
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, C++17
+*******************************************************************************/
+/**
+ * @file gps_bench_cpp.cpp
+ * @brief Compares gps::NmeaParser with the C core on the same corpora.
+ *
+ * Each corpus is loaded into memory and cut down to the sentences both
+ * parsers decode: valid lines of the GP talker whose type the C core is
+ * configured for, ended by CR LF and short enough for its buffer.  The
+ * C++ parser accepts any talker and a bare LF, and the C core decodes
+ * types NmeaParser skips, so anything else would time different work.  A check pass then feeds every line to both and fails the run
+ * when the time, position or fix status of a GGA or RMC differs from the
+ * C globals.  Fields left empty are skipped, the C core keeps the last
+ * value where C++ decodes 0.  The corpus is then replayed through
+ *  - the C core, gps_put per byte and gps_parse per line
+ *  - gps::NmeaParser::put per byte
+ *  - gps::NmeaParser::feed in blocks of -b bytes
+ * The best of -r passes is reported for each.
+ *
+ * @code
+ * gps_bench_cpp [-r repeat] [-b block] corpus.nmea ...
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
+#include <cmath>
+#include <getopt.h>
+#include "gps_parser.h"
+#include "gps_parser.hpp"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define MAX_REPORTED    10      /* Mismatches printed per corpus */
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    char *data;
+    size_t size;
+    const char *path;
+} corpus_t;
+
+typedef struct
+{
+    const char *name;
+    uint64_t best;
+    uint64_t sentences;
+} run_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+/* Keeps the decoded values alive so the passes can't be optimised away */
+static volatile double sink;
+
+/* Sentence types of the C core's profile that NmeaParser decodes too */
+static const char *const common_types[] =
+{
+#ifdef GGA
+    "GGA",
+#endif
+#ifdef GLL
+    "GLL",
+#endif
+#ifdef GSA
+    "GSA",
+#endif
+#ifdef GSV
+    "GSV",
+#endif
+#ifdef RMC
+    "RMC",
+#endif
+#ifdef VTG
+    "VTG",
+#endif
+#ifdef ZDA
+    "ZDA",
+#endif
+};
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int load_corpus( const char *path, corpus_t *corpus )
+{
+    FILE *fp = strcmp( path, "-" ) ? fopen( path, "rb" ) : stdin;
+    size_t capacity = 1 << 20;
+
+    if( fp == NULL )
+    {
+        perror( path );
+        return -1;
+    }
+
+    corpus->path = path;
+    corpus->size = 0;
+    corpus->data = ( char * )malloc( capacity );
+
+    while( corpus->data != NULL )
+    {
+        size_t n = fread( corpus->data + corpus->size, 1,
+                          capacity - corpus->size, fp );
+
+        corpus->size += n;
+
+        if( corpus->size < capacity )
+            break;
+
+        capacity *= 2;
+        corpus->data = ( char * )realloc( corpus->data, capacity );
+    }
+
+    if( fp != stdin )
+        fclose( fp );
+
+    if( corpus->data == NULL )
+    {
+        fprintf( stderr, "%s: out of memory\n", path );
+        return -1;
+    }
+
+    return 0;
+}
+
+static bool common( std::string_view line )
+{
+    gps::Fields fields( gps::validate( line ) );
+
+    if( line.size() < 2 || line.size() - 2 >= BUFFER_MAX ||
+        line.substr( line.size() - 2 ) != "\r\n" || fields.talker() != "GP" )
+        return false;
+
+    for( const char *type : common_types )
+    {
+        if( fields.formatter() == type )
+            return true;
+    }
+
+    return false;
+}
+
+/* Keeps the common lines in place, returns the number dropped */
+static uint64_t filter_corpus( corpus_t *corpus )
+{
+    const char *p = corpus->data;
+    const char *end = corpus->data + corpus->size;
+    size_t kept = 0;
+    uint64_t dropped = 0;
+
+    while( p < end )
+    {
+        const char *eol = ( const char * )memchr( p, '\n', end - p );
+        size_t length = ( eol ? eol + 1 : end ) - p;
+
+        if( eol != NULL && common( { p, length } ) )
+        {
+            memmove( corpus->data + kept, p, length );
+            kept += length;
+        }
+        else
+            dropped++;
+
+        p += length;
+    }
+
+    corpus->size = kept;
+
+    return dropped;
+}
+
+static double degrees( const location_t *location )
+{
+    double value = location->degrees + location->minutes / 60.0;
+
+    return ( location->azmuth == SOUTH || location->azmuth == WEST ) ? -value : value;
+}
+
+static bool same_time( const gps::Time &t, const utc_time_t *c )
+{
+    return t.hour == c->hour && t.minute == c->minute && t.second == c->second && t.ms == c->ms;
+}
+
+/* Differences between a decoded GGA or RMC and the C globals after the same line */
+static int compare( const gps::NmeaParser::value_type &s, std::string_view line )
+{
+    gps::Fields f( gps::validate( line ) );
+    int errors = 0;
+
+    if( auto gga = std::get_if< gps::Gga >( &s ) )
+    {
+        errors += !f[ 1 ].empty() && !same_time( gga->time, gps_current_fix() );
+        errors += !f[ 2 ].empty() && !f[ 3 ].empty() &&
+                  fabs( gga->latitude - degrees( gps_current_lat() ) ) > 1e-9;
+        errors += !f[ 4 ].empty() && !f[ 5 ].empty() &&
+                  fabs( gga->longitude - degrees( gps_current_lon() ) ) > 1e-9;
+        errors += !f[ 6 ].empty() && gga->quality != ( uint8_t )gps_gga_fix_quality();
+    }
+    else if( auto rmc = std::get_if< gps::Rmc >( &s ) )
+    {
+        errors += !f[ 1 ].empty() && !same_time( rmc->time, gps_current_fix() );
+        errors += !f[ 2 ].empty() && rmc->valid != ( gps_rmc_status() == RMC_ACTIVE );
+        errors += !f[ 3 ].empty() && !f[ 4 ].empty() &&
+                  fabs( rmc->latitude - degrees( gps_current_lat() ) ) > 1e-9;
+        errors += !f[ 5 ].empty() && !f[ 6 ].empty() &&
+                  fabs( rmc->longitude - degrees( gps_current_lon() ) ) > 1e-9;
+    }
+
+    return errors;
+}
+
+/* Feeds every line to both parsers, returns the number of lines that differ */
+static uint64_t check( const corpus_t *corpus )
+{
+    static gps::NmeaParser parser;
+    const char *line = corpus->data;
+    const char *p = corpus->data;
+    const char *end = corpus->data + corpus->size;
+    uint64_t mismatches = 0;
+
+    parser.reset();
+
+    while( p < end )
+    {
+        char c = *p++;
+        const gps::NmeaParser::value_type *s;
+
+        gps_put( c );
+        s = parser.put( c );
+
+        if( c != '\n' )
+            continue;
+
+        gps_parse();
+
+        if( s != nullptr && compare( *s, { line, ( size_t )( p - line ) } ) )
+        {
+            if( mismatches++ < MAX_REPORTED )
+                fprintf( stderr, "%s: c and c++ differ on %.*s", corpus->path,
+                         ( int )( p - line ), line );
+        }
+
+        line = p;
+    }
+
+    return mismatches;
+}
+
+static uint64_t run_c( const corpus_t *corpus, uint64_t *sentences )
+{
+    const char *p = corpus->data;
+    const char *end = corpus->data + corpus->size;
+    gps_epoch_t epoch;
+    uint64_t start = gps_clock_ns();
+
+    *sentences = 0;
+
+    while( p < end )
+    {
+        char c = *p++;
+
+        gps_put( c );
+
+        if( c == '\n' )
+        {
+            gps_parse();
+            ( *sentences )++;
+        }
+    }
+
+    gps_last_epoch( &epoch );
+    sink = epoch.latitude;
+
+    return gps_clock_ns() - start;
+}
+
+static double position( const gps::NmeaParser::value_type &s )
+{
+    if( auto gga = std::get_if< gps::Gga >( &s ) )
+        return gga->latitude;
+
+    if( auto rmc = std::get_if< gps::Rmc >( &s ) )
+        return rmc->latitude;
+
+    return 0.0;
+}
+
+static uint64_t run_put( const corpus_t *corpus, uint64_t *sentences )
+{
+    static gps::NmeaParser parser;
+    const char *p = corpus->data;
+    const char *end = corpus->data + corpus->size;
+    double sum = 0;
+    uint64_t start = gps_clock_ns();
+
+    *sentences = 0;
+
+    while( p < end )
+    {
+        if( auto s = parser.put( *p++ ) )
+        {
+            sum += position( *s );
+            ( *sentences )++;
+        }
+    }
+
+    sink = sum;
+
+    return gps_clock_ns() - start;
+}
+
+static uint64_t run_feed( const corpus_t *corpus, size_t block, uint64_t *sentences )
+{
+    static gps::NmeaParser parser;
+    size_t offset;
+    double sum = 0;
+    uint64_t start = gps_clock_ns();
+
+    *sentences = 0;
+
+    for( offset = 0; offset < corpus->size; offset += block )
+    {
+        size_t n = corpus->size - offset < block ? corpus->size - offset : block;
+
+        for( const auto &s : parser.feed( { corpus->data + offset, n } ) )
+        {
+            sum += position( s );
+            ( *sentences )++;
+        }
+    }
+
+    sink = sum;
+
+    return gps_clock_ns() - start;
+}
+
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-r repeat] [-b block] corpus.nmea ...\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    run_t runs[ 3 ] = { { "c", 0, 0 }, { "c++ put", 0, 0 }, { "c++ feed", 0, 0 } };
+    uint64_t bytes = 0;
+    long repeat = 5, block = 4096;
+    int opt, i, k;
+    long r;
+
+    while( ( opt = getopt( argc, argv, "r:b:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'r':
+            repeat = strtol( optarg, NULL, 10 );
+            break;
+        case 'b':
+            block = strtol( optarg, NULL, 10 );
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind >= argc || repeat < 1 || block < 1 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    for( i = optind; i < argc; i++ )
+    {
+        corpus_t corpus;
+        uint64_t best[ 3 ] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+        uint64_t sentences[ 3 ];
+        uint64_t dropped, mismatches;
+
+        if( load_corpus( argv[ i ], &corpus ) )
+            return 1;
+
+        dropped = filter_corpus( &corpus );
+        mismatches = check( &corpus );
+
+        if( dropped )
+            printf( "%s: %lu lines outside the common set dropped\n", corpus.path,
+                    ( unsigned long )dropped );
+
+        if( mismatches )
+        {
+            fprintf( stderr, "%s: %lu lines decode differently\n", corpus.path,
+                     ( unsigned long )mismatches );
+            free( corpus.data );
+            return 1;
+        }
+
+        for( r = 0; r < repeat; r++ )
+        {
+            uint64_t t[ 3 ];
+
+            t[ 0 ] = run_c( &corpus, &sentences[ 0 ] );
+            t[ 1 ] = run_put( &corpus, &sentences[ 1 ] );
+            t[ 2 ] = run_feed( &corpus, ( size_t )block, &sentences[ 2 ] );
+
+            for( k = 0; k < 3; k++ )
+            {
+                if( t[ k ] < best[ k ] )
+                    best[ k ] = t[ k ];
+            }
+        }
+
+        for( k = 0; k < 3; k++ )
+        {
+            runs[ k ].best += best[ k ];
+            runs[ k ].sentences += sentences[ k ];
+        }
+
+        bytes += corpus.size;
+        free( corpus.data );
+    }
+
+    printf( "%-9s %10s %12s %12s %8s\n", "parser", "MB/s", "ns/line", "sentences", "vs c" );
+
+    for( k = 0; k < 3; k++ )
+    {
+        double seconds = runs[ k ].best / 1e9;
+
+        printf( "%-9s %10.1f %12.1f %12lu %8.2f\n", runs[ k ].name,
+                bytes / 1e6 / seconds,
+                ( double )runs[ k ].best / ( runs[ 0 ].sentences ? runs[ 0 ].sentences : 1 ),
+                ( unsigned long )runs[ k ].sentences,
+                ( double )runs[ 0 ].best / runs[ k ].best );
+    }
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
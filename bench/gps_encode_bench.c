@@ -0,0 +1,395 @@
+/*******************************************************************************
+* Title                 :   NMEA Encoder Benchmark
+* Filename              :   gps_encode_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_encode_bench.c
+ * @brief Checks gps_encode against the parser and times it against printf.
+ *
+ * The round trip pass fills the structures of every encoded sentence type
+ * with random values, encodes them, feeds the sentence through gps_put /
+ * gps_parse, encodes what the parser decoded and compares the bytes.
+ * Values are drawn past the clamping limits too, and every sentence is
+ * checked for length and checksum.  Any difference fails the run.
+ *
+ * The speed pass encodes GGA and RMC -n times with gps_encode and with
+ * snprintf and a checksum loop, the way applications did it so far.
+ *
+ * @code
+ * gps_encode_bench -r 1000000 -n 10000000
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <getopt.h>
+#include <time.h>
+#include "gps_parser.h"
+#include "gps_encode.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define TYPES           6
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef uint8_t ( *encode_t )( char *buffer );
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+static utc_time_t fix_time;
+static TimeStruct date;
+static location_t lat, lon;
+static gga_t gga;
+static rmc_t rmc;
+static vtg_t vtg;
+static gsa_t gsa;
+static gsv_t gsv;
+static zda_t zda;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* xorshift64*, the same on every host */
+static uint32_t random_below( uint32_t n )
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+
+    return ( uint32_t )( ( ( state * 0x2545F4914F6CDD1Dull ) >> 32 ) % n );
+}
+
+static double random_range( double low, double high )
+{
+    return low + ( high - low ) * random_below( 1u << 30 ) / ( double )( 1u << 30 );
+}
+
+/* Every optional field filled in, the parser keeps empty ones */
+static void random_values( void )
+{
+    int i;
+
+    fix_time.hour = random_below( 24 );
+    fix_time.minute = random_below( 60 );
+    fix_time.second = random_below( 60 );
+    fix_time.ms = random_below( 100 ) * 10;
+    date.md = 1 + random_below( 31 );
+    date.mo = 1 + random_below( 12 );
+    date.yy = 2000 + random_below( 100 );
+
+    lat.degrees = random_below( 90 );
+    lat.minutes = random_range( 0, 60 );
+    lat.azmuth = random_below( 2 ) ? NORTH : SOUTH;
+    lon.degrees = random_below( 180 );
+    lon.minutes = random_range( 0, 60 );
+    lon.azmuth = random_below( 2 ) ? EAST : WEST;
+
+    gga.fix = ( fix_t )random_below( 9 );
+    gga.num_sats = random_below( 16 );
+    gga.horizontal = ( float )random_range( 0, 120 );
+    gga.altitude = random_range( -2000, 12000 );
+    gga.height = random_range( -1200, 1200 );
+    gga.last_update = random_below( 200 );
+    gga.station_id = 1 + random_below( 1100 );
+
+    rmc.status = random_below( 2 ) ? RMC_ACTIVE : RMC_VOID;
+    rmc.speed = random_range( 0, 12000 );
+    rmc.track = random_range( 0, 1100 );
+    rmc.magnetic.mag_variation = random_range( 0, 1100 );
+    rmc.magnetic.azmuth = random_below( 2 ) ? EAST : WEST;
+    rmc.mode = ( GPS_STATUS_t )( RMC_AUTONOMOUS + random_below( 3 ) );
+
+    vtg.track = random_range( 0, 1100 );
+    vtg.mag_track = random_range( 0, 1100 );
+    vtg.speed_knots = random_range( 0, 12000 );
+    vtg.speed_km = random_range( 0, 120000 );
+
+    gsa.mode = random_below( 2 ) ? GSA_AUTO_MODE : GSA_MANUAL_MODE;
+    gsa.fix = ( GSA_MODE_t )( GSA_NO_FIX + random_below( 3 ) );
+
+    for( i = 0; i < 12; i++ )
+        gsa.sats[ i ] = random_below( 3 ) ? random_below( 256 ) : 0;
+
+    gsa.pdop = ( float )random_range( 0, 120 );
+    gsa.hdop = ( float )random_range( 0, 120 );
+    gsa.vdop = ( float )random_range( 0, 120 );
+
+    gsv.num_sentences = 1 + random_below( MAX_GSV_SENTENCES );
+    gsv.sentence = 1 + random_below( gsv.num_sentences );
+    gsv.num_sats = random_below( 64 );
+
+    for( i = 0; i < 4; i++ )
+    {
+        gsv.sat_info[ i ].sat_prn_num = random_below( 256 );
+        gsv.sat_info[ i ].elevation = random_below( 91 );
+        gsv.sat_info[ i ].azimuth = random_below( 360 );
+        gsv.sat_info[ i ].snr = random_below( 3 ) ? random_below( 100 ) : 0;
+    }
+
+    zda.local_hour = ( uint8_t )( int8_t )( random_below( 27 ) - 13 );
+    zda.local_min = random_below( 60 );
+}
+
+static uint8_t encode_gga( char *buffer )
+{
+    return gps_encode_gga( buffer, &fix_time, &lat, &lon, &gga );
+}
+
+static uint8_t encode_rmc( char *buffer )
+{
+    return gps_encode_rmc( buffer, &fix_time, &date, &lat, &lon, &rmc );
+}
+
+static uint8_t encode_vtg( char *buffer )
+{
+    return gps_encode_vtg( buffer, &vtg );
+}
+
+static uint8_t encode_gsa( char *buffer )
+{
+    return gps_encode_gsa( buffer, &gsa );
+}
+
+static uint8_t encode_gsv( char *buffer )
+{
+    return gps_encode_gsv( buffer, &gsv );
+}
+
+static uint8_t encode_zda( char *buffer )
+{
+    return gps_encode_zda( buffer, &fix_time, &date, &zda );
+}
+
+/* Copies what the parser decoded back into the structures */
+static void read_back( int type )
+{
+    fix_time = *gps_current_fix();
+    lat = *gps_current_lat();
+    lon = *gps_current_lon();
+    date = *gps_current_time();
+
+    switch( type )
+    {
+    case 0:
+        gga.fix = gps_gga_fix_quality();
+        gga.num_sats = gps_gga_satcount();
+        gga.horizontal = gps_gga_hor_dilution();
+        gga.altitude = gps_gga_altitude();
+        gga.height = gps_gga_msl();
+        gga.last_update = gps_gga_lastDGPS_update();
+        gga.station_id = gps_gga_DGPS_stationID();
+        break;
+    case 1:
+        rmc.status = gps_rmc_status();
+        rmc.speed = gps_rmc_speed();
+        rmc.track = gps_rmc_track();
+        rmc.magnetic.mag_variation = gps_rmc_mag_var();
+        rmc.magnetic.azmuth = gps_rmc_direction();
+        rmc.mode = gps_rmc_mode();
+        break;
+    case 2:
+        vtg.track = gps_vtg_track();
+        vtg.mag_track = gps_vtg_mag();
+        vtg.speed_knots = gps_vtg_speedknt();
+        vtg.speed_km = gps_vtg_speedkm();
+        break;
+    case 3:
+        gsa.mode = gps_gsa_mode();
+        gsa.fix = gps_gsa_fix_type();
+        memcpy( gsa.sats, gps_gsa_sat_prn(), sizeof( gsa.sats ) );
+        gsa.pdop = gps_gsa_precision_dilution();
+        gsa.hdop = gps_gsa_horizontal_dilution();
+        gsa.vdop = gps_gsa_vertical_dilution();
+        break;
+    case 4:
+        gsv = *gps_gsv_message( gsv.sentence );
+        break;
+    default:
+        zda.local_hour = gps_zda_local_hour();
+        zda.local_min = gps_zda_local_min();
+        break;
+    }
+}
+
+static int checksum_ok( const char *line, uint8_t length )
+{
+    const char *star = strchr( line, '*' );
+    uint8_t sum = 0;
+    const char *p;
+
+    if( star == NULL || star + 5 != line + length )
+        return 0;
+
+    for( p = line + 1; p < star; p++ )
+        sum ^= ( uint8_t )*p;
+
+    return strtoul( star + 1, NULL, 16 ) == sum;
+}
+
+static long round_trip( long count )
+{
+    static const encode_t encoders[ TYPES ] =
+    {
+        encode_gga, encode_rmc, encode_vtg, encode_gsa, encode_gsv, encode_zda
+    };
+    char first[ GPS_ENCODE_MAX ], second[ GPS_ENCODE_MAX ];
+    uint8_t longest = 0;
+    long i, failed = 0;
+
+    for( i = 0; i < count; i++ )
+    {
+        int type = ( int )( i % TYPES );
+        uint8_t length;
+        const char *p;
+
+        random_values();
+        length = encoders[ type ]( first );
+
+        for( p = first; *p; p++ )
+            gps_put( *p );
+
+        gps_parse();
+        read_back( type );
+        encoders[ type ]( second );
+
+        if( length > longest )
+            longest = length;
+
+        if( length > GPS_ENCODE_MAX - 1 || length != strlen( first ) ||
+            !checksum_ok( first, length ) || strcmp( first, second ) )
+        {
+            if( failed++ < 10 )
+                fprintf( stderr, "mismatch\n  %s  %s", first, second );
+        }
+    }
+
+    printf( "round trip %ld sentences, %ld failed, longest %u\n", count, failed, longest );
+
+    return failed;
+}
+
+static uint8_t printf_gga( char *buffer )
+{
+    uint8_t sum = 0;
+    int n = snprintf( buffer, GPS_ENCODE_MAX,
+                      "$GPGGA,%02u%02u%02u.%02u,%02u%07.4f,%c,%03u%07.4f,%c,%u,%02u,%.1f,%.1f,M,%.1f,M,%u,%04u",
+                      fix_time.hour, fix_time.minute, fix_time.second, fix_time.ms / 10,
+                      lat.degrees, lat.minutes, lat.azmuth == SOUTH ? 'S' : 'N',
+                      lon.degrees, lon.minutes, lon.azmuth == WEST ? 'W' : 'E',
+                      gga.fix, gga.num_sats, gga.horizontal, gga.altitude, gga.height,
+                      gga.last_update, gga.station_id );
+    int i;
+
+    for( i = 1; i < n; i++ )
+        sum ^= ( uint8_t )buffer[ i ];
+
+    return ( uint8_t )( n + snprintf( buffer + n, GPS_ENCODE_MAX - n, "*%02X\r\n", sum ) );
+}
+
+static uint8_t printf_rmc( char *buffer )
+{
+    uint8_t sum = 0;
+    int n = snprintf( buffer, GPS_ENCODE_MAX,
+                      "$GPRMC,%02u%02u%02u.%02u,%c,%02u%07.4f,%c,%03u%07.4f,%c,%.1f,%.1f,%02u%02u%02u,%.1f,%c,A",
+                      fix_time.hour, fix_time.minute, fix_time.second, fix_time.ms / 10,
+                      rmc.status == RMC_ACTIVE ? 'A' : 'V',
+                      lat.degrees, lat.minutes, lat.azmuth == SOUTH ? 'S' : 'N',
+                      lon.degrees, lon.minutes, lon.azmuth == WEST ? 'W' : 'E',
+                      rmc.speed, rmc.track, date.md, date.mo, date.yy % 100,
+                      rmc.magnetic.mag_variation, rmc.magnetic.azmuth == WEST ? 'W' : 'E' );
+    int i;
+
+    for( i = 1; i < n; i++ )
+        sum ^= ( uint8_t )buffer[ i ];
+
+    return ( uint8_t )( n + snprintf( buffer + n, GPS_ENCODE_MAX - n, "*%02X\r\n", sum ) );
+}
+
+/* ns per sentence, GGA and RMC in turn */
+static double time_encoder( encode_t gga_encoder, encode_t rmc_encoder, long count,
+                            uint64_t *bytes )
+{
+    char buffer[ GPS_ENCODE_MAX ];
+    uint64_t start, total = 0;
+    long i;
+
+    start = gps_clock_ns();
+
+    for( i = 0; i < count; i += 2 )
+    {
+        fix_time.ms = ( uint16_t )( i % 1000 );
+        lat.minutes = ( i & 0xFFFF ) * ( 60.0 / 65536 );
+        total += gga_encoder( buffer );
+        total += rmc_encoder( buffer );
+    }
+
+    *bytes = total;
+
+    return ( double )( gps_clock_ns() - start ) / count;
+}
+
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-r round_trips] [-n encodes]\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    long trips = 600000, encodes = 10000000;
+    double encode_ns, printf_ns;
+    uint64_t encode_bytes, printf_bytes;
+    int opt;
+
+    while( ( opt = getopt( argc, argv, "r:n:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'r':
+            trips = strtol( optarg, NULL, 10 );
+            break;
+        case 'n':
+            encodes = strtol( optarg, NULL, 10 );
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( trips < 0 || encodes < 2 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    if( round_trip( trips ) )
+        return 1;
+
+    random_values();
+    encode_ns = time_encoder( encode_gga, encode_rmc, encodes, &encode_bytes );
+    printf_ns = time_encoder( printf_gga, printf_rmc, encodes, &printf_bytes );
+
+    printf( "%-10s %10s %12s\n", "encoder", "ns/line", "MB/s" );
+    printf( "%-10s %10.1f %12.1f\n", "gps_encode", encode_ns,
+            encode_bytes / ( encode_ns * encodes / 1e3 ) );
+    printf( "%-10s %10.1f %12.1f\n", "snprintf", printf_ns,
+            printf_bytes / ( printf_ns * encodes / 1e3 ) );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,398 @@
+/*******************************************************************************
+* Title                 :   Fleet Ingestion Benchmark
+* Filename              :   gps_fleet_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_fleet_bench.c
+ * @brief Load generator for the ingestion workers.
+ *
+ * -n units stream seven sentences per epoch into -w workers for -d
+ * seconds.  -m picks the streams: socketpairs, pipes or ptys, the worker
+ * reading the pty side a receiver would be on.  With -t they are TCP
+ * connections to the workers' port on the loopback instead.  -u runs the
+ * workers on io_uring, to compare with epoll.
+ *
+ * Every stream starts with a $PUNIT hello of its unit number from 1.  The
+ * generator then writes to every unit in turn as long as its stream takes
+ * data, keeping each stream whole across partial writes.  It reports the
+ * lines decoded per second and the reads it took, and fails unless every
+ * ID has a unit with an epoch with the position sent.
+ *
+ * The generator runs on the same machine and takes its share of the cores.
+ *
+ * @code
+ * gps_fleet_bench -n 5000 -w 4 -d 10
+ * gps_fleet_bench -u -m pipe -n 5000
+ * gps_fleet_bench -t 10110 -n 5000 -w 4
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _XOPEN_SOURCE 700           /* posix_openpt() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include "gps_ingest.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define WORKERS_MAX     64
+#define BLOCK_EPOCHS    60
+#define LINE_BYTES      96
+#define LATITUDE        48.1173
+#define LONGITUDE       11.516667
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static int use_uring;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static size_t sentence( char *out, size_t size, const char *body )
+{
+    uint8_t sum = 0;
+    const char *p;
+
+    for( p = body; *p; p++ )
+        sum ^= ( uint8_t )*p;
+
+    return snprintf( out, size, "$%s*%02X\r\n", body, sum );
+}
+
+/* A minute of epochs, repeated by every unit */
+static char *generate( size_t *size )
+{
+    char *text = malloc( BLOCK_EPOCHS * 7 * LINE_BYTES );
+    size_t n = 0;
+    int e;
+
+    if( text == NULL )
+        return NULL;
+
+    for( e = 0; e < BLOCK_EPOCHS; e++ )
+    {
+        char body[ LINE_BYTES ];
+
+        snprintf( body, sizeof( body ), "GPRMC,1200%02d.00,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W", e );
+        n += sentence( text + n, LINE_BYTES, body );
+        snprintf( body, sizeof( body ), "GPGGA,1200%02d.00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,", e );
+        n += sentence( text + n, LINE_BYTES, body );
+        n += sentence( text + n, LINE_BYTES, "GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1" );
+        n += sentence( text + n, LINE_BYTES, "GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00" );
+        n += sentence( text + n, LINE_BYTES, "GPGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,19,40,246,00" );
+        n += sentence( text + n, LINE_BYTES, "GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,00,,,," );
+        n += sentence( text + n, LINE_BYTES, "GPVTG,054.7,T,034.4,M,005.5,N,010.2,K" );
+    }
+
+    *size = n;
+    return text;
+}
+
+static void *worker_main( void *arg )
+{
+#ifdef GPS_IO_URING
+    if( use_uring )
+    {
+        if( gps_ingest_run_uring( arg ) )
+            perror( "gps_ingest_run_uring" );
+
+        return NULL;
+    }
+#endif
+
+    if( gps_ingest_run( arg ) )
+        perror( "gps_ingest_run" );
+
+    return NULL;
+}
+
+/* A pty in raw mode, the worker reads the side a receiver would be on */
+static int pty_open( int fds[ 2 ] )
+{
+    struct termios tio;
+    int master = posix_openpt( O_RDWR | O_NOCTTY );
+    int slave;
+
+    if( master < 0 || grantpt( master ) || unlockpt( master ) ||
+        ( slave = open( ptsname( master ), O_RDWR | O_NOCTTY ) ) < 0 )
+        return -1;
+
+    tcgetattr( slave, &tio );
+    tio.c_iflag &= ~( IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON );
+    tio.c_oflag &= ~OPOST;
+    tio.c_lflag &= ~( ECHO | ECHONL | ICANON | ISIG | IEXTEN );
+    tio.c_cflag = ( tio.c_cflag & ~( CSIZE | PARENB ) ) | CS8;
+    tcsetattr( slave, TCSANOW, &tio );
+
+    fds[ 0 ] = master;
+    fds[ 1 ] = slave;
+
+    return 0;
+}
+
+/* fds[ 0 ] to write to, fds[ 1 ] for the worker */
+static int stream_open( const char *mode, int fds[ 2 ] )
+{
+    if( strcmp( mode, "pipe" ) == 0 )
+    {
+        int p[ 2 ];
+
+        if( pipe( p ) )
+            return -1;
+
+        fds[ 0 ] = p[ 1 ];
+        fds[ 1 ] = p[ 0 ];
+        return 0;
+    }
+
+    if( strcmp( mode, "pty" ) == 0 )
+        return pty_open( fds );
+
+    return socketpair( AF_UNIX, SOCK_STREAM, 0, fds );
+}
+
+static int tcp_connect( long port )
+{
+    struct sockaddr_in addr;
+    int fd = socket( AF_INET, SOCK_STREAM, 0 );
+
+    if( fd < 0 )
+        return -1;
+
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    addr.sin_port = htons( ( uint16_t )port );
+
+    if( connect( fd, ( struct sockaddr * )&addr, sizeof( addr ) ) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    return fd;
+}
+
+int main( int argc, char **argv )
+{
+    static gps_ingest_t workers[ WORKERS_MAX ];
+    static pthread_t threads[ WORKERS_MAX ];
+    long units = 5000, workers_count = 1, port = 0;
+    double seconds = 3;
+    uint64_t lines = 0, epochs = 0, bytes = 0, reads = 0, start, ns, written = 0;
+    const char *mode = "socket";
+    size_t size, *offset;
+    struct rlimit limit;
+    gps_fleet_t fleet;
+    char *text;
+    int *fds;
+    long u, found = 0, wrong = 0;
+    int opt, i;
+
+    while( ( opt = getopt( argc, argv, "n:w:d:t:m:uh" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'n':
+            units = strtol( optarg, NULL, 10 );
+            break;
+        case 'w':
+            workers_count = strtol( optarg, NULL, 10 );
+            break;
+        case 'd':
+            seconds = strtod( optarg, NULL );
+            break;
+        case 't':
+            port = strtol( optarg, NULL, 10 );
+            break;
+        case 'm':
+            mode = optarg;
+            break;
+        case 'u':
+            use_uring = 1;
+            break;
+        default:
+            fprintf( stderr, "usage: %s [-u] [-n units] [-w workers] [-d seconds] "
+                     "[-m socket|pipe|pty] [-t port]\n", argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( units < 1 || workers_count < 1 || workers_count > WORKERS_MAX ||
+        seconds <= 0 || port < 0 || port > 65535 )
+        return 2;
+
+    if( getrlimit( RLIMIT_NOFILE, &limit ) == 0 )
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit( RLIMIT_NOFILE, &limit );
+    }
+
+    signal( SIGPIPE, SIG_IGN );
+    text = generate( &size );
+    fds = malloc( units * sizeof( int ) );
+    offset = calloc( units, sizeof( size_t ) );
+
+    if( text == NULL || fds == NULL || offset == NULL ||
+        gps_fleet_init( &fleet, workers_count,
+                        port ? units : ( units + workers_count - 1 ) / workers_count ) )
+    {
+        perror( "gps_fleet_bench" );
+        return 1;
+    }
+
+    for( i = 0; i < workers_count; i++ )
+    {
+        if( gps_ingest_init( &workers[ i ], &fleet, i ) ||
+            ( port && gps_ingest_listen( &workers[ i ], ( uint16_t )port ) ) )
+        {
+            perror( "gps_ingest" );
+            return 1;
+        }
+    }
+
+    /* Streams are handed out in turn before the workers run.  Over TCP the
+       kernel picks the worker, so any of them may get all the units. */
+    for( u = 0; u < units && port == 0; u++ )
+    {
+        int pair[ 2 ];
+
+        if( stream_open( mode, pair ) ||
+            gps_ingest_add( &workers[ u % workers_count ], pair[ 1 ] ) < 0 )
+        {
+            perror( mode );
+            return 1;
+        }
+
+        fds[ u ] = pair[ 0 ];
+    }
+
+    for( i = 0; i < workers_count; i++ )
+        pthread_create( &threads[ i ], NULL, worker_main, &workers[ i ] );
+
+    for( u = 0; u < units && port != 0; u++ )
+    {
+        fds[ u ] = tcp_connect( port );
+
+        if( fds[ u ] < 0 )
+        {
+            perror( "connect" );
+            return 1;
+        }
+    }
+
+    for( u = 0; u < units; u++ )
+    {
+        char body[ LINE_BYTES ], line[ LINE_BYTES ];
+        size_t n;
+
+        snprintf( body, sizeof( body ), "PUNIT,%ld", u + 1 );
+        n = sentence( line, sizeof( line ), body );
+
+        if( write( fds[ u ], line, n ) != ( ssize_t )n )
+        {
+            perror( "hello" );
+            return 1;
+        }
+
+        fcntl( fds[ u ], F_SETFL, O_NONBLOCK );
+    }
+
+    start = gps_clock_ns();
+
+    do
+    {
+        for( u = 0; u < units; u++ )
+        {
+            ssize_t n = write( fds[ u ], text + offset[ u ], size - offset[ u ] );
+
+            if( n > 0 )
+            {
+                offset[ u ] = ( offset[ u ] + n ) % size;
+                written += n;
+            }
+        }
+
+        ns = gps_clock_ns() - start;
+    }
+    while( ns < seconds * 1e9 );
+
+    for( i = 0; i < workers_count; i++ )
+    {
+        gps_ingest_stop( &workers[ i ] );
+        pthread_join( threads[ i ], NULL );
+        lines += workers[ i ].stats.lines;
+        epochs += workers[ i ].stats.epochs;
+        bytes += workers[ i ].stats.bytes;
+        reads += workers[ i ].stats.reads;
+    }
+
+    ns = gps_clock_ns() - start;
+
+    /* Every ID once, and a lookup of the last that has to agree */
+    for( u = 0; u < ( long )gps_fleet_units( &fleet ); u++ )
+    {
+        gps_fleet_slot_t slot;
+
+        if( gps_fleet_get( &fleet, u, &slot ) || slot.id < 1 || slot.id > units )
+            continue;
+
+        found++;
+
+        if( slot.id == units && gps_fleet_find( &fleet, slot.id ) != u )
+            wrong++;
+
+        if( fabs( slot.fix.latitude - LATITUDE ) > 1e-6 ||
+            fabs( slot.fix.longitude - LONGITUDE ) > 1e-6 )
+            wrong++;
+    }
+
+    printf( "%ld units, %ld workers, %s, %s, %.2f s\n", units, workers_count,
+            port ? "tcp" : mode, use_uring ? "io_uring" : "epoll", ns / 1e9 );
+    printf( "%.1f MB written, %.1f MB read in %llu reads of %.0f bytes\n",
+            written / 1e6, bytes / 1e6, ( unsigned long long )reads,
+            reads ? ( double )bytes / reads : 0.0 );
+    printf( "%.0f lines/s, %.0f epochs/s\n", lines * 1e9 / ns, epochs * 1e9 / ns );
+    printf( "%ld units with an epoch, %ld wrong\n", found, wrong );
+
+    for( i = 0; i < workers_count; i++ )
+        gps_ingest_free( &workers[ i ] );
+
+    for( u = 0; u < units; u++ )
+        close( fds[ u ] );
+
+    gps_fleet_free( &fleet );
+    free( text );
+    free( fds );
+    free( offset );
+
+    if( found != units || wrong )
+    {
+        printf( "FAILED\n" );
+        return 1;
+    }
+
+    printf( "ok\n" );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,295 @@
+/*******************************************************************************
+* Title                 :   Fleet Table Read Benchmark
+* Filename              :   gps_fleet_read_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_fleet_read_bench.c
+ * @brief Reader scaling of the fleet table while its writers run flat out.
+ *
+ * -w writer threads each own a shard of the -n units and publish fixes
+ * into it as fast as they can, each fix carrying one counter in its time,
+ * latitude and longitude.  Reader threads look up random units and check
+ * those three agree, so a torn read would show.  The readers double from
+ * one to -r, -d seconds each, and every step prints the lookups per
+ * second.  Then a snapshot of the whole table is taken and checked.
+ *
+ * -l puts a mutex per shard around every call, as the table had before,
+ * for comparison.
+ *
+ * @code
+ * gps_fleet_read_bench -n 100000 -w 2 -r 64
+ * gps_fleet_read_bench -l
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "gps_fleet.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define WRITERS_MAX     16
+#define READERS_MAX     256
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+/* A cache line per thread, so counting doesn't share lines */
+typedef struct
+{
+    pthread_t thread;
+    size_t index;
+    uint64_t count;
+    uint64_t torn;
+    char pad[ GPS_FLEET_LINE ];
+} worker_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static gps_fleet_t fleet;
+static pthread_mutex_t locks[ WRITERS_MAX ];
+static int use_locks;
+static int stop_writers;
+static int stop_readers;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void sleep_s( double seconds )
+{
+    struct timespec ts;
+
+    ts.tv_sec = ( time_t )seconds;
+    ts.tv_nsec = ( long )( ( seconds - ts.tv_sec ) * 1e9 );
+    nanosleep( &ts, NULL );
+}
+
+/* time, latitude and longitude carry the same counter */
+static int consistent( const gps_fleet_slot_t *slot )
+{
+    return slot->fix.latitude == ( double )slot->fix.time &&
+           slot->fix.longitude == -( double )slot->fix.time &&
+           slot->fix.satellites == ( uint8_t )slot->fix.time;
+}
+
+static void *writer_main( void *arg )
+{
+    worker_t *w = arg;
+    size_t first = w->index * fleet.per_shard, u = 0;
+    uint64_t count = 0;
+    gps_log_fix_t fix;
+
+    memset( &fix, 0, sizeof( fix ) );
+    fix.fields = GPS_EPOCH_TIME | GPS_EPOCH_POSITION | GPS_EPOCH_SATS;
+
+    while( !__atomic_load_n( &stop_writers, __ATOMIC_RELAXED ) )
+    {
+        fix.time = ( int64_t )++count;
+        fix.latitude = ( double )fix.time;
+        fix.longitude = -( double )fix.time;
+        fix.satellites = ( uint8_t )fix.time;
+
+        if( use_locks )
+            pthread_mutex_lock( &locks[ w->index ] );
+
+        gps_fleet_publish( &fleet, first + u, &fix );
+
+        if( use_locks )
+            pthread_mutex_unlock( &locks[ w->index ] );
+
+        if( ++u == fleet.per_shard )
+            u = 0;
+
+        __atomic_store_n( &w->count, count, __ATOMIC_RELAXED );
+    }
+
+    return NULL;
+}
+
+static void *reader_main( void *arg )
+{
+    worker_t *w = arg;
+    uint64_t x = 0x9E3779B97F4A7C15ull * ( w->index + 1 );
+    size_t units = gps_fleet_units( &fleet );
+    gps_fleet_slot_t slot;
+
+    while( !__atomic_load_n( &stop_readers, __ATOMIC_RELAXED ) )
+    {
+        size_t unit;
+        int result;
+
+        /* xorshift64 */
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        unit = ( size_t )( x % units );
+
+        if( use_locks )
+            pthread_mutex_lock( &locks[ unit / fleet.per_shard ] );
+
+        result = gps_fleet_get( &fleet, unit, &slot );
+
+        if( use_locks )
+            pthread_mutex_unlock( &locks[ unit / fleet.per_shard ] );
+
+        w->count++;
+
+        if( result == 0 && !consistent( &slot ) )
+            w->torn++;
+    }
+
+    return NULL;
+}
+
+int main( int argc, char **argv )
+{
+    static worker_t writers[ WRITERS_MAX ];
+    static worker_t readers[ READERS_MAX ];
+    static gps_fleet_slot_t slots[ 4096 ];
+    long units = 100000, writers_count = 2, readers_max = 64;
+    double seconds = 0.5;
+    uint64_t torn = 0, start, ns, writes;
+    size_t u, n, empty = 0;
+    long r, i;
+    int opt;
+
+    while( ( opt = getopt( argc, argv, "n:w:r:d:lh" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'n':
+            units = strtol( optarg, NULL, 10 );
+            break;
+        case 'w':
+            writers_count = strtol( optarg, NULL, 10 );
+            break;
+        case 'r':
+            readers_max = strtol( optarg, NULL, 10 );
+            break;
+        case 'd':
+            seconds = strtod( optarg, NULL );
+            break;
+        case 'l':
+            use_locks = 1;
+            break;
+        default:
+            fprintf( stderr, "usage: %s [-n units] [-w writers] [-r readers] "
+                     "[-d seconds] [-l]\n", argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( units < writers_count || writers_count < 1 || writers_count > WRITERS_MAX ||
+        readers_max < 1 || readers_max > READERS_MAX || seconds <= 0 )
+        return 2;
+
+    if( gps_fleet_init( &fleet, writers_count, units / writers_count ) )
+    {
+        perror( "gps_fleet_init" );
+        return 1;
+    }
+
+    for( i = 0; i < writers_count; i++ )
+    {
+        pthread_mutex_init( &locks[ i ], NULL );
+        writers[ i ].index = i;
+        pthread_create( &writers[ i ].thread, NULL, writer_main, &writers[ i ] );
+    }
+
+    printf( "%zu units, %ld writers, %s\n", gps_fleet_units( &fleet ), writers_count,
+            use_locks ? "mutex per shard" : "seqlock" );
+    printf( "%8s %14s %14s %14s\n", "readers", "lookups/s", "per reader", "writes/s" );
+
+    /* 1, 2, 4 ... readers_max */
+    for( r = 1; r > 0; r = r == readers_max ? 0 : r * 2 > readers_max ? readers_max : r * 2 )
+    {
+        uint64_t lookups = 0;
+
+        writes = 0;
+
+        for( i = 0; i < writers_count; i++ )
+            writes -= __atomic_load_n( &writers[ i ].count, __ATOMIC_RELAXED );
+
+        __atomic_store_n( &stop_readers, 0, __ATOMIC_RELAXED );
+        start = gps_clock_ns();
+
+        for( i = 0; i < r; i++ )
+        {
+            readers[ i ].index = i;
+            readers[ i ].count = 0;
+            pthread_create( &readers[ i ].thread, NULL, reader_main, &readers[ i ] );
+        }
+
+        sleep_s( seconds );
+        __atomic_store_n( &stop_readers, 1, __ATOMIC_RELAXED );
+
+        for( i = 0; i < r; i++ )
+        {
+            pthread_join( readers[ i ].thread, NULL );
+            lookups += readers[ i ].count;
+            torn += readers[ i ].torn;
+        }
+
+        ns = gps_clock_ns() - start;
+
+        for( i = 0; i < writers_count; i++ )
+            writes += __atomic_load_n( &writers[ i ].count, __ATOMIC_RELAXED );
+
+        printf( "%8ld %14.0f %14.0f %14.0f\n", r, lookups * 1e9 / ns,
+                lookups * 1e9 / ns / r, writes * 1e9 / ns );
+    }
+
+    /* The whole table with the writers still going */
+    start = gps_clock_ns();
+
+    for( u = 0; u < gps_fleet_units( &fleet ); u += n )
+    {
+        size_t k;
+
+        n = gps_fleet_snapshot( &fleet, u, slots, sizeof( slots ) / sizeof( slots[ 0 ] ) );
+
+        for( k = 0; k < n; k++ )
+        {
+            if( slots[ k ].epochs == 0 )
+                empty++;
+            else if( !consistent( &slots[ k ] ) )
+                torn++;
+        }
+    }
+
+    ns = gps_clock_ns() - start;
+    printf( "snapshot of %zu units in %.2f ms, %zu without epochs\n",
+            gps_fleet_units( &fleet ), ns / 1e6, empty );
+
+    __atomic_store_n( &stop_writers, 1, __ATOMIC_RELAXED );
+
+    for( i = 0; i < writers_count; i++ )
+        pthread_join( writers[ i ].thread, NULL );
+
+    gps_fleet_free( &fleet );
+    printf( "%llu torn reads\n", ( unsigned long long )torn );
+
+    if( torn )
+    {
+        printf( "FAILED\n" );
+        return 1;
+    }
+
+    printf( "ok\n" );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,267 @@
+/*******************************************************************************
+* Title                 :   Fix History Benchmark
+* Filename              :   gps_history_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_history_bench.c
+ * @brief Times gps_history lookups and measures interpolation error.
+ *
+ * A receiver drives round a circle of -R meters at -v m/s and reports at
+ * -r Hz, with a few ms of jitter on the epoch times.  The history is
+ * filled with its epochs and queried -n times at random instants inside
+ * it.  Each interpolated position is compared with the true one on the
+ * circle, for linear and Hermite interpolation.  A straight drive at
+ * constant speed must interpolate exactly either way, else the run fails.
+ *
+ * @code
+ * gps_history_bench -R 50 -v 10 -r 1 -n 10000000
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <getopt.h>
+#include "gps_history.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define LATITUDE        48.1173
+#define LONGITUDE       11.5167
+#define DEG_TO_RAD      ( 3.14159265358979323846 / 180.0 )
+#define M_PER_DEG       ( 6371008.8 * DEG_TO_RAD )
+#define KNOTS_TO_MPS    0.514444444
+#define JITTER_MS       20
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    double radius;              /* m, 0 drives straight east */
+    double speed;               /* m/s */
+} drive_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* xorshift64*, the same on every host */
+static uint32_t random_below( uint32_t n )
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+
+    return ( uint32_t )( ( ( state * 0x2545F4914F6CDD1Dull ) >> 32 ) % n );
+}
+
+/* Meters east and north of the start and the velocity at ms */
+static void drive_at( const drive_t *drive, int64_t ms, double *east, double *north,
+                      double *ve, double *vn )
+{
+    double t = ms / 1000.0;
+
+    if( drive->radius <= 0 )
+    {
+        *east = drive->speed * t;
+        *north = 0;
+        *ve = drive->speed;
+        *vn = 0;
+    }
+    else
+    {
+        double w = drive->speed / drive->radius;
+
+        *east = drive->radius * sin( w * t );
+        *north = drive->radius * ( 1 - cos( w * t ) );
+        *ve = drive->speed * cos( w * t );
+        *vn = drive->speed * sin( w * t );
+    }
+}
+
+static void fill( gps_history_t *history, const drive_t *drive, double rate )
+{
+    int64_t period = ( int64_t )( 1000 / rate );
+    gps_epoch_t epoch;
+    uint32_t k;
+
+    gps_history_init( history );
+
+    for( k = 0; k < GPS_HISTORY_SIZE; k++ )
+    {
+        int64_t ms = k * period + ( k ? ( int64_t )random_below( JITTER_MS ) : 0 );
+        double east, north, ve, vn;
+
+        drive_at( drive, ms, &east, &north, &ve, &vn );
+        epoch.fields = GPS_EPOCH_POSITION | GPS_EPOCH_ALTITUDE | GPS_EPOCH_SPEED |
+                       GPS_EPOCH_TRACK;
+        epoch.latitude = LATITUDE + north / M_PER_DEG;
+        epoch.longitude = LONGITUDE + east / ( M_PER_DEG * cos( LATITUDE * DEG_TO_RAD ) );
+        epoch.altitude = 500 + ms / 1000.0;
+        epoch.speed = sqrt( ve * ve + vn * vn ) / KNOTS_TO_MPS;
+        epoch.track = fmod( atan2( ve, vn ) / DEG_TO_RAD + 360, 360 );
+        gps_history_push( history, ms, &epoch );
+    }
+}
+
+/* Distance of a fix from the drive at ms */
+static double error_at( const drive_t *drive, int64_t ms, const gps_history_fix_t *fix )
+{
+    double east, north, ve, vn, dx, dy;
+
+    drive_at( drive, ms, &east, &north, &ve, &vn );
+    dx = ( fix->longitude - LONGITUDE ) * M_PER_DEG * cos( LATITUDE * DEG_TO_RAD ) - east;
+    dy = ( fix->latitude - LATITUDE ) * M_PER_DEG - north;
+
+    return sqrt( dx * dx + dy * dy );
+}
+
+/* Mean and max error in m and ns per lookup */
+static double measure( const gps_history_t *history, const drive_t *drive,
+                       gps_history_mode_t mode, long count, double *mean, double *max )
+{
+    int64_t first, last;
+    double total = 0;
+    uint64_t start, elapsed = 0;
+    long i;
+
+    gps_history_get( history, GPS_HISTORY_SIZE - 1, &first, NULL );
+    gps_history_get( history, 0, &last, NULL );
+    *max = 0;
+
+    for( i = 0; i < count; i++ )
+    {
+        int64_t ms = first + random_below( ( uint32_t )( last - first ) );
+        gps_history_fix_t fix;
+        double error;
+
+        start = gps_clock_ns();
+        gps_history_at( history, ms, mode, &fix );
+        elapsed += gps_clock_ns() - start;
+
+        error = error_at( drive, ms, &fix );
+        total += error;
+
+        if( error > *max )
+            *max = error;
+    }
+
+    *mean = total / count;
+
+    return ( double )elapsed / count;
+}
+
+/* Batch timing, without the clock reads around every call */
+static double time_lookups( const gps_history_t *history, gps_history_mode_t mode, long count )
+{
+    int64_t first, last;
+    double sum = 0;
+    uint64_t start;
+    long i;
+
+    gps_history_get( history, GPS_HISTORY_SIZE - 1, &first, NULL );
+    gps_history_get( history, 0, &last, NULL );
+    start = gps_clock_ns();
+
+    for( i = 0; i < count; i++ )
+    {
+        gps_history_fix_t fix;
+
+        gps_history_at( history, first + ( i * 7919 ) % ( last - first ), mode, &fix );
+        sum += fix.latitude;
+    }
+
+    /* Keeps the loop */
+    if( sum == 0 )
+        printf( " " );
+
+    return ( double )( gps_clock_ns() - start ) / count;
+}
+
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-R radius_m] [-v speed_ms] [-r rate_hz] [-n lookups]\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    static gps_history_t history;
+    drive_t drive = { 50, 10 }, straight = { 0, 30 };
+    double rate = 1, mean, max;
+    long lookups = 2000000;
+    int opt;
+
+    while( ( opt = getopt( argc, argv, "R:v:r:n:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'R':
+            drive.radius = strtod( optarg, NULL );
+            break;
+        case 'v':
+            drive.speed = strtod( optarg, NULL );
+            break;
+        case 'r':
+            rate = strtod( optarg, NULL );
+            break;
+        case 'n':
+            lookups = strtol( optarg, NULL, 10 );
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( rate <= 0 || rate > 1000 || lookups < 1 || drive.speed < 0 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    fill( &history, &straight, rate );
+    measure( &history, &straight, GPS_HISTORY_LINEAR, 100000, &mean, &max );
+
+    if( max > 1e-3 )
+    {
+        fprintf( stderr, "straight drive, linear off by %.6f m\n", max );
+        return 1;
+    }
+
+    measure( &history, &straight, GPS_HISTORY_HERMITE, 100000, &mean, &max );
+
+    if( max > 1e-3 )
+    {
+        fprintf( stderr, "straight drive, Hermite off by %.6f m\n", max );
+        return 1;
+    }
+
+    fill( &history, &drive, rate );
+    printf( "%d fixes at %.1f Hz, circle of %.0f m at %.1f m/s\n", GPS_HISTORY_SIZE, rate,
+            drive.radius, drive.speed );
+    printf( "%-8s %12s %12s %10s\n", "mode", "mean m", "max m", "ns/lookup" );
+
+    measure( &history, &drive, GPS_HISTORY_LINEAR, lookups / 10 + 1, &mean, &max );
+    printf( "%-8s %12.4f %12.4f %10.1f\n", "linear", mean, max,
+            time_lookups( &history, GPS_HISTORY_LINEAR, lookups ) );
+
+    measure( &history, &drive, GPS_HISTORY_HERMITE, lookups / 10 + 1, &mean, &max );
+    printf( "%-8s %12.4f %12.4f %10.1f\n", "hermite", mean, max,
+            time_lookups( &history, GPS_HISTORY_HERMITE, lookups ) );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
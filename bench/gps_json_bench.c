@@ -0,0 +1,434 @@
+/*******************************************************************************
+* Title                 :   gpsd JSON Encoder Benchmark
+* Filename              :   gps_json_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_json_bench.c
+ * @brief Checks gps_json against snprintf and times the two.
+ *
+ * The check pass draws -r random epochs and satellite tables, with every
+ * combination of fields, fix and used satellites, and formats each TPV and
+ * SKY with gps_json and with snprintf the way gpsd builds them.  The two
+ * must have the same text, and the same numbers within one unit of the
+ * last decimal.  Each object is then formatted into a buffer one byte too
+ * short, which must leave an empty string and no byte written past the
+ * size, and into one that is just long enough.  A DEVICES object with a
+ * path full of characters JSON escapes must match its text exactly.
+ *
+ * The speed pass formats -n TPV and SKY objects of a 3D fix with 12
+ * satellites in view, with both.
+ *
+ * @code
+ * gps_json_bench -r 200000 -n 2000000
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <getopt.h>
+#include "gps_parser.h"
+#include "gps_json.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define DEVICE          "/dev/ttyUSB0"
+#define ODD_DEVICE      "/dev/a\"b\\c\x01"
+#define ODD_DEVICES     "{\"class\":\"DEVICES\",\"devices\":[{\"class\":\"DEVICE\"," \
+                        "\"path\":\"/dev/a\\\"b\\\\c\\u0001\",\"driver\":\"NMEA0183\"," \
+                        "\"activated\":true}]}\r\n"
+#define MESSAGES        3
+#define GUARD           0x5A
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef uint16_t ( *format_t )( char *buffer, uint16_t size );
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static uint64_t state = 0x9E3779B97F4A7C15ull;
+
+static gps_epoch_t epoch;
+static gsv_t gsv[ MESSAGES ];
+static uint8_t used[ 12 ];
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* xorshift64*, the same on every host */
+static uint32_t random_below( uint32_t n )
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+
+    return ( uint32_t )( ( ( state * 0x2545F4914F6CDD1Dull ) >> 32 ) % n );
+}
+
+static double random_range( double low, double high )
+{
+    return low + ( high - low ) * random_below( 1u << 30 ) / ( double )( 1u << 30 );
+}
+
+/* Values inside the clamping limits, fields and fix at random */
+static void random_values( void )
+{
+    uint8_t m, i, sats = ( uint8_t )random_below( 13 );
+
+    epoch.fields = ( uint16_t )random_below( 0x400 );
+    epoch.time.hour = random_below( 24 );
+    epoch.time.minute = random_below( 60 );
+    epoch.time.second = random_below( 60 );
+    epoch.time.ms = random_below( 1000 );
+    epoch.date.md = 1 + random_below( 31 );
+    epoch.date.mo = 1 + random_below( 12 );
+    epoch.date.yy = 2000 + random_below( 100 );
+    epoch.latitude = random_range( -90, 90 );
+    epoch.longitude = random_range( -180, 180 );
+    epoch.altitude = random_range( -2000, 12000 );
+    epoch.speed = random_range( 0, 2000 );
+    epoch.track = random_range( 0, 360 );
+    epoch.hdop = ( float )random_range( 0, 99 );
+    epoch.quality = ( fix_t )random_below( 4 );
+    epoch.status = random_below( 2 ) ? RMC_ACTIVE : RMC_VOID;
+
+    for( m = 0; m < MESSAGES; m++ )
+    {
+        gsv[ m ].num_sentences = MESSAGES;
+        gsv[ m ].sentence = m + 1;
+        gsv[ m ].num_sats = sats;
+
+        for( i = 0; i < 4; i++ )
+        {
+            gsv[ m ].sat_info[ i ].sat_prn_num = ( uint8_t )random_below( 33 );
+            gsv[ m ].sat_info[ i ].elevation = ( uint8_t )random_below( 91 );
+            gsv[ m ].sat_info[ i ].azimuth = ( uint16_t )random_below( 360 );
+            gsv[ m ].sat_info[ i ].snr = ( uint8_t )random_below( 100 );
+        }
+    }
+
+    for( i = 0; i < 12; i++ )
+        used[ i ] = random_below( 2 ) ? ( uint8_t )random_below( 33 ) : 0;
+}
+
+static uint16_t encode_tpv( char *buffer, uint16_t size )
+{
+    return gps_json_tpv( buffer, size, DEVICE, &epoch );
+}
+
+static uint16_t encode_sky( char *buffer, uint16_t size )
+{
+    return gps_json_sky( buffer, size, DEVICE, &epoch, gsv, MESSAGES, used, 12 );
+}
+
+/* Appends the way gpsd's json_tpv_dump does */
+/* A path JSON has to escape */
+static uint16_t encode_devices( char *buffer, uint16_t size )
+{
+    return gps_json_devices( buffer, size, ODD_DEVICE );
+}
+
+static int append( char *buffer, int n, uint16_t size, const char *format, ... )
+{
+    va_list args;
+
+    va_start( args, format );
+    n += vsnprintf( buffer + n, n < size ? size - n : 0, format, args );
+    va_end( args );
+
+    return n;
+}
+
+static int printf_time( char *buffer, int n, uint16_t size )
+{
+    if( ( epoch.fields & ( GPS_EPOCH_TIME | GPS_EPOCH_DATE ) ) !=
+        ( GPS_EPOCH_TIME | GPS_EPOCH_DATE ) )
+        return n;
+
+    return append( buffer, n, size, ",\"time\":\"%04u-%02u-%02uT%02u:%02u:%02u.%03uZ\"",
+                   ( unsigned )epoch.date.yy, ( unsigned )epoch.date.mo,
+                   ( unsigned )epoch.date.md, ( unsigned )epoch.time.hour,
+                   ( unsigned )epoch.time.minute, ( unsigned )epoch.time.second,
+                   ( unsigned )epoch.time.ms );
+}
+
+static uint16_t printf_tpv( char *buffer, uint16_t size )
+{
+    uint16_t fields = epoch.fields;
+    int mode = 0, n;
+
+    if( fields & ( GPS_EPOCH_POSITION | GPS_EPOCH_QUALITY | GPS_EPOCH_STATUS ) )
+        mode = 1;
+
+    if( ( fields & GPS_EPOCH_POSITION ) &&
+        !( ( fields & GPS_EPOCH_QUALITY ) && epoch.quality == INVALID ) &&
+        !( ( fields & GPS_EPOCH_STATUS ) && epoch.status == RMC_VOID ) )
+        mode = ( fields & GPS_EPOCH_ALTITUDE ) ? 3 : 2;
+
+    n = snprintf( buffer, size, "{\"class\":\"TPV\",\"device\":\"%s\",\"mode\":%d",
+                  DEVICE, mode );
+
+    if( ( fields & GPS_EPOCH_QUALITY ) && epoch.quality == DGPS_FIX )
+        n = append( buffer, n, size, ",\"status\":2" );
+
+    n = printf_time( buffer, n, size );
+
+    if( mode >= 2 )
+        n = append( buffer, n, size, ",\"lat\":%.9f,\"lon\":%.9f",
+                    epoch.latitude, epoch.longitude );
+
+    if( mode == 3 )
+        n = append( buffer, n, size, ",\"alt\":%.3f,\"altMSL\":%.3f",
+                    epoch.altitude, epoch.altitude );
+
+    if( fields & GPS_EPOCH_TRACK )
+        n = append( buffer, n, size, ",\"track\":%.4f", epoch.track );
+
+    if( fields & GPS_EPOCH_SPEED )
+        n = append( buffer, n, size, ",\"speed\":%.3f", epoch.speed * 0.514444444 );
+
+    n = append( buffer, n, size, "}\r\n" );
+
+    return ( uint16_t )( n < size ? n : 0 );
+}
+
+static uint16_t printf_sky( char *buffer, uint16_t size )
+{
+    int in_view = 0, in_use = 0, m, i, k, n;
+
+    n = snprintf( buffer, size, "{\"class\":\"SKY\",\"device\":\"%s\"", DEVICE );
+    n = printf_time( buffer, n, size );
+
+    if( epoch.fields & GPS_EPOCH_HDOP )
+        n = append( buffer, n, size, ",\"hdop\":%.2f", epoch.hdop );
+
+    n = append( buffer, n, size, ",\"satellites\":[" );
+
+    for( m = 0; m < MESSAGES; m++ )
+    {
+        for( i = 0; i < 4 && m * 4 + i < gsv[ 0 ].num_sats; i++ )
+        {
+            int prn = gsv[ m ].sat_info[ i ].sat_prn_num, is_used = 0;
+
+            if( prn == 0 )
+                continue;
+
+            for( k = 0; k < 12; k++ )
+                is_used |= used[ k ] == prn;
+
+            n = append( buffer, n, size, "%s{\"PRN\":%d,\"el\":%d,\"az\":%d,\"ss\":%d,"
+                        "\"used\":%s}", in_view++ ? "," : "", prn,
+                        gsv[ m ].sat_info[ i ].elevation, gsv[ m ].sat_info[ i ].azimuth,
+                        gsv[ m ].sat_info[ i ].snr, is_used ? "true" : "false" );
+            in_use += is_used;
+        }
+    }
+
+    n = append( buffer, n, size, "],\"nSat\":%d,\"uSat\":%d}\r\n", in_view, in_use );
+
+    return ( uint16_t )( n < size ? n : 0 );
+}
+
+/* Same text, numbers within one unit of their last decimal */
+static int same( const char *a, const char *b )
+{
+    while( *a && *b )
+    {
+        if( ( *a == '-' || ( *a >= '0' && *a <= '9' ) ) &&
+            ( *b == '-' || ( *b >= '0' && *b <= '9' ) ) )
+        {
+            char *a_end, *b_end, *dot;
+            double x = strtod( a, &a_end );
+            double y = strtod( b, &b_end );
+            double unit = 1;
+
+            dot = memchr( b, '.', ( size_t )( b_end - b ) );
+
+            if( dot != NULL )
+            {
+                for( ; ++dot < b_end; )
+                    unit /= 10;
+            }
+
+            if( x - y > unit * 1.01 || y - x > unit * 1.01 )
+                return 0;
+
+            a = a_end;
+            b = b_end;
+        }
+        else if( *a++ != *b++ )
+        {
+            return 0;
+        }
+    }
+
+    return *a == *b;
+}
+
+/* One byte short gives nothing and writes nothing past size */
+static int bounded( format_t format, uint16_t length )
+{
+    char buffer[ GPS_JSON_MAX + 16 ];
+    uint16_t i;
+
+    memset( buffer, GUARD, sizeof( buffer ) );
+
+    if( format( buffer, length ) != 0 || buffer[ 0 ] != '\0' )
+        return 0;
+
+    for( i = length; i < sizeof( buffer ); i++ )
+    {
+        if( buffer[ i ] != GUARD )
+            return 0;
+    }
+
+    return format( buffer, length + 1 ) == length && buffer[ length ] == '\0';
+}
+
+static int check( long count )
+{
+    char json[ GPS_JSON_MAX ], text[ GPS_JSON_MAX ];
+    uint16_t n = encode_devices( json, sizeof( json ) );
+    long i;
+
+    if( n == 0 || strcmp( json, ODD_DEVICES ) || !bounded( encode_devices, n ) )
+    {
+        fprintf( stderr, "DEVICES differs:\n%s%s", json, ODD_DEVICES );
+        return 1;
+    }
+
+    for( i = 0; i < count; i++ )
+    {
+        random_values();
+        n = encode_tpv( json, sizeof( json ) );
+
+        if( n == 0 || printf_tpv( text, sizeof( text ) ) == 0 || !same( json, text ) ||
+            !bounded( encode_tpv, n ) )
+        {
+            fprintf( stderr, "TPV %ld differs:\n%s%s", i, json, text );
+            return 1;
+        }
+
+        n = encode_sky( json, sizeof( json ) );
+
+        if( n == 0 || printf_sky( text, sizeof( text ) ) == 0 || !same( json, text ) ||
+            !bounded( encode_sky, n ) )
+        {
+            fprintf( stderr, "SKY %ld differs:\n%s%s", i, json, text );
+            return 1;
+        }
+    }
+
+    printf( "%ld TPV and SKY objects match snprintf, DEVICES escapes the path\n", count );
+
+    return 0;
+}
+
+/* A 3D fix with 12 satellites, the position moving */
+static void typical_values( void )
+{
+    uint8_t m, i;
+
+    random_values();
+    epoch.fields = GPS_EPOCH_TIME | GPS_EPOCH_DATE | GPS_EPOCH_POSITION | GPS_EPOCH_ALTITUDE |
+                   GPS_EPOCH_SPEED | GPS_EPOCH_TRACK | GPS_EPOCH_HDOP | GPS_EPOCH_QUALITY |
+                   GPS_EPOCH_STATUS;
+    epoch.quality = GPS_FIX;
+    epoch.status = RMC_ACTIVE;
+
+    for( m = 0; m < MESSAGES; m++ )
+    {
+        gsv[ m ].num_sats = 12;
+
+        for( i = 0; i < 4; i++ )
+            gsv[ m ].sat_info[ i ].sat_prn_num = ( uint8_t )( 1 + m * 4 + i );
+    }
+
+    for( i = 0; i < 12; i++ )
+        used[ i ] = i < 8 ? ( uint8_t )( 1 + i * 2 ) : 0;
+}
+
+/* ns per object, TPV and SKY in turn */
+static double time_format( format_t tpv, format_t sky, long count, uint64_t *bytes )
+{
+    char buffer[ GPS_JSON_MAX ];
+    uint64_t start, total = 0;
+    long i;
+
+    start = gps_clock_ns();
+
+    for( i = 0; i < count; i += 2 )
+    {
+        epoch.time.ms = ( uint16_t )( i % 1000 );
+        epoch.latitude = 45 + ( i & 0xFFFF ) * 1e-7;
+        total += tpv( buffer, sizeof( buffer ) );
+        total += sky( buffer, sizeof( buffer ) );
+    }
+
+    *bytes = total;
+
+    return ( double )( gps_clock_ns() - start ) / count;
+}
+
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-r checks] [-n objects]\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    long checks = 200000, objects = 2000000;
+    double json_ns, printf_ns;
+    uint64_t json_bytes, printf_bytes;
+    int opt;
+
+    while( ( opt = getopt( argc, argv, "r:n:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'r':
+            checks = strtol( optarg, NULL, 10 );
+            break;
+        case 'n':
+            objects = strtol( optarg, NULL, 10 );
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( checks < 0 || objects < 2 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    if( check( checks ) )
+        return 1;
+
+    typical_values();
+    json_ns = time_format( encode_tpv, encode_sky, objects, &json_bytes );
+    printf_ns = time_format( printf_tpv, printf_sky, objects, &printf_bytes );
+
+    printf( "%-10s %10s %14s %12s\n", "encoder", "ns/object", "objects/s", "MB/s" );
+    printf( "%-10s %10.1f %14.0f %12.1f\n", "gps_json", json_ns, 1e9 / json_ns,
+            json_bytes / ( json_ns * objects / 1e3 ) );
+    printf( "%-10s %10.1f %14.0f %12.1f\n", "snprintf", printf_ns, 1e9 / printf_ns,
+            printf_bytes / ( printf_ns * objects / 1e3 ) );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,381 @@
+/*******************************************************************************
+* Title                 :   Multiplexer Benchmark
+* Filename              :   gps_mux_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_mux_bench.c
+ * @brief Measures gps_mux through pipes and checks what comes out.
+ *
+ * Three writer processes feed the multiplexer through pipes as fast as it
+ * reads:
+ *  - GP, the primary, seven sentences per epoch, without a fix for the
+ *    middle third of its -n epochs
+ *  - GN, the backup, the same sentences with a fix throughout
+ *  - HE, a compass forwarding only THS, which also sends GGA and PUBX
+ * A reader process drains the output, checks every line and counts them.
+ * The run fails when a line is damaged, when a line of the primary
+ * without a fix, a GGA of the compass or a PUBX gets through, or when a
+ * THS is missing.
+ *
+ * The timeout is a minute, so the backup counts as live however the
+ * processes are scheduled.
+ *
+ * @code
+ * gps_mux_bench -n 200000
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "gps_mux.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define SOURCES         3
+#define TIMEOUT_MS      60000
+#define LINE_BYTES      96
+#define READ_BYTES      65536
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+/* Counted by the reader */
+typedef struct
+{
+    uint64_t lines;
+    uint64_t bytes;
+    uint64_t damaged;
+    uint64_t talker[ SOURCES ];
+    uint64_t nofix;             /* Primary lines without a fix */
+    uint64_t foreign;           /* Compass GGA and PUBX */
+    uint64_t ths;
+} tally_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static const char *talkers[ SOURCES ] = { "GP", "GN", "HE" };
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* Appends $body*hh CR LF */
+static size_t sentence( char *out, const char *body )
+{
+    uint8_t sum = 0;
+    const char *p;
+
+    for( p = body; *p; p++ )
+        sum ^= ( uint8_t )*p;
+
+    return sprintf( out, "$%s*%02X\r\n", body, sum );
+}
+
+/* Text of a writer, epochs of one second */
+static char *generate( int source, long epochs, size_t *size )
+{
+    char *text = malloc( ( size_t )epochs * 7 * LINE_BYTES );
+    const char *tk = talkers[ source ];
+    size_t n = 0;
+    long e;
+
+    if( text == NULL )
+        return NULL;
+
+    for( e = 0; e < epochs; e++ )
+    {
+        char body[ LINE_BYTES ];
+        int fix = source != 0 || e < epochs / 3 || e >= 2 * epochs / 3;
+        int hh = ( int )( e / 3600 % 24 ), mm = ( int )( e / 60 % 60 ), ss = ( int )( e % 60 );
+
+        if( source == 2 )
+        {
+            sprintf( body, "HETHS,%d.%d,A", ( int )( e % 360 ), ( int )( e % 10 ) );
+            n += sentence( text + n, body );
+            sprintf( body, "HEGGA,%02d%02d%02d.00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,",
+                     hh, mm, ss );
+            n += sentence( text + n, body );
+            sprintf( body, "PUBX,00,%02d%02d%02d.00,4807.038,N", hh, mm, ss );
+            n += sentence( text + n, body );
+            continue;
+        }
+
+        sprintf( body, "%sRMC,%02d%02d%02d.00,%c,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W",
+                 tk, hh, mm, ss, fix ? 'A' : 'V' );
+        n += sentence( text + n, body );
+        sprintf( body, "%sGGA,%02d%02d%02d.00,4807.038,N,01131.000,E,%d,08,0.9,545.4,M,46.9,M,,",
+                 tk, hh, mm, ss, fix );
+        n += sentence( text + n, body );
+        sprintf( body, "%sGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1", tk );
+        n += sentence( text + n, body );
+        sprintf( body, "%sGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00", tk );
+        n += sentence( text + n, body );
+        sprintf( body, "%sGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,19,40,246,00", tk );
+        n += sentence( text + n, body );
+        sprintf( body, "%sGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,00,,,,", tk );
+        n += sentence( text + n, body );
+        sprintf( body, "%sVTG,054.7,T,034.4,M,005.5,N,010.2,K", tk );
+        n += sentence( text + n, body );
+    }
+
+    *size = n;
+    return text;
+}
+
+static int checksum_ok( const char *line, const char *end )
+{
+    uint8_t sum = 0;
+    const char *p;
+
+    if( end - line < 6 || line[ 0 ] != '$' || end[ -5 ] != '*' )
+        return 0;
+
+    for( p = line + 1; p < end - 5; p++ )
+        sum ^= ( uint8_t )*p;
+
+    return strtoul( end - 4, NULL, 16 ) == sum;
+}
+
+/* First character of field n, the formatter is field 0 */
+static char field( const char *line, const char *end, int n )
+{
+    while( n > 0 && line < end )
+        n -= *line++ == ',';
+
+    return line < end ? *line : '\0';
+}
+
+static void tally_line( tally_t *t, const char *line, const char *end )
+{
+    int s;
+
+    t->lines++;
+    t->bytes += end - line;
+
+    if( !checksum_ok( line, end ) )
+    {
+        t->damaged++;
+        return;
+    }
+
+    if( memcmp( line + 1, "PUBX", 4 ) == 0 )
+    {
+        t->foreign++;
+        return;
+    }
+
+    for( s = 0; s < SOURCES; s++ )
+    {
+        if( memcmp( line + 1, talkers[ s ], 2 ) == 0 )
+            t->talker[ s ]++;
+    }
+
+    if( memcmp( line + 1, "GPRMC", 5 ) == 0 && field( line, end, 2 ) == 'V' )
+        t->nofix++;
+
+    if( memcmp( line + 1, "GPGGA", 5 ) == 0 && field( line, end, 6 ) == '0' )
+        t->nofix++;
+
+    if( memcmp( line + 1, "HEGGA", 5 ) == 0 )
+        t->foreign++;
+
+    if( memcmp( line + 3, "THS", 3 ) == 0 )
+        t->ths++;
+}
+
+/* Drains the output and reports the tally through result */
+static void reader( int in, int result )
+{
+    static char buffer[ READ_BYTES + LINE_BYTES ];
+    tally_t t;
+    size_t fill = 0;
+    ssize_t n;
+
+    memset( &t, 0, sizeof( t ) );
+
+    while( ( n = read( in, buffer + fill, READ_BYTES ) ) > 0 )
+    {
+        char *p = buffer;
+        char *end = buffer + fill + n;
+        char *nl;
+
+        while( ( nl = memchr( p, '\n', end - p ) ) != NULL )
+        {
+            tally_line( &t, p, nl + 1 );
+            p = nl + 1;
+        }
+
+        fill = end - p;
+        memmove( buffer, p, fill );
+
+        if( fill > LINE_BYTES )
+            fill = 0;
+    }
+
+    if( write( result, &t, sizeof( t ) ) != sizeof( t ) )
+        _exit( 1 );
+
+    _exit( 0 );
+}
+
+static void writer( int out, const char *text, size_t size )
+{
+    while( size > 0 )
+    {
+        ssize_t n = write( out, text, size );
+
+        if( n < 0 && errno == EINTR )
+            continue;
+
+        if( n < 0 )
+            _exit( 1 );
+
+        text += n;
+        size -= n;
+    }
+
+    _exit( 0 );
+}
+
+int main( int argc, char **argv )
+{
+    static gps_mux_t mux;
+    long epochs = 100000;
+    char *text[ SOURCES ];
+    size_t size[ SOURCES ];
+    int out[ 2 ], result[ 2 ];
+    uint64_t lines = 0, forwarded = 0, start, ns;
+    tally_t t;
+    int opt, s, failed;
+
+    while( ( opt = getopt( argc, argv, "n:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'n':
+            epochs = strtol( optarg, NULL, 10 );
+            break;
+        default:
+            fprintf( stderr, "usage: %s [-n epochs]\n", argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( epochs < 3 )
+        epochs = 3;
+
+    for( s = 0; s < SOURCES; s++ )
+    {
+        text[ s ] = generate( s, epochs, &size[ s ] );
+
+        if( text[ s ] == NULL )
+        {
+            perror( "generate" );
+            return 1;
+        }
+    }
+
+    if( pipe( out ) || pipe( result ) )
+    {
+        perror( "pipe" );
+        return 1;
+    }
+
+    if( fork() == 0 )
+    {
+        close( out[ 1 ] );
+        close( result[ 0 ] );
+        reader( out[ 0 ], result[ 1 ] );
+    }
+
+    close( out[ 0 ] );
+    close( result[ 1 ] );
+    gps_mux_init( &mux, out[ 1 ], TIMEOUT_MS );
+    start = gps_clock_ns();
+
+    for( s = 0; s < SOURCES; s++ )
+    {
+        int in[ 2 ];
+
+        if( pipe( in ) )
+        {
+            perror( "pipe" );
+            return 1;
+        }
+
+        if( fork() == 0 )
+        {
+            close( in[ 0 ] );
+            close( out[ 1 ] );
+            writer( in[ 1 ], text[ s ], size[ s ] );
+        }
+
+        close( in[ 1 ] );
+        gps_mux_add( &mux, in[ 0 ], s,
+                     s == 2 ? GPS_MUX_TYPE( GPS_SENTENCE_THS ) : GPS_MUX_ALL );
+    }
+
+    if( gps_mux_run( &mux ) )
+    {
+        perror( "gps_mux_run" );
+        return 1;
+    }
+
+    close( out[ 1 ] );
+
+    if( read( result[ 0 ], &t, sizeof( t ) ) != sizeof( t ) )
+    {
+        fprintf( stderr, "reader failed\n" );
+        return 1;
+    }
+
+    ns = gps_clock_ns() - start;
+
+    while( wait( NULL ) > 0 )
+        ;
+
+    for( s = 0; s < SOURCES; s++ )
+    {
+        const gps_mux_stats_t *st = &mux.source[ s ].stats;
+
+        printf( "%s: %llu lines, %llu forwarded, %llu standby, %llu filtered, %llu invalid\n",
+                talkers[ s ], ( unsigned long long )st->lines,
+                ( unsigned long long )st->forwarded, ( unsigned long long )st->standby,
+                ( unsigned long long )st->filtered, ( unsigned long long )st->invalid );
+        lines += st->lines;
+        forwarded += st->forwarded;
+    }
+
+    printf( "%llu lines in %.3f s, %.0f sentences/s in, %.0f sentences/s out, %llu failovers\n",
+            ( unsigned long long )lines, ns / 1e9, lines * 1e9 / ns,
+            forwarded * 1e9 / ns, ( unsigned long long )mux.failovers );
+    printf( "output: %llu lines, %llu GP, %llu GN, %llu THS, %llu damaged, "
+            "%llu without fix, %llu filtered through\n",
+            ( unsigned long long )t.lines, ( unsigned long long )t.talker[ 0 ],
+            ( unsigned long long )t.talker[ 1 ], ( unsigned long long )t.ths,
+            ( unsigned long long )t.damaged, ( unsigned long long )t.nofix,
+            ( unsigned long long )t.foreign );
+
+    failed = t.lines != forwarded || t.damaged || t.nofix || t.foreign ||
+             t.ths != ( uint64_t )epochs;
+
+    for( s = 0; s < SOURCES; s++ )
+        free( text[ s ] );
+
+    printf( "%s\n", failed ? "FAILED" : "ok" );
+
+    return failed ? 1 : 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,268 @@
+/*******************************************************************************
+* Title                 :   NTP Reference Clock Benchmark
+* Filename              :   gps_ntp_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_ntp_bench.c
+ * @brief Checks the samples gps_ntp writes against a known arrival delay.
+ *
+ * A child process plays a receiver with a slow start: -n epochs at -r Hz,
+ * each sent -d ms after the UTC time it carries plus a random jitter of
+ * up to -j ms, through a pipe.  The parent reads them with gps_serial,
+ * writes a sample of each to a private SHM unit and takes it back the way
+ * chronyd does.  The first -c samples calibrate the offset, the rest are
+ * compensated with it.  Both the delay found and the offsets the reader
+ * would see after compensating are reported.  It fails unless the delay
+ * found is within the jitter of the one sent and the compensated offsets
+ * are around 0.
+ *
+ * @code
+ * gps_ntp_bench -d 40 -j 4 -r 10 -n 100
+ * gps_ntp_bench -d 300 -j 20 -r 1 -n 30 -c 10
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _DEFAULT_SOURCE             /* gmtime_r() and shmctl() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/shm.h>
+#include <sys/wait.h>
+#include "gps_parser.h"
+#include "gps_serial.h"
+#include "gps_ntp.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define LINE_BYTES      96
+#define TOLERANCE_NS    2000000     /* Wakeups on a loaded host */
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int64_t realtime_ns( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_REALTIME, &ts );
+    return ( int64_t )ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static void sleep_until( int64_t ns )
+{
+    struct timespec ts;
+
+    ts.tv_sec = ( time_t )( ns / 1000000000ll );
+    ts.tv_nsec = ( long )( ns % 1000000000ll );
+
+    while( clock_nanosleep( CLOCK_REALTIME, TIMER_ABSTIME, &ts, NULL ) == EINTR )
+        ;
+}
+
+static size_t sentence( char *out, const char *body )
+{
+    uint8_t sum = 0;
+    const char *p;
+
+    for( p = body; *p; p++ )
+        sum ^= ( uint8_t )*p;
+
+    return sprintf( out, "$%s*%02X\r\n", body, sum );
+}
+
+/* RMC, GGA and GSA of the UTC time in ns */
+static size_t epoch( char *text, int64_t utc )
+{
+    time_t seconds = ( time_t )( utc / 1000000000ll );
+    int cs = ( int )( utc % 1000000000ll / 10000000 );
+    char body[ LINE_BYTES ];
+    size_t n = 0;
+    struct tm tm;
+
+    gmtime_r( &seconds, &tm );
+    sprintf( body, "GPRMC,%02d%02d%02d.%02d,A,4807.038,N,01131.000,E,022.4,084.4,"
+             "%02d%02d%02d,003.1,W", tm.tm_hour, tm.tm_min, tm.tm_sec, cs,
+             tm.tm_mday, tm.tm_mon + 1, tm.tm_year % 100 );
+    n += sentence( text + n, body );
+    sprintf( body, "GPGGA,%02d%02d%02d.%02d,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,",
+             tm.tm_hour, tm.tm_min, tm.tm_sec, cs );
+    n += sentence( text + n, body );
+    n += sentence( text + n, "GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1" );
+
+    return n;
+}
+
+/* The receiver, epochs on the 1 / rate s grid of the system clock */
+static void receiver( int out, long epochs, long rate, int64_t delay, int64_t jitter )
+{
+    int64_t step = 1000000000ll / rate;
+    int64_t first = ( realtime_ns() / 1000000000ll + 1 ) * 1000000000ll;
+    char text[ 3 * LINE_BYTES ];
+    long e;
+
+    srand( 1 );
+
+    for( e = 0; e < epochs; e++ )
+    {
+        int64_t utc = first + e * step;
+        size_t size = epoch( text, utc );
+
+        sleep_until( utc + delay + ( jitter ? ( int64_t )( ( double )rand() / RAND_MAX * jitter ) : 0 ) );
+
+        if( write( out, text, size ) != ( ssize_t )size )
+            _exit( 1 );
+    }
+
+    _exit( 0 );
+}
+
+static int compare( const void *a, const void *b )
+{
+    int64_t x = *( const int64_t * )a, y = *( const int64_t * )b;
+
+    return x < y ? -1 : x > y;
+}
+
+int main( int argc, char **argv )
+{
+    static gps_serial_t port;
+    static int64_t offsets[ 10000 ];
+    long epochs = 50, rate = 10, calibrate = 20;
+    double delay_ms = 40, jitter_ms = 4;
+    int64_t delay, jitter, expected, found = 0;
+    uint64_t samples;
+    size_t count = 0;
+    uint32_t last = 0;
+    long unread = 0;
+    gps_ntp_t ntp, reader;
+    gps_ntp_sample_t sample;
+    gps_epoch_t ep;
+    int fds[ 2 ], opt, failed;
+    pid_t pid;
+
+    while( ( opt = getopt( argc, argv, "n:r:d:j:c:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'n':
+            epochs = strtol( optarg, NULL, 10 );
+            break;
+        case 'r':
+            rate = strtol( optarg, NULL, 10 );
+            break;
+        case 'd':
+            delay_ms = strtod( optarg, NULL );
+            break;
+        case 'j':
+            jitter_ms = strtod( optarg, NULL );
+            break;
+        case 'c':
+            calibrate = strtol( optarg, NULL, 10 );
+            break;
+        default:
+            fprintf( stderr, "usage: %s [-n epochs] [-r Hz] [-d delay_ms] [-j jitter_ms] "
+                     "[-c samples]\n", argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    delay = ( int64_t )( delay_ms * 1e6 );
+    jitter = ( int64_t )( jitter_ms * 1e6 );
+
+    if( rate < 1 || rate > 100 || calibrate < 1 || epochs <= calibrate ||
+        epochs > 10000 || delay < 0 || jitter < 0 || delay + jitter >= 1000000000ll / rate )
+    {
+        fprintf( stderr, "delay and jitter must fit in an epoch, -c below -n\n" );
+        return 2;
+    }
+
+    /* A unit of our own, not one a running chronyd reads */
+    if( gps_ntp_open( &ntp, 1000 + ( int )( getpid() % 100000 ) ) ||
+        gps_ntp_open( &reader, ntp.unit ) || pipe( fds ) )
+    {
+        perror( "gps_ntp_open" );
+        return 1;
+    }
+
+    pid = fork();
+
+    if( pid == 0 )
+    {
+        close( fds[ 0 ] );
+        receiver( fds[ 1 ], epochs, rate, delay, jitter );
+    }
+
+    close( fds[ 1 ] );
+
+    if( pid < 0 || gps_serial_setup( &port, fds[ 0 ], 0 ) )
+    {
+        perror( "receiver" );
+        return 1;
+    }
+
+    while( gps_serial_burst( &port, -1 ) > 0 )
+    {
+        gps_serial_put( &port );
+
+        if( gps_last_epoch( &ep ) == last )
+            continue;
+
+        last = ep.epoch;
+
+        if( gps_ntp_sample( &ntp, &ep, port.first ) )
+            continue;
+
+        if( !gps_ntp_read( &reader, &sample ) )
+        {
+            unread++;
+            continue;
+        }
+
+        if( ntp.samples == ( uint64_t )calibrate )
+        {
+            found = gps_ntp_delay( &ntp );
+            ntp.offset = found;
+        }
+        else if( ntp.samples > ( uint64_t )calibrate )
+            offsets[ count++ ] = sample.clock - sample.receive;
+    }
+
+    waitpid( pid, NULL, 0 );
+    samples = ntp.samples;
+    printf( "%llu samples, %llu rejected, %ld not read\n",
+            ( unsigned long long )samples, ( unsigned long long )ntp.rejected, unread );
+    shmctl( ntp.id, IPC_RMID, NULL );
+    gps_ntp_close( &reader );
+    gps_ntp_close( &ntp );
+
+    expected = delay + jitter / 2;
+    printf( "delay sent %.3f ms median, found %.3f ms after %ld samples\n",
+            expected / 1e6, found / 1e6, calibrate );
+
+    if( count == 0 )
+    {
+        printf( "FAILED\n" );
+        return 1;
+    }
+
+    qsort( offsets, count, sizeof( int64_t ), compare );
+    printf( "compensated offset min %.3f ms, p50 %.3f ms, max %.3f ms over %zu samples\n",
+            offsets[ 0 ] / 1e6, offsets[ count / 2 ] / 1e6, offsets[ count - 1 ] / 1e6, count );
+
+    failed = unread || samples != ( uint64_t )epochs ||
+             llabs( found - expected ) > jitter / 2 + TOLERANCE_NS ||
+             llabs( offsets[ count / 2 ] ) > jitter / 2 + TOLERANCE_NS;
+    printf( failed ? "FAILED\n" : "ok\n" );
+
+    return failed;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,316 @@
+/*******************************************************************************
+* Title                 :   Track Query Benchmark
+* Filename              :   gps_query_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_query_bench.c
+ * @brief Measures gps_query on a large synthetic store.
+ *
+ * A vehicle is driven around a one degree square at 10 Hz for -n fixes,
+ * with a short outage now and then, and written to a store.  -k keeps an
+ * existing store instead.  Then -q random queries of every kind are run:
+ *  - time, one minute of fixes
+ *  - box, a square of about a kilometre over the whole store
+ *  - box + time, the same square within one day
+ *  - at, the position at a time
+ * For comparison, one box query also tests every block without the index.
+ *
+ * @code
+ * gps_query_bench -n 1000000000 -o billion.gpst
+ * gps_query_bench -k -o billion.gpst -q 10000
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <unistd.h>
+#include "gps_query.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define BATCH_ROWS      ( 1 << 20 )
+#define START_TIME      1577836800000ll     /* 2020-01-01 */
+#define PERIOD_MS       100
+#define OUTAGE_EVERY    200000
+#define OUTAGE_ROWS     300
+#define ORIGIN_LAT      48.0
+#define ORIGIN_LON      11.0
+#define BOX_DEGREES     0.01
+#define DAY_MS          86400000ll
+#define PI              3.14159265358979323846
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    const char *name;
+    uint64_t ns;
+    gps_query_stats_t stats;
+} kind_t;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static double uniform( void )
+{
+    return rand() / ( RAND_MAX + 1.0 );
+}
+
+/* Random walk of the heading, bouncing off the edges of the square */
+static int generate( const char *path, uint64_t fixes )
+{
+    gps_store_writer_t writer;
+    gps_track_t batch;
+    double lat = ORIGIN_LAT + 0.5, lon = ORIGIN_LON + 0.5, heading = 0, alt = 500;
+    uint64_t row = 0;
+
+    memset( &batch, 0, sizeof( batch ) );
+
+    if( gps_track_reserve( &batch, BATCH_ROWS ) || gps_store_create( &writer, path ) )
+        return -1;
+
+    while( row < fixes )
+    {
+        size_t i;
+
+        batch.count = fixes - row < BATCH_ROWS ? ( size_t )( fixes - row ) : BATCH_ROWS;
+
+        for( i = 0; i < batch.count; i++, row++ )
+        {
+            double step = 15.0 * PERIOD_MS / 1000 / 111000;
+
+            heading += ( uniform() - 0.5 ) * 0.2;
+            lat += step * cos( heading );
+            lon += step * sin( heading ) / 0.67;
+            alt += uniform() - 0.5;
+
+            if( lat < ORIGIN_LAT || lat > ORIGIN_LAT + 1 ||
+                lon < ORIGIN_LON || lon > ORIGIN_LON + 1 )
+            {
+                heading += PI;
+                lat += 2 * step * cos( heading );
+                lon += 2 * step * sin( heading ) / 0.67;
+            }
+
+            batch.time[ i ] = START_TIME + ( int64_t )row * PERIOD_MS;
+            batch.latitude[ i ] = lat;
+            batch.longitude[ i ] = lon;
+            batch.altitude[ i ] = ( float )alt;
+            batch.speed[ i ] = 29.2f;
+            batch.track[ i ] = ( float )fmod( heading * 180 / PI + 720, 360 );
+            batch.hdop[ i ] = 0.9f;
+            batch.quality[ i ] = 1;
+            batch.satellites[ i ] = 9;
+            batch.fields[ i ] = GPS_EPOCH_TIME | GPS_EPOCH_DATE | GPS_EPOCH_POSITION |
+                                GPS_EPOCH_ALTITUDE | GPS_EPOCH_SPEED | GPS_EPOCH_TRACK |
+                                GPS_EPOCH_HDOP | GPS_EPOCH_QUALITY | GPS_EPOCH_SATS |
+                                GPS_EPOCH_STATUS;
+
+            if( row % OUTAGE_EVERY < OUTAGE_ROWS )
+            {
+                batch.quality[ i ] = 0;
+                batch.satellites[ i ] = 2;
+                batch.fields[ i ] &= ~( GPS_EPOCH_POSITION | GPS_EPOCH_ALTITUDE |
+                                        GPS_EPOCH_SPEED | GPS_EPOCH_TRACK );
+            }
+        }
+
+        if( gps_store_append( &writer, &batch ) )
+            break;
+    }
+
+    gps_track_free( &batch );
+
+    return gps_store_finish( &writer );
+}
+
+/* The box query without the index, counting matches only */
+static uint64_t scan_box( const gps_store_t *store, const gps_query_box_t *box )
+{
+    static int64_t lat[ GPS_STORE_BLOCK_ROWS ], lon[ GPS_STORE_BLOCK_ROWS ];
+    int64_t south = llround( box->south * GPS_STORE_DEGREES );
+    int64_t north = llround( box->north * GPS_STORE_DEGREES );
+    int64_t west = llround( box->west * GPS_STORE_DEGREES );
+    int64_t east = llround( box->east * GPS_STORE_DEGREES );
+    uint64_t count = 0;
+    size_t b, i;
+
+    for( b = 0; b < store->blocks; b++ )
+    {
+        const uint16_t *fields = gps_store_fields( store, b );
+
+        if( gps_store_stream( store, b, GPS_STORE_LATITUDE, lat ) ||
+            gps_store_stream( store, b, GPS_STORE_LONGITUDE, lon ) )
+            return count;
+
+        for( i = 0; i < store->index[ b ].rows; i++ )
+            count += lat[ i ] >= south && lat[ i ] <= north &&
+                     lon[ i ] >= west && lon[ i ] <= east &&
+                     ( fields[ i ] & GPS_EPOCH_POSITION );
+    }
+
+    return count;
+}
+
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-n fixes] [-q queries] [-k] [-o store.gpst]\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    const char *path = "query_bench.gpst";
+    kind_t kinds[ 4 ] = { { "time", 0, { 0 } }, { "box", 0, { 0 } },
+                          { "box+time", 0, { 0 } }, { "at", 0, { 0 } } };
+    uint64_t fixes = 1000000000ull, start, scanned;
+    long queries = 1000, q;
+    int keep = 0, opt, k;
+    gps_query_box_t box;
+    gps_query_fix_t fix;
+    gps_query_t query;
+    gps_store_t store;
+    gps_track_t out;
+    int64_t span;
+
+    while( ( opt = getopt( argc, argv, "n:q:ko:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'n':
+            fixes = strtoull( optarg, NULL, 10 );
+            break;
+        case 'q':
+            queries = strtol( optarg, NULL, 10 );
+            break;
+        case 'k':
+            keep = 1;
+            break;
+        case 'o':
+            path = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( fixes < 2 || queries < 1 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    if( !keep || access( path, R_OK ) )
+    {
+        start = gps_clock_ns();
+
+        if( generate( path, fixes ) )
+        {
+            fprintf( stderr, "%s: %s\n", path, strerror( errno ) );
+            return 1;
+        }
+
+        printf( "generated  %llu fixes in %.1f s\n", ( unsigned long long )fixes,
+                ( gps_clock_ns() - start ) / 1e9 );
+    }
+
+    if( gps_store_open( &store, path ) || gps_query_init( &query, &store ) )
+    {
+        fprintf( stderr, "%s: %s\n", path, strerror( errno ) );
+        return 1;
+    }
+
+    printf( "store      %llu fixes, %llu blocks, %.1f bytes per fix\n",
+            ( unsigned long long )store.header->rows, ( unsigned long long )store.blocks,
+            ( double )store.size / store.header->rows );
+
+    memset( &out, 0, sizeof( out ) );
+    span = store.header->max_time - store.header->min_time;
+    srand( 1 );
+
+    for( q = 0; q < queries; q++ )
+    {
+        int64_t t = store.header->min_time + ( int64_t )( uniform() * span );
+
+        for( k = 0; k < 4; k++ )
+        {
+            gps_query_stats_t before = query.stats;
+            int result;
+
+            if( k == 1 && gps_query_at( &query, t, 0, &fix ) == 0 )
+            {
+                box.south = fix.latitude - BOX_DEGREES / 2;
+                box.north = fix.latitude + BOX_DEGREES / 2;
+                box.west = fix.longitude - BOX_DEGREES / 2;
+                box.east = fix.longitude + BOX_DEGREES / 2;
+                before = query.stats;
+            }
+
+            out.count = 0;
+            start = gps_clock_ns();
+
+            switch( k )
+            {
+            case 0:
+                result = gps_query_time( &query, t, t + 60000, &out );
+                break;
+            case 1:
+                result = gps_query_box( &query, &box, INT64_MIN, INT64_MAX, &out );
+                break;
+            case 2:
+                result = gps_query_box( &query, &box, t - DAY_MS / 2, t + DAY_MS / 2, &out );
+                break;
+            default:
+                result = gps_query_at( &query, t, 10000, &fix ) && errno != ENOENT;
+                break;
+            }
+
+            kinds[ k ].ns += gps_clock_ns() - start;
+
+            if( result )
+            {
+                fprintf( stderr, "%s: %s\n", kinds[ k ].name, strerror( errno ) );
+                return 1;
+            }
+
+            kinds[ k ].stats.queries += query.stats.queries - before.queries;
+            kinds[ k ].stats.blocks += query.stats.blocks - before.blocks;
+            kinds[ k ].stats.rows += query.stats.rows - before.rows;
+        }
+    }
+
+    printf( "%-9s %10s %12s %14s %12s\n", "query", "count", "us/query", "blocks/query", "rows/query" );
+
+    for( k = 0; k < 4; k++ )
+    {
+        printf( "%-9s %10llu %12.1f %14.1f %12.1f\n", kinds[ k ].name,
+                ( unsigned long long )kinds[ k ].stats.queries,
+                kinds[ k ].ns / 1e3 / queries,
+                ( double )kinds[ k ].stats.blocks / queries,
+                ( double )kinds[ k ].stats.rows / queries );
+    }
+
+    start = gps_clock_ns();
+    scanned = scan_box( &store, &box );
+    printf( "box scan without index: %.1f ms, %llu rows\n", ( gps_clock_ns() - start ) / 1e6,
+            ( unsigned long long )scanned );
+
+    gps_track_free( &out );
+    gps_query_free( &query );
+    gps_store_close( &store );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
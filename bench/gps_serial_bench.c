@@ -0,0 +1,322 @@
+/*******************************************************************************
+* Title                 :   Serial Port Benchmark
+* Filename              :   gps_serial_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_serial_bench.c
+ * @brief Reads a simulated receiver through a pty with gps_serial.
+ *
+ * A child process plays the receiver on the master side of a pty.  It
+ * sends -n epochs of seven sentences at -r Hz, eight chars at a time at
+ * the pace of -b baud, as a UART with a small FIFO would hand them over.
+ * After every epoch it passes the time its last byte went out through a
+ * pipe.
+ *
+ * The parent reads the slave side with gps_serial_burst() and decodes
+ * every burst with gps_serial_put().  It reports the wakeups per epoch
+ * and the delay from the last byte to the epoch, and the bursts that were
+ * not exactly one epoch.  Those happen when the receiver process is held
+ * up for longer than the gap, and only delay the epoch.  It fails unless
+ * every epoch arrives whole, in order and with the position sent.
+ *
+ * -v reads the same stream the way applications often do, blocking in
+ * read() with VMIN 255 and VTIME 1, for comparison.  The delay is then
+ * counted to the read that completes the epoch.
+ *
+ * @code
+ * gps_serial_bench -b 9600 -r 1 -n 10
+ * gps_serial_bench -b 115200 -r 10 -n 100 -v
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _XOPEN_SOURCE 700           /* posix_openpt() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "gps_parser.h"
+#include "gps_serial.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define EPOCH_LINES     7
+#define LINE_BYTES      96
+#define CHUNK           8           /* Chars handed over at once */
+#define LATITUDE_MIN    7.038
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void sleep_until( uint64_t ns )
+{
+    struct timespec ts;
+
+    ts.tv_sec = ns / 1000000000ull;
+    ts.tv_nsec = ns % 1000000000ull;
+
+    while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL ) == EINTR )
+        ;
+}
+
+static size_t sentence( char *out, const char *body )
+{
+    uint8_t sum = 0;
+    const char *p;
+
+    for( p = body; *p; p++ )
+        sum ^= ( uint8_t )*p;
+
+    return sprintf( out, "$%s*%02X\r\n", body, sum );
+}
+
+/* Epoch e, its RMC and GGA carry e as the seconds of the time */
+static size_t epoch( char *text, long e )
+{
+    char body[ LINE_BYTES ];
+    size_t n = 0;
+    int h = ( int )( e / 3600 % 24 ), m = ( int )( e / 60 % 60 ), s = ( int )( e % 60 );
+
+    sprintf( body, "GPRMC,%02d%02d%02d.00,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W",
+             h, m, s );
+    n += sentence( text + n, body );
+    sprintf( body, "GPGGA,%02d%02d%02d.00,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,",
+             h, m, s );
+    n += sentence( text + n, body );
+    n += sentence( text + n, "GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1" );
+    n += sentence( text + n, "GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00" );
+    n += sentence( text + n, "GPGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,19,40,246,00" );
+    n += sentence( text + n, "GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,00,,,," );
+    n += sentence( text + n, "GPVTG,054.7,T,034.4,M,005.5,N,010.2,K" );
+
+    return n;
+}
+
+/* The receiver, on the master side */
+static void receiver( int master, int times, long epochs, long rate, long baud )
+{
+    uint64_t chunk_ns = CHUNK * 10 * 1000000000ull / baud;
+    uint64_t start = gps_clock_ns() + 100000000ull;
+    char text[ EPOCH_LINES * LINE_BYTES ];
+    long e;
+
+    for( e = 0; e < epochs; e++ )
+    {
+        uint64_t t = start + e * 1000000000ull / rate;
+        size_t size = epoch( text, e ), i;
+
+        for( i = 0; i < size; i += CHUNK )
+        {
+            sleep_until( t );
+
+            if( write( master, text + i, size - i < CHUNK ? size - i : CHUNK ) < 0 )
+                _exit( 1 );
+
+            t += chunk_ns;
+        }
+
+        t = gps_clock_ns();
+
+        if( write( times, &t, sizeof( t ) ) != sizeof( t ) )
+            _exit( 1 );
+    }
+
+    /* Let the reader drain before the pty hangs up */
+    sleep_until( gps_clock_ns() + 200000000ull );
+    _exit( 0 );
+}
+
+/* Bytes up to the end of the first epoch, 0 when it is not complete */
+static size_t epoch_end( const char *data, size_t size )
+{
+    size_t i;
+    int lines = 0;
+
+    for( i = 0; i < size; i++ )
+    {
+        if( data[ i ] == '\n' && ++lines == EPOCH_LINES )
+            return i + 1;
+    }
+
+    return 0;
+}
+
+/* Seconds of the first line, -1 unless it is an RMC */
+static long rmc_seconds( const char *line )
+{
+    if( strncmp( line, "$GPRMC,", 7 ) )
+        return -1;
+
+    return ( line[ 11 ] - '0' ) * 10 + ( line[ 12 ] - '0' );
+}
+
+int main( int argc, char **argv )
+{
+    static gps_serial_t port, held;
+    long epochs = 20, rate = 10, baud = 115200;
+    long read_epochs = 0, split = 0, wrong = 0, e = 0, wakeups = 0;
+    uint64_t sent, delay = 0, delay_max = 0;
+    int naive = 0, opt, master, slave, times[ 2 ], status;
+    pid_t child;
+
+    while( ( opt = getopt( argc, argv, "n:r:b:vh" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'n':
+            epochs = strtol( optarg, NULL, 10 );
+            break;
+        case 'r':
+            rate = strtol( optarg, NULL, 10 );
+            break;
+        case 'b':
+            baud = strtol( optarg, NULL, 10 );
+            break;
+        case 'v':
+            naive = 1;
+            break;
+        default:
+            fprintf( stderr, "usage: %s [-n epochs] [-r hz] [-b baud] [-v]\n", argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( epochs < 1 || rate < 1 || rate > 50 || baud < 4800 )
+        return 2;
+
+    /* A receiver that never pauses has no bursts */
+    if( epoch( port.buffer, 0 ) * 10 * rate > ( size_t )baud * 3 / 4 )
+    {
+        fprintf( stderr, "%ld baud can't carry %ld epochs a second\n", baud, rate );
+        return 2;
+    }
+
+    master = posix_openpt( O_RDWR | O_NOCTTY );
+
+    if( master < 0 || grantpt( master ) || unlockpt( master ) || pipe( times ) ||
+        ( slave = open( ptsname( master ), O_RDWR | O_NOCTTY ) ) < 0 ||
+        gps_serial_setup( &port, slave, baud ) )
+    {
+        perror( "pty" );
+        return 1;
+    }
+
+    if( naive )
+    {
+        struct termios tio;
+
+        tcgetattr( slave, &tio );
+        tio.c_cc[ VMIN ] = 255;
+        tio.c_cc[ VTIME ] = 1;
+        tcsetattr( slave, TCSANOW, &tio );
+    }
+
+    child = fork();
+
+    if( child == 0 )
+    {
+        close( slave );
+        close( times[ 0 ] );
+        receiver( master, times[ 1 ], epochs, rate, baud );
+    }
+
+    close( times[ 1 ] );
+
+    /* Epochs are gathered in held, a burst should be exactly one */
+    while( e < epochs )
+    {
+        size_t end;
+
+        if( naive )
+        {
+            ssize_t got = read( slave, held.buffer + held.fill,
+                                GPS_SERIAL_BUFFER - held.fill );
+
+            if( got <= 0 )
+                break;
+
+            held.fill += got;
+            wakeups++;
+        }
+        else
+        {
+            if( gps_serial_burst( &port, 2000 ) <= 0 ||
+                held.fill + port.size > GPS_SERIAL_BUFFER )
+                break;
+
+            if( held.fill || epoch_end( port.buffer, port.size ) != port.size )
+                split++;
+
+            memcpy( held.buffer + held.fill, port.buffer, port.size );
+            held.fill += port.size;
+        }
+
+        while( e < epochs && ( end = epoch_end( held.buffer, held.fill ) ) > 0 )
+        {
+            if( read( times[ 0 ], &sent, sizeof( sent ) ) != sizeof( sent ) )
+                break;
+
+            sent = gps_clock_ns() - sent;
+            delay += sent;
+
+            if( sent > delay_max )
+                delay_max = sent;
+
+            held.size = end;
+            gps_serial_put( &held );
+            read_epochs++;
+
+            if( rmc_seconds( held.buffer ) != e % 60 ||
+                gps_current_fix()->second != e % 60 ||
+                gps_current_lat()->minutes < LATITUDE_MIN - 1e-6 ||
+                gps_current_lat()->minutes > LATITUDE_MIN + 1e-6 )
+                wrong++;
+
+            e++;
+            memmove( held.buffer, held.buffer + end, held.fill - end );
+            held.fill -= end;
+        }
+    }
+
+    if( !naive )
+        wakeups = ( long )port.stats.reads;
+
+    waitpid( child, &status, 0 );
+
+    printf( "%ld epochs at %ld Hz, %ld baud, %s\n", epochs, rate, baud,
+            naive ? "VMIN 255 VTIME 1" : "gps_serial_burst" );
+    printf( "gap %d ms, low latency %s\n", port.gap, port.low_latency ? "on" : "off" );
+    printf( "%ld epochs read, %.1f reads each\n", read_epochs,
+            read_epochs ? ( double )wakeups / read_epochs : 0.0 );
+    printf( "last byte to epoch %.2f ms average, %.2f ms worst\n",
+            read_epochs ? delay / 1e6 / read_epochs : 0.0, delay_max / 1e6 );
+
+    if( !naive )
+        printf( "%llu bursts, %ld not one epoch\n",
+                ( unsigned long long )port.stats.bursts, split );
+
+    printf( "%ld wrong\n", wrong );
+
+    /* Bursts split by the scheduler only cost latency */
+    if( read_epochs != epochs || wrong )
+    {
+        printf( "FAILED\n" );
+        return 1;
+    }
+
+    printf( "ok\n" );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,300 @@
+/*******************************************************************************
+* Title                 :   Shared Memory Fan-out Benchmark
+* Filename              :   gps_shm_bench.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_shm_bench.c
+ * @brief Latency from gps_shm_publish() to reader processes.
+ *
+ * -k reader processes attach to a fresh ring and wait on it with
+ * gps_shm_wait().  The parent then publishes -n entries at -r Hz, each fix
+ * carrying its sequence in time, latitude and longitude so a torn copy
+ * would show.  Every reader takes the time from publication to its copy
+ * of each entry and sends mean, p50, p99 and max back through a pipe,
+ * with the entries it missed.  It fails unless every reader accounts for
+ * every entry, whole.
+ *
+ * -p makes the readers poll gps_shm_read() instead of sleeping, yielding
+ * the CPU between empty polls.
+ *
+ * @code
+ * gps_shm_bench -k 8 -n 2000 -r 1000
+ * gps_shm_bench -k 8 -p
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "gps_shm.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define READERS_MAX     64
+#define NAME_SIZE       32
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    uint64_t count;
+    uint64_t missed;
+    uint64_t torn;
+    uint64_t mean;              /**< ns */
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t max;
+} result_t;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void sleep_until( uint64_t ns )
+{
+    struct timespec ts;
+
+    ts.tv_sec = ns / 1000000000ull;
+    ts.tv_nsec = ns % 1000000000ull;
+
+    while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL ) == EINTR )
+        ;
+}
+
+static int compare( const void *a, const void *b )
+{
+    uint64_t x = *( const uint64_t * )a, y = *( const uint64_t * )b;
+
+    return x < y ? -1 : x > y;
+}
+
+/* Reads until entry last, then writes its result to fd */
+static int reader_main( const char *name, long entries, int poll_only, int ready, int fd )
+{
+    uint64_t *latency = malloc( entries * sizeof( uint64_t ) );
+    uint64_t total = 0, last;
+    gps_shm_entry_t entry;
+    result_t result;
+    gps_shm_t shm;
+    int got = 1;
+
+    memset( &result, 0, sizeof( result ) );
+
+    if( latency == NULL || gps_shm_attach( &shm, name ) )
+    {
+        perror( name );
+        return 1;
+    }
+
+    last = shm.ring->head + entries;
+
+    if( write( ready, "r", 1 ) != 1 )
+        return 1;
+
+    close( ready );
+
+    while( shm.next <= last && got >= 0 )
+    {
+        if( poll_only )
+        {
+            got = gps_shm_read( &shm, &entry );
+
+            if( got == 0 )
+            {
+                sched_yield();
+                continue;
+            }
+        }
+        else
+        {
+            got = gps_shm_wait( &shm, &entry, 1000 );
+
+            if( got == 0 )
+                break;
+        }
+
+        if( got > 0 )
+        {
+            uint64_t ns = gps_clock_ns() - entry.published;
+
+            if( entry.fix.time != ( int64_t )entry.sequence ||
+                entry.fix.latitude != ( double )entry.fix.time ||
+                entry.fix.longitude != -( double )entry.fix.time )
+                result.torn++;
+
+            latency[ result.count++ ] = ns;
+            total += ns;
+        }
+    }
+
+    result.missed = shm.missed;
+
+    if( result.count )
+    {
+        qsort( latency, result.count, sizeof( uint64_t ), compare );
+        result.mean = total / result.count;
+        result.p50 = latency[ result.count / 2 ];
+        result.p99 = latency[ result.count * 99 / 100 ];
+        result.max = latency[ result.count - 1 ];
+    }
+
+    gps_shm_detach( &shm );
+    free( latency );
+
+    return write( fd, &result, sizeof( result ) ) == sizeof( result ) ? 0 : 1;
+}
+
+int main( int argc, char **argv )
+{
+    static result_t results[ READERS_MAX ];
+    long readers = 4, entries = 1000, rate = 1000;
+    char name[ NAME_SIZE ];
+    uint64_t start, next, spent = 0;
+    int ready[ 2 ], done[ 2 ];
+    int poll_only = 0, failed = 0, opt;
+    gps_log_fix_t fix;
+    gps_shm_t shm;
+    long i;
+
+    while( ( opt = getopt( argc, argv, "k:n:r:ph" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'k':
+            readers = strtol( optarg, NULL, 10 );
+            break;
+        case 'n':
+            entries = strtol( optarg, NULL, 10 );
+            break;
+        case 'r':
+            rate = strtol( optarg, NULL, 10 );
+            break;
+        case 'p':
+            poll_only = 1;
+            break;
+        default:
+            fprintf( stderr, "usage: %s [-k readers] [-n entries] [-r Hz] [-p]\n", argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( readers < 1 || readers > READERS_MAX || entries < 1 || rate < 1 )
+        return 2;
+
+    snprintf( name, sizeof( name ), "/gps_shm_bench.%ld", ( long )getpid() );
+
+    if( gps_shm_create( &shm, name ) || pipe( ready ) || pipe( done ) )
+    {
+        perror( name );
+        return 1;
+    }
+
+    for( i = 0; i < readers; i++ )
+    {
+        pid_t pid = fork();
+
+        if( pid == 0 )
+        {
+            close( ready[ 0 ] );
+            close( done[ 0 ] );
+            _exit( reader_main( name, entries, poll_only, ready[ 1 ], done[ 1 ] ) );
+        }
+
+        if( pid < 0 )
+        {
+            perror( "fork" );
+            shm_unlink( name );
+            return 1;
+        }
+    }
+
+    close( ready[ 1 ] );
+    close( done[ 1 ] );
+
+    /* Every reader attached */
+    for( i = 0; i < readers; i++ )
+    {
+        char c;
+
+        if( read( ready[ 0 ], &c, 1 ) != 1 )
+        {
+            fprintf( stderr, "a reader failed to attach\n" );
+            shm_unlink( name );
+            return 1;
+        }
+    }
+
+    memset( &fix, 0, sizeof( fix ) );
+    fix.fields = GPS_EPOCH_TIME | GPS_EPOCH_POSITION;
+    start = next = gps_clock_ns();
+
+    for( i = 0; i < entries; i++ )
+    {
+        uint64_t before;
+
+        sleep_until( next );
+        next += 1000000000ull / rate;
+        fix.time = ( int64_t )shm.ring->head + 1;
+        fix.latitude = ( double )fix.time;
+        fix.longitude = -( double )fix.time;
+        before = gps_clock_ns();
+        gps_shm_publish( &shm, &fix, NULL, 0 );
+        spent += gps_clock_ns() - before;
+    }
+
+    printf( "%ld readers %s, %ld entries at %ld Hz in %.2f s, publish %.2f us\n",
+            readers, poll_only ? "polling" : "waiting", entries, rate,
+            ( gps_clock_ns() - start ) / 1e9, spent / 1e3 / entries );
+    printf( "%8s %8s %8s %10s %10s %10s %10s\n",
+            "reader", "entries", "missed", "mean us", "p50 us", "p99 us", "max us" );
+
+    for( i = 0; i < readers; i++ )
+    {
+        result_t *r = &results[ i ];
+
+        if( read( done[ 0 ], r, sizeof( result_t ) ) != sizeof( result_t ) )
+        {
+            fprintf( stderr, "reader %ld sent no result\n", i );
+            failed = 1;
+            continue;
+        }
+
+        printf( "%8ld %8llu %8llu %10.1f %10.1f %10.1f %10.1f\n", i,
+                ( unsigned long long )r->count, ( unsigned long long )r->missed,
+                r->mean / 1e3, r->p50 / 1e3, r->p99 / 1e3, r->max / 1e3 );
+
+        if( r->torn || r->count + r->missed != ( uint64_t )entries )
+            failed = 1;
+    }
+
+    while( wait( NULL ) > 0 )
+        ;
+
+    gps_shm_detach( &shm );
+    shm_unlink( name );
+
+    if( failed )
+    {
+        printf( "FAILED\n" );
+        return 1;
+    }
+
+    printf( "ok\n" );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
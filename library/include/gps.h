@@ -11,11 +11,11 @@ void gps_process( void );
 
 uint8_t gps_get_current_lon_degrees( void );
 double gps_get_current_lon_minutes( void );
-AZMUTH_t gps_get_current_lon_azmuth( void );
+azmuth_t gps_get_current_lon_azmuth( void );
 
 uint8_t gps_get_current_lat_degrees( void );
 double gps_get_current_lat_minutes( void );
-AZMUTH_t gps_get_current_lat_azmuth( void );
+azmuth_t gps_get_current_lat_azmuth( void );
 
 uint8_t gps_get_current_day( void );
 uint8_t gps_get_current_month( void );
@@ -0,0 +1,63 @@
+/****************************************************************************
+* Title                 :   Host Clock and Calendar
+* Filename              :   gps_clock.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_clock.h
+ * @brief Monotonic clock and civil date arithmetic of the host tools
+ *
+ * The tools and benchmarks time themselves, stamp arrivals and convert
+ * between dates and days since 1970 with these, rather than each keeping
+ * a copy.  It is built as gps_clock, apart from the parser library, since
+ * the clock needs POSIX.
+ *
+ * Dates are of the proleptic Gregorian calendar, after Howard Hinnant's
+ * algorithms.
+ *
+ * @code
+ * uint64_t start = gps_clock_ns();
+ * int64_t ms = gps_days_from_civil( 2026, 10, 19 ) * 86400000ll;
+ * @endcode
+ */
+#ifndef GPS_CLOCK_H_
+#define GPS_CLOCK_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief CLOCK_MONOTONIC in ns
+ */
+uint64_t gps_clock_ns( void );
+
+/**
+ * @brief Days since 1970-01-01 of a date
+ *
+ * @param month - 1 to 12
+ * @param day - 1 to 31
+ */
+int64_t gps_days_from_civil( int32_t year, int32_t month, int32_t day );
+
+/**
+ * @brief Date of days since 1970-01-01, negative before
+ */
+void gps_civil_from_days( int64_t days, int32_t *year, int32_t *month, int32_t *day );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_CLOCK_H_ */
+
+/*** End of File **************************************************************/
@@ -1,15 +1,52 @@
 #ifndef _GPS_CONFIG_H
 #define _GPS_CONFIG_H
 
-#define UBLOX_6
+/* Receiver profile, pick one here or on the compiler command line
+   ( e.g. -DQUECTEL_L80 ).  GENERIC only decodes the six common sentences.
+   CUSTOM defines nothing, list the sentences you use below it instead.
+   Sentences that aren't defined cost neither RAM nor ROM.
+*/
+//#define UBLOX_6
 //#define QUECTEL_L10
 //#define QUECTEL_L30
 //#define QUECTEL_L80
 //#define HORNET_NANO
+//#define GENERIC
+//#define CUSTOM
+
+#if !defined( UBLOX_6 ) && !defined( QUECTEL_L10 ) && !defined( QUECTEL_L30 ) && \
+    !defined( QUECTEL_L80 ) && !defined( HORNET_NANO ) && !defined( GENERIC ) && \
+    !defined( CUSTOM )
+#define UBLOX_6
+#endif
 
-/* Universal sentences automatically supported
+/* Sentences every profile except CUSTOM decodes
    GGA,RMC,GSA,GSV,GLL,VTG
 */
+#if !defined( CUSTOM )
+#define GGA
+#define GLL
+#define GSA
+#define GSV
+#define RMC
+#define VTG
+#endif
+
+/* Optional diagnostics, each costs RAM and a few cycles per char
+   GPS_STATS - parser health counters, see gps_stats_get()
+   GPS_TRACE - per stage cycle counts, see gps_trace.h
+   GPS_TIMESTAMPS - arrival and decode times, see gps_put_ts()
+   GPS_FOOTPRINT - static RAM report, see gps_footprint()
+*/
+//#define GPS_STATS
+//#define GPS_TRACE
+//#define GPS_TIMESTAMPS
+
+/* Sentence your receiver sends last in every epoch.  The epoch is then
+   published as soon as it is decoded instead of when the next fix time
+   arrives.
+*/
+//#define GPS_EPOCH_END GPS_SENTENCE_GLL
 
 #if defined( UBLOX_6 )
 #define DTM
@@ -36,7 +73,13 @@
 
 #if defined( HORNET_NANO )
 #define MSS
+#endif
 
+#if defined( CUSTOM )
+/* e.g. a position only build
+#define GGA
+#define RMC
+*/
 #endif
 
 #endif
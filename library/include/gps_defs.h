@@ -41,18 +41,43 @@
 /******************************************************************************
 * Preprocessor Constants
 *******************************************************************************/
-#define MAX_FIELDS 19
-#define MAX_FIELD_SIZE 10
-#define BUFFER_MAX 80
+
+
+/******************************************************************************
+* Configuration Constants
+*******************************************************************************/
+/* Capacities, each can be overridden on the compiler command line.  The
+   parser refuses to build when they can't hold the configured sentences.
+*/
+#ifndef MAX_FIELDS
+#define MAX_FIELDS 19           /**< Fields per sentence, GSV needs 19 */
+#endif
+
+#ifndef GPS_LONGEST_FIELD
+#define GPS_LONGEST_FIELD 11    /**< dddmm.mmmmm, use 10 for 4 decimal receivers */
+#endif
+
+#ifndef MAX_FIELD_SIZE
+#define MAX_FIELD_SIZE ( GPS_LONGEST_FIELD + 1 )
+#endif
+
+#ifndef BUFFER_MAX
+#define BUFFER_MAX 82           /**< NMEA maximum of 80 chars plus terminator */
+#endif
+
+#ifndef MAX_GSV_SENTENCES
+#define MAX_GSV_SENTENCES 3     /**< GSV messages kept, 4 satellites each */
+#endif
 
 #ifdef TXT
+#ifndef MAX_TXT_PACKAGES
 #define MAX_TXT_PACKAGES 3
+#endif
+#ifndef MAX_TXT_SIZE
 #define MAX_TXT_SIZE 20
-#define MAX_TXT_MESSAGE ( 3 * MAX_TXT_SIZE ) + 1
 #endif
-/******************************************************************************
-* Configuration Constants
-*******************************************************************************/
+#define MAX_TXT_MESSAGE ( MAX_TXT_PACKAGES * MAX_TXT_SIZE ) + 1
+#endif
 
 
 /******************************************************************************
@@ -99,7 +124,7 @@ typedef struct
     uint8_t hour;   /**< Hour in 24 hour */
     uint8_t minute; /**< Minutes */
     uint8_t second; /**< Seconds */
-    uint8_t ms;     /**< Miliseconds */
+    uint16_t ms;    /**< Miliseconds */
 } utc_time_t;
 
 /**
@@ -159,9 +184,6 @@ typedef enum
  */
 typedef struct
 {
-    utc_time_t *fix_time;  /**< Fix taken at 12:35:19 UTC */
-    location_t *lat;       /**< Latitude 48 deg 07.038' N */
-    location_t *lon;       /**< Longitude 11 deg 31.000' E */
     fix_t fix;             /**< Fix quality */
     uint8_t num_sats : 4;  /**< Number of satellites being tracked  */
     float horizontal;      /**< Horizontal dilution of position */
@@ -202,9 +224,6 @@ typedef enum
  */
 typedef struct
 {
-    location_t *lat;
-    location_t *lon;
-    utc_time_t *fix_time;/**< Fix taken at 22:54:44 UTC */
     ACTIVE_t active;    /**< Data Active or V (void) */
 } gll_t;
 
@@ -309,7 +328,7 @@ typedef struct
     {
         uint8_t sat_prn_num;   /**< Satellite PRN number */
         uint8_t elevation;     /**< Elevation in degrees */
-        uint8_t azimuth;       /**< Azimuth in degrees */
+        uint16_t azimuth;      /**< Azimuth in degrees */
         uint8_t snr;           /**< SNR ( Signal to noise ratio ) higher is better */
     } sat_info[4];
 } gsv_t;
@@ -349,14 +368,9 @@ typedef enum
  */
 typedef struct
 {
-    utc_time_t *fix_time; /**< Fix taken at 12:35:19 UTC */
-
     GPS_STATUS_t status; /**< Status A=active or V=Void. */
-    location_t *lat;
-    location_t *lon;
     double speed;       /**< Speed over the ground in knots */
     double track;       /**< Track angle in degrees True */
-    TimeStruct *date;   /**< Date - 23rd of March 1994 */
 
     struct
     {
@@ -475,7 +489,6 @@ typedef struct
  */
 typedef struct
 {
-    utc_time_t *fix_time;     /**< UTC Time */
     float lat_error;    /**< Error in latitude */
     float lon_error;    /**< Error in longitude */
     float alt_error;    /**< Error in altitude */
@@ -530,7 +543,6 @@ typedef struct
  */
 typedef struct
 {
-    utc_time_t *fix_time; /**< UTC Time */
     uint8_t mode;   /**< Mode of receiver */
     float range;    /**< Range residuals for SVs */
 } grs_t;
@@ -557,7 +569,6 @@ typedef struct
  */
 typedef struct
 {
-    utc_time_t *fix_time;     /**< 082356.00 - UTC Time, Time of associated position fix (hhmmss.sss) */
     float rms;          /**< 1.8 - RMS value of the standard deviation of the ranges */
     float std_dev_maj;
     float std_dev_min;
@@ -666,11 +677,143 @@ typedef struct
  */
 typedef struct
 {
-    TimeStruct *time;
     uint8_t local_hour;
     uint8_t local_min;
 } zda_t;
 
+#endif
+
+/**
+ * @enum Sentence types known to the parser
+ */
+typedef enum
+{
+    GPS_SENTENCE_UNKNOWN = 0,
+    GPS_SENTENCE_GGA,
+    GPS_SENTENCE_GLL,
+    GPS_SENTENCE_GSA,
+    GPS_SENTENCE_GSV,
+    GPS_SENTENCE_RMC,
+    GPS_SENTENCE_VTG,
+    GPS_SENTENCE_DTM,
+    GPS_SENTENCE_GBS,
+    GPS_SENTENCE_GPQ,
+    GPS_SENTENCE_GRS,
+    GPS_SENTENCE_GST,
+    GPS_SENTENCE_THS,
+    GPS_SENTENCE_TXT,
+    GPS_SENTENCE_ZDA,
+    GPS_SENTENCE_COUNT
+} gps_sentence_t;
+
+#ifdef GPS_STATS
+/**
+ * @struct Parser health counters
+ *
+ * Counts everything the parser receives, decodes, and throws away. Arrays
+ * are indexed by gps_sentence_t. Checksum failures and overwritten
+ * sentences whose type can't be recognised are counted under
+ * GPS_SENTENCE_UNKNOWN.
+ */
+typedef struct
+{
+    uint32_t sequence;      /**< Changes on every update */
+    uint32_t bytes;         /**< Bytes fed to gps_put */
+    uint32_t overflows;     /**< Lines longer than BUFFER_MAX, discarded */
+    uint32_t unknown;       /**< Valid sentences of a type not configured */
+    uint8_t max_length;     /**< Longest line seen, without CR LF */
+    uint32_t parsed[ GPS_SENTENCE_COUNT ];  /**< Decoded */
+    uint32_t failed[ GPS_SENTENCE_COUNT ];  /**< Failed checksum */
+    uint32_t dropped[ GPS_SENTENCE_COUNT ]; /**< Overwritten before gps_parse ran */
+} gps_stats_t;
+#endif
+
+#ifdef GPS_TIMESTAMPS
+/**
+ * @brief Arrival and decode time stamps
+ *
+ * The unit is whatever the application passes to gps_put_ts and returns
+ * from GPS_TIMESTAMP_NOW().  Define GPS_TIMESTAMP_TYPE to widen it.
+ */
+#if defined( GPS_TIMESTAMP_TYPE )
+typedef GPS_TIMESTAMP_TYPE gps_timestamp_t;
+#elif defined( __GNUC__ ) && !defined( __MIKROC_PRO_FOR_ARM__ )
+typedef uint64_t gps_timestamp_t;   /**< Host default, CLOCK_MONOTONIC ns */
+#else
+typedef uint32_t gps_timestamp_t;
+#endif
+
+/**
+ * @struct Time stamps of one sentence
+ */
+typedef struct
+{
+    gps_timestamp_t first_byte; /**< '$' received */
+    gps_timestamp_t last_byte;  /**< '\n' received */
+    gps_timestamp_t decoded;    /**< Sentence handler finished */
+} gps_sentence_times_t;
+#endif
+
+/**
+ * @enum Valid members of gps_epoch_t
+ */
+enum
+{
+    GPS_EPOCH_TIME     = 0x0001,
+    GPS_EPOCH_DATE     = 0x0002,
+    GPS_EPOCH_POSITION = 0x0004,
+    GPS_EPOCH_ALTITUDE = 0x0008,
+    GPS_EPOCH_SPEED    = 0x0010,
+    GPS_EPOCH_TRACK    = 0x0020,
+    GPS_EPOCH_HDOP     = 0x0040,
+    GPS_EPOCH_QUALITY  = 0x0080,
+    GPS_EPOCH_SATS     = 0x0100,
+    GPS_EPOCH_STATUS   = 0x0200
+};
+
+/**
+ * @struct One navigation epoch
+ *
+ * Everything the receiver reported for one UTC fix time, merged from all
+ * sentences carrying that time and the time-less sentences in between.
+ */
+typedef struct
+{
+    uint32_t epoch;         /**< Number of epochs published so far */
+    uint16_t fields;        /**< GPS_EPOCH_* bits of the valid members */
+    uint16_t sentences;     /**< Bit ( 1 << gps_sentence_t ) per sentence merged */
+    utc_time_t time;        /**< UTC fix time */
+    TimeStruct date;        /**< md, mo and yy valid */
+    double latitude;        /**< Decimal degrees, south negative */
+    double longitude;       /**< Decimal degrees, west negative */
+    double altitude;        /**< Meters above mean sea level */
+    double speed;           /**< Knots */
+    double track;           /**< Degrees true */
+    float hdop;             /**< Horizontal dilution of precision */
+    fix_t quality;          /**< GGA fix quality */
+    uint8_t num_sats;       /**< Satellites used */
+    GPS_STATUS_t status;    /**< RMC status */
+#ifdef GPS_TIMESTAMPS
+    gps_timestamp_t first_byte; /**< First byte of the first sentence */
+    gps_timestamp_t last_byte;  /**< Last byte of the last sentence */
+    gps_timestamp_t decoded;    /**< Epoch published */
+#endif
+} gps_epoch_t;
+
+#ifdef GPS_FOOTPRINT
+/**
+ * @struct Static RAM used by the parser, in bytes
+ */
+typedef struct
+{
+    uint16_t buffers;       /**< Receive and process line buffers */
+    uint16_t fields;        /**< Field tokens of the sentence being parsed */
+    uint16_t common;        /**< Position, time and epoch state */
+    uint16_t sentences;     /**< Decoded state of all configured sentences */
+    uint16_t diagnostics;   /**< GPS_STATS, GPS_TRACE and GPS_TIMESTAMPS */
+    uint16_t total;
+    uint16_t sentence[ GPS_SENTENCE_COUNT ]; /**< State per sentence type */
+} gps_footprint_t;
 #endif
 /******************************************************************************
 * Variables
@@ -0,0 +1,133 @@
+/****************************************************************************
+* Title                 :   NMEA Sentence Encoder
+* Filename              :   gps_encode.h
+* Origin Date           :   10/19/2026
+* Notes                 :   None
+*****************************************************************************/
+/**
+ * @file gps_encode.h
+ * @brief Formats the parser's sentence structures back into NMEA
+ *
+ * Every encoder writes one complete sentence, checksum and CR LF included,
+ * into a caller buffer of GPS_ENCODE_MAX bytes and terminates it.  Numbers
+ * are formatted with integer arithmetic only, no printf and no heap.  Each
+ * field is clamped to a fixed width, so no sentence is longer than the 82
+ * characters NMEA allows.
+ *
+ * Precision:
+ *  - time hhmmss.ss, latitude ddmm.mmmm, longitude dddmm.mmmm
+ *  - speed, track, altitude, geoid height, magnetic variation and the
+ *    HDOP of GGA 0.1
+ *  - DOP of GSA 0.01
+ *
+ * An encoded sentence with every optional field filled in decodes with
+ * gps_parse() to values that encode to the same bytes again.  The parser
+ * keeps the old value of a field that is empty.
+ *
+ * @code
+ * char line[ GPS_ENCODE_MAX ];
+ *
+ * n = gps_encode_gga( line, gps_current_fix(), gps_current_lat(),
+ *                     gps_current_lon(), &gga );
+ * UART1_Write_Text( line );
+ * @endcode
+ */
+#ifndef GPS_ENCODE_H_
+#define GPS_ENCODE_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include "time.h"
+#include "gps_defs.h"
+
+/******************************************************************************
+* Configuration Constants
+*******************************************************************************/
+#ifndef GPS_ENCODE_TALKER
+#define GPS_ENCODE_TALKER "GP"  /**< Talker ID of encoded sentences */
+#endif
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_ENCODE_MAX 83       /**< 82 characters and the terminator */
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief GGA, fix time, position and quality
+ *
+ * The DGPS fields are left empty when gga->station_id is 0, and a
+ * position when its azmuth is UNKNOWN, as in GGA without a fix.
+ *
+ * @return uint8_t - characters written, without the terminator
+ */
+uint8_t gps_encode_gga( char *buffer, const utc_time_t *time,
+                        const location_t *lat, const location_t *lon,
+                        const gga_t *gga );
+
+/**
+ * @brief RMC, minimum recommended data
+ *
+ * The magnetic variation is left empty when its direction is UNKNOWN and
+ * the mode when it is RMC_UKNOWN.
+ *
+ * @param date - md, mo and yy
+ *
+ * @return uint8_t - characters written, without the terminator
+ */
+uint8_t gps_encode_rmc( char *buffer, const utc_time_t *time,
+                        const TimeStruct *date, const location_t *lat,
+                        const location_t *lon, const rmc_t *rmc );
+
+/**
+ * @brief VTG, track and ground speed
+ *
+ * @return uint8_t - characters written, without the terminator
+ */
+uint8_t gps_encode_vtg( char *buffer, const vtg_t *vtg );
+
+/**
+ * @brief GSA, DOP and active satellites, PRN 0 is an empty slot
+ *
+ * @return uint8_t - characters written, without the terminator
+ */
+uint8_t gps_encode_gsa( char *buffer, const gsa_t *gsa );
+
+/**
+ * @brief GSV, one message of satellites in view
+ *
+ * Holds the satellites of gsv->sentence that num_sats leaves for it, up
+ * to four.
+ *
+ * @return uint8_t - characters written, without the terminator
+ */
+uint8_t gps_encode_gsv( char *buffer, const gsv_t *gsv );
+
+#ifdef ZDA
+/**
+ * @brief ZDA, UTC date and time and the local zone
+ *
+ * @param date - md, mo and yy
+ * @param zda - local_hour is read as a signed offset
+ *
+ * @return uint8_t - characters written, without the terminator
+ */
+uint8_t gps_encode_zda( char *buffer, const utc_time_t *time,
+                        const TimeStruct *date, const zda_t *zda );
+#endif
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_ENCODE_H_ */
+
+/*** End of File **************************************************************/
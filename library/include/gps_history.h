@@ -0,0 +1,154 @@
+/****************************************************************************
+* Title                 :   Fix History
+* Filename              :   gps_history.h
+* Origin Date           :   10/19/2026
+* Notes                 :   None
+*****************************************************************************/
+/**
+ * @file gps_history.h
+ * @brief The last GPS_HISTORY_SIZE fixes, looked up and interpolated by time
+ *
+ * Answers where the receiver was at a past instant, for geotagging camera
+ * frames or aligning sensor samples.  Each epoch is stored with a time of
+ * the application's monotonic clock, in GPS_HISTORY_TICKS per second, for
+ * example the tick of the sentence's last byte.  The times are kept apart
+ * from the fixes, so a lookup searches a compact array in O(log n).  All
+ * storage is inside gps_history_t, nothing is allocated.
+ *
+ * Between two fixes the position is interpolated linearly or along a
+ * cubic Hermite curve that follows the velocities both fixes reported,
+ * which keeps turns round at low epoch rates.  A fix without speed and
+ * track uses the straight line to the other fix as its tangent.  Altitude
+ * is always linear.
+ *
+ * @code
+ * gps_history_t history;
+ * gps_history_fix_t fix;
+ *
+ * gps_history_init( &history );
+ *
+ * if( gps_last_epoch( &epoch ) != last )
+ *     gps_history_push( &history, tick_ms(), &epoch );
+ *
+ * if( gps_history_at( &history, frame_ms, GPS_HISTORY_HERMITE, &fix ) == 0 )
+ *     tag_frame( fix.latitude, fix.longitude );
+ * @endcode
+ */
+#ifndef GPS_HISTORY_H_
+#define GPS_HISTORY_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include "time.h"
+#include "gps_defs.h"
+
+/******************************************************************************
+* Configuration Constants
+*******************************************************************************/
+#ifndef GPS_HISTORY_SIZE
+#define GPS_HISTORY_SIZE 64     /**< Fixes kept, a power of two */
+#endif
+
+#ifndef GPS_HISTORY_TICKS
+#define GPS_HISTORY_TICKS 1000  /**< Clock ticks per second */
+#endif
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @enum Interpolation between two fixes
+ */
+typedef enum
+{
+    GPS_HISTORY_LINEAR,
+    GPS_HISTORY_HERMITE
+} gps_history_mode_t;
+
+/**
+ * @struct Position and velocity of a fix
+ */
+typedef struct
+{
+    double latitude;        /**< Decimal degrees, south negative */
+    double longitude;       /**< Decimal degrees, west negative */
+    float altitude;         /**< Meters above mean sea level */
+    float north;            /**< Velocity north, m/s */
+    float east;             /**< Velocity east, m/s */
+    uint16_t fields;        /**< GPS_EPOCH_POSITION, ALTITUDE, and SPEED and
+                                 TRACK when the velocity is known */
+} gps_history_fix_t;
+
+/**
+ * @struct Ring of fixes
+ */
+typedef struct
+{
+    uint32_t count;         /**< Fixes pushed, the newest is ( count - 1 ) % size */
+    int64_t time[ GPS_HISTORY_SIZE ];
+    gps_history_fix_t fix[ GPS_HISTORY_SIZE ];
+} gps_history_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Empties a history
+ */
+void gps_history_init( gps_history_t *history );
+
+/**
+ * @brief Stores an epoch, over the oldest fix when full
+ *
+ * @param time - monotonic clock ticks, later than the newest fix
+ *
+ * @return int - 0, or -1 for an epoch without a position or a time not
+ * after the newest
+ */
+int gps_history_push( gps_history_t *history, int64_t time, const gps_epoch_t *epoch );
+
+/**
+ * @brief Number of fixes held, up to GPS_HISTORY_SIZE
+ */
+uint16_t gps_history_size( const gps_history_t *history );
+
+/**
+ * @brief A fix by age, 0 is the newest
+ *
+ * @return int - 0 or -1 when there is no such fix
+ */
+int gps_history_get( const gps_history_t *history, uint16_t age, int64_t *time,
+                     gps_history_fix_t *fix );
+
+/**
+ * @brief Age of the newest fix at or before time, by binary search
+ *
+ * @return int - age, 0 is the newest, or -1 when time is before the oldest
+ */
+int gps_history_find( const gps_history_t *history, int64_t time );
+
+/**
+ * @brief Position and velocity at a time between the oldest and newest fix
+ *
+ * fields has ALTITUDE, SPEED and TRACK when both fixes had them.  Without
+ * the velocities of both, north and east are those of the straight line
+ * between the fixes, or of the Hermite curve.
+ *
+ * @return int - 0 or -1 when time is outside the history
+ */
+int gps_history_at( const gps_history_t *history, int64_t time, gps_history_mode_t mode,
+                    gps_history_fix_t *fix );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_HISTORY_H_ */
+
+/*** End of File **************************************************************/
@@ -0,0 +1,99 @@
+/****************************************************************************
+* Title                 :   gpsd JSON Encoder
+* Filename              :   gps_json.h
+* Origin Date           :   10/19/2026
+* Notes                 :   None
+*****************************************************************************/
+/**
+ * @file gps_json.h
+ * @brief Formats epochs and satellites as gpsd TPV and SKY objects
+ *
+ * The objects are the ones gpsd sends to its watchers, each on a line of
+ * its own ended with CR LF, so dashboards and libraries that speak the
+ * gpsd protocol read them unchanged.  As in gps_encode, numbers are
+ * formatted with integer arithmetic, without printf and without the heap,
+ * and every value is clamped to a fixed width.  Nothing is written past
+ * size bytes: an object that doesn't fit isn't written at all.
+ *
+ * TPV carries what the epoch has: time with a date, position, altMSL,
+ * track and speed in m/s as gpsd reports it.  mode is 1 without a fix, 2
+ * without altitude and 3 with it.
+ *
+ * Precision:
+ *  - latitude and longitude 1e-9 degrees, as gpsd
+ *  - altitude, speed 0.001, track 0.0001, DOP 0.01
+ *
+ * @code
+ * char json[ GPS_JSON_MAX ];
+ *
+ * if( gps_last_epoch( &epoch ) != last )
+ *     send( fd, json, gps_json_tpv( json, sizeof( json ), "/dev/ttyS0", &epoch ), 0 );
+ * @endcode
+ */
+#ifndef GPS_JSON_H_
+#define GPS_JSON_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include "time.h"
+#include "gps_defs.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_JSON_MAX 1024       /**< TPV, or SKY of 12 satellites */
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief TPV, time, position and velocity of an epoch
+ *
+ * @param device - path of the receiver, NULL leaves it out
+ *
+ * @return uint16_t - characters written, without the terminator, 0 when
+ * the object didn't fit
+ */
+uint16_t gps_json_tpv( char *buffer, uint16_t size, const char *device,
+                       const gps_epoch_t *epoch );
+
+/**
+ * @brief SKY, the satellites in view and the ones used
+ *
+ * @param gsv - messages consecutive GSV messages, gps_gsv_message( 1 )
+ * points to all of them
+ * @param used - PRNs used for the fix as GSA lists them, 0 is an empty
+ * slot, NULL marks none as used
+ * @param epoch - gives time and hdop, may be NULL
+ *
+ * @return uint16_t - characters written, without the terminator, 0 when
+ * the object didn't fit
+ */
+uint16_t gps_json_sky( char *buffer, uint16_t size, const char *device,
+                       const gps_epoch_t *epoch, const gsv_t *gsv,
+                       uint8_t messages, const uint8_t *used, uint8_t used_count );
+
+/**
+ * @brief DEVICES, the answer to ?DEVICES and ?WATCH, with one NMEA0183
+ * receiver
+ *
+ * @param device - path of the receiver, escaped as JSON needs
+ *
+ * @return uint16_t - characters written, without the terminator, 0 when
+ * the object didn't fit
+ */
+uint16_t gps_json_devices( char *buffer, uint16_t size, const char *device );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_JSON_H_ */
+
+/*** End of File **************************************************************/
@@ -55,6 +55,7 @@
 #include <stdint.h>
 #include "time.h"
 #include "gps_defs.h"
+#include "gps_trace.h"
 
 /******************************************************************************
 * Preprocessor Constants
@@ -114,6 +115,36 @@ extern "C" {
  */
 void gps_put( char input );
 
+#ifdef GPS_TIMESTAMPS
+/**
+ * @brief gps_put with the arrival time of the char
+ *
+ * The time of the first byte and of the closing '\n' are kept with each
+ * sentence and with the epoch it belongs to, see gps_sentence_times and
+ * gps_last_epoch.  Don't mix with plain gps_put calls.
+ *
+ * @code
+ * gps_put_ts( UART3_DR, DWT_CYCCNT );
+ * @endcode
+ *
+ * @param input - individual char from GPS feed
+ * @param ts - time the char arrived
+ */
+void gps_put_ts( char input, gps_timestamp_t ts );
+
+/**
+ * @brief gps_put_ts for a DMA or FIFO block
+ *
+ * Every char of the block is stamped with ts, normally the time the
+ * transfer or idle line interrupt fired.
+ *
+ * @param data - chars from the GPS feed
+ * @param len - number of chars
+ * @param ts - time the block arrived
+ */
+void gps_put_block_ts( const char *data, uint16_t len, gps_timestamp_t ts );
+#endif
+
 /**
  * @brief gps_parse
  *
@@ -122,6 +153,75 @@ void gps_put( char input );
  */
 void gps_parse();
 
+/**
+ * @brief Name of a sentence type
+ *
+ * @param type - sentence type
+ *
+ * @return const char * - three letter identifier, e.g. "GGA"
+ */
+const char *gps_sentence_name( gps_sentence_t type );
+
+/**
+ * @brief Last complete navigation epoch
+ *
+ * An epoch is published when a sentence with a different fix time is
+ * decoded, or right after the GPS_EPOCH_END sentence if one is configured.
+ *
+ * @param epoch - destination, may be NULL to only poll the counter
+ *
+ * @return uint32_t - epochs published so far, 0 if none yet
+ */
+uint32_t gps_last_epoch( gps_epoch_t *epoch );
+
+/**
+ * @brief Publishes the open epoch now
+ *
+ * For hosts that know the epoch is over, when the line went idle after
+ * the receiver's burst for example, instead of waiting for the next fix
+ * time.  An epoch split by an early flush is published as two.
+ */
+void gps_epoch_flush( void );
+
+#ifdef GPS_TIMESTAMPS
+/**
+ * @brief Time stamps of the last sentence of a type
+ *
+ * @param type - sentence type
+ * @param times - destination
+ */
+void gps_sentence_times( gps_sentence_t type, gps_sentence_times_t *times );
+#endif
+
+#ifdef GPS_FOOTPRINT
+/**
+ * @brief Static RAM taken by the parser in this configuration
+ *
+ * Built per receiver profile by the footprint report, see
+ * tools/gps_footprint.c.
+ *
+ * @param fp - destination
+ */
+void gps_footprint( gps_footprint_t *fp );
+#endif
+
+#ifdef GPS_STATS
+/**
+ * @brief Consistent copy of the parser health counters
+ *
+ * Safe to call while gps_put is running from an interrupt.  The copy is
+ * retried until no update happened during it.
+ *
+ * @param stats - destination
+ */
+void gps_stats_get( gps_stats_t *stats );
+
+/**
+ * @brief Clears all parser health counters
+ */
+void gps_stats_reset( void );
+#endif
+
 /***************** Common ***************/
 /**
  * @brief Current longitude
@@ -153,6 +253,7 @@ TimeStruct* gps_current_time( void );
 utc_time_t* gps_current_fix( void );
 
 /****************** GGA ******************/
+#ifdef GGA
 /**
  * @brief GGA sentence with quality of fix from
  * most recent fix
@@ -218,8 +319,10 @@ uint16_t gps_gga_lastDGPS_update( void );
  * @return uint16_t
  */
 uint16_t gps_gga_DGPS_stationID( void );
+#endif
 
 /***************** GLL ******************/
+#ifdef GLL
 /**
  * @brief GLL sentence state of Loran
  *
@@ -229,8 +332,10 @@ uint16_t gps_gga_DGPS_stationID( void );
  * @retval LORAN_VOID = 2
  */
 ACTIVE_t gps_gll_active( void );
+#endif
 
 /***************** GSA ******************/
+#ifdef GSA
 /**
  * @brief GSA sentence mode of sat
  *
@@ -288,10 +393,22 @@ float gps_gsa_horizontal_dilution( void );
  * @return float
  */
 float gps_gsa_vertical_dilution( void );
+#endif
 
 /***************** GSV *****************/
-// TODO: Must combine sat info and clear
+#ifdef GSV
+/**
+ * @brief GSV message of the last satellites in view
+ *
+ * @param number - 1 to MAX_GSV_SENTENCES
+ *
+ * @return gsv_t * - 0 when number is out of range
+ */
+gsv_t *gps_gsv_message( uint8_t number );
+#endif
+
 /***************** RMC *****************/
+#ifdef RMC
 /**
  * @brief RMC sentence status of sat
  *
@@ -350,8 +467,10 @@ azmuth_t gps_rmc_direction( void );
  * @retval RMC_NOT_VALID = 5
  */
 GPS_STATUS_t gps_rmc_mode( void );
+#endif
 
 /**************** VTG *****************/
+#ifdef VTG
 /**
  * @brief VTG sentence track
  *
@@ -379,6 +498,7 @@ double gps_vtg_speedknt( void );
  * @return double
  */
 double gps_vtg_speedkm( void );
+#endif
 
 #ifdef DTM
 /**
@@ -0,0 +1,805 @@
+/****************************************************************************
+* Title                 :   GPS Parser C++ Interface
+* Filename              :   gps_parser.hpp
+* Origin Date           :   10/19/2026
+* Notes                 :   Header only, C++17
+*****************************************************************************/
+/**
+ * @file gps_parser.hpp
+ * @brief Header only C++ parser with per instance state
+ *
+ * The C core keeps its state in file scope variables, so a process can run
+ * one of it.  gps::Parser holds everything it needs in the object, decodes
+ * only the sentence types it is instantiated with and never allocates.
+ *
+ * @code
+ * gps::Parser< gps::Gga, gps::Rmc > parser;
+ *
+ * for( const auto &sentence : parser.feed( { block, length } ) )
+ * {
+ *     if( auto gga = std::get_if< gps::Gga >( &sentence ) )
+ *         use( gga->latitude, gga->longitude );
+ * }
+ * @endcode
+ *
+ * Lines are validated and split in place; the field views point into the
+ * caller's block, or into the parser when a line spans two blocks.  Any
+ * talker ID is accepted.  Empty numeric fields decode as 0.
+ */
+#ifndef GPS_PARSER_HPP_
+#define GPS_PARSER_HPP_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <tuple>
+#include <variant>
+#include "gps_defs.h"
+
+namespace gps
+{
+
+/******************************************************************************
+* Configuration Constants
+*******************************************************************************/
+inline constexpr std::size_t max_fields = 24; /**< Address plus data fields */
+inline constexpr std::size_t max_line = 128;  /**< Longest line kept across blocks */
+
+/******************************************************************************
+* Helpers
+*******************************************************************************/
+namespace detail
+{
+
+constexpr int hex( char c )
+{
+    return ( c >= '0' && c <= '9' ) ? c - '0' :
+           ( c >= 'A' && c <= 'F' ) ? c - 'A' + 10 :
+           ( c >= 'a' && c <= 'f' ) ? c - 'a' + 10 : -1;
+}
+
+/* Leading digits only, stops at the first other character */
+constexpr uint32_t to_uint( std::string_view s )
+{
+    uint32_t value = 0;
+
+    for( char c : s )
+    {
+        if( c < '0' || c > '9' )
+            break;
+
+        value = value * 10 + ( uint32_t )( c - '0' );
+    }
+
+    return value;
+}
+
+constexpr double to_double( std::string_view s )
+{
+    constexpr double scale[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+                                 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+    uint64_t mantissa = 0;
+    std::size_t i = 0, decimals = 0;
+    bool negative = false, fraction = false;
+
+    if( !s.empty() && ( s[ 0 ] == '-' || s[ 0 ] == '+' ) )
+        negative = s[ i++ ] == '-';
+
+    for( ; i < s.size(); i++ )
+    {
+        if( s[ i ] == '.' && !fraction )
+        {
+            fraction = true;
+        }
+        else if( s[ i ] >= '0' && s[ i ] <= '9' && decimals < 15 )
+        {
+            mantissa = mantissa * 10 + ( uint64_t )( s[ i ] - '0' );
+            decimals += fraction;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return ( negative ? -1.0 : 1.0 ) * ( double )mantissa / scale[ decimals ];
+}
+
+/* Packs a three letter sentence formatter for table lookup */
+constexpr uint32_t key( std::string_view formatter )
+{
+    return formatter.size() < 3 ? 0 :
+           ( uint32_t )( uint8_t )formatter[ 0 ] << 16 |
+           ( uint32_t )( uint8_t )formatter[ 1 ] << 8 |
+           ( uint32_t )( uint8_t )formatter[ 2 ];
+}
+
+} // namespace detail
+
+/******************************************************************************
+* Framing
+*******************************************************************************/
+/**
+ * @brief Checks framing and checksum of one line
+ *
+ * @param line - "$...*hh", optionally followed by CR and / or LF
+ *
+ * @return std::string_view - text between '$' and '*', empty when invalid
+ */
+constexpr std::string_view validate( std::string_view line )
+{
+    uint8_t sum = 0;
+    int high = 0, low = 0;
+
+    while( !line.empty() && ( line.back() == '\n' || line.back() == '\r' ) )
+        line.remove_suffix( 1 );
+
+    if( line.size() < 4 || line[ 0 ] != '$' || line[ line.size() - 3 ] != '*' )
+        return {};
+
+    high = detail::hex( line[ line.size() - 2 ] );
+    low = detail::hex( line[ line.size() - 1 ] );
+    line = line.substr( 1, line.size() - 4 );
+
+    for( char c : line )
+        sum ^= ( uint8_t )c;
+
+    if( high < 0 || low < 0 || sum != ( high << 4 | low ) )
+        return {};
+
+    return line;
+}
+
+/**
+ * @brief Fields of a validated sentence
+ *
+ * Index 0 is the address ( e.g. "GPGGA" ), data fields follow from 1 as in
+ * the NMEA tables.  Indexing past the last field gives an empty view.
+ */
+class Fields
+{
+public:
+    using const_iterator = const std::string_view *;
+
+    constexpr Fields() = default;
+
+    /**
+     * @param body - output of validate()
+     */
+    constexpr explicit Fields( std::string_view body )
+    {
+        std::size_t start = 0;
+
+        if( body.empty() )
+            return;
+
+        for( ;; )
+        {
+            std::size_t comma = body.find( ',', start );
+
+            if( count_ == max_fields )
+            {
+                truncated_ = true;
+                break;
+            }
+
+            if( comma == std::string_view::npos )
+            {
+                fields_[ count_++ ] = body.substr( start );
+                break;
+            }
+
+            fields_[ count_++ ] = body.substr( start, comma - start );
+            start = comma + 1;
+        }
+    }
+
+    constexpr std::size_t size() const { return count_; }
+    constexpr bool empty() const { return count_ == 0; }
+    /** More than max_fields fields, the rest were dropped */
+    constexpr bool truncated() const { return truncated_; }
+
+    constexpr std::string_view operator[]( std::size_t i ) const
+    {
+        return i < count_ ? fields_[ i ] : std::string_view();
+    }
+
+    constexpr const_iterator begin() const { return fields_.data(); }
+    constexpr const_iterator end() const { return fields_.data() + count_; }
+
+    constexpr std::string_view address() const { return ( *this )[ 0 ]; }
+
+    /** Two letter talker ID, empty for proprietary sentences */
+    constexpr std::string_view talker() const
+    {
+        std::string_view a = address();
+
+        return ( a.size() == 5 && a[ 0 ] != 'P' ) ? a.substr( 0, 2 ) : std::string_view();
+    }
+
+    /** Three letter sentence formatter, e.g. "GGA" */
+    constexpr std::string_view formatter() const
+    {
+        std::string_view a = address();
+
+        return ( a.size() == 5 && a[ 0 ] != 'P' ) ? a.substr( 2 ) : std::string_view();
+    }
+
+private:
+    std::array< std::string_view, max_fields > fields_{};
+    std::size_t count_ = 0;
+    bool truncated_ = false;
+};
+
+/******************************************************************************
+* Decoded Values
+*******************************************************************************/
+struct Time
+{
+    uint8_t hour = 0;
+    uint8_t minute = 0;
+    uint8_t second = 0;
+    uint16_t ms = 0;
+
+    /** hhmmss[.sss] */
+    static constexpr Time decode( std::string_view s )
+    {
+        Time t;
+        std::size_t dot = s.find( '.' );
+
+        if( s.size() < 6 )
+            return t;
+
+        t.hour = ( uint8_t )detail::to_uint( s.substr( 0, 2 ) );
+        t.minute = ( uint8_t )detail::to_uint( s.substr( 2, 2 ) );
+        t.second = ( uint8_t )detail::to_uint( s.substr( 4, 2 ) );
+
+        if( dot != std::string_view::npos )
+            t.ms = ( uint16_t )( detail::to_double( s.substr( dot ) ) * 1000.0 + 0.5 );
+
+        return t;
+    }
+};
+
+struct Date
+{
+    uint8_t day = 0;
+    uint8_t month = 0;
+    uint16_t year = 0;
+
+    /** ddmmyy */
+    static constexpr Date decode( std::string_view s )
+    {
+        Date d;
+
+        if( s.size() < 6 )
+            return d;
+
+        d.day = ( uint8_t )detail::to_uint( s.substr( 0, 2 ) );
+        d.month = ( uint8_t )detail::to_uint( s.substr( 2, 2 ) );
+        d.year = ( uint16_t )( 2000 + detail::to_uint( s.substr( 4, 2 ) ) );
+
+        return d;
+    }
+};
+
+/**
+ * @brief Signed decimal degrees from ( d )ddmm.mmmm and a hemisphere
+ */
+constexpr double degrees( std::string_view value, std::string_view hemisphere )
+{
+    std::size_t dot = value.find( '.' );
+    double result = 0.0;
+
+    if( dot == std::string_view::npos )
+        dot = value.size();
+
+    if( dot < 2 )
+        return 0.0;
+
+    result = detail::to_uint( value.substr( 0, dot - 2 ) ) +
+             detail::to_double( value.substr( dot - 2 ) ) / 60.0;
+
+    return ( hemisphere == "S" || hemisphere == "W" ) ? -result : result;
+}
+
+/******************************************************************************
+* Sentences
+*******************************************************************************/
+/**
+ * Every sentence type has its gps_sentence_t id, its formatter and a
+ * decode() from Fields.  Parser can be instantiated with any set of them.
+ */
+struct Gga
+{
+    static constexpr gps_sentence_t id = GPS_SENTENCE_GGA;
+    static constexpr std::string_view formatter = "GGA";
+
+    Time time;
+    double latitude = 0;
+    double longitude = 0;
+    uint8_t quality = 0;        /**< 0 = no fix */
+    uint8_t satellites = 0;
+    float hdop = 0;
+    float altitude = 0;         /**< Above mean sea level, m */
+    float separation = 0;       /**< Geoid separation, m */
+
+    static constexpr Gga decode( const Fields &f )
+    {
+        Gga s;
+
+        s.time = Time::decode( f[ 1 ] );
+        s.latitude = degrees( f[ 2 ], f[ 3 ] );
+        s.longitude = degrees( f[ 4 ], f[ 5 ] );
+        s.quality = ( uint8_t )detail::to_uint( f[ 6 ] );
+        s.satellites = ( uint8_t )detail::to_uint( f[ 7 ] );
+        s.hdop = ( float )detail::to_double( f[ 8 ] );
+        s.altitude = ( float )detail::to_double( f[ 9 ] );
+        s.separation = ( float )detail::to_double( f[ 11 ] );
+
+        return s;
+    }
+};
+
+struct Gll
+{
+    static constexpr gps_sentence_t id = GPS_SENTENCE_GLL;
+    static constexpr std::string_view formatter = "GLL";
+
+    double latitude = 0;
+    double longitude = 0;
+    Time time;
+    bool valid = false;         /**< Status 'A' */
+
+    static constexpr Gll decode( const Fields &f )
+    {
+        Gll s;
+
+        s.latitude = degrees( f[ 1 ], f[ 2 ] );
+        s.longitude = degrees( f[ 3 ], f[ 4 ] );
+        s.time = Time::decode( f[ 5 ] );
+        s.valid = f[ 6 ] == "A";
+
+        return s;
+    }
+};
+
+struct Gsa
+{
+    static constexpr gps_sentence_t id = GPS_SENTENCE_GSA;
+    static constexpr std::string_view formatter = "GSA";
+
+    char mode = 0;              /**< 'M'anual or 'A'utomatic */
+    uint8_t fix = 0;            /**< 1 none, 2 2D, 3 3D */
+    uint8_t count = 0;          /**< Used entries of prn */
+    std::array< uint8_t, 12 > prn{};
+    float pdop = 0;
+    float hdop = 0;
+    float vdop = 0;
+
+    static constexpr Gsa decode( const Fields &f )
+    {
+        Gsa s;
+
+        s.mode = f[ 1 ].empty() ? 0 : f[ 1 ][ 0 ];
+        s.fix = ( uint8_t )detail::to_uint( f[ 2 ] );
+
+        for( std::size_t i = 3; i < 15; i++ )
+        {
+            if( !f[ i ].empty() )
+                s.prn[ s.count++ ] = ( uint8_t )detail::to_uint( f[ i ] );
+        }
+
+        s.pdop = ( float )detail::to_double( f[ 15 ] );
+        s.hdop = ( float )detail::to_double( f[ 16 ] );
+        s.vdop = ( float )detail::to_double( f[ 17 ] );
+
+        return s;
+    }
+};
+
+struct Satellite
+{
+    uint8_t prn = 0;
+    uint8_t elevation = 0;      /**< Degrees */
+    uint16_t azimuth = 0;       /**< Degrees true */
+    uint8_t snr = 0;            /**< dB-Hz, 0 when not tracked */
+};
+
+struct Gsv
+{
+    static constexpr gps_sentence_t id = GPS_SENTENCE_GSV;
+    static constexpr std::string_view formatter = "GSV";
+
+    uint8_t sentences = 0;      /**< Sentences in this cycle */
+    uint8_t index = 0;          /**< This one, from 1 */
+    uint8_t in_view = 0;
+    uint8_t count = 0;          /**< Used entries of satellites */
+    std::array< Satellite, 4 > satellites{};
+
+    static constexpr Gsv decode( const Fields &f )
+    {
+        Gsv s;
+
+        s.sentences = ( uint8_t )detail::to_uint( f[ 1 ] );
+        s.index = ( uint8_t )detail::to_uint( f[ 2 ] );
+        s.in_view = ( uint8_t )detail::to_uint( f[ 3 ] );
+
+        for( std::size_t i = 4; i < f.size() && s.count < 4; i += 4 )
+        {
+            Satellite &sat = s.satellites[ s.count ];
+
+            if( f[ i ].empty() )
+                break;
+
+            sat.prn = ( uint8_t )detail::to_uint( f[ i ] );
+            sat.elevation = ( uint8_t )detail::to_uint( f[ i + 1 ] );
+            sat.azimuth = ( uint16_t )detail::to_uint( f[ i + 2 ] );
+            sat.snr = ( uint8_t )detail::to_uint( f[ i + 3 ] );
+            s.count++;
+        }
+
+        return s;
+    }
+};
+
+struct Rmc
+{
+    static constexpr gps_sentence_t id = GPS_SENTENCE_RMC;
+    static constexpr std::string_view formatter = "RMC";
+
+    Time time;
+    bool valid = false;         /**< Status 'A' */
+    double latitude = 0;
+    double longitude = 0;
+    float speed = 0;            /**< Knots */
+    float track = 0;            /**< Degrees true */
+    Date date;
+
+    static constexpr Rmc decode( const Fields &f )
+    {
+        Rmc s;
+
+        s.time = Time::decode( f[ 1 ] );
+        s.valid = f[ 2 ] == "A";
+        s.latitude = degrees( f[ 3 ], f[ 4 ] );
+        s.longitude = degrees( f[ 5 ], f[ 6 ] );
+        s.speed = ( float )detail::to_double( f[ 7 ] );
+        s.track = ( float )detail::to_double( f[ 8 ] );
+        s.date = Date::decode( f[ 9 ] );
+
+        return s;
+    }
+};
+
+struct Vtg
+{
+    static constexpr gps_sentence_t id = GPS_SENTENCE_VTG;
+    static constexpr std::string_view formatter = "VTG";
+
+    float track = 0;            /**< Degrees true */
+    float track_magnetic = 0;
+    float knots = 0;
+    float kmh = 0;
+
+    static constexpr Vtg decode( const Fields &f )
+    {
+        Vtg s;
+
+        s.track = ( float )detail::to_double( f[ 1 ] );
+        s.track_magnetic = ( float )detail::to_double( f[ 3 ] );
+        s.knots = ( float )detail::to_double( f[ 5 ] );
+        s.kmh = ( float )detail::to_double( f[ 7 ] );
+
+        return s;
+    }
+};
+
+struct Zda
+{
+    static constexpr gps_sentence_t id = GPS_SENTENCE_ZDA;
+    static constexpr std::string_view formatter = "ZDA";
+
+    Time time;
+    Date date;
+
+    static constexpr Zda decode( const Fields &f )
+    {
+        Zda s;
+
+        s.time = Time::decode( f[ 1 ] );
+        s.date.day = ( uint8_t )detail::to_uint( f[ 2 ] );
+        s.date.month = ( uint8_t )detail::to_uint( f[ 3 ] );
+        s.date.year = ( uint16_t )detail::to_uint( f[ 4 ] );
+
+        return s;
+    }
+};
+
+/******************************************************************************
+* Parser
+*******************************************************************************/
+/**
+ * @brief Stream parser for a fixed set of sentence types
+ *
+ * Types not in the set are counted as unsupported and never decoded, so
+ * their code isn't instantiated.
+ */
+template < class... Types >
+class Parser
+{
+    static_assert( sizeof...( Types ) > 0, "Parser needs at least one sentence type" );
+
+public:
+    using value_type = std::variant< Types... >;
+
+    struct Stats
+    {
+        uint32_t lines = 0;         /**< Complete lines seen */
+        uint32_t decoded = 0;
+        uint32_t invalid = 0;       /**< Framing or checksum */
+        uint32_t unsupported = 0;   /**< Valid but not in Types */
+        uint32_t overflows = 0;     /**< Longer than max_line across blocks */
+    };
+
+    template < class T >
+    static constexpr bool supports = ( std::is_same_v< T, Types > || ... );
+
+    /**
+     * @brief Decoded sentences of one block
+     *
+     * Iterate it to the end before the next feed(), the unterminated tail
+     * of the block is kept only then.
+     */
+    class Range
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Parser::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type *;
+            using reference = const value_type &;
+
+            iterator() = default;
+
+            reference operator*() const { return parser_->current_; }
+            pointer operator->() const { return &parser_->current_; }
+
+            iterator &operator++()
+            {
+                next();
+                return *this;
+            }
+
+            bool operator==( const iterator &other ) const { return done_ == other.done_; }
+            bool operator!=( const iterator &other ) const { return done_ != other.done_; }
+
+        private:
+            friend class Range;
+
+            iterator( Parser *parser, const char *pos, const char *end )
+                : parser_( parser ), pos_( pos ), end_( end ), done_( false )
+            {
+                next();
+            }
+
+            void next()
+            {
+                while( pos_ != end_ )
+                {
+                    const char *nl = ( const char * )std::memchr( pos_, '\n', end_ - pos_ );
+                    std::string_view line;
+
+                    if( nl == nullptr )
+                    {
+                        parser_->append( pos_, end_ - pos_ );
+                        pos_ = end_;
+                        break;
+                    }
+
+                    if( parser_->length_ || parser_->overflow_ )
+                    {
+                        parser_->append( pos_, nl + 1 - pos_ );
+                        line = parser_->take();
+                    }
+                    else
+                    {
+                        line = std::string_view( pos_, nl + 1 - pos_ );
+                    }
+
+                    pos_ = nl + 1;
+
+                    if( parser_->decode_line( line ) )
+                        return;
+                }
+
+                done_ = true;
+            }
+
+            Parser *parser_ = nullptr;
+            const char *pos_ = nullptr;
+            const char *end_ = nullptr;
+            bool done_ = true;
+        };
+
+        iterator begin() { return iterator( parser_, block_.data(), block_.data() + block_.size() ); }
+        iterator end() { return iterator(); }
+
+    private:
+        friend class Parser;
+
+        Range( Parser *parser, std::string_view block ) : parser_( parser ), block_( block ) {}
+
+        Parser *parser_;
+        std::string_view block_;
+    };
+
+    /**
+     * @brief Decodes the complete lines of a block
+     *
+     * @param block - any slice of the stream, lines may span blocks
+     */
+    Range feed( std::string_view block ) { return Range( this, block ); }
+
+    /**
+     * @brief Byte at a time input, as gps_put()
+     *
+     * @return const value_type * - decoded sentence when c ended one,
+     * valid until the next call
+     */
+    const value_type *put( char c )
+    {
+        append( &c, 1 );
+
+        if( c != '\n' )
+            return nullptr;
+
+        return decode_line( take() ) ? &current_ : nullptr;
+    }
+
+    /**
+     * @brief Decodes one complete line without touching the stream state
+     *
+     * @return const value_type * - valid until the next call
+     */
+    const value_type *decode( std::string_view line )
+    {
+        return decode_line( line ) ? &current_ : nullptr;
+    }
+
+    /**
+     * @brief Last decoded sentence of a type
+     *
+     * @return const T * - nullptr until one was decoded
+     */
+    template < class T >
+    const T *last() const
+    {
+        static_assert( supports< T >, "T is not in the parser's sentence set" );
+
+        return ( seen_ & bit< T >() ) ? &std::get< T >( last_ ) : nullptr;
+    }
+
+    const Stats &stats() const { return stats_; }
+
+    /** Drops a partial line, the last sentences and the counters */
+    void reset() { *this = Parser(); }
+
+private:
+    using decoder_t = void ( * )( Parser &, const Fields & );
+
+    struct Entry
+    {
+        uint32_t key;
+        decoder_t decode;
+    };
+
+    template < class T >
+    static constexpr uint32_t bit()
+    {
+        return 1u << ( uint32_t )T::id;
+    }
+
+    template < class T >
+    static void decode_as( Parser &p, const Fields &f )
+    {
+        T &value = std::get< T >( p.last_ );
+
+        value = T::decode( f );
+        p.current_.template emplace< T >( value );
+        p.seen_ |= bit< T >();
+    }
+
+    static constexpr std::array< Entry, sizeof...( Types ) > table =
+    { { Entry{ detail::key( Types::formatter ), &decode_as< Types > }... } };
+
+    bool decode_line( std::string_view line )
+    {
+        std::string_view body = validate( line );
+        uint32_t k;
+
+        /* Overflowed lines come back empty and are only counted there */
+        if( line.empty() )
+            return false;
+
+        stats_.lines++;
+
+        if( body.empty() )
+        {
+            stats_.invalid++;
+            return false;
+        }
+
+        Fields fields( body );
+        k = detail::key( fields.formatter() );
+
+        for( const Entry &e : table )
+        {
+            if( e.key == k )
+            {
+                e.decode( *this, fields );
+                stats_.decoded++;
+                return true;
+            }
+        }
+
+        stats_.unsupported++;
+        return false;
+    }
+
+    void append( const char *data, std::size_t n )
+    {
+        if( overflow_ || length_ + n > max_line )
+        {
+            overflow_ = true;
+            return;
+        }
+
+        std::memcpy( line_ + length_, data, n );
+        length_ += n;
+    }
+
+    /* Ends the held line, which stays readable until the next append */
+    std::string_view take()
+    {
+        std::string_view line( line_, overflow_ ? 0 : length_ );
+
+        if( overflow_ )
+            stats_.overflows++;
+
+        length_ = 0;
+        overflow_ = false;
+
+        return line;
+    }
+
+    char line_[ max_line ] = {};
+    std::size_t length_ = 0;
+    bool overflow_ = false;
+    value_type current_;
+    std::tuple< Types... > last_;
+    uint32_t seen_ = 0;
+    Stats stats_;
+};
+
+/** The common sentence set */
+using NmeaParser = Parser< Gga, Gll, Gsa, Gsv, Rmc, Vtg, Zda >;
+
+/* Framing and decoding are usable at compile time */
+static_assert( !validate( "$GPZDA,201530.00,04,07,2002,00,00*60\r\n" ).empty() );
+static_assert( Zda::decode( Fields( validate( "$GPZDA,201530.00,04,07,2002,00,00*60" ) ) ).date.year == 2002 );
+
+} // namespace gps
+
+#endif /* GPS_PARSER_HPP_ */
+
+/*** End of File **************************************************************/
@@ -0,0 +1,174 @@
+/****************************************************************************
+* Title                 :   GPS Parser Tracing
+* Filename              :   gps_trace.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Only active when GPS_TRACE is defined
+*****************************************************************************/
+/**
+ * @file gps_trace.h
+ * @brief Cycle counting around the parser hot path
+ *
+ * With GPS_TRACE defined the parser timestamps gps_put, validate_checksum,
+ * parse_fields and every process_* call, and accumulates count, min, avg,
+ * max and a log2 histogram per stage.  Without it all hooks expand to
+ * nothing.
+ *
+ * The timestamp source is GPS_TRACE_CLOCK().  Defaults:
+ *  - Cortex-M3/M4/M7/M33: DWT CYCCNT, enabled by gps_trace_init()
+ *  - x86 hosts: rdtsc
+ *  - other hosts: CLOCK_MONOTONIC in ns
+ *
+ * Anything else ( Cortex-M0, PIC, AVR, 8051 ) must define
+ * GPS_TRACE_CLOCK() and GPS_TRACE_UNIT before including the parser, e.g. a
+ * free running timer:
+ * @code
+ * #define GPS_TRACE_CLOCK() ( TMR1 )
+ * #define GPS_TRACE_UNIT    "ticks"
+ * @endcode
+ *
+ * Process stages include the parse_fields call they make.
+ */
+#ifndef GPS_TRACE_H_
+#define GPS_TRACE_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include "gps_defs.h"
+
+/******************************************************************************
+* Configuration Constants
+*******************************************************************************/
+#ifndef GPS_TRACE_BUCKETS
+#define GPS_TRACE_BUCKETS 16    /**< log2 histogram buckets per stage */
+#endif
+
+#ifndef GPS_TRACE_BUCKET_SHIFT
+#define GPS_TRACE_BUCKET_SHIFT 4 /**< First bucket holds samples below 2^shift */
+#endif
+
+#ifdef GPS_TRACE
+
+#if defined( GPS_TRACE_CLOCK )
+/* Supplied by the application */
+#elif defined( __MIKROC_PRO_FOR_ARM__ ) || defined( __ARM_ARCH_7M__ ) || \
+      defined( __ARM_ARCH_7EM__ ) || defined( __ARM_ARCH_8M_MAIN__ )
+#define GPS_TRACE_DWT
+#define GPS_TRACE_CLOCK() ( *( volatile uint32_t * )0xE0001004 )
+#define GPS_TRACE_UNIT "cycles"
+#elif ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ )
+#include <x86intrin.h>
+#define GPS_TRACE_CLOCK() ( ( gps_cycles_t )__rdtsc() )
+#define GPS_TRACE_UNIT "cycles"
+#elif defined( __GNUC__ )
+#include <time.h>
+static inline uint32_t gps_trace_clock_ns( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( uint32_t )( ts.tv_sec * 1000000000ull + ts.tv_nsec );
+}
+#define GPS_TRACE_CLOCK() gps_trace_clock_ns()
+#define GPS_TRACE_UNIT "ns"
+#else
+#error "GPS_TRACE needs GPS_TRACE_CLOCK() on this platform"
+#endif
+
+#ifndef GPS_TRACE_UNIT
+#define GPS_TRACE_UNIT "ticks"
+#endif
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/** Clock difference, wraps safely for stages shorter than 2^32 ticks */
+typedef uint32_t gps_cycles_t;
+
+#ifdef GPS_TRACE_SUM_TYPE
+typedef GPS_TRACE_SUM_TYPE gps_trace_sum_t;
+#elif defined( __MIKROC_PRO_FOR_ARM__ ) || defined( __GNUC__ )
+typedef uint64_t gps_trace_sum_t;
+#else
+typedef uint32_t gps_trace_sum_t;
+#endif
+
+/**
+ * @enum Traced stages
+ *
+ * Each configured sentence has its own process stage at
+ * GPS_TRACE_PROCESS + gps_sentence_t.
+ */
+enum
+{
+    GPS_TRACE_PUT = 0,
+    GPS_TRACE_CHECKSUM,
+    GPS_TRACE_FIELDS,
+    GPS_TRACE_PROCESS,
+    GPS_TRACE_STAGES = GPS_TRACE_PROCESS + GPS_SENTENCE_COUNT
+};
+
+/**
+ * @struct Statistics of one stage
+ */
+typedef struct
+{
+    uint32_t count;
+    gps_cycles_t min;
+    gps_cycles_t max;
+    gps_trace_sum_t total;
+    uint32_t buckets[ GPS_TRACE_BUCKETS ]; /**< [i] counts samples < 2^(shift+i) */
+} gps_trace_stage_t;
+
+/**
+ * @struct All traced stages
+ */
+typedef struct
+{
+    uint32_t sequence;  /**< Changes on every update */
+    gps_trace_stage_t stage[ GPS_TRACE_STAGES ];
+} gps_trace_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts the trace clock where needed and clears the statistics
+ */
+void gps_trace_init( void );
+
+/**
+ * @brief Consistent copy of the stage statistics
+ *
+ * @param trace - destination
+ */
+void gps_trace_get( gps_trace_t *trace );
+
+/**
+ * @brief Clears the stage statistics
+ */
+void gps_trace_reset( void );
+
+/**
+ * @brief Name of a traced stage
+ *
+ * @param stage - GPS_TRACE_PUT .. GPS_TRACE_STAGES - 1
+ *
+ * @return const char * - e.g. "put" or "process GGA"
+ */
+const char *gps_trace_stage_name( int stage );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_TRACE */
+
+#endif /* GPS_TRACE_H_ */
+
+/*** End of File **************************************************************/
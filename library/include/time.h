@@ -28,8 +28,8 @@
  *   SW:              ARM 4.5.2
  *
  */
-#ifndef _TIME_H
-#define _TIME_H
+#ifndef _GPS_TIME_H
+#define _GPS_TIME_H
 
 /******************************************************************************
 * Includes
@@ -0,0 +1,66 @@
+/*******************************************************************************
+* Title                 :   Host Clock and Calendar
+* Filename              :   gps_clock.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_clock.c
+ * @brief Monotonic clock and days to civil dates and back.
+ *
+ * The calendar counts in eras of 400 years, 146097 days, from 0000-03-01,
+ * so the leap day is the last of its year and the months from March have
+ * lengths a linear formula gives.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <time.h>
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define DAYS_PER_ERA    146097
+#define EPOCH_DAYS      719468      /**< 1970-01-01 from 0000-03-01 */
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+uint64_t gps_clock_ns( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ( uint64_t )ts.tv_sec * 1000000000ull + ( uint64_t )ts.tv_nsec;
+}
+
+int64_t gps_days_from_civil( int32_t year, int32_t month, int32_t day )
+{
+    int64_t y = ( int64_t )year - ( month <= 2 );
+    int64_t era = ( y >= 0 ? y : y - 399 ) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = ( 153 * ( month > 2 ? month - 3 : month + 9 ) + 2 ) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * DAYS_PER_ERA + doe - EPOCH_DAYS;
+}
+
+void gps_civil_from_days( int64_t days, int32_t *year, int32_t *month, int32_t *day )
+{
+    int64_t z = days + EPOCH_DAYS;
+    int64_t era = ( z >= 0 ? z : z - ( DAYS_PER_ERA - 1 ) ) / DAYS_PER_ERA;
+    int64_t doe = z - era * DAYS_PER_ERA;
+    int64_t yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+    int64_t doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+    int64_t mp = ( 5 * doy + 2 ) / 153;
+
+    *day = ( int32_t )( doy - ( 153 * mp + 2 ) / 5 + 1 );
+    *month = ( int32_t )( mp < 10 ? mp + 3 : mp - 9 );
+    *year = ( int32_t )( yoe + era * 400 + ( *month <= 2 ) );
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,406 @@
+/*******************************************************************************
+* Title                 :   NMEA Sentence Encoder
+* Filename              :   gps_encode.c
+* Origin Date           :   10/19/2026
+* Notes                 :   None
+*******************************************************************************/
+/**
+ * @file gps_encode.c
+ * @brief Formats the parser's sentence structures back into NMEA.
+ *
+ * A cursor writes the sentence and folds every character after the '$'
+ * into the checksum as it goes.  Fixed point values are clamped before
+ * they are rounded, so the widths in the field comments are the most any
+ * input produces.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include "gps_encode.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define MINUTES_SCALE   10000       /**< mm.mmmm */
+#define MINUTES_MAX     599999
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    char *start;
+    char *p;
+    uint8_t sum;
+} cursor_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void put_char( cursor_t *c, char ch );
+static void put_uint( cursor_t *c, uint32_t value, uint8_t width );
+static void put_fixed( cursor_t *c, double value, uint8_t decimals,
+                       int32_t min, int32_t max );
+static void put_time( cursor_t *c, const utc_time_t *time );
+static void put_location( cursor_t *c, const location_t *location,
+                          uint8_t width );
+static void begin( cursor_t *c, char *buffer, const char *type );
+static uint8_t finish( cursor_t *c );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void put_char( cursor_t *c, char ch )
+{
+    *c->p++ = ch;
+    c->sum ^= ( uint8_t )ch;
+}
+
+/* Zero padded to width digits */
+static void put_uint( cursor_t *c, uint32_t value, uint8_t width )
+{
+    char digits[ 10 ];
+    uint8_t n = 0;
+
+    do
+    {
+        digits[ n++ ] = ( char )( '0' + value % 10 );
+        value /= 10;
+    } while( value != 0 || n < width );
+
+    while( n > 0 )
+        put_char( c, digits[ --n ] );
+}
+
+/* min and max are in units of the last decimal */
+static void put_fixed( cursor_t *c, double value, uint8_t decimals,
+                       int32_t min, int32_t max )
+{
+    uint32_t scale = decimals == 2 ? 100 : decimals == 1 ? 10 : 1;
+    double scaled = value * scale;
+    int32_t units;
+
+    if( scaled >= max )
+        units = max;
+    else if( scaled <= min )
+        units = min;
+    else if( scaled < 0 )
+        units = -( int32_t )( 0.5 - scaled );
+    else
+        units = ( int32_t )( scaled + 0.5 );
+
+    if( units < 0 )
+    {
+        put_char( c, '-' );
+        units = -units;
+    }
+
+    put_uint( c, ( uint32_t )units / scale, 1 );
+
+    if( decimals > 0 )
+    {
+        put_char( c, '.' );
+        put_uint( c, ( uint32_t )units % scale, decimals );
+    }
+}
+
+/* hhmmss.ss */
+static void put_time( cursor_t *c, const utc_time_t *time )
+{
+    put_uint( c, time->hour % 100, 2 );
+    put_uint( c, time->minute % 100, 2 );
+    put_uint( c, time->second % 100, 2 );
+    put_char( c, '.' );
+    put_uint( c, time->ms / 10 % 100, 2 );
+}
+
+/* ( d )ddmm.mmmm,H or two empty fields without a hemisphere */
+static void put_location( cursor_t *c, const location_t *location,
+                          uint8_t width )
+{
+    uint32_t minutes;
+
+    switch( location->azmuth )
+    {
+    case NORTH:
+    case SOUTH:
+    case EAST:
+    case WEST:
+        break;
+    default:
+        put_char( c, ',' );
+        return;
+    }
+
+    minutes = location->minutes <= 0 ? 0 :
+              location->minutes * MINUTES_SCALE >= MINUTES_MAX ? MINUTES_MAX :
+              ( uint32_t )( location->minutes * MINUTES_SCALE + 0.5 );
+
+    put_uint( c, location->degrees % ( width == 2 ? 100 : 1000 ), width );
+    put_uint( c, minutes / MINUTES_SCALE, 2 );
+    put_char( c, '.' );
+    put_uint( c, minutes % MINUTES_SCALE, 4 );
+    put_char( c, ',' );
+    put_char( c, " NSEW"[ location->azmuth ] );
+}
+
+/* $ttXXX, */
+static void begin( cursor_t *c, char *buffer, const char *type )
+{
+    const char *talker = GPS_ENCODE_TALKER;
+
+    c->start = buffer;
+    c->p = buffer;
+    c->sum = 0;
+    *c->p++ = '$';
+    put_char( c, talker[ 0 ] );
+    put_char( c, talker[ 1 ] );
+    put_char( c, type[ 0 ] );
+    put_char( c, type[ 1 ] );
+    put_char( c, type[ 2 ] );
+    put_char( c, ',' );
+}
+
+/* *hh CR LF and the terminator */
+static uint8_t finish( cursor_t *c )
+{
+    static const char hex[] = "0123456789ABCDEF";
+    uint8_t sum = c->sum;
+
+    *c->p++ = '*';
+    *c->p++ = hex[ sum >> 4 ];
+    *c->p++ = hex[ sum & 0x0F ];
+    *c->p++ = '\r';
+    *c->p++ = '\n';
+    *c->p = '\0';
+
+    return ( uint8_t )( c->p - c->start );
+}
+
+uint8_t gps_encode_gga( char *buffer, const utc_time_t *time,
+                        const location_t *lat, const location_t *lon,
+                        const gga_t *gga )
+{
+    cursor_t c;
+
+    begin( &c, buffer, "GGA" );
+    put_time( &c, time );                               /* hhmmss.ss */
+    put_char( &c, ',' );
+    put_location( &c, lat, 2 );                         /* ddmm.mmmm,N */
+    put_char( &c, ',' );
+    put_location( &c, lon, 3 );                         /* dddmm.mmmm,E */
+    put_char( &c, ',' );
+    put_uint( &c, gga->fix % 10, 1 );
+    put_char( &c, ',' );
+    put_uint( &c, gga->num_sats, 2 );                   /* dd */
+    put_char( &c, ',' );
+    put_fixed( &c, gga->horizontal, 1, 0, 999 );        /* dd.d */
+    put_char( &c, ',' );
+    put_fixed( &c, gga->altitude, 1, -9999, 99999 );    /* -999.9, 9999.9 */
+    put_char( &c, ',' );
+    put_char( &c, 'M' );
+    put_char( &c, ',' );
+    put_fixed( &c, gga->height, 1, -9999, 9999 );       /* -999.9 */
+    put_char( &c, ',' );
+    put_char( &c, 'M' );
+    put_char( &c, ',' );
+
+    if( gga->station_id != 0 )
+    {
+        put_uint( &c, gga->last_update > 99 ? 99 : gga->last_update, 1 );
+        put_char( &c, ',' );
+        put_uint( &c, gga->station_id > 1023 ? 1023 : gga->station_id, 4 );
+    }
+    else
+    {
+        put_char( &c, ',' );
+    }
+
+    return finish( &c );
+}
+
+uint8_t gps_encode_rmc( char *buffer, const utc_time_t *time,
+                        const TimeStruct *date, const location_t *lat,
+                        const location_t *lon, const rmc_t *rmc )
+{
+    cursor_t c;
+
+    begin( &c, buffer, "RMC" );
+    put_time( &c, time );
+    put_char( &c, ',' );
+
+    if( rmc->status == RMC_ACTIVE )
+        put_char( &c, 'A' );
+    else if( rmc->status == RMC_VOID )
+        put_char( &c, 'V' );
+
+    put_char( &c, ',' );
+    put_location( &c, lat, 2 );
+    put_char( &c, ',' );
+    put_location( &c, lon, 3 );
+    put_char( &c, ',' );
+    put_fixed( &c, rmc->speed, 1, 0, 99999 );           /* 9999.9 */
+    put_char( &c, ',' );
+    put_fixed( &c, rmc->track, 1, 0, 9999 );            /* 999.9 */
+    put_char( &c, ',' );
+    put_uint( &c, date->md % 100, 2 );                  /* ddmmyy */
+    put_uint( &c, date->mo % 100, 2 );
+    put_uint( &c, date->yy % 100, 2 );
+    put_char( &c, ',' );
+
+    if( rmc->magnetic.azmuth == EAST || rmc->magnetic.azmuth == WEST )
+    {
+        put_fixed( &c, rmc->magnetic.mag_variation, 1, 0, 9999 );
+        put_char( &c, ',' );
+        put_char( &c, rmc->magnetic.azmuth == EAST ? 'E' : 'W' );
+    }
+    else
+    {
+        put_char( &c, ',' );
+    }
+
+    switch( rmc->mode )
+    {
+    case RMC_AUTONOMOUS:
+        put_char( &c, ',' );
+        put_char( &c, 'A' );
+        break;
+    case RMC_DIFFERENTIAL:
+        put_char( &c, ',' );
+        put_char( &c, 'D' );
+        break;
+    case RMC_NOT_VALID:
+        put_char( &c, ',' );
+        put_char( &c, 'N' );
+        break;
+    default:
+        break;
+    }
+
+    return finish( &c );
+}
+
+uint8_t gps_encode_vtg( char *buffer, const vtg_t *vtg )
+{
+    cursor_t c;
+
+    begin( &c, buffer, "VTG" );
+    put_fixed( &c, vtg->track, 1, 0, 9999 );            /* 999.9 */
+    put_char( &c, ',' );
+    put_char( &c, 'T' );
+    put_char( &c, ',' );
+    put_fixed( &c, vtg->mag_track, 1, 0, 9999 );
+    put_char( &c, ',' );
+    put_char( &c, 'M' );
+    put_char( &c, ',' );
+    put_fixed( &c, vtg->speed_knots, 1, 0, 99999 );     /* 9999.9 */
+    put_char( &c, ',' );
+    put_char( &c, 'N' );
+    put_char( &c, ',' );
+    put_fixed( &c, vtg->speed_km, 1, 0, 999999 );       /* 99999.9 */
+    put_char( &c, ',' );
+    put_char( &c, 'K' );
+
+    return finish( &c );
+}
+
+uint8_t gps_encode_gsa( char *buffer, const gsa_t *gsa )
+{
+    cursor_t c;
+    int i;
+
+    begin( &c, buffer, "GSA" );
+
+    if( gsa->mode == GSA_AUTO_MODE )
+        put_char( &c, 'A' );
+    else if( gsa->mode == GSA_MANUAL_MODE )
+        put_char( &c, 'M' );
+
+    put_char( &c, ',' );
+
+    if( gsa->fix >= GSA_NO_FIX && gsa->fix <= GSA_3D_FIX )
+        put_uint( &c, gsa->fix, 1 );
+
+    for( i = 0; i < 12; i++ )
+    {
+        put_char( &c, ',' );
+
+        if( gsa->sats[ i ] != 0 )
+            put_uint( &c, gsa->sats[ i ], 2 );          /* ddd */
+    }
+
+    put_char( &c, ',' );
+    put_fixed( &c, gsa->pdop, 2, 0, 9999 );             /* 99.99 */
+    put_char( &c, ',' );
+    put_fixed( &c, gsa->hdop, 2, 0, 9999 );
+    put_char( &c, ',' );
+    put_fixed( &c, gsa->vdop, 2, 0, 9999 );
+
+    return finish( &c );
+}
+
+uint8_t gps_encode_gsv( char *buffer, const gsv_t *gsv )
+{
+    uint8_t sentence = gsv->sentence ? gsv->sentence : 1;
+    uint8_t before = ( uint8_t )( ( sentence - 1 ) * 4 );
+    uint8_t count = gsv->num_sats > before ? gsv->num_sats - before : 0;
+    cursor_t c;
+    uint8_t i;
+
+    begin( &c, buffer, "GSV" );
+    put_uint( &c, gsv->num_sentences, 1 );
+    put_char( &c, ',' );
+    put_uint( &c, sentence, 1 );
+    put_char( &c, ',' );
+    put_uint( &c, gsv->num_sats, 2 );
+
+    for( i = 0; i < count && i < 4; i++ )
+    {
+        put_char( &c, ',' );
+        put_uint( &c, gsv->sat_info[ i ].sat_prn_num, 2 );      /* ddd */
+        put_char( &c, ',' );
+        put_uint( &c, gsv->sat_info[ i ].elevation % 100, 2 );
+        put_char( &c, ',' );
+        put_uint( &c, gsv->sat_info[ i ].azimuth % 1000, 3 );
+        put_char( &c, ',' );
+
+        if( gsv->sat_info[ i ].snr != 0 )
+            put_uint( &c, gsv->sat_info[ i ].snr % 100, 2 );
+    }
+
+    return finish( &c );
+}
+
+#ifdef ZDA
+uint8_t gps_encode_zda( char *buffer, const utc_time_t *time,
+                        const TimeStruct *date, const zda_t *zda )
+{
+    int8_t local_hour = ( int8_t )zda->local_hour;
+    cursor_t c;
+
+    begin( &c, buffer, "ZDA" );
+    put_time( &c, time );
+    put_char( &c, ',' );
+    put_uint( &c, date->md % 100, 2 );
+    put_char( &c, ',' );
+    put_uint( &c, date->mo % 100, 2 );
+    put_char( &c, ',' );
+    put_uint( &c, date->yy % 10000, 4 );
+    put_char( &c, ',' );
+
+    if( local_hour < 0 )
+    {
+        put_char( &c, '-' );
+        local_hour = ( int8_t )-local_hour;
+    }
+
+    put_uint( &c, ( uint8_t )local_hour % 100, 2 );
+    put_char( &c, ',' );
+    put_uint( &c, zda->local_min % 100, 2 );
+
+    return finish( &c );
+}
+#endif
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,248 @@
+/*******************************************************************************
+* Title                 :   Fix History
+* Filename              :   gps_history.c
+* Origin Date           :   10/19/2026
+* Notes                 :   None
+*******************************************************************************/
+/**
+ * @file gps_history.c
+ * @brief Ring of timed fixes with binary search and interpolation.
+ *
+ * Fixes are addressed by their order from the oldest, which the ring maps
+ * to a slot with a mask.  Interpolation works in meters east and north of
+ * the earlier fix, where velocities and positions share a unit, and goes
+ * back to degrees at the end.  Over the few hundred meters between epochs
+ * the flat approximation is far below receiver noise.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "gps_history.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define MASK            ( GPS_HISTORY_SIZE - 1 )
+#define KNOTS_TO_MPS    0.514444444
+#define DEG_TO_RAD      ( 3.14159265358979323846 / 180.0 )
+#define M_PER_DEG       ( 6371008.8 * DEG_TO_RAD )
+#define VELOCITY        ( GPS_EPOCH_SPEED | GPS_EPOCH_TRACK )
+
+#define STATIC_ASSERT( COND, NAME ) typedef char static_assert_##NAME[ ( COND ) ? 1 : -1 ]
+
+STATIC_ASSERT( GPS_HISTORY_SIZE >= 2 && ( GPS_HISTORY_SIZE & MASK ) == 0, history_size );
+STATIC_ASSERT( GPS_HISTORY_SIZE <= 32768, history_size_max );
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint32_t slot( const gps_history_t *history, uint16_t index );
+static int search( const gps_history_t *history, int64_t time );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* Slot of the index-th fix from the oldest */
+static uint32_t slot( const gps_history_t *history, uint16_t index )
+{
+    return ( history->count - gps_history_size( history ) + index ) & MASK;
+}
+
+/* Index from the oldest of the last fix at or before time, -1 if none */
+static int search( const gps_history_t *history, int64_t time )
+{
+    int low = 0, high = gps_history_size( history ) - 1;
+
+    if( high < 0 || time < history->time[ slot( history, 0 ) ] )
+        return -1;
+
+    while( low < high )
+    {
+        int middle = ( low + high + 1 ) / 2;
+
+        if( history->time[ slot( history, ( uint16_t )middle ) ] <= time )
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    return low;
+}
+
+void gps_history_init( gps_history_t *history )
+{
+    memset( history, 0, sizeof( gps_history_t ) );
+}
+
+int gps_history_push( gps_history_t *history, int64_t time, const gps_epoch_t *epoch )
+{
+    gps_history_fix_t *fix;
+    uint32_t s = history->count & MASK;
+
+    if( !( epoch->fields & GPS_EPOCH_POSITION ) ||
+        ( history->count > 0 && time <= history->time[ ( history->count - 1 ) & MASK ] ) )
+        return -1;
+
+    fix = &history->fix[ s ];
+    fix->latitude = epoch->latitude;
+    fix->longitude = epoch->longitude;
+    fix->altitude = ( float )epoch->altitude;
+    fix->fields = epoch->fields & ( GPS_EPOCH_POSITION | GPS_EPOCH_ALTITUDE );
+    fix->north = 0;
+    fix->east = 0;
+
+    /* A standing receiver often leaves the track empty */
+    if( ( epoch->fields & GPS_EPOCH_SPEED ) &&
+        ( ( epoch->fields & GPS_EPOCH_TRACK ) || epoch->speed == 0 ) )
+    {
+        double speed = epoch->speed * KNOTS_TO_MPS;
+        double track = ( epoch->fields & GPS_EPOCH_TRACK ) ? epoch->track * DEG_TO_RAD : 0;
+
+        fix->north = ( float )( speed * cos( track ) );
+        fix->east = ( float )( speed * sin( track ) );
+        fix->fields |= VELOCITY;
+    }
+
+    history->time[ s ] = time;
+
+    /* Past the wrap of the counter the slots go on in the same order */
+    if( ++history->count == 0 )
+        history->count = GPS_HISTORY_SIZE;
+
+    return 0;
+}
+
+uint16_t gps_history_size( const gps_history_t *history )
+{
+    return ( uint16_t )( history->count < GPS_HISTORY_SIZE ? history->count : GPS_HISTORY_SIZE );
+}
+
+int gps_history_get( const gps_history_t *history, uint16_t age, int64_t *time,
+                     gps_history_fix_t *fix )
+{
+    uint16_t size = gps_history_size( history );
+    uint32_t s;
+
+    if( age >= size )
+        return -1;
+
+    s = slot( history, ( uint16_t )( size - 1 - age ) );
+
+    if( time != 0 )
+        *time = history->time[ s ];
+
+    if( fix != 0 )
+        *fix = history->fix[ s ];
+
+    return 0;
+}
+
+int gps_history_find( const gps_history_t *history, int64_t time )
+{
+    int index = search( history, time );
+
+    return index < 0 ? -1 : gps_history_size( history ) - 1 - index;
+}
+
+int gps_history_at( const gps_history_t *history, int64_t time, gps_history_mode_t mode,
+                    gps_history_fix_t *fix )
+{
+    const gps_history_fix_t *a, *b;
+    double s, dt, per_lon, dx, dy, x, y, vx, vy;
+    double m0x, m0y, m1x, m1y, lon;
+    int64_t t0, t1;
+    int index = search( history, time );
+    uint32_t sa;
+
+    if( index < 0 )
+        return -1;
+
+    sa = slot( history, ( uint16_t )index );
+    a = &history->fix[ sa ];
+    t0 = history->time[ sa ];
+
+    if( time == t0 )
+    {
+        *fix = *a;
+        return 0;
+    }
+
+    /* After the newest */
+    if( index == gps_history_size( history ) - 1 )
+        return -1;
+
+    b = &history->fix[ slot( history, ( uint16_t )( index + 1 ) ) ];
+    t1 = history->time[ slot( history, ( uint16_t )( index + 1 ) ) ];
+    s = ( double )( time - t0 ) / ( double )( t1 - t0 );
+    dt = ( double )( t1 - t0 ) / GPS_HISTORY_TICKS;
+
+    /* Meters of b east and north of a, the short way round in longitude */
+    per_lon = M_PER_DEG * cos( a->latitude * DEG_TO_RAD );
+
+    if( per_lon < 1e-3 )
+        per_lon = 1e-3;
+
+    lon = b->longitude - a->longitude;
+
+    if( lon > 180 )
+        lon -= 360;
+    else if( lon < -180 )
+        lon += 360;
+
+    dx = lon * per_lon;
+    dy = ( b->latitude - a->latitude ) * M_PER_DEG;
+
+    if( mode == GPS_HISTORY_HERMITE )
+    {
+        /* Tangents over the whole interval, the chord without a velocity */
+        double s2 = s * s, s3 = s2 * s;
+        double h10 = s3 - 2 * s2 + s, h01 = 3 * s2 - 2 * s3, h11 = s3 - s2;
+        double d10 = 3 * s2 - 4 * s + 1, d01 = 6 * s - 6 * s2, d11 = 3 * s2 - 2 * s;
+
+        m0x = ( a->fields & VELOCITY ) == VELOCITY ? a->east * dt : dx;
+        m0y = ( a->fields & VELOCITY ) == VELOCITY ? a->north * dt : dy;
+        m1x = ( b->fields & VELOCITY ) == VELOCITY ? b->east * dt : dx;
+        m1y = ( b->fields & VELOCITY ) == VELOCITY ? b->north * dt : dy;
+
+        x = h10 * m0x + h01 * dx + h11 * m1x;
+        y = h10 * m0y + h01 * dy + h11 * m1y;
+        vx = ( d10 * m0x + d01 * dx + d11 * m1x ) / dt;
+        vy = ( d10 * m0y + d01 * dy + d11 * m1y ) / dt;
+    }
+    else
+    {
+        x = s * dx;
+        y = s * dy;
+
+        if( ( a->fields & b->fields & VELOCITY ) == VELOCITY )
+        {
+            vx = a->east + s * ( b->east - a->east );
+            vy = a->north + s * ( b->north - a->north );
+        }
+        else
+        {
+            vx = dx / dt;
+            vy = dy / dt;
+        }
+    }
+
+    fix->latitude = a->latitude + y / M_PER_DEG;
+    fix->longitude = a->longitude + x / per_lon;
+
+    if( fix->longitude > 180 )
+        fix->longitude -= 360;
+    else if( fix->longitude < -180 )
+        fix->longitude += 360;
+
+    fix->altitude = ( float )( a->altitude + s * ( b->altitude - a->altitude ) );
+    fix->east = ( float )vx;
+    fix->north = ( float )vy;
+    fix->fields = GPS_EPOCH_POSITION | ( a->fields & b->fields & ( GPS_EPOCH_ALTITUDE | VELOCITY ) );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,356 @@
+/*******************************************************************************
+* Title                 :   gpsd JSON Encoder
+* Filename              :   gps_json.c
+* Origin Date           :   10/19/2026
+* Notes                 :   None
+*******************************************************************************/
+/**
+ * @file gps_json.c
+ * @brief Formats epochs and satellite tables as gpsd JSON objects.
+ *
+ * A cursor stops one short of the end of the buffer and remembers that it
+ * did, so an object is either complete or not there.  Fixed point values
+ * are split into a whole and a fraction of at most nine digits, which both
+ * fit 32 bits, so no 64 bit arithmetic is needed on small targets.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include "gps_json.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define KNOTS_TO_MPS    0.514444444
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    char *start;
+    char *p;
+    char *last;                 /**< Room for the terminator */
+    uint16_t size;
+    uint8_t full;
+} cursor_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static const uint32_t powers[] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void put_char( cursor_t *c, char ch );
+static void put_text( cursor_t *c, const char *text );
+static void put_uint( cursor_t *c, uint32_t value, uint8_t width );
+static void put_fixed( cursor_t *c, double value, uint8_t decimals, double limit );
+static void put_string( cursor_t *c, const char *text );
+static void put_time( cursor_t *c, const gps_epoch_t *epoch );
+static void begin( cursor_t *c, char *buffer, uint16_t size, const char *type,
+                   const char *device );
+static uint16_t finish( cursor_t *c );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void put_char( cursor_t *c, char ch )
+{
+    if( c->p < c->last )
+        *c->p++ = ch;
+    else
+        c->full = 1;
+}
+
+static void put_text( cursor_t *c, const char *text )
+{
+    while( *text )
+        put_char( c, *text++ );
+}
+
+/* Zero padded to width digits */
+static void put_uint( cursor_t *c, uint32_t value, uint8_t width )
+{
+    char digits[ 10 ];
+    uint8_t n = 0;
+
+    do
+    {
+        digits[ n++ ] = ( char )( '0' + value % 10 );
+        value /= 10;
+    } while( value != 0 || n < width );
+
+    while( n > 0 )
+        put_char( c, digits[ --n ] );
+}
+
+/* decimals up to 9, the magnitude clamped to limit */
+static void put_fixed( cursor_t *c, double value, uint8_t decimals, double limit )
+{
+    uint32_t whole, fraction;
+
+    /* NaN */
+    if( value != value )
+        value = 0;
+
+    if( value * powers[ decimals ] <= -0.5 )
+    {
+        put_char( c, '-' );
+        value = -value;
+    }
+    else if( value < 0 )
+    {
+        value = 0;
+    }
+
+    if( value > limit )
+        value = limit;
+
+    whole = ( uint32_t )value;
+    fraction = ( uint32_t )( ( value - whole ) * powers[ decimals ] + 0.5 );
+
+    if( fraction >= powers[ decimals ] )
+    {
+        whole++;
+        fraction -= powers[ decimals ];
+    }
+
+    put_uint( c, whole, 1 );
+
+    if( decimals > 0 )
+    {
+        put_char( c, '.' );
+        put_uint( c, fraction, decimals );
+    }
+}
+
+/* Quoted, with the characters JSON doesn't allow escaped */
+static void put_string( cursor_t *c, const char *text )
+{
+    static const char hex[] = "0123456789abcdef";
+
+    put_char( c, '"' );
+
+    for( ; *text; text++ )
+    {
+        uint8_t ch = ( uint8_t )*text;
+
+        if( ch == '"' || ch == '\\' )
+        {
+            put_char( c, '\\' );
+            put_char( c, ( char )ch );
+        }
+        else if( ch < 0x20 )
+        {
+            put_text( c, "\\u00" );
+            put_char( c, hex[ ch >> 4 ] );
+            put_char( c, hex[ ch & 0x0F ] );
+        }
+        else
+        {
+            put_char( c, ( char )ch );
+        }
+    }
+
+    put_char( c, '"' );
+}
+
+/* ,"time":"yyyy-mm-ddThh:mm:ss.sssZ" with a date only */
+static void put_time( cursor_t *c, const gps_epoch_t *epoch )
+{
+    if( ( epoch->fields & ( GPS_EPOCH_TIME | GPS_EPOCH_DATE ) ) !=
+        ( GPS_EPOCH_TIME | GPS_EPOCH_DATE ) )
+        return;
+
+    put_text( c, ",\"time\":\"" );
+    put_uint( c, epoch->date.yy % 10000, 4 );
+    put_char( c, '-' );
+    put_uint( c, epoch->date.mo % 100, 2 );
+    put_char( c, '-' );
+    put_uint( c, epoch->date.md % 100, 2 );
+    put_char( c, 'T' );
+    put_uint( c, epoch->time.hour % 100, 2 );
+    put_char( c, ':' );
+    put_uint( c, epoch->time.minute % 100, 2 );
+    put_char( c, ':' );
+    put_uint( c, epoch->time.second % 100, 2 );
+    put_char( c, '.' );
+    put_uint( c, epoch->time.ms % 1000, 3 );
+    put_text( c, "Z\"" );
+}
+
+/* {"class":"TYPE","device":"..." */
+static void begin( cursor_t *c, char *buffer, uint16_t size, const char *type,
+                   const char *device )
+{
+    c->start = buffer;
+    c->p = buffer;
+    c->last = buffer + ( size ? size - 1 : 0 );
+    c->size = size;
+    c->full = size == 0;
+
+    put_text( c, "{\"class\":\"" );
+    put_text( c, type );
+    put_char( c, '"' );
+
+    if( device != 0 )
+    {
+        put_text( c, ",\"device\":" );
+        put_string( c, device );
+    }
+}
+
+/* } CR LF and the terminator, or nothing */
+static uint16_t finish( cursor_t *c )
+{
+    put_text( c, "}\r\n" );
+
+    if( c->full )
+    {
+        if( c->size > 0 )
+            *c->start = '\0';
+
+        return 0;
+    }
+
+    *c->p = '\0';
+
+    return ( uint16_t )( c->p - c->start );
+}
+
+uint16_t gps_json_tpv( char *buffer, uint16_t size, const char *device,
+                       const gps_epoch_t *epoch )
+{
+    uint16_t fields = epoch->fields;
+    uint8_t mode = 0;
+    cursor_t c;
+
+    if( fields & ( GPS_EPOCH_POSITION | GPS_EPOCH_QUALITY | GPS_EPOCH_STATUS ) )
+        mode = 1;
+
+    if( ( fields & GPS_EPOCH_POSITION ) &&
+        !( ( fields & GPS_EPOCH_QUALITY ) && epoch->quality == INVALID ) &&
+        !( ( fields & GPS_EPOCH_STATUS ) && epoch->status == RMC_VOID ) )
+        mode = ( fields & GPS_EPOCH_ALTITUDE ) ? 3 : 2;
+
+    begin( &c, buffer, size, "TPV", device );
+    put_text( &c, ",\"mode\":" );
+    put_uint( &c, mode, 1 );
+
+    if( ( fields & GPS_EPOCH_QUALITY ) && epoch->quality == DGPS_FIX )
+        put_text( &c, ",\"status\":2" );
+
+    put_time( &c, epoch );
+
+    if( mode >= 2 )
+    {
+        put_text( &c, ",\"lat\":" );
+        put_fixed( &c, epoch->latitude, 9, 90 );
+        put_text( &c, ",\"lon\":" );
+        put_fixed( &c, epoch->longitude, 9, 180 );
+    }
+
+    if( mode == 3 )
+    {
+        put_text( &c, ",\"alt\":" );
+        put_fixed( &c, epoch->altitude, 3, 999999 );
+        put_text( &c, ",\"altMSL\":" );
+        put_fixed( &c, epoch->altitude, 3, 999999 );
+    }
+
+    if( fields & GPS_EPOCH_TRACK )
+    {
+        put_text( &c, ",\"track\":" );
+        put_fixed( &c, epoch->track, 4, 360 );
+    }
+
+    if( fields & GPS_EPOCH_SPEED )
+    {
+        put_text( &c, ",\"speed\":" );
+        put_fixed( &c, epoch->speed * KNOTS_TO_MPS, 3, 999999 );
+    }
+
+    return finish( &c );
+}
+
+uint16_t gps_json_sky( char *buffer, uint16_t size, const char *device,
+                       const gps_epoch_t *epoch, const gsv_t *gsv,
+                       uint8_t messages, const uint8_t *used, uint8_t used_count )
+{
+    uint8_t in_view = 0, in_use = 0, m, i, k;
+    cursor_t c;
+
+    begin( &c, buffer, size, "SKY", device );
+
+    if( epoch != 0 )
+    {
+        put_time( &c, epoch );
+
+        if( epoch->fields & GPS_EPOCH_HDOP )
+        {
+            put_text( &c, ",\"hdop\":" );
+            put_fixed( &c, epoch->hdop, 2, 99 );
+        }
+    }
+
+    put_text( &c, ",\"satellites\":[" );
+
+    for( m = 0; m < messages; m++ )
+    {
+        uint8_t before = ( uint8_t )( m * 4 );
+        uint8_t count = gsv[ 0 ].num_sats > before ? gsv[ 0 ].num_sats - before : 0;
+
+        for( i = 0; i < count && i < 4; i++ )
+        {
+            const uint8_t prn = gsv[ m ].sat_info[ i ].sat_prn_num;
+            uint8_t is_used = 0;
+
+            if( prn == 0 )
+                continue;
+
+            for( k = 0; used != 0 && k < used_count; k++ )
+                is_used |= used[ k ] == prn;
+
+            if( in_view++ )
+                put_char( &c, ',' );
+
+            put_text( &c, "{\"PRN\":" );
+            put_uint( &c, prn, 1 );
+            put_text( &c, ",\"el\":" );
+            put_uint( &c, gsv[ m ].sat_info[ i ].elevation % 100, 1 );
+            put_text( &c, ",\"az\":" );
+            put_uint( &c, gsv[ m ].sat_info[ i ].azimuth % 1000, 1 );
+            put_text( &c, ",\"ss\":" );
+            put_uint( &c, gsv[ m ].sat_info[ i ].snr % 100, 1 );
+            put_text( &c, is_used ? ",\"used\":true}" : ",\"used\":false}" );
+            in_use += is_used;
+        }
+    }
+
+    put_text( &c, "],\"nSat\":" );
+    put_uint( &c, in_view, 1 );
+    put_text( &c, ",\"uSat\":" );
+    put_uint( &c, in_use, 1 );
+
+    return finish( &c );
+}
+
+uint16_t gps_json_devices( char *buffer, uint16_t size, const char *device )
+{
+    cursor_t c;
+
+    begin( &c, buffer, size, "DEVICES", 0 );
+    put_text( &c, ",\"devices\":[{\"class\":\"DEVICE\",\"path\":" );
+    put_string( &c, device );
+    put_text( &c, ",\"driver\":\"NMEA0183\",\"activated\":true}]" );
+
+    return finish( &c );
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -1,3 +1,8 @@
+/* clock_gettime is POSIX, not C99 */
+#if defined( __unix__ ) && !defined( _POSIX_C_SOURCE )
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,8 +23,47 @@
 #define ON_PC
 #endif
 
+#ifdef GPS_TIMESTAMPS
+#ifndef GPS_TIMESTAMP_NOW
+#ifdef ON_PC
+#include <time.h>
+#define GPS_TIMESTAMP_NOW() timestamp_now()
+#else
+#error "GPS_TIMESTAMPS needs GPS_TIMESTAMP_NOW() on this platform"
+#endif
+#endif
+#endif
+
+/* Helpers only the configured sentences need */
+#if defined( GGA ) || defined( GLL ) || defined( RMC ) || defined( GBS ) || \
+    defined( GRS ) || defined( GST ) || defined( ZDA )
+#define NEED_TIME
+#endif
+#if defined( GGA ) || defined( GLL ) || defined( RMC )
+#define NEED_LOCATION
+#endif
+
 #define field( NAME ) fields->tokens[ NAME ][ 0 ]
 #define token( NAME ) fields->tokens[ NAME ]
+#define NO_TEXT -1          /* parse_fields() without a field that runs on */
+
+#ifdef GPS_STATS
+#define STAT_INC( COUNTER ) do { stats.COUNTER++; stats.sequence++; } while( 0 )
+#else
+#define STAT_INC( COUNTER ) do { } while( 0 )
+#endif
+
+/* TRACE_BEGIN declares a variable so it must open its block */
+#ifdef GPS_TRACE
+#define TRACE_BEGIN( START ) gps_cycles_t START = ( gps_cycles_t )GPS_TRACE_CLOCK()
+#define TRACE_END( STAGE, START ) \
+    trace_record( STAGE, ( gps_cycles_t )GPS_TRACE_CLOCK() - START )
+#define TRACE_RESTART( START ) START = ( gps_cycles_t )GPS_TRACE_CLOCK()
+#else
+#define TRACE_BEGIN( START )
+#define TRACE_RESTART( START )
+#define TRACE_END( STAGE, START )
+#endif
 
 /**************************
  * Globals
@@ -29,6 +73,24 @@ static volatile char buffer[ BUFFER_MAX ];
 static char process_buffer[ BUFFER_MAX ];
 static volatile uint8_t buffer_position;
 static volatile bool process_flag;
+#ifdef GPS_STATS
+static volatile gps_stats_t stats;
+#endif
+#ifdef GPS_TRACE
+static volatile gps_trace_t trace;
+#endif
+#ifdef GPS_TIMESTAMPS
+static volatile gps_timestamp_t line_first;
+static volatile gps_timestamp_t line_last;
+static volatile gps_timestamp_t process_first;
+static volatile gps_timestamp_t process_last;
+static gps_sentence_times_t sentence_times[ GPS_SENTENCE_COUNT ];
+#endif
+
+/* Epoch being merged and the last complete one */
+static gps_epoch_t open_epoch;
+static gps_epoch_t last_epoch;
+static uint32_t epoch_count;
 
 /* Global information recieved from several sentences */
 static location_t cur_longitude;
@@ -44,6 +106,7 @@ enum
     LOCATION_LON
 };
 
+#ifdef GGA
 // GGA fields
 enum
 {
@@ -63,7 +126,9 @@ enum
     GGA_STATION_ID
 };
 static gga_t cur_gga;
+#endif
 
+#ifdef GLL
 // GLL fields
 enum
 {
@@ -75,7 +140,9 @@ enum
     GLL_DATA_ACTIVE
 };
 static gll_t cur_gll;
+#endif
 
+#ifdef GSA
 // GSA fields
 enum
 {
@@ -98,7 +165,9 @@ enum
     GSA_VDOP
 };
 static gsa_t cur_gsa;
+#endif
 
+#ifdef GSV
 // GSV fields
 enum
 {
@@ -122,8 +191,10 @@ enum
     GSV_AZIMUTH4,
     GSV_SNR4,
 };
-static gsv_t cur_gsv[3];
+static gsv_t cur_gsv[ MAX_GSV_SENTENCES ];
+#endif
 
+#ifdef RMC
 // RMC fields
 enum
 {
@@ -141,16 +212,19 @@ enum
     RMC_MODE
 };
 static rmc_t cur_rmc;
+#endif
 
+#ifdef VTG
 // VTG fields
 enum
 {
     VTG_TRACK = 0,
     VTG_MAG_TRACK = 2,
     VTG_SPEED_KNOTS = 4,
-    VTG_SPEED_KM
+    VTG_SPEED_KM = 6
 };
 static vtg_t cur_vtg;
+#endif
 
 #ifdef DTM
 // DTM fields
@@ -222,7 +296,6 @@ enum
     TXT_TYPE,
     TXT_MESSGE
 };
-static char txt_message[MAX_TXT_MESSAGE];
 static txt_t cur_txt[MAX_TXT_PACKAGES];
 #endif
 #ifdef ZDA
@@ -245,16 +318,74 @@ typedef struct
     int8_t num_of_fields;
     char tokens[ MAX_FIELDS ][ MAX_FIELD_SIZE ];
 } fields_t;
+/* Fields of the sentence being processed */
+static fields_t sentence_fields;
+
+/* Capacity checks, a negative array size stops the build */
+#define STATIC_ASSERT( COND, NAME ) typedef char static_assert_##NAME[ ( COND ) ? 1 : -1 ]
+
+STATIC_ASSERT( BUFFER_MAX > 80 && BUFFER_MAX <= 255, buffer_max );
+STATIC_ASSERT( MAX_FIELD_SIZE > GPS_LONGEST_FIELD, max_field_size );
+STATIC_ASSERT( MAX_FIELD_SIZE >= 10, max_field_size_time ); /* hhmmss.ss */
+STATIC_ASSERT( MAX_FIELDS <= 127, max_fields_count );
+#ifdef GGA
+STATIC_ASSERT( MAX_FIELDS >= GGA_STATION_ID + 1, max_fields_gga );
+#endif
+#ifdef GLL
+STATIC_ASSERT( MAX_FIELDS >= GLL_DATA_ACTIVE + 1, max_fields_gll );
+#endif
+#ifdef GSA
+STATIC_ASSERT( MAX_FIELDS >= GSA_VDOP + 1, max_fields_gsa );
+#endif
+#ifdef GSV
+STATIC_ASSERT( MAX_FIELDS >= GSV_SNR4 + 1, max_fields_gsv );
+STATIC_ASSERT( MAX_GSV_SENTENCES >= 1, max_gsv_sentences );
+#endif
+#ifdef RMC
+STATIC_ASSERT( MAX_FIELDS >= RMC_MODE + 1, max_fields_rmc );
+#endif
+#ifdef VTG
+STATIC_ASSERT( MAX_FIELDS >= VTG_SPEED_KM + 1, max_fields_vtg );
+#endif
+#ifdef DTM
+STATIC_ASSERT( MAX_FIELDS >= DTM_DATUM + 1, max_fields_dtm );
+#endif
+#ifdef GBS
+STATIC_ASSERT( MAX_FIELDS >= GBS_STD_DEVIATION + 1, max_fields_gbs );
+#endif
+#ifdef GRS
+STATIC_ASSERT( MAX_FIELDS >= GRS_RANGE + 1, max_fields_grs );
+#endif
+#ifdef GST
+STATIC_ASSERT( MAX_FIELDS >= GST_STD_ALT + 1, max_fields_gst );
+#endif
+#ifdef TXT
+STATIC_ASSERT( MAX_FIELDS >= TXT_MESSGE + 1, max_fields_txt );
+STATIC_ASSERT( MAX_TXT_PACKAGES >= 1 && MAX_TXT_SIZE >= 2, max_txt );
+#endif
+#ifdef ZDA
+STATIC_ASSERT( MAX_FIELDS >= ZDA_LOCAL_MINUTES + 1, max_fields_zda );
+#endif
 
 
 /************************************
  * Private Prototypes
  ***********************************/
+#ifdef GGA
 static void process_gga( char *sentence );
+#endif
+#ifdef GLL
 static void process_gll( char *sentence );
+#endif
+#ifdef GSA
 static void process_gsa( char *sentence );
+#endif
+#ifdef GSV
 static void process_gsv( char *sentence );
+#endif
+#ifdef RMC
 static void process_rmc( char *sentence );
+#endif
 #ifdef DTM
 static void process_dtm( char *sentence );
 #endif
@@ -284,31 +415,55 @@ static void process_zda( char *sentence );
 #endif
 
 // Router of sentence parsing
-/* parses the sentence into fields */
-static fields_t* parse_fields( char *sentence );
+/* parses the sentence into fields, only text_field may run on into the unused tokens */
+static fields_t* parse_fields( char *sentence, int8_t text_field );
 /* Removes leading 0 and returns float */
 static double get_num_float( char *str );
 /* Removes leading 0 and returns int */
 static int get_num( char *str );
+#ifdef NEED_TIME
 /* gets the time from string and populates time pointer */
 static void get_time( char *str, utc_time_t *time );
+#endif
+#ifdef RMC
 /* gets time as well as date from string and populates pointer */
 static void get_date( char *str, TimeStruct *ts );
+#endif
+#ifdef NEED_LOCATION
 /* Parses location both degrees, minutes, and azmuth */
 static void get_location( char *str, location_t *location, int type );
+#endif
 /* for those platforms not found on the MikroC compiler */
 static int xtoi( char *hexstring );
 /* Utility function to calculate valid sentence */
 static bool validate_checksum( char *sentence );
+/* Identifies the sentence from its address field */
+static gps_sentence_t sentence_type( const char *sentence );
 /* Main processing function */
 static void gps_process_sentence( char *sentence );
+#ifdef GPS_TRACE
+/* Adds one measurement to a stage */
+static void trace_record( int stage, gps_cycles_t cycles );
+#endif
+/* Merges the processed sentence into the open epoch */
+static void epoch_update( gps_sentence_t type );
+/* Publishes the open epoch */
+static void epoch_close( void );
+#ifdef NEED_LOCATION
+/* Signed decimal degrees of a location */
+static double location_degrees( const location_t *location );
+#endif
+#if defined( GPS_TIMESTAMPS ) && defined( ON_PC )
+static gps_timestamp_t timestamp_now( void );
+#endif
 
 /*********************
   Private Implimentations
 *********************/
+#ifdef GGA
 static void process_gga( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -317,45 +472,36 @@ static void process_gga( char *sentence )
         {
         case GGA_fix_tIME:
             if( field( GGA_fix_tIME ) )
-            {
-                cur_gga.fix_time = &cur_fix;
-                get_time( token( GGA_fix_tIME ), cur_gga.fix_time );
-            }
+                get_time( token( GGA_fix_tIME ), &cur_fix );
             break;
         case GGA_LAT:
             if( field( GGA_LAT ) )
-            {
-                cur_gga.lat = &cur_latitude;
-                get_location( token( GGA_LAT ), cur_gga.lat, LOCATION_LAT );
-            }
+                get_location( token( GGA_LAT ), &cur_latitude, LOCATION_LAT );
             break;
         case GGA_LAT_AZMUTH:
             if( field( GGA_LAT_AZMUTH ) )
             {
                 if( field( GGA_LAT_AZMUTH ) == 'N' )
-                    cur_gga.lat->azmuth = NORTH;
+                    cur_latitude.azmuth = NORTH;
                 else if( field( GGA_LAT_AZMUTH ) == 'S' )
-                    cur_gga.lat->azmuth = SOUTH;
+                    cur_latitude.azmuth = SOUTH;
                 else
-                    cur_gga.lat->azmuth = UNKNOWN;
+                    cur_latitude.azmuth = UNKNOWN;
             }
             break;
         case GGA_LON:
             if( field( GGA_LON ) )
-            {
-                cur_gga.lon = &cur_longitude;
-                get_location( token( GGA_LON ), cur_gga.lon, LOCATION_LON );
-            }
+                get_location( token( GGA_LON ), &cur_longitude, LOCATION_LON );
             break;
         case GGA_LON_AZMUTH:
             if( field( GGA_LON_AZMUTH ) )
             {
                 if( field( GGA_LON_AZMUTH ) == 'E' )
-                    cur_gga.lon->azmuth = EAST;
+                    cur_longitude.azmuth = EAST;
                 else if( field( GGA_LON_AZMUTH ) == 'W' )
-                    cur_gga.lon->azmuth = WEST;
+                    cur_longitude.azmuth = WEST;
                 else
-                    cur_gga.lon->azmuth = UNKNOWN;
+                    cur_longitude.azmuth = UNKNOWN;
             }
             break;
         case GGA_FIX_QUALITY:
@@ -390,10 +536,12 @@ static void process_gga( char *sentence )
     }
     return;
 }
+#endif
 
+#ifdef GLL
 static void process_gll( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -402,35 +550,26 @@ static void process_gll( char *sentence )
         {
         case GLL_LOCATION_LAT:
             if( field( GLL_LOCATION_LAT ) )
-            {
-                cur_gll.lat = &cur_latitude;
-                get_location( token( GLL_LOCATION_LAT ), cur_gll.lon, LOCATION_LAT );
-            }
+                get_location( token( GLL_LOCATION_LAT ), &cur_latitude, LOCATION_LAT );
             break;
         case GLL_LOCATION_LAT_AZMUTH:
             if( field( GLL_LOCATION_LAT_AZMUTH ) )
             {
                 if( field( GLL_LOCATION_LAT_AZMUTH ) == 'N' )
-                    cur_gll.lat->azmuth = NORTH;
+                    cur_latitude.azmuth = NORTH;
                 else if( field( GLL_LOCATION_LAT_AZMUTH ) == 'S' )
-                    cur_gll.lat->azmuth = SOUTH;
+                    cur_latitude.azmuth = SOUTH;
                 else
-                    cur_gll.lat->azmuth = UNKNOWN;
+                    cur_latitude.azmuth = UNKNOWN;
             }
             break;
         case GLL_LOCATION_LON:
             if( field( GLL_LOCATION_LON ) )
-            {
-                cur_gll.lon = &cur_longitude;
-                get_location( token( GLL_LOCATION_LON ), cur_gll.lon, LOCATION_LON );
-            }
+                get_location( token( GLL_LOCATION_LON ), &cur_longitude, LOCATION_LON );
             break;
         case GLL_fix_tIME:
             if( field( GLL_fix_tIME ) )
-            {
-                cur_gll.fix_time = &cur_fix;
-                get_time( token( GLL_fix_tIME ), cur_gll.fix_time );
-            }
+                get_time( token( GLL_fix_tIME ), &cur_fix );
             break;
         case GLL_DATA_ACTIVE:
             if( field( GLL_DATA_ACTIVE ) )
@@ -446,12 +585,17 @@ static void process_gll( char *sentence )
         };
     }
 }
+#endif
 
+#ifdef GSA
 static void process_gsa( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
+    /* Empty slots are unused, not unchanged */
+    memset( cur_gsa.sats, 0, sizeof( cur_gsa.sats ) );
+
     for( i = 0; i < fields->num_of_fields; i++ )
     {
         switch( i )
@@ -525,37 +669,49 @@ static void process_gsa( char *sentence )
             break;
         case GSA_HDOP:
             if( field( GSA_HDOP ) )
-                cur_gsa.pdop = get_num_float( token( GSA_HDOP ) );
+                cur_gsa.hdop = get_num_float( token( GSA_HDOP ) );
             break;
         case GSA_VDOP:
             if( field( GSA_VDOP ) )
-                cur_gsa.pdop = get_num_float( token( GSA_VDOP ) );
+                cur_gsa.vdop = get_num_float( token( GSA_VDOP ) );
             break;
         };
     }
     return;
 }
+#endif
 
+#ifdef GSV
 static void process_gsv( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
     gsv_t *cur_sentence = &cur_gsv[0];
+    uint8_t num_sentences = 0;
 
 
     for( i = 0; i < fields->num_of_fields; i++ )
     {
         switch( i )
         {
+        case GSV_NUM_SENTENCE:
+            if( field( GSV_NUM_SENTENCE ) )
+                num_sentences = get_num( token( GSV_NUM_SENTENCE ) );
+            break;
         case GSV_SENTENCE:
             if( field( GSV_SENTENCE ) )
             {
                 uint8_t tmp_num = get_num( token( GSV_SENTENCE ) );
 
-                if( tmp_num <= 3 && tmp_num >= 1 )
+                if( tmp_num <= MAX_GSV_SENTENCES && tmp_num >= 1 )
                     cur_sentence = &cur_gsv[tmp_num - 1];
                 else
                     return;
+
+                /* Satellites the message leaves empty are gone */
+                memset( cur_sentence, 0, sizeof( gsv_t ) );
+                cur_sentence->num_sentences = num_sentences;
+                cur_sentence->sentence = tmp_num;
             }
             break;
         case GSV_NUM_SATS:
@@ -576,7 +732,7 @@ static void process_gsv( char *sentence )
             break;
         case GSV_SNR1:
             if( field( GSV_SNR1 ) )
-                cur_sentence->sat_info[0].azimuth = get_num( token( GSV_SNR1 ) );
+                cur_sentence->sat_info[0].snr = get_num( token( GSV_SNR1 ) );
             break;
         case GSV_SAT2_PRN:
             if( field( GSV_SAT2_PRN) )
@@ -592,7 +748,7 @@ static void process_gsv( char *sentence )
             break;
         case GSV_SNR2:
             if( field( GSV_SNR2 ) )
-                cur_sentence->sat_info[1].azimuth = get_num( token( GSV_SNR2 ) );
+                cur_sentence->sat_info[1].snr = get_num( token( GSV_SNR2 ) );
             break;
         case GSV_SAT3_PRN:
             if( field( GSV_SAT3_PRN) )
@@ -608,7 +764,7 @@ static void process_gsv( char *sentence )
             break;
         case GSV_SNR3:
             if( field( GSV_SNR3 ) )
-                cur_sentence->sat_info[2].azimuth = get_num( token( GSV_SNR3 ) );
+                cur_sentence->sat_info[2].snr = get_num( token( GSV_SNR3 ) );
             break;
         case GSV_SAT4_PRN:
             if( field( GSV_SAT4_PRN) )
@@ -624,17 +780,19 @@ static void process_gsv( char *sentence )
             break;
         case GSV_SNR4:
             if( field( GSV_SNR4 ) )
-                cur_sentence->sat_info[3].azimuth = get_num( token( GSV_SNR4 ) );
+                cur_sentence->sat_info[3].snr = get_num( token( GSV_SNR4 ) );
             break;
         };
     }
     return;
 }
+#endif
 
 
+#ifdef RMC
 static void process_rmc( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -643,10 +801,7 @@ static void process_rmc( char *sentence )
         {
         case RMC_FIX:
             if( field( RMC_FIX ) )
-            {
-                cur_rmc.fix_time = &cur_fix;
-                get_time( token( RMC_FIX ), cur_rmc.fix_time );
-            }
+                get_time( token( RMC_FIX ), &cur_fix );
             break;
         case RMC_STATUS:
             if( field( RMC_STATUS ) )
@@ -661,38 +816,32 @@ static void process_rmc( char *sentence )
             break;
         case RMC_LAT:
             if( field( RMC_LAT ) )
-            {
-                cur_rmc.lat = &cur_latitude;
-                get_location( token( RMC_LAT ), cur_rmc.lat, LOCATION_LAT );
-            }
+                get_location( token( RMC_LAT ), &cur_latitude, LOCATION_LAT );
             break;
         case RMC_LAT_AZMUTH:
             if( field( RMC_LAT_AZMUTH ) )
             {
                 if( field( RMC_LAT_AZMUTH ) == 'N' )
-                    cur_rmc.lat->azmuth = NORTH;
+                    cur_latitude.azmuth = NORTH;
                 else if( field( RMC_LAT_AZMUTH ) == 'S' )
-                    cur_rmc.lat->azmuth = SOUTH;
+                    cur_latitude.azmuth = SOUTH;
                 else
-                    cur_rmc.lat->azmuth = UNKNOWN;
+                    cur_latitude.azmuth = UNKNOWN;
             }
             break;
         case RMC_LON:
             if( field( RMC_LON ) )
-            {
-                cur_rmc.lon = &cur_longitude;
-                get_location( token( RMC_LON ), cur_rmc.lon, LOCATION_LON );
-            }
+                get_location( token( RMC_LON ), &cur_longitude, LOCATION_LON );
             break;
         case RMC_LON_AZMUTH:
             if( field( RMC_LON_AZMUTH ) )
             {
                 if( field( RMC_LON_AZMUTH ) == 'W' )
-                    cur_rmc.lon->azmuth = WEST;
+                    cur_longitude.azmuth = WEST;
                 else if( field( RMC_LON_AZMUTH ) == 'E' )
-                    cur_rmc.lon->azmuth = EAST;
+                    cur_longitude.azmuth = EAST;
                 else
-                    cur_rmc.lon->azmuth = UNKNOWN;
+                    cur_longitude.azmuth = UNKNOWN;
             }
             break;
         case RMC_SPEED:
@@ -705,10 +854,7 @@ static void process_rmc( char *sentence )
             break;
         case RMC_DATE:
             if( field( RMC_DATE ) )
-            {
-                cur_rmc.date = &cur_time;
-                get_date( token( RMC_DATE ), cur_rmc.date );
-            }
+                get_date( token( RMC_DATE ), &cur_time );
             break;
         case RMC_MAG:
             if( field( RMC_MAG ) )
@@ -729,14 +875,29 @@ static void process_rmc( char *sentence )
                     cur_rmc.magnetic.azmuth = UNKNOWN;
             }
             break;
+        case RMC_MODE:
+            if( field( RMC_MODE ) )
+            {
+                if( field( RMC_MODE ) == 'A' )
+                    cur_rmc.mode = RMC_AUTONOMOUS;
+                else if( field( RMC_MODE ) == 'D' )
+                    cur_rmc.mode = RMC_DIFFERENTIAL;
+                else if( field( RMC_MODE ) == 'N' )
+                    cur_rmc.mode = RMC_NOT_VALID;
+                else
+                    cur_rmc.mode = RMC_UKNOWN;
+            }
+            break;
         };
     }
     return;
 }
+#endif
 
+#ifdef VTG
 static void process_vtg( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -749,25 +910,26 @@ static void process_vtg( char *sentence )
             break;
         case VTG_MAG_TRACK:
             if( field( VTG_MAG_TRACK ) )
-                cur_vtg.track = get_num_float( token( VTG_MAG_TRACK ) );
+                cur_vtg.mag_track = get_num_float( token( VTG_MAG_TRACK ) );
             break;
         case VTG_SPEED_KNOTS:
             if( field( VTG_SPEED_KNOTS ) )
-                cur_vtg.track = get_num_float( token( VTG_SPEED_KNOTS ) );
+                cur_vtg.speed_knots = get_num_float( token( VTG_SPEED_KNOTS ) );
             break;
         case VTG_SPEED_KM:
             if( field( VTG_SPEED_KM ) )
-                cur_vtg.track = get_num_float( token( VTG_SPEED_KM ) );
+                cur_vtg.speed_km = get_num_float( token( VTG_SPEED_KM ) );
             break;
         };
     }
     return;
 }
+#endif
 
 #ifdef DTM
 static void process_dtm( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -861,7 +1023,7 @@ static void process_dtm( char *sentence )
 #ifdef GBS
 static void process_gbs( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -870,10 +1032,7 @@ static void process_gbs( char *sentence )
         {
         case GBS_UTC:
             if( field( GBS_UTC ) )
-            {
-                cur_gbs.fix_time = &cur_fix;
-                get_time( token( GBS_UTC ), cur_gbs.fix_time );
-            }
+                get_time( token( GBS_UTC ), &cur_fix );
             break;
         case GBS_LAT_ERROR:
             if( field( GBS_LAT_ERROR ) )
@@ -911,10 +1070,13 @@ static void process_gbs( char *sentence )
 #ifdef GPQ
 static void process_gpq( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
 
     if( fields->tokens[0][0] != '\0' )
-        strcpy( cur_gpq.id, fields->tokens[0] );
+    {
+        strncpy( cur_gpq.id, fields->tokens[0], sizeof( cur_gpq.id ) - 1 );
+        cur_gpq.id[ sizeof( cur_gpq.id ) - 1 ] = '\0';
+    }
     return;
 }
 #endif
@@ -922,7 +1084,7 @@ static void process_gpq( char *sentence )
 #ifdef GRS
 static void process_grs( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -931,10 +1093,7 @@ static void process_grs( char *sentence )
         {
         case GRS_UTC:
             if( field( GRS_UTC ) )
-            {
-                cur_grs.fix_time = &cur_fix;
-                get_time( token( GRS_UTC ), cur_grs.fix_time );
-            }
+                get_time( token( GRS_UTC ), &cur_fix );
             break;
         case GRS_MODE:
             if( field( GRS_MODE ) )
@@ -953,7 +1112,7 @@ static void process_grs( char *sentence )
 #ifdef GST
 static void process_gst( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
     for( i = 0; i < fields->num_of_fields; i++ )
@@ -962,10 +1121,7 @@ static void process_gst( char *sentence )
         {
         case GST_UTC:
             if( field( GST_UTC ) )
-            {
-                cur_gst.fix_time = &cur_fix;
-                get_time( token( GST_UTC ), cur_gst.fix_time );
-            }
+                get_time( token( GST_UTC ), &cur_fix );
             break;
         case GST_RMS:
             if( field( GST_RMS ) )
@@ -1004,7 +1160,7 @@ static void process_gst( char *sentence )
 #ifdef THS
 static void process_ths( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
 
     if( fields->tokens[ 0 ][ 0 ] != '\0' )
         cur_ths.heading = get_num_float( fields->tokens[ 0 ] );
@@ -1032,7 +1188,7 @@ static void process_ths( char *sentence )
 #ifdef TXT
 static void process_txt( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, TXT_MESSGE );
     int i;
     txt_t *tmptxt = &cur_txt[0];
 
@@ -1049,7 +1205,7 @@ static void process_txt( char *sentence )
             {
                 uint8_t tmpnum = get_num( token( TXT_MESSAGE_NUM) );
 
-                if( tmpnum <= MAX_TXT_PACKAGES )
+                if( tmpnum >= 1 && tmpnum <= MAX_TXT_PACKAGES )
                 {
                     tmptxt = &cur_txt[ tmpnum -1 ];
                 }
@@ -1061,7 +1217,10 @@ static void process_txt( char *sentence )
             break;
         case TXT_MESSGE:
             if( field( TXT_MESSGE ) )
-                strcpy( tmptxt->mesg, token( TXT_MESSGE ) );
+            {
+                strncpy( tmptxt->mesg, token( TXT_MESSGE ), MAX_TXT_SIZE - 1 );
+                tmptxt->mesg[ MAX_TXT_SIZE - 1 ] = '\0';
+            }
             break;
         };
     }
@@ -1073,11 +1232,9 @@ static void process_txt( char *sentence )
 #ifdef ZDA
 static void process_zda( char *sentence )
 {
-    fields_t *fields = parse_fields( sentence );
+    fields_t *fields = parse_fields( sentence, NO_TEXT );
     int i;
 
-    cur_zda.time = &cur_time;
-
     for( i = 0; i < fields->num_of_fields; i++ )
     {
         switch( i )
@@ -1085,24 +1242,23 @@ static void process_zda( char *sentence )
         case ZDA_TIME:
             if( field( ZDA_TIME ) )
             {
-                utc_time_t tmp_time;
-                get_time( token( ZDA_TIME ), &tmp_time );
-                cur_zda.time->hh = tmp_time.hour;
-                cur_zda.time->mn = tmp_time.minute;
-                cur_zda.time->ss = tmp_time.second;
+                get_time( token( ZDA_TIME ), &cur_fix );
+                cur_time.hh = cur_fix.hour;
+                cur_time.mn = cur_fix.minute;
+                cur_time.ss = cur_fix.second;
             }
             break;
         case ZDA_DAY:
             if( field( ZDA_DAY ) )
-                cur_zda.time->md = get_num( token( ZDA_DAY ) );
+                cur_time.md = get_num( token( ZDA_DAY ) );
             break;
         case ZDA_MONTH:
             if( field( ZDA_MONTH ) )
-                cur_zda.time->mo = get_num( token( ZDA_MONTH ) );
+                cur_time.mo = get_num( token( ZDA_MONTH ) );
             break;
         case ZDA_YEAR:
             if( field( ZDA_YEAR ) )
-                cur_zda.time->yy = get_num( token( ZDA_YEAR ) );
+                cur_time.yy = get_num( token( ZDA_YEAR ) );
             break;
         case ZDA_LOCAL_HOURS:
             if( field( ZDA_LOCAL_HOURS ) )
@@ -1119,33 +1275,42 @@ static void process_zda( char *sentence )
 #endif
 
 
-static fields_t* parse_fields( char *sentence )
+static fields_t* parse_fields( char *sentence, int8_t text_field )
 {
-    static fields_t tmp_fields;
     char *p_sentence = sentence;
-    char *p_next = strchr( p_sentence, '*' );
+    char *p_next;
+    TRACE_BEGIN( start );
 
-    tmp_fields.num_of_fields = 0;
-    memset( &tmp_fields, 0, sizeof( fields_t ) );
+    p_next = strchr( p_sentence, '*' );
+    memset( &sentence_fields, 0, sizeof( fields_t ) );
 
-    *p_next = '\0'; // Replace start of checksum with null
+    if( p_next != 0 )
+        *p_next = '\0'; // Replace start of checksum with null
     p_sentence = strchr( p_sentence, ',' ); /* Moves us to the first, which is just past the identifier */
 
-    do
+    while( p_sentence != 0 && sentence_fields.num_of_fields < MAX_FIELDS )
     {
+        size_t len, room;
+        char *p_token = sentence_fields.tokens[ sentence_fields.num_of_fields++ ];
+
         p_sentence++;
         p_next = strchr( p_sentence, ',' );     /* Gets the next , so we can calculate the number of bytes to copy */
+        len = ( p_next != 0 ) ? ( size_t )( p_next - p_sentence ) : strlen( p_sentence );
 
-        if( p_next != 0 )
-            memcpy( tmp_fields.tokens[tmp_fields.num_of_fields++], p_sentence, p_next - p_sentence );
+        /* Only the text, when it is the last field, may run on into the unused
+           tokens, every other field is cut to its token */
+        if( p_next == 0 && sentence_fields.num_of_fields - 1 == text_field )
+            room = ( char * )sentence_fields.tokens + sizeof( sentence_fields.tokens ) - p_token - 1;
         else
-            strcpy( tmp_fields.tokens[tmp_fields.num_of_fields++], p_sentence );
+            room = MAX_FIELD_SIZE - 1;
+
+        memcpy( p_token, p_sentence, ( len < room ) ? len : room );
 
         p_sentence = p_next;
     }
-    while( p_sentence != 0 );
 
-    return &tmp_fields;
+    TRACE_END( GPS_TRACE_FIELDS, start );
+    return &sentence_fields;
 }
 
 
@@ -1176,41 +1341,38 @@ static int get_num( char *str )
     return num;
 }
 
+#ifdef NEED_TIME
 static void get_time( char *str, utc_time_t *time )
 {
-    char tmp[4] = {0}, *p_tmp = str;
-    int i, runcount;
-    void *tmp_time = ( void* )time;
+    char tmp[ 3 ] = { 0 };
+    char *p_frac = strchr( str, '.' );
+    uint16_t scale = 100;
 
-    if( strchr( str, '.' ) )
-        runcount = 4;
-    else
-        runcount = 3;
+    if( strlen( str ) < 6 )
+        return;
+
+    strncpy( tmp, str, 2 );
+    time->hour = get_num( tmp );
+    strncpy( tmp, str + 2, 2 );
+    time->minute = get_num( tmp );
+    strncpy( tmp, str + 4, 2 );
+    time->second = get_num( tmp );
+    time->ms = 0;
 
-    for( i = 0; i < runcount; i++ )
+    if( p_frac != 0 )
     {
-        if( *p_tmp == '.' )
+        while( isdigit( *++p_frac ) && scale > 0 )
         {
-            p_tmp++;
-            strncpy( tmp, p_tmp, 3 );
-            tmp[3] = 0;
-        }
-        else
-        {
-            strncpy( tmp, p_tmp, 2 );
-            tmp[2] = 0;
+            time->ms += ( *p_frac - '0' ) * scale;
+            scale /= 10;
         }
-
-        *( uint8_t* )tmp_time = get_num( tmp );
-
-        p_tmp += 2;
-
-        ( uint8_t* )tmp_time++;
     }
 
     return;
 }
+#endif
 
+#ifdef RMC
 static void get_date( char *str, TimeStruct *ts )
 {
     char tmp[3] = {0};
@@ -1220,14 +1382,16 @@ static void get_date( char *str, TimeStruct *ts )
     ts->md = get_num( tmp );
     p_str += 2;
     strncpy( tmp, p_str, 2 );
-    ts->mn = get_num( tmp );
+    ts->mo = get_num( tmp );
     p_str += 2;
     strncpy( tmp, p_str, 2 );
     ts->yy = 2000 + get_num( tmp );
 
     return;
 }
+#endif
 
+#ifdef NEED_LOCATION
 static void get_location( char *str, location_t *location, int type )
 {
     if( location != 0 )
@@ -1246,12 +1410,14 @@ static void get_location( char *str, location_t *location, int type )
         }
 
         location->degrees = get_num( tmp );
-        strcpy( tmp, p_tmp );
-        location->minutes = get_num( tmp );
+        strncpy( tmp, p_tmp, sizeof( tmp ) - 1 );
+        tmp[ sizeof( tmp ) - 1 ] = '\0';
+        location->minutes = get_num_float( tmp );
     }
 
     return;
 }
+#endif
 
 // Only needed on platforms other than mikroC
 #ifdef ON_PC
@@ -1284,7 +1450,6 @@ static int xtoi( char *hexstring )
 bool validate_checksum( char *sentence )
 {
     bool flagValid = true;
-    char text[80];
 
     if( sentence[ 0 ] != '$' )
     {
@@ -1302,8 +1467,11 @@ bool validate_checksum( char *sentence )
         current_char = sentence[position++]; // get first chr
         chksum = current_char;
 
-        while( ( current_char != '*' ) && ( position < BUFFER_MAX ) )
+        while( ( current_char != '*' ) && ( position < BUFFER_MAX - 2 ) )
         {
+            if( current_char == '\0' )
+                return false; // Line ended without a checksum
+
             current_char = sentence[ position ]; // get next chr
 
             if( current_char != '*' )
@@ -1338,72 +1506,436 @@ bool validate_checksum( char *sentence )
     return flagValid;
 }
 
-// Router for incoming complete sentences
-static void gps_process_sentence( char *sentence )
+// Identifies the sentence from its address field
+static gps_sentence_t sentence_type( const char *sentence )
 {
-#define MAX_COMPARE 5
-    char *process_sentence = sentence;
-
-    if( !validate_checksum( process_sentence ) )
-        return;
-
-    if( !strncmp( sentence, "$GPGGA", MAX_COMPARE ) )
-        process_gga( process_sentence );
+#define MAX_COMPARE 6
+    if( sentence[ 0 ] != '$' )
+        return GPS_SENTENCE_UNKNOWN;
+#ifdef GGA
     else if( !strncmp( sentence, "$GPGGA", MAX_COMPARE ) )
-        process_gga( process_sentence );
+        return GPS_SENTENCE_GGA;
+#endif
+#ifdef GLL
     else if( !strncmp( sentence, "$GPGLL", MAX_COMPARE ) )
-        process_gll( process_sentence );
+        return GPS_SENTENCE_GLL;
+#endif
+#ifdef GSA
     else if( !strncmp( sentence, "$GPGSA", MAX_COMPARE ) )
-        process_gsa( process_sentence );
+        return GPS_SENTENCE_GSA;
+#endif
+#ifdef GSV
     else if( !strncmp( sentence, "$GPGSV", MAX_COMPARE ) )
-        process_gsv( process_sentence );
+        return GPS_SENTENCE_GSV;
+#endif
+#ifdef RMC
     else if( !strncmp( sentence, "$GPRMC", MAX_COMPARE ) )
-        process_rmc( process_sentence );
+        return GPS_SENTENCE_RMC;
+#endif
+#ifdef VTG
     else if( !strncmp( sentence, "$GPVTG", MAX_COMPARE ) )
-        process_vtg( process_sentence );
+        return GPS_SENTENCE_VTG;
+#endif
 #ifdef DTM
     else if( !strncmp( sentence, "$GPDTM", MAX_COMPARE ) )
-        process_dtm( process_sentence );
+        return GPS_SENTENCE_DTM;
 #endif
 #ifdef GBS
     else if( !strncmp( sentence, "$GPGBS", MAX_COMPARE ) )
-        process_gbs( process_sentence );
+        return GPS_SENTENCE_GBS;
 #endif
 #ifdef GPQ
     else if( !strncmp( sentence, "$GPGPQ", MAX_COMPARE ) )
-        process_gpq( process_sentence );
+        return GPS_SENTENCE_GPQ;
 #endif
 #ifdef GRS
     else if( !strncmp( sentence, "$GPGRS", MAX_COMPARE ) )
-        process_grs( process_sentence );
+        return GPS_SENTENCE_GRS;
 #endif
 #ifdef GST
     else if( !strncmp( sentence, "$GPGST", MAX_COMPARE ) )
-        process_gst( process_sentence );
+        return GPS_SENTENCE_GST;
 #endif
 #ifdef THS
     else if( !strncmp( sentence, "$GPTHS", MAX_COMPARE ) )
-        process_ths( process_sentence );
+        return GPS_SENTENCE_THS;
 #endif
 #ifdef TXT
     else if( !strncmp( sentence, "$GPTXT", MAX_COMPARE ) )
-        process_txt( process_sentence );
+        return GPS_SENTENCE_TXT;
 #endif
 #ifdef ZDA
     else if( !strncmp( sentence, "$GPZDA", MAX_COMPARE ) )
-        process_zda( process_sentence );
+        return GPS_SENTENCE_ZDA;
+#endif
+    return GPS_SENTENCE_UNKNOWN;
+}
+
+// Router for incoming complete sentences
+static void gps_process_sentence( char *sentence )
+{
+    gps_sentence_t type = sentence_type( sentence );
+    bool valid;
+    TRACE_BEGIN( start );
+
+    valid = validate_checksum( sentence );
+    TRACE_END( GPS_TRACE_CHECKSUM, start );
+
+    if( !valid )
+    {
+        STAT_INC( failed[ type ] );
+        return;
+    }
+
+    TRACE_RESTART( start );
+    switch( type )
+    {
+#ifdef GGA
+    case GPS_SENTENCE_GGA:
+        process_gga( sentence );
+        break;
+#endif
+#ifdef GLL
+    case GPS_SENTENCE_GLL:
+        process_gll( sentence );
+        break;
+#endif
+#ifdef GSA
+    case GPS_SENTENCE_GSA:
+        process_gsa( sentence );
+        break;
+#endif
+#ifdef GSV
+    case GPS_SENTENCE_GSV:
+        process_gsv( sentence );
+        break;
+#endif
+#ifdef RMC
+    case GPS_SENTENCE_RMC:
+        process_rmc( sentence );
+        break;
+#endif
+#ifdef VTG
+    case GPS_SENTENCE_VTG:
+        process_vtg( sentence );
+        break;
+#endif
+#ifdef DTM
+    case GPS_SENTENCE_DTM:
+        process_dtm( sentence );
+        break;
+#endif
+#ifdef GBS
+    case GPS_SENTENCE_GBS:
+        process_gbs( sentence );
+        break;
+#endif
+#ifdef GPQ
+    case GPS_SENTENCE_GPQ:
+        process_gpq( sentence );
+        break;
+#endif
+#ifdef GRS
+    case GPS_SENTENCE_GRS:
+        process_grs( sentence );
+        break;
+#endif
+#ifdef GST
+    case GPS_SENTENCE_GST:
+        process_gst( sentence );
+        break;
+#endif
+#ifdef THS
+    case GPS_SENTENCE_THS:
+        process_ths( sentence );
+        break;
+#endif
+#ifdef TXT
+    case GPS_SENTENCE_TXT:
+        process_txt( sentence );
+        break;
+#endif
+#ifdef ZDA
+    case GPS_SENTENCE_ZDA:
+        process_zda( sentence );
+        break;
 #endif
+    default:
+        STAT_INC( unknown );
+        return;
+    }
+
+    TRACE_END( GPS_TRACE_PROCESS + type, start );
+    STAT_INC( parsed[ type ] );
+
+#ifdef GPS_TIMESTAMPS
+    sentence_times[ type ].first_byte = process_first;
+    sentence_times[ type ].last_byte = process_last;
+    sentence_times[ type ].decoded = GPS_TIMESTAMP_NOW();
+#endif
+    epoch_update( type );
     return;
 }
 
 
 
+
+// Merges what the processed sentence reported into the open epoch
+static void epoch_update( gps_sentence_t type )
+{
+    fields_t *fields = &sentence_fields;
+    int time_field = -1;
+
+    switch( type )
+    {
+#ifdef GGA
+    case GPS_SENTENCE_GGA:
+        time_field = GGA_fix_tIME;
+        break;
+#endif
+#ifdef GLL
+    case GPS_SENTENCE_GLL:
+        time_field = GLL_fix_tIME;
+        break;
+#endif
+#ifdef RMC
+    case GPS_SENTENCE_RMC:
+        time_field = RMC_FIX;
+        break;
+#endif
+#ifdef GBS
+    case GPS_SENTENCE_GBS:
+        time_field = GBS_UTC;
+        break;
+#endif
+#ifdef GRS
+    case GPS_SENTENCE_GRS:
+        time_field = GRS_UTC;
+        break;
+#endif
+#ifdef GST
+    case GPS_SENTENCE_GST:
+        time_field = GST_UTC;
+        break;
+#endif
+#ifdef ZDA
+    case GPS_SENTENCE_ZDA:
+        time_field = ZDA_TIME;
+        break;
+#endif
+    default:
+        break;
+    }
+
+    /* A new fix time starts a new epoch */
+    if( time_field >= 0 && field( time_field ) )
+    {
+        if( ( open_epoch.fields & GPS_EPOCH_TIME ) &&
+            ( open_epoch.time.hour != cur_fix.hour ||
+              open_epoch.time.minute != cur_fix.minute ||
+              open_epoch.time.second != cur_fix.second ||
+              open_epoch.time.ms != cur_fix.ms ) )
+            epoch_close();
+
+        open_epoch.time = cur_fix;
+        open_epoch.fields |= GPS_EPOCH_TIME;
+    }
+
+    switch( type )
+    {
+#ifdef GGA
+    case GPS_SENTENCE_GGA:
+        if( field( GGA_LAT ) && field( GGA_LAT_AZMUTH ) &&
+            field( GGA_LON ) && field( GGA_LON_AZMUTH ) )
+        {
+            open_epoch.latitude = location_degrees( &cur_latitude );
+            open_epoch.longitude = location_degrees( &cur_longitude );
+            open_epoch.fields |= GPS_EPOCH_POSITION;
+        }
+        if( field( GGA_FIX_QUALITY ) )
+        {
+            open_epoch.quality = cur_gga.fix;
+            open_epoch.fields |= GPS_EPOCH_QUALITY;
+        }
+        if( field( GGA_NUM_SATS ) )
+        {
+            open_epoch.num_sats = cur_gga.num_sats;
+            open_epoch.fields |= GPS_EPOCH_SATS;
+        }
+        if( field( GGA_HORT_DIL ) )
+        {
+            open_epoch.hdop = cur_gga.horizontal;
+            open_epoch.fields |= GPS_EPOCH_HDOP;
+        }
+        if( field( GGA_ALT ) )
+        {
+            open_epoch.altitude = cur_gga.altitude;
+            open_epoch.fields |= GPS_EPOCH_ALTITUDE;
+        }
+        break;
+#endif
+#ifdef GLL
+    case GPS_SENTENCE_GLL:
+        if( field( GLL_LOCATION_LAT ) && field( GLL_LOCATION_LAT_AZMUTH ) &&
+            field( GLL_LOCATION_LON ) && field( GLL_LOCATION_LON_AZMUTH ) )
+        {
+            open_epoch.latitude = location_degrees( &cur_latitude );
+            open_epoch.longitude = location_degrees( &cur_longitude );
+            open_epoch.fields |= GPS_EPOCH_POSITION;
+        }
+        break;
+#endif
+#ifdef GSA
+    case GPS_SENTENCE_GSA:
+        if( field( GSA_HDOP ) )
+        {
+            open_epoch.hdop = cur_gsa.hdop;
+            open_epoch.fields |= GPS_EPOCH_HDOP;
+        }
+        break;
+#endif
+#ifdef RMC
+    case GPS_SENTENCE_RMC:
+        if( field( RMC_STATUS ) )
+        {
+            open_epoch.status = cur_rmc.status;
+            open_epoch.fields |= GPS_EPOCH_STATUS;
+        }
+        if( field( RMC_LAT ) && field( RMC_LAT_AZMUTH ) &&
+            field( RMC_LON ) && field( RMC_LON_AZMUTH ) )
+        {
+            open_epoch.latitude = location_degrees( &cur_latitude );
+            open_epoch.longitude = location_degrees( &cur_longitude );
+            open_epoch.fields |= GPS_EPOCH_POSITION;
+        }
+        if( field( RMC_SPEED ) )
+        {
+            open_epoch.speed = cur_rmc.speed;
+            open_epoch.fields |= GPS_EPOCH_SPEED;
+        }
+        if( field( RMC_TRACK ) )
+        {
+            open_epoch.track = cur_rmc.track;
+            open_epoch.fields |= GPS_EPOCH_TRACK;
+        }
+        if( field( RMC_DATE ) )
+        {
+            open_epoch.date = cur_time;
+            open_epoch.fields |= GPS_EPOCH_DATE;
+        }
+        break;
+#endif
+#ifdef VTG
+    case GPS_SENTENCE_VTG:
+        if( field( VTG_TRACK ) )
+        {
+            open_epoch.track = cur_vtg.track;
+            open_epoch.fields |= GPS_EPOCH_TRACK;
+        }
+        if( field( VTG_SPEED_KNOTS ) )
+        {
+            open_epoch.speed = cur_vtg.speed_knots;
+            open_epoch.fields |= GPS_EPOCH_SPEED;
+        }
+        break;
+#endif
+#ifdef ZDA
+    case GPS_SENTENCE_ZDA:
+        if( field( ZDA_DAY ) && field( ZDA_MONTH ) && field( ZDA_YEAR ) )
+        {
+            open_epoch.date = cur_time;
+            open_epoch.fields |= GPS_EPOCH_DATE;
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+
+#ifdef GPS_TIMESTAMPS
+    if( open_epoch.sentences == 0 )
+        open_epoch.first_byte = process_first;
+    open_epoch.last_byte = process_last;
+#endif
+    open_epoch.sentences |= ( uint16_t )1 << type;
+
+#ifdef GPS_EPOCH_END
+    if( type == GPS_EPOCH_END )
+        epoch_close();
+#endif
+}
+
+static void epoch_close()
+{
+    if( open_epoch.sentences == 0 )
+        return;
+
+    open_epoch.epoch = ++epoch_count;
+#ifdef GPS_TIMESTAMPS
+    open_epoch.decoded = GPS_TIMESTAMP_NOW();
+#endif
+    last_epoch = open_epoch;
+    memset( &open_epoch, 0, sizeof( gps_epoch_t ) );
+}
+
+#ifdef NEED_LOCATION
+static double location_degrees( const location_t *location )
+{
+    double degrees = location->degrees + location->minutes / 60.0;
+
+    if( location->azmuth == SOUTH || location->azmuth == WEST )
+        degrees = -degrees;
+
+    return degrees;
+}
+#endif
+
+#if defined( GPS_TIMESTAMPS ) && defined( ON_PC )
+static gps_timestamp_t timestamp_now()
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( gps_timestamp_t )ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+#ifdef GPS_TRACE
+// Accumulates one stage measurement
+static void trace_record( int stage, gps_cycles_t cycles )
+{
+    volatile gps_trace_stage_t *st = &trace.stage[ stage ];
+    gps_cycles_t limit = ( gps_cycles_t )1 << GPS_TRACE_BUCKET_SHIFT;
+    uint8_t bucket = 0;
+
+    while( cycles >= limit && bucket < GPS_TRACE_BUCKETS - 1 )
+    {
+        limit <<= 1;
+        bucket++;
+    }
+
+    trace.sequence++;
+    if( st->count == 0 || cycles < st->min )
+        st->min = cycles;
+    if( cycles > st->max )
+        st->max = cycles;
+
+    st->count++;
+    st->total += cycles;
+    st->buckets[ bucket ]++;
+    trace.sequence++;
+}
+#endif
+
 /*******************************
  *     Public Functions
  * ****************************/
 void gps_put( char input )
 {
     static bool sentence_flag;
+    TRACE_BEGIN( start );
+
+    STAT_INC( bytes );
 
     if( ( input != '\r' && input != '\n' ) && buffer_position < BUFFER_MAX )
     {
@@ -1413,19 +1945,52 @@ void gps_put( char input )
     {
         sentence_flag = true;
     }
-    else if( input == '\n' && sentence_flag )
+    else if( input == '\n' && sentence_flag && buffer_position < BUFFER_MAX )
     {
+#ifdef GPS_STATS
+        if( process_flag )
+            STAT_INC( dropped[ sentence_type( process_buffer ) ] );
+
+        if( buffer_position > stats.max_length )
+            stats.max_length = buffer_position;
+#endif
         buffer[ buffer_position ] = '\0';
         buffer_position = 0;
-        strcpy( process_buffer, buffer );
+        strcpy( process_buffer, ( char * )buffer );
+#ifdef GPS_TIMESTAMPS
+        process_first = line_first;
+        process_last = line_last;
+#endif
         sentence_flag = false;
         process_flag = true;
     }
     else
     {
+        if( buffer_position >= BUFFER_MAX )
+            STAT_INC( overflows );
+
         buffer_position = 0; /* invalid something or other */
     }
+
+    TRACE_END( GPS_TRACE_PUT, start );
+}
+
+#ifdef GPS_TIMESTAMPS
+void gps_put_ts( char input, gps_timestamp_t ts )
+{
+    if( buffer_position == 0 )
+        line_first = ts;
+
+    line_last = ts;
+    gps_put( input );
+}
+
+void gps_put_block_ts( const char *data, uint16_t len, gps_timestamp_t ts )
+{
+    while( len-- )
+        gps_put_ts( *data++, ts );
 }
+#endif
 
 void gps_parse()
 {
@@ -1437,6 +2002,187 @@ void gps_parse()
     return;
 }
 
+const char *gps_sentence_name( gps_sentence_t type )
+{
+    static const char *names[ GPS_SENTENCE_COUNT ] =
+    {
+        "???", "GGA", "GLL", "GSA", "GSV", "RMC", "VTG", "DTM",
+        "GBS", "GPQ", "GRS", "GST", "THS", "TXT", "ZDA"
+    };
+
+    if( type >= GPS_SENTENCE_COUNT )
+        type = GPS_SENTENCE_UNKNOWN;
+
+    return names[ type ];
+}
+
+#ifdef GPS_FOOTPRINT
+void gps_footprint( gps_footprint_t *fp )
+{
+    int i;
+
+    memset( fp, 0, sizeof( gps_footprint_t ) );
+
+    /* gps_put keeps one more bool of its own */
+    fp->buffers = sizeof( buffer ) + sizeof( process_buffer ) +
+                  sizeof( buffer_position ) + sizeof( process_flag ) + sizeof( bool );
+    fp->fields = sizeof( sentence_fields );
+    fp->common = sizeof( cur_longitude ) + sizeof( cur_latitude ) + sizeof( cur_time ) +
+                 sizeof( cur_fix ) + sizeof( open_epoch ) + sizeof( last_epoch ) +
+                 sizeof( epoch_count );
+
+#ifdef GGA
+    fp->sentence[ GPS_SENTENCE_GGA ] = sizeof( cur_gga );
+#endif
+#ifdef GLL
+    fp->sentence[ GPS_SENTENCE_GLL ] = sizeof( cur_gll );
+#endif
+#ifdef GSA
+    fp->sentence[ GPS_SENTENCE_GSA ] = sizeof( cur_gsa );
+#endif
+#ifdef GSV
+    fp->sentence[ GPS_SENTENCE_GSV ] = sizeof( cur_gsv );
+#endif
+#ifdef RMC
+    fp->sentence[ GPS_SENTENCE_RMC ] = sizeof( cur_rmc );
+#endif
+#ifdef VTG
+    fp->sentence[ GPS_SENTENCE_VTG ] = sizeof( cur_vtg );
+#endif
+#ifdef DTM
+    fp->sentence[ GPS_SENTENCE_DTM ] = sizeof( cur_dtm );
+#endif
+#ifdef GBS
+    fp->sentence[ GPS_SENTENCE_GBS ] = sizeof( cur_gbs );
+#endif
+#ifdef GPQ
+    fp->sentence[ GPS_SENTENCE_GPQ ] = sizeof( cur_gpq );
+#endif
+#ifdef GRS
+    fp->sentence[ GPS_SENTENCE_GRS ] = sizeof( cur_grs );
+#endif
+#ifdef GST
+    fp->sentence[ GPS_SENTENCE_GST ] = sizeof( cur_gst );
+#endif
+#ifdef THS
+    fp->sentence[ GPS_SENTENCE_THS ] = sizeof( cur_ths );
+#endif
+#ifdef TXT
+    fp->sentence[ GPS_SENTENCE_TXT ] = sizeof( cur_txt );
+#endif
+#ifdef ZDA
+    fp->sentence[ GPS_SENTENCE_ZDA ] = sizeof( cur_zda );
+#endif
+
+    for( i = 0; i < GPS_SENTENCE_COUNT; i++ )
+        fp->sentences += fp->sentence[ i ];
+
+#ifdef GPS_STATS
+    fp->diagnostics += sizeof( stats );
+#endif
+#ifdef GPS_TRACE
+    fp->diagnostics += sizeof( trace ) + 12;    /* + stage name buffer */
+#endif
+#ifdef GPS_TIMESTAMPS
+    fp->diagnostics += 4 * sizeof( gps_timestamp_t ) + sizeof( sentence_times );
+#endif
+
+    fp->total = fp->buffers + fp->fields + fp->common + fp->sentences + fp->diagnostics;
+}
+#endif
+
+uint32_t gps_last_epoch( gps_epoch_t *epoch )
+{
+    if( epoch != 0 )
+        *epoch = last_epoch;
+
+    return epoch_count;
+}
+
+void gps_epoch_flush()
+{
+    epoch_close();
+}
+
+#ifdef GPS_TIMESTAMPS
+void gps_sentence_times( gps_sentence_t type, gps_sentence_times_t *times )
+{
+    if( type >= GPS_SENTENCE_COUNT )
+        type = GPS_SENTENCE_UNKNOWN;
+
+    *times = sentence_times[ type ];
+}
+#endif
+
+#ifdef GPS_STATS
+void gps_stats_get( gps_stats_t *dest )
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = stats.sequence;
+        memcpy( dest, ( const void * )&stats, sizeof( gps_stats_t ) );
+    }
+    while( sequence != stats.sequence );
+}
+
+void gps_stats_reset()
+{
+    memset( ( void * )&stats, 0, sizeof( gps_stats_t ) );
+}
+#endif
+
+#ifdef GPS_TRACE
+void gps_trace_init()
+{
+#ifdef GPS_TRACE_DWT
+    *( volatile uint32_t * )0xE000EDFC |= 0x01000000; /* DEMCR.TRCENA */
+    *( volatile uint32_t * )0xE0001004 = 0;           /* DWT_CYCCNT */
+    *( volatile uint32_t * )0xE0001000 |= 0x00000001; /* DWT_CTRL.CYCCNTENA */
+#endif
+    gps_trace_reset();
+}
+
+void gps_trace_get( gps_trace_t *dest )
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = trace.sequence;
+        memcpy( dest, ( const void * )&trace, sizeof( gps_trace_t ) );
+    }
+    while( sequence != trace.sequence );
+}
+
+void gps_trace_reset()
+{
+    memset( ( void * )&trace, 0, sizeof( gps_trace_t ) );
+}
+
+const char *gps_trace_stage_name( int stage )
+{
+    static char name[ 12 ] = "process ";
+
+    if( stage == GPS_TRACE_PUT )
+        return "put";
+    else if( stage == GPS_TRACE_CHECKSUM )
+        return "checksum";
+    else if( stage == GPS_TRACE_FIELDS )
+        return "fields";
+    else if( stage >= GPS_TRACE_PROCESS && stage < GPS_TRACE_STAGES )
+    {
+        gps_sentence_t type = ( gps_sentence_t )( stage - GPS_TRACE_PROCESS );
+
+        strcpy( &name[ 8 ], gps_sentence_name( type ) );
+        return name;
+    }
+
+    return "???";
+}
+#endif
+
 /***************** Common ***************/
 location_t* gps_current_lon()
 {
@@ -1459,6 +2205,7 @@ utc_time_t* gps_current_fix()
 }
 
 /****************** GGA ******************/
+#ifdef GGA
 fix_t gps_gga_fix_quality()
 {
     return cur_gga.fix;
@@ -1493,14 +2240,18 @@ uint16_t gps_gga_DGPS_stationID()
 {
     return cur_gga.station_id;
 }
+#endif
 
 /***************** GLL ******************/
+#ifdef GLL
 ACTIVE_t gps_gll_active()
 {
     return cur_gll.active;
 }
+#endif
 
 /***************** GSA ******************/
+#ifdef GSA
 GSA_MODE_t gps_gsa_mode()
 {
     return cur_gsa.mode;
@@ -1530,10 +2281,21 @@ float gps_gsa_vertical_dilution()
 {
     return cur_gsa.vdop;
 }
+#endif
 
 /***************** GSV *****************/
-// TODO: Must combine sat info and clear
+#ifdef GSV
+gsv_t *gps_gsv_message( uint8_t number )
+{
+    if( number < 1 || number > MAX_GSV_SENTENCES )
+        return 0;
+
+    return &cur_gsv[ number - 1 ];
+}
+#endif
+
 /***************** RMC *****************/
+#ifdef RMC
 GPS_STATUS_t gps_rmc_status()
 {
     return cur_rmc.status;
@@ -1563,8 +2325,10 @@ GPS_STATUS_t gps_rmc_mode()
 {
     return cur_rmc.mode;
 }
+#endif
 
 /**************** VTG *****************/
+#ifdef VTG
 double gps_vtg_track()
 {
     return cur_vtg.track;
@@ -1584,6 +2348,7 @@ double gps_vtg_speedkm()
 {
     return cur_vtg.speed_km;
 }
+#endif
 
 #ifdef DTM
 datum_code_t gps_dtm_local()
@@ -1739,6 +2504,13 @@ vehicle_status_t gps_ths_status()
 #endif
 
 #ifdef ZDA
-uint8_t gps_zda_local_hour( void );
-uint8_t gps_zda_local_min( void );
+uint8_t gps_zda_local_hour( void )
+{
+    return cur_zda.local_hour;
+}
+
+uint8_t gps_zda_local_min( void )
+{
+    return cur_zda.local_min;
+}
 #endif
\ No newline at end of file
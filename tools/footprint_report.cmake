@@ -0,0 +1,41 @@
+# Runs every gps_footprint_<profile> and writes a markdown table of the
+# static RAM and code size per receiver profile.
+#
+#   ENTRIES   ,exe|object,exe|object...
+#   SIZE_TOOL binutils size, optional
+#   OUTPUT    markdown file
+
+string( REPLACE "," ";" entries "${ENTRIES}" )
+
+set( report "| profile | buffers | fields | common | sentences | diagnostics | RAM | code |\n" )
+set( report "${report}|---|---:|---:|---:|---:|---:|---:|---:|\n" )
+
+foreach( entry ${entries} )
+    string( REPLACE "|" ";" parts "${entry}" )
+    list( GET parts 0 exe )
+    list( GET parts 1 object )
+
+    execute_process( COMMAND ${exe} --row
+        OUTPUT_VARIABLE row OUTPUT_STRIP_TRAILING_WHITESPACE RESULT_VARIABLE failed )
+    if( failed )
+        message( FATAL_ERROR "${exe} failed" )
+    endif()
+
+    set( code "n/a" )
+    if( SIZE_TOOL )
+        execute_process( COMMAND ${SIZE_TOOL} ${object}
+            OUTPUT_VARIABLE size_out OUTPUT_STRIP_TRAILING_WHITESPACE )
+        # berkeley format: text data bss dec hex filename
+        string( REGEX MATCH "\n *([0-9]+)" match "${size_out}" )
+        set( code "${CMAKE_MATCH_1}" )
+    endif()
+
+    string( REPLACE "," " | " cells "${row}" )
+    set( report "${report}| ${cells} | ${code} |\n" )
+endforeach()
+
+set( report "${report}\nBytes on the host compiler, code is the -Os text size of gps_parser.c.\n" )
+
+file( WRITE ${OUTPUT} "${report}" )
+message( "${report}" )
+message( "Written to ${OUTPUT}" )
@@ -0,0 +1,560 @@
+/*******************************************************************************
+* Title                 :   Track Exporters
+* Filename              :   gps_export.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_export.c
+ * @brief CSV, GPX and GeoJSON rows formatted straight into write blocks.
+ *
+ * Before a row is formatted the block being filled must have room for
+ * GPS_EXPORT_ROW_MAX bytes, else the next block is started, so rows are
+ * formatted in place and never copied.  Fixed point values are scaled to
+ * a 64 bit integer once and split into digits from there.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "gps_export.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define MS_PER_DAY      86400000
+#define EARTH_RADIUS    6371008.8
+#define DEG_TO_RAD      ( 3.14159265358979323846 / 180.0 )
+#define FIXED_MAX       1e9
+
+#define CSV_HEADER      "time_ms,latitude,longitude,altitude,speed,track,hdop,quality," \
+                        "satellites,fields\n"
+#define GPX_HEADER      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"                    \
+                        "<gpx version=\"1.1\" creator=\"gps_export\" "                  \
+                        "xmlns=\"http://www.topografix.com/GPX/1/1\">\n<trk>\n<trkseg>\n"
+#define GPX_FOOTER      "</trkseg>\n</trk>\n</gpx>\n"
+#define GEOJSON_HEADER  "{\"type\":\"Feature\",\"geometry\":{\"type\":\"LineString\","   \
+                        "\"coordinates\":[\n"
+#define GEOJSON_POINT   "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\","        \
+                        "\"coordinates\":"
+#define GEOJSON_EMPTY   "{\"type\":\"FeatureCollection\",\"features\":[]}\n"
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static const uint64_t powers[] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* GGA fix quality, GPX fix */
+static const char *const gpx_fix[] =
+{
+    "none", "3d", "dgps", "pps"
+};
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static char *put_text( char *p, const char *text );
+static char *put_uint( char *p, uint64_t value, int width );
+static char *put_fixed( char *p, double value, int decimals );
+static char *put_time( char *p, int64_t time );
+static char *row_csv( char *p, const gps_log_fix_t *fix );
+static char *row_gpx( char *p, const gps_log_fix_t *fix );
+static char *row_geojson( char *p, const gps_log_fix_t *fix );
+static int flush( gps_export_t *exp, size_t blocks );
+static char *reserve( gps_export_t *exp );
+static void commit( gps_export_t *exp, const char *end );
+static void write_text( gps_export_t *exp, const char *text );
+static void write_fix( gps_export_t *exp, const gps_log_fix_t *fix );
+static int keep( const gps_export_t *exp, const gps_log_fix_t *fix );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static char *put_text( char *p, const char *text )
+{
+    while( *text )
+        *p++ = *text++;
+
+    return p;
+}
+
+/* Zero padded to width digits */
+static char *put_uint( char *p, uint64_t value, int width )
+{
+    char digits[ 20 ];
+    int n = 0;
+
+    do
+    {
+        digits[ n++ ] = ( char )( '0' + value % 10 );
+        value /= 10;
+    } while( value != 0 || n < width );
+
+    while( n > 0 )
+        *p++ = digits[ --n ];
+
+    return p;
+}
+
+/* decimals up to 9, no -0 */
+static char *put_fixed( char *p, double value, int decimals )
+{
+    uint64_t scaled;
+
+    /* NaN */
+    if( value != value )
+        value = 0;
+
+    if( value > FIXED_MAX )
+        value = FIXED_MAX;
+    else if( value < -FIXED_MAX )
+        value = -FIXED_MAX;
+
+    if( value < 0 )
+    {
+        scaled = ( uint64_t )( -value * powers[ decimals ] + 0.5 );
+
+        if( scaled != 0 )
+            *p++ = '-';
+    }
+    else
+    {
+        scaled = ( uint64_t )( value * powers[ decimals ] + 0.5 );
+    }
+
+    p = put_uint( p, scaled / powers[ decimals ], 1 );
+
+    if( decimals > 0 )
+    {
+        *p++ = '.';
+        p = put_uint( p, scaled % powers[ decimals ], decimals );
+    }
+
+    return p;
+}
+
+/* yyyy-mm-ddThh:mm:ss.sssZ of ms since 1970 */
+static char *put_time( char *p, int64_t time )
+{
+    int64_t days = time / MS_PER_DAY;
+    int32_t ms = ( int32_t )( time % MS_PER_DAY );
+    int32_t y, m, d;
+
+    if( ms < 0 )
+    {
+        ms += MS_PER_DAY;
+        days--;
+    }
+
+    gps_civil_from_days( days, &y, &m, &d );
+    p = put_uint( p, ( uint64_t )( y < 0 ? 0 : y ), 4 );
+    *p++ = '-';
+    p = put_uint( p, ( uint64_t )m, 2 );
+    *p++ = '-';
+    p = put_uint( p, ( uint64_t )d, 2 );
+    *p++ = 'T';
+    p = put_uint( p, ms / 3600000, 2 );
+    *p++ = ':';
+    p = put_uint( p, ms / 60000 % 60, 2 );
+    *p++ = ':';
+    p = put_uint( p, ms / 1000 % 60, 2 );
+    *p++ = '.';
+    p = put_uint( p, ms % 1000, 3 );
+    *p++ = 'Z';
+
+    return p;
+}
+
+static char *row_csv( char *p, const gps_log_fix_t *fix )
+{
+    if( fix->time < 0 )
+        *p++ = '-';
+
+    p = put_uint( p, ( uint64_t )( fix->time < 0 ? -fix->time : fix->time ), 1 );
+    *p++ = ',';
+    p = put_fixed( p, fix->latitude, 8 );
+    *p++ = ',';
+    p = put_fixed( p, fix->longitude, 8 );
+    *p++ = ',';
+    p = put_fixed( p, fix->altitude, 2 );
+    *p++ = ',';
+    p = put_fixed( p, fix->speed, 2 );
+    *p++ = ',';
+    p = put_fixed( p, fix->track, 2 );
+    *p++ = ',';
+    p = put_fixed( p, fix->hdop, 2 );
+    *p++ = ',';
+    p = put_uint( p, fix->quality, 1 );
+    *p++ = ',';
+    p = put_uint( p, fix->satellites, 1 );
+    *p++ = ',';
+    p = put_uint( p, fix->fields, 1 );
+    *p++ = '\n';
+
+    return p;
+}
+
+/* ele, time, fix, sat and hdop, in the order of the GPX schema */
+static char *row_gpx( char *p, const gps_log_fix_t *fix )
+{
+    p = put_text( p, "<trkpt lat=\"" );
+    p = put_fixed( p, fix->latitude, 8 );
+    p = put_text( p, "\" lon=\"" );
+    p = put_fixed( p, fix->longitude, 8 );
+    p = put_text( p, "\">" );
+
+    if( fix->fields & GPS_EPOCH_ALTITUDE )
+    {
+        p = put_text( p, "<ele>" );
+        p = put_fixed( p, fix->altitude, 2 );
+        p = put_text( p, "</ele>" );
+    }
+
+    if( fix->fields & GPS_EPOCH_DATE )
+    {
+        p = put_text( p, "<time>" );
+        p = put_time( p, fix->time );
+        p = put_text( p, "</time>" );
+    }
+
+    if( ( fix->fields & GPS_EPOCH_QUALITY ) && fix->quality <= PPS_FIX )
+    {
+        p = put_text( p, "<fix>" );
+        p = put_text( p, fix->quality == GPS_FIX && !( fix->fields & GPS_EPOCH_ALTITUDE )
+                         ? "2d" : gpx_fix[ fix->quality ] );
+        p = put_text( p, "</fix>" );
+    }
+
+    if( fix->fields & GPS_EPOCH_SATS )
+    {
+        p = put_text( p, "<sat>" );
+        p = put_uint( p, fix->satellites, 1 );
+        p = put_text( p, "</sat>" );
+    }
+
+    if( fix->fields & GPS_EPOCH_HDOP )
+    {
+        p = put_text( p, "<hdop>" );
+        p = put_fixed( p, fix->hdop, 2 );
+        p = put_text( p, "</hdop>" );
+    }
+
+    return put_text( p, "</trkpt>\n" );
+}
+
+/* [lon,lat] or [lon,lat,alt] */
+static char *row_geojson( char *p, const gps_log_fix_t *fix )
+{
+    *p++ = '[';
+    p = put_fixed( p, fix->longitude, 8 );
+    *p++ = ',';
+    p = put_fixed( p, fix->latitude, 8 );
+
+    if( fix->fields & GPS_EPOCH_ALTITUDE )
+    {
+        *p++ = ',';
+        p = put_fixed( p, fix->altitude, 2 );
+    }
+
+    *p++ = ']';
+
+    return p;
+}
+
+/* The first blocks in a single writev */
+static int flush( gps_export_t *exp, size_t blocks )
+{
+    struct iovec iov[ GPS_EXPORT_BLOCKS ];
+    struct iovec *next = iov;
+    int count = 0;
+    size_t i;
+
+    for( i = 0; i < blocks; i++ )
+    {
+        if( exp->used[ i ] == 0 )
+            continue;
+
+        iov[ count ].iov_base = exp->data[ i ];
+        iov[ count++ ].iov_len = exp->used[ i ];
+        exp->used[ i ] = 0;
+    }
+
+    while( count > 0 && !exp->error )
+    {
+        ssize_t n = writev( exp->fd, next, count );
+
+        if( n < 0 )
+        {
+            if( errno != EINTR )
+                exp->error = errno;
+
+            continue;
+        }
+
+        exp->bytes += n;
+
+        /* A partial write goes on from where it stopped */
+        while( count > 0 && ( size_t )n >= next->iov_len )
+        {
+            n -= next->iov_len;
+            next++;
+            count--;
+        }
+
+        if( count > 0 )
+        {
+            next->iov_base = ( char * )next->iov_base + n;
+            next->iov_len -= n;
+        }
+    }
+
+    if( exp->error )
+    {
+        errno = exp->error;
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Room for a row */
+static char *reserve( gps_export_t *exp )
+{
+    if( GPS_EXPORT_BLOCK - exp->fill < GPS_EXPORT_ROW_MAX )
+    {
+        exp->used[ exp->block++ ] = exp->fill;
+        exp->fill = 0;
+
+        if( exp->block == GPS_EXPORT_BLOCKS )
+        {
+            flush( exp, GPS_EXPORT_BLOCKS );
+            exp->block = 0;
+        }
+    }
+
+    return exp->data[ exp->block ] + exp->fill;
+}
+
+static void commit( gps_export_t *exp, const char *end )
+{
+    exp->fill = end - exp->data[ exp->block ];
+}
+
+static void write_text( gps_export_t *exp, const char *text )
+{
+    commit( exp, put_text( reserve( exp ), text ) );
+}
+
+static void write_fix( gps_export_t *exp, const gps_log_fix_t *fix )
+{
+    char *p = reserve( exp );
+
+    switch( exp->format )
+    {
+    case GPS_EXPORT_GPX:
+        p = row_gpx( p, fix );
+        break;
+    case GPS_EXPORT_GEOJSON:
+        /* A LineString needs two positions, the first waits in kept for
+           the second and one alone becomes a Point */
+        if( exp->written == 1 )
+        {
+            p = put_text( p, GEOJSON_HEADER );
+            p = row_geojson( p, &exp->kept );
+        }
+
+        if( exp->written >= 1 )
+        {
+            p = put_text( p, ",\n" );
+            p = row_geojson( p, fix );
+        }
+
+        break;
+    default:
+        p = row_csv( p, fix );
+        break;
+    }
+
+    commit( exp, p );
+
+    if( fix->fields & GPS_EPOCH_DATE )
+    {
+        if( exp->first_time < 0 )
+            exp->first_time = fix->time;
+
+        exp->last_time = fix->time;
+    }
+
+    exp->kept = *fix;
+    exp->written++;
+    exp->pending = 0;
+}
+
+/* At least interval ms and distance m from the last kept fix, a clock
+   going back or a position missing on either side keeps it */
+static int keep( const gps_export_t *exp, const gps_log_fix_t *fix )
+{
+    const gps_log_fix_t *kept = &exp->kept;
+
+    if( exp->written == 0 )
+        return 1;
+
+    if( exp->interval > 0 && fix->time >= kept->time &&
+        fix->time - kept->time < exp->interval )
+        return 0;
+
+    if( exp->distance > 0 && ( fix->fields & kept->fields & GPS_EPOCH_POSITION ) )
+    {
+        /* Equirectangular, exact enough at the distances it decides */
+        double x = ( fix->longitude - kept->longitude ) * DEG_TO_RAD *
+                   cos( ( fix->latitude + kept->latitude ) * ( DEG_TO_RAD / 2 ) );
+        double y = ( fix->latitude - kept->latitude ) * DEG_TO_RAD;
+
+        if( ( x * x + y * y ) * EARTH_RADIUS * EARTH_RADIUS < exp->distance * exp->distance )
+            return 0;
+    }
+
+    return 1;
+}
+
+int gps_export_open( gps_export_t *exp, int fd, gps_export_format_t format )
+{
+    memset( exp, 0, offsetof( gps_export_t, data ) );
+    exp->fd = fd;
+    exp->format = format;
+    exp->first_time = -1;
+    exp->last_time = -1;
+
+    switch( format )
+    {
+    case GPS_EXPORT_GPX:
+        write_text( exp, GPX_HEADER );
+        break;
+    case GPS_EXPORT_GEOJSON:
+        break;
+    case GPS_EXPORT_CSV:
+        write_text( exp, CSV_HEADER );
+        break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
+
+int gps_export_fix( gps_export_t *exp, const gps_log_fix_t *fix )
+{
+    exp->fixes++;
+
+    if( exp->format != GPS_EXPORT_CSV && !( fix->fields & GPS_EPOCH_POSITION ) )
+        return exp->error ? -1 : 0;
+
+    if( keep( exp, fix ) )
+    {
+        write_fix( exp, fix );
+    }
+    else
+    {
+        exp->last = *fix;
+        exp->pending = 1;
+    }
+
+    if( exp->error )
+    {
+        errno = exp->error;
+        return -1;
+    }
+
+    return 0;
+}
+
+int gps_export_track( gps_export_t *exp, const gps_track_t *track, size_t first,
+                      size_t rows )
+{
+    gps_log_fix_t fix;
+    size_t i;
+
+    for( i = first; i < first + rows; i++ )
+    {
+        gps_track_get( track, i, &fix );
+
+        if( gps_export_fix( exp, &fix ) )
+            return -1;
+    }
+
+    return 0;
+}
+
+int gps_export_close( gps_export_t *exp )
+{
+    if( exp->pending )
+        write_fix( exp, &exp->last );
+
+    if( exp->format == GPS_EXPORT_GPX )
+    {
+        write_text( exp, GPX_FOOTER );
+    }
+    else if( exp->format == GPS_EXPORT_GEOJSON && exp->written == 0 )
+    {
+        write_text( exp, GEOJSON_EMPTY );
+    }
+    else if( exp->format == GPS_EXPORT_GEOJSON )
+    {
+        char *p = reserve( exp );
+
+        if( exp->written == 1 )
+        {
+            p = put_text( p, GEOJSON_POINT );
+            p = row_geojson( p, &exp->kept );
+            p = put_text( p, "},\"properties\":{\"points\":" );
+        }
+        else
+        {
+            p = put_text( p, "\n]},\"properties\":{\"points\":" );
+        }
+
+        p = put_uint( p, exp->written, 1 );
+
+        if( exp->first_time >= 0 )
+        {
+            p = put_text( p, ",\"start\":\"" );
+            p = put_time( p, exp->first_time );
+            p = put_text( p, "\",\"end\":\"" );
+            p = put_time( p, exp->last_time );
+            *p++ = '"';
+        }
+
+        commit( exp, put_text( p, "}}\n" ) );
+    }
+
+    exp->used[ exp->block ] = exp->fill;
+    exp->fill = 0;
+
+    return flush( exp, exp->block + 1 );
+}
+
+int gps_export_format( const char *name, gps_export_format_t *format )
+{
+    if( strcmp( name, "csv" ) == 0 )
+        *format = GPS_EXPORT_CSV;
+    else if( strcmp( name, "gpx" ) == 0 )
+        *format = GPS_EXPORT_GPX;
+    else if( strcmp( name, "geojson" ) == 0 )
+        *format = GPS_EXPORT_GEOJSON;
+    else
+        return -1;
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
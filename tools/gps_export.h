@@ -0,0 +1,143 @@
+/****************************************************************************
+* Title                 :   Track Exporters
+* Filename              :   gps_export.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_export.h
+ * @brief Streams fixes to a file descriptor as CSV, GPX or GeoJSON
+ *
+ * Fixes are formatted as they come, so the memory used is the exporter
+ * alone however long the track is.  Numbers are formatted with integer
+ * arithmetic.  Rows go into a ring of blocks that is written with a single
+ * writev when it is full, and a row is never split across blocks.
+ *
+ * CSV has the columns of gps_track_write_csv() and takes every fix.  GPX
+ * writes a trk with one trkseg, GeoJSON a Feature with a LineString and
+ * the time range in its properties; both skip fixes without a position.
+ * GeoJSON with a single fix kept is a Point Feature, and without any an
+ * empty FeatureCollection, so it is written from the second fix on.
+ * GPX times need a date, fixes without one have no time element.
+ *
+ * Decimation: with interval or distance set, a fix is kept only when at
+ * least interval ms passed and it moved at least distance meters since
+ * the last kept fix.  The last fix of the track is always kept.
+ *
+ * @code
+ * static gps_export_t exp;
+ *
+ * gps_export_open( &exp, STDOUT_FILENO, GPS_EXPORT_GPX );
+ * exp.interval = 5000;
+ * gps_export_track( &exp, &log.track, 0, log.track.count );
+ * gps_export_close( &exp );
+ * @endcode
+ */
+#ifndef GPS_EXPORT_H_
+#define GPS_EXPORT_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "gps_log.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_EXPORT_BLOCK    65536   /**< Bytes per block */
+#define GPS_EXPORT_BLOCKS   16      /**< Blocks per writev */
+#define GPS_EXPORT_ROW_MAX  512     /**< Longest row of any format */
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @enum Output formats
+ */
+typedef enum
+{
+    GPS_EXPORT_CSV,
+    GPS_EXPORT_GPX,
+    GPS_EXPORT_GEOJSON
+} gps_export_format_t;
+
+/**
+ * @struct Exporter, about a MB, static or on the heap
+ */
+typedef struct
+{
+    int fd;
+    gps_export_format_t format;
+    int64_t interval;       /**< ms between kept fixes, 0 keeps all */
+    double distance;        /**< m between kept fixes, 0 keeps all */
+    uint64_t fixes;         /**< Fixes passed in */
+    uint64_t written;       /**< Rows written */
+    uint64_t bytes;         /**< Bytes written */
+    int64_t first_time;     /**< Time of the first and last row written */
+    int64_t last_time;
+    gps_log_fix_t kept;     /**< Last fix written */
+    gps_log_fix_t last;     /**< Last fix passed in */
+    int pending;            /**< last wasn't written */
+    int error;              /**< errno of a failed write, nothing is written after it */
+    size_t block;           /**< Block being filled */
+    size_t fill;            /**< Bytes in it */
+    size_t used[ GPS_EXPORT_BLOCKS ];
+    char data[ GPS_EXPORT_BLOCKS ][ GPS_EXPORT_BLOCK ];
+} gps_export_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts an export and writes the header
+ *
+ * Decimation is off until interval or distance are set.
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_export_open( gps_export_t *exp, int fd, gps_export_format_t format );
+
+/**
+ * @brief Exports a fix
+ *
+ * @return int - 0 or -1 with errno set, after any failed write
+ */
+int gps_export_fix( gps_export_t *exp, const gps_log_fix_t *fix );
+
+/**
+ * @brief Exports rows first to first + rows - 1 of a track
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_export_track( gps_export_t *exp, const gps_track_t *track, size_t first,
+                      size_t rows );
+
+/**
+ * @brief Writes the last fix, the footer and everything buffered
+ *
+ * The file descriptor is left open.
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_export_close( gps_export_t *exp );
+
+/**
+ * @brief Parses a format name, csv, gpx or geojson
+ *
+ * @return int - 0 or -1 for an unknown name
+ */
+int gps_export_format( const char *name, gps_export_format_t *format );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_EXPORT_H_ */
+
+/*** End of File **************************************************************/
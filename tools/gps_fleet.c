@@ -0,0 +1,212 @@
+/*******************************************************************************
+* Title                 :   Fleet Table
+* Filename              :   gps_fleet.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_fleet.c
+ * @brief Latest fix of every receiver of a fleet, shared between threads.
+ *
+ * The state before the sequence is copied as 64 bit words with relaxed
+ * atomic loads and stores, so a read that overlaps a write is only a
+ * torn copy to throw away and never a data race.  The fences order those
+ * words against the sequence as in a seqlock.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "gps_fleet.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define STATIC_ASSERT( COND, NAME ) typedef char static_assert_##NAME[ ( COND ) ? 1 : -1 ]
+
+/* fix, epochs and id */
+#define WORDS   ( offsetof( gps_fleet_slot_t, online ) / sizeof( uint64_t ) )
+
+STATIC_ASSERT( sizeof( gps_fleet_slot_t ) == GPS_FLEET_LINE, slot_is_a_line );
+STATIC_ASSERT( offsetof( gps_fleet_slot_t, online ) % sizeof( uint64_t ) == 0,
+               words_before_online );
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+/* A word of a shared slot, may alias its fields */
+typedef uint64_t __attribute__(( may_alias )) word_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void slot_write( gps_fleet_slot_t *slot, const gps_fleet_slot_t *state );
+static void slot_read( const gps_fleet_slot_t *slot, gps_fleet_slot_t *state );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* Only the writer of the shard gets here, so slot->sequence is its own */
+static void slot_write( gps_fleet_slot_t *slot, const gps_fleet_slot_t *state )
+{
+    word_t *to = ( word_t * )slot;
+    uint64_t words[ WORDS ];
+    uint32_t sequence = slot->sequence;
+    size_t i;
+
+    memcpy( words, state, sizeof( words ) );
+    __atomic_store_n( &slot->sequence, sequence + 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    for( i = 0; i < WORDS; i++ )
+        __atomic_store_n( &to[ i ], words[ i ], __ATOMIC_RELAXED );
+
+    __atomic_store_n( &slot->online, state->online, __ATOMIC_RELAXED );
+    __atomic_store_n( &slot->sequence, sequence + 2, __ATOMIC_RELEASE );
+}
+
+static void slot_read( const gps_fleet_slot_t *slot, gps_fleet_slot_t *state )
+{
+    const word_t *from = ( const word_t * )slot;
+    uint64_t words[ WORDS ];
+    uint32_t before, after;
+    size_t i;
+
+    do
+    {
+        before = __atomic_load_n( &slot->sequence, __ATOMIC_ACQUIRE );
+
+        for( i = 0; i < WORDS; i++ )
+            words[ i ] = __atomic_load_n( &from[ i ], __ATOMIC_RELAXED );
+
+        state->online = __atomic_load_n( &slot->online, __ATOMIC_RELAXED );
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        after = __atomic_load_n( &slot->sequence, __ATOMIC_RELAXED );
+    }
+    while( ( before & 1 ) || before != after );
+
+    memcpy( state, words, sizeof( words ) );
+    state->sequence = before;
+}
+
+int gps_fleet_init( gps_fleet_t *fleet, size_t shards, size_t per_shard )
+{
+    void *slots;
+
+    memset( fleet, 0, sizeof( gps_fleet_t ) );
+
+    if( shards == 0 || per_shard == 0 )
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if( posix_memalign( &slots, GPS_FLEET_LINE, shards * per_shard * sizeof( gps_fleet_slot_t ) ) )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    memset( slots, 0, shards * per_shard * sizeof( gps_fleet_slot_t ) );
+    fleet->slot = slots;
+    fleet->shards = shards;
+    fleet->per_shard = per_shard;
+
+    return 0;
+}
+
+void gps_fleet_free( gps_fleet_t *fleet )
+{
+    free( fleet->slot );
+    memset( fleet, 0, sizeof( gps_fleet_t ) );
+}
+
+size_t gps_fleet_units( const gps_fleet_t *fleet )
+{
+    return fleet->shards * fleet->per_shard;
+}
+
+void gps_fleet_publish( gps_fleet_t *fleet, size_t unit, const gps_log_fix_t *fix )
+{
+    gps_fleet_slot_t *slot = &fleet->slot[ unit ];
+    gps_fleet_slot_t state = *slot;
+
+    state.fix = *fix;
+    state.epochs++;
+    slot_write( slot, &state );
+}
+
+void gps_fleet_online( gps_fleet_t *fleet, size_t unit, uint32_t id, int online )
+{
+    gps_fleet_slot_t *slot = &fleet->slot[ unit ];
+    gps_fleet_slot_t state = *slot;
+
+    if( online && ( id == 0 || id != state.id ) )
+        state.epochs = 0;
+
+    state.id = id;
+    state.online = online;
+    slot_write( slot, &state );
+}
+
+int gps_fleet_get( const gps_fleet_t *fleet, size_t unit, gps_fleet_slot_t *slot )
+{
+    slot_read( &fleet->slot[ unit ], slot );
+
+    if( slot->epochs == 0 )
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    return 0;
+}
+
+long gps_fleet_find( const gps_fleet_t *fleet, uint32_t id )
+{
+    size_t units = gps_fleet_units( fleet );
+    gps_fleet_slot_t best, slot;
+    long found = -1;
+    size_t u;
+
+    for( u = 0; id != 0 && u < units; u++ )
+    {
+        slot_read( &fleet->slot[ u ], &slot );
+
+        if( slot.id == id &&
+            ( found < 0 || slot.online > best.online ||
+              ( slot.online == best.online && slot.fix.time > best.fix.time ) ) )
+        {
+            best = slot;
+            found = ( long )u;
+        }
+    }
+
+    if( found < 0 )
+        errno = ENOENT;
+
+    return found;
+}
+
+size_t gps_fleet_snapshot( const gps_fleet_t *fleet, size_t first,
+                           gps_fleet_slot_t *slots, size_t count )
+{
+    size_t units = gps_fleet_units( fleet );
+    size_t i;
+
+    if( first >= units )
+        return 0;
+
+    if( count > units - first )
+        count = units - first;
+
+    for( i = 0; i < count; i++ )
+        slot_read( &fleet->slot[ first + i ], &slots[ i ] );
+
+    return count;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,151 @@
+/****************************************************************************
+* Title                 :   Fleet Table
+* Filename              :   gps_fleet.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_fleet.h
+ * @brief Latest fix of every receiver of a fleet, shared between threads
+ *
+ * Units are numbered from 0 and split into shards of consecutive units.
+ * Each shard is written by one thread at a time, the ingestion worker
+ * owning those units.  Any number of threads read.
+ *
+ * A unit belongs to a receiver ID while it has one: a receiver that comes
+ * back gets the unit it had, with its epochs, and gps_fleet_find() looks
+ * a unit up by the ID.  ID 0 is a receiver without one.
+ *
+ * A slot is one cache line with its own sequence, a seqlock: the writer
+ * makes it odd, stores the state and makes it even again.  Readers copy
+ * the line between two reads of the sequence and keep the copy when both
+ * are the same even number.  They never write to the table, so they
+ * neither slow down the writer nor each other, and they never wait for a
+ * lock.  A read is only repeated when a write of the same unit overlapped
+ * it, which takes a few ns once an epoch.
+ *
+ * @code
+ * gps_fleet_init( &fleet, workers, units_per_worker );
+ * ...
+ * if( gps_fleet_get( &fleet, unit, &slot ) == 0 )
+ *     printf( "%f %f\n", slot.fix.latitude, slot.fix.longitude );
+ *
+ * unit = gps_fleet_find( &fleet, 4711 );
+ *
+ * for( u = 0; u < gps_fleet_units( &fleet ); u += n )
+ *     n = gps_fleet_snapshot( &fleet, u, slots, 1024 );
+ * @endcode
+ */
+#ifndef GPS_FLEET_H_
+#define GPS_FLEET_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "gps_log.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_FLEET_LINE      64      /**< Bytes of a slot, a cache line */
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct State of a unit, GPS_FLEET_LINE bytes
+ */
+typedef struct
+{
+    gps_log_fix_t fix;          /**< Last epoch published */
+    uint32_t epochs;            /**< Epochs published, 0 before the first */
+    uint32_t id;                /**< Receiver ID, 0 without */
+    int32_t online;             /**< Connected now */
+    uint32_t sequence;          /**< Writes, odd during one */
+} gps_fleet_slot_t;
+
+/**
+ * @struct Table
+ */
+typedef struct
+{
+    size_t shards;
+    size_t per_shard;           /**< Units of a shard */
+    gps_fleet_slot_t *slot;     /**< Aligned to GPS_FLEET_LINE */
+} gps_fleet_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Table of shards * per_shard units, all offline
+ *
+ * @return int - 0, or -1 with errno EINVAL when either count is 0 or
+ * ENOMEM
+ */
+int gps_fleet_init( gps_fleet_t *fleet, size_t shards, size_t per_shard );
+
+/**
+ * @brief Releases a table
+ */
+void gps_fleet_free( gps_fleet_t *fleet );
+
+/**
+ * @brief Units of the table
+ */
+size_t gps_fleet_units( const gps_fleet_t *fleet );
+
+/**
+ * @brief Stores the latest epoch of a unit, from the writer of its shard
+ */
+void gps_fleet_publish( gps_fleet_t *fleet, size_t unit, const gps_log_fix_t *fix );
+
+/**
+ * @brief Marks a unit as connected or not, from the writer of its shard
+ *
+ * A connection of another receiver than the last, or of one without an
+ * ID, starts with no epochs.
+ */
+void gps_fleet_online( gps_fleet_t *fleet, size_t unit, uint32_t id, int online );
+
+/**
+ * @brief Copies the state of a unit
+ *
+ * @return int - 0 or -1 with errno ENOENT before its first epoch
+ */
+int gps_fleet_get( const gps_fleet_t *fleet, size_t unit, gps_fleet_slot_t *slot );
+
+/**
+ * @brief Unit of a receiver ID, by a scan of the table
+ *
+ * With several writers a receiver can have a unit in more than one
+ * shard, the one online is taken then, else the one with the latest fix.
+ *
+ * @return long - the unit or -1 with errno ENOENT
+ */
+long gps_fleet_find( const gps_fleet_t *fleet, uint32_t id );
+
+/**
+ * @brief Copies the states of consecutive units
+ *
+ * Every state is whole, but they are copied one after the other while
+ * the writers go on, units without epochs included.
+ *
+ * @return size_t - states copied, fewer than count at the end of the table
+ */
+size_t gps_fleet_snapshot( const gps_fleet_t *fleet, size_t first,
+                           gps_fleet_slot_t *slots, size_t count );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_FLEET_H_ */
+
+/*** End of File **************************************************************/
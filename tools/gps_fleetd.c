@@ -0,0 +1,206 @@
+/*******************************************************************************
+* Title                 :   Fleet Ingestion Daemon
+* Filename              :   gps_fleetd.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_fleetd.c
+ * @brief Terminates NMEA over TCP from many receivers.
+ *
+ * -w workers, one per core by default, each run an epoll loop with its own
+ * SO_REUSEPORT socket on -p and a pool of -c connections.  Every -s
+ * seconds it prints the connections and the lines and epochs per second.
+ * -u runs the workers on io_uring instead, falling back to epoll on
+ * kernels without multishot reads.  SIGINT or SIGTERM stops it.
+ *
+ * @code
+ * gps_fleetd -p 10110 -c 2048
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include "gps_ingest.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define PORT            10110
+#define CONNECTIONS     2048
+#define WORKERS_MAX     256
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static int use_uring;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-u] [-p port] [-w workers] [-c connections] [-s seconds]\n",
+             name );
+}
+
+static void *worker_main( void *arg )
+{
+#ifdef GPS_IO_URING
+    if( use_uring && gps_ingest_run_uring( arg ) == 0 )
+        return NULL;
+
+    if( use_uring && errno != EINVAL && errno != ENOSYS )
+    {
+        perror( "gps_ingest_run_uring" );
+        return NULL;
+    }
+#endif
+
+    if( gps_ingest_run( arg ) )
+        perror( "gps_ingest_run" );
+
+    return NULL;
+}
+
+/* Totals of all workers */
+static void totals( const gps_ingest_t *workers, int count, gps_ingest_stats_t *sum,
+                    size_t *open )
+{
+    int i;
+
+    memset( sum, 0, sizeof( gps_ingest_stats_t ) );
+    *open = 0;
+
+    for( i = 0; i < count; i++ )
+    {
+        sum->accepted += workers[ i ].stats.accepted;
+        sum->refused += workers[ i ].stats.refused;
+        sum->lines += workers[ i ].stats.lines;
+        sum->epochs += workers[ i ].stats.epochs;
+        *open += workers[ i ].open;
+    }
+}
+
+int main( int argc, char **argv )
+{
+    static gps_ingest_t workers[ WORKERS_MAX ];
+    static pthread_t threads[ WORKERS_MAX ];
+    long workers_count = sysconf( _SC_NPROCESSORS_ONLN );
+    long connections = CONNECTIONS;
+    long port = PORT;
+    long seconds = 10;
+    gps_ingest_stats_t last, now;
+    struct timespec period;
+    struct rlimit limit;
+    gps_fleet_t fleet;
+    sigset_t signals;
+    size_t open;
+    int opt, i, sig;
+
+    while( ( opt = getopt( argc, argv, "p:w:c:s:uh" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'p':
+            port = strtol( optarg, NULL, 10 );
+            break;
+        case 'w':
+            workers_count = strtol( optarg, NULL, 10 );
+            break;
+        case 'c':
+            connections = strtol( optarg, NULL, 10 );
+            break;
+        case 's':
+            seconds = strtol( optarg, NULL, 10 );
+            break;
+        case 'u':
+            use_uring = 1;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( workers_count < 1 || workers_count > WORKERS_MAX || connections < 1 ||
+        port < 1 || port > 65535 || seconds < 1 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    /* A descriptor per connection */
+    if( getrlimit( RLIMIT_NOFILE, &limit ) == 0 )
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit( RLIMIT_NOFILE, &limit );
+    }
+
+    /* Workers inherit the mask, only the main thread takes the signals */
+    sigemptyset( &signals );
+    sigaddset( &signals, SIGINT );
+    sigaddset( &signals, SIGTERM );
+    pthread_sigmask( SIG_BLOCK, &signals, NULL );
+    signal( SIGPIPE, SIG_IGN );
+
+    if( gps_fleet_init( &fleet, workers_count, connections ) )
+    {
+        perror( "gps_fleet_init" );
+        return 1;
+    }
+
+    for( i = 0; i < workers_count; i++ )
+    {
+        if( gps_ingest_init( &workers[ i ], &fleet, i ) ||
+            gps_ingest_listen( &workers[ i ], ( uint16_t )port ) ||
+            pthread_create( &threads[ i ], NULL, worker_main, &workers[ i ] ) )
+        {
+            perror( "gps_fleetd" );
+            return 1;
+        }
+    }
+
+    fprintf( stderr, "%ld workers of %ld connections on port %ld\n",
+             workers_count, connections, port );
+
+    period.tv_sec = seconds;
+    period.tv_nsec = 0;
+    totals( workers, workers_count, &last, &open );
+
+    do
+    {
+        sig = sigtimedwait( &signals, NULL, &period );
+        totals( workers, workers_count, &now, &open );
+        fprintf( stderr, "%zu connected, %llu accepted, %llu refused, "
+                 "%.0f lines/s, %.0f epochs/s\n", open,
+                 ( unsigned long long )now.accepted, ( unsigned long long )now.refused,
+                 ( double )( now.lines - last.lines ) / seconds,
+                 ( double )( now.epochs - last.epochs ) / seconds );
+        last = now;
+    }
+    while( sig < 0 && ( errno == EAGAIN || errno == EINTR ) );
+
+    for( i = 0; i < workers_count; i++ )
+    {
+        gps_ingest_stop( &workers[ i ] );
+        pthread_join( threads[ i ], NULL );
+        gps_ingest_free( &workers[ i ] );
+    }
+
+    gps_fleet_free( &fleet );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,76 @@
+/*******************************************************************************
+* Title                 :   GPS Parser Footprint
+* Filename              :   gps_footprint.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, built once per receiver profile
+*******************************************************************************/
+/**
+ * @file gps_footprint.c
+ * @brief Prints the static RAM the parser takes in one configuration.
+ *
+ * The build compiles the parser and this file once per receiver profile
+ * ( gps_footprint_UBLOX_6, gps_footprint_GENERIC, ... ).  The footprint
+ * target runs all of them and adds the code size of each parser object.
+ *
+ * @code
+ * gps_footprint          breakdown per sentence
+ * gps_footprint --row    one CSV row for the report
+ * @endcode
+ *
+ * Sizes are those of the host compiler.  Targets with 4 byte pointers or
+ * 4 byte doubles need less.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "gps_parser.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#ifndef GPS_PROFILE_NAME
+#define GPS_PROFILE_NAME "default"
+#endif
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+int main( int argc, char **argv )
+{
+    gps_footprint_t fp;
+    int i;
+
+    gps_footprint( &fp );
+
+    if( argc > 1 && !strcmp( argv[ 1 ], "--row" ) )
+    {
+        printf( "%s,%u,%u,%u,%u,%u,%u\n", GPS_PROFILE_NAME, fp.buffers, fp.fields,
+                fp.common, fp.sentences, fp.diagnostics, fp.total );
+        return 0;
+    }
+
+    printf( "profile      %s\n", GPS_PROFILE_NAME );
+    printf( "BUFFER_MAX %u, MAX_FIELDS %u, MAX_FIELD_SIZE %u, MAX_GSV_SENTENCES %u\n\n",
+            ( unsigned )BUFFER_MAX, ( unsigned )MAX_FIELDS, ( unsigned )MAX_FIELD_SIZE,
+            ( unsigned )MAX_GSV_SENTENCES );
+    printf( "buffers      %5u\n", fp.buffers );
+    printf( "fields       %5u\n", fp.fields );
+    printf( "common       %5u\n", fp.common );
+
+    for( i = 0; i < GPS_SENTENCE_COUNT; i++ )
+    {
+        if( fp.sentence[ i ] )
+            printf( "  %s        %5u\n", gps_sentence_name( ( gps_sentence_t )i ),
+                    fp.sentence[ i ] );
+    }
+
+    printf( "sentences    %5u\n", fp.sentences );
+    printf( "diagnostics  %5u\n", fp.diagnostics );
+    printf( "total        %5u bytes\n", fp.total );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
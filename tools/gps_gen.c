@@ -0,0 +1,868 @@
+/*******************************************************************************
+* Title                 :   NMEA Corpus Generator
+* Filename              :   gps_gen.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_gen.c
+ * @brief Deterministic synthetic NMEA / UBX corpus generator.
+ *
+ * Simulates a receiver moving along a configurable trajectory and writes the
+ * sentences it would output each epoch.  The same seed and options always
+ * produce the same bytes, so corpora can be regenerated instead of shared.
+ *
+ * @code
+ * gps_gen --seed 7 --rate 10 --sats 14 --constellations GP,GL --bytes 1G -o soak.nmea
+ * gps_gen --epochs 3600 --bad-checksum 0.01 --truncate 0.005 --long-field 0.01 --ubx 0.1 -o errors.nmea
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <math.h>
+#include <getopt.h>
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define EARTH_RADIUS        6371000.0
+#define KNOTS_TO_MPS        0.514444
+#define DEG_TO_RAD          ( M_PI / 180.0 )
+#define MAX_CONSTELLATIONS  4
+#define MAX_SATS            64
+#define MAX_MIX             16
+#define SENTENCE_MAX        96
+#define LONG_LINE           74      /* Up to *hh CR LF, within the 82 of NMEA */
+#define OUT_BUFFER          ( 1 << 20 )
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef enum
+{
+    S_RMC, S_VTG, S_GGA, S_GSA, S_GSV, S_GLL, S_ZDA, S_GST,
+    S_GBS, S_GRS, S_DTM, S_THS, S_TXT, S_GPQ, S_COUNT
+} sentence_t;
+
+typedef struct
+{
+    sentence_t type;
+    double probability;     /* Chance of being output in a given epoch */
+} mix_entry_t;
+
+typedef struct
+{
+    char talker[ 3 ];
+    int prn_base;
+    int count;
+} constellation_t;
+
+typedef struct
+{
+    int prn;
+    double azimuth;
+    double elevation;
+    double az_rate;
+    double el_phase;
+    int snr;
+    int used;
+} satellite_t;
+
+typedef struct
+{
+    /* Trajectory */
+    double lat, lon, alt;
+    double speed;           /* knots */
+    double heading;         /* degrees true */
+    double turn;            /* degrees / second */
+    double wander;          /* random heading change, degrees / second */
+    double climb;           /* meters / second */
+    /* Time */
+    int64_t time_ms;        /* milliseconds since 1970 */
+    double rate;            /* epochs / second */
+    /* Output */
+    char talker[ 3 ];
+    mix_entry_t mix[ MAX_MIX ];
+    int num_mix;
+    constellation_t constellations[ MAX_CONSTELLATIONS ];
+    int num_constellations;
+    int num_sats;
+    /* Error injection, probability per sentence */
+    double bad_checksum;
+    double truncate;
+    double noise;
+    double drop_cr;
+    double long_field;
+    double ubx;
+} config_t;
+
+typedef struct
+{
+    uint64_t epochs;
+    uint64_t sentences;
+    uint64_t bytes;
+    uint64_t bad_checksum;
+    uint64_t truncated;
+    uint64_t noise;
+    uint64_t drop_cr;
+    uint64_t long_field;
+    uint64_t ubx;
+} gen_stats_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static const char *sentence_names[ S_COUNT ] =
+{
+    "RMC", "VTG", "GGA", "GSA", "GSV", "GLL", "ZDA", "GST",
+    "GBS", "GRS", "DTM", "THS", "TXT", "GPQ"
+};
+
+static const char *default_mix =
+    "RMC,VTG,GGA,GSA,GSV,GLL,ZDA,GST,GBS,GRS,DTM,THS,TXT:0.02,GPQ:0.01";
+
+static const char *txt_messages[] =
+{
+    "u-blox ag",
+    "HW  00040007",
+    "ROM CORE 7.03",
+    "ANTSTATUS=OK",
+};
+
+static uint64_t rng_state;
+static satellite_t sats[ MAX_SATS ];
+static char out_buffer[ OUT_BUFFER ];
+static size_t out_used;
+static FILE *out_fp;
+static gen_stats_t stats;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint64_t rng_next( void );
+static double rng_uniform( void );
+static int rng_range( int lo, int hi );
+static void out_write( const void *data, size_t len );
+static void out_flush( void );
+static void format_degrees( char *buffer, size_t size, double degrees, int width );
+static int parse_start( const char *str, int64_t *time_ms );
+static uint64_t parse_size( const char *str );
+static int parse_mix( config_t *cfg, const char *str );
+static int parse_constellations( config_t *cfg, const char *str );
+static void emit( const config_t *cfg, const char *fmt, ... );
+static void emit_ubx( const config_t *cfg );
+static void satellites_init( config_t *cfg );
+static void satellites_step( double dt );
+static void generate_epoch( const config_t *cfg );
+static void advance( config_t *cfg );
+static void usage( const char *name );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* xorshift64* - small, fast and identical on every platform */
+static uint64_t rng_next()
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+
+    return rng_state * 0x2545F4914F6CDD1Dull;
+}
+
+static double rng_uniform()
+{
+    return ( rng_next() >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+static int rng_range( int lo, int hi )
+{
+    return lo + ( int )( rng_next() % ( uint64_t )( hi - lo + 1 ) );
+}
+
+static void out_write( const void *data, size_t len )
+{
+    if( out_used + len > OUT_BUFFER )
+        out_flush();
+
+    memcpy( &out_buffer[ out_used ], data, len );
+    out_used += len;
+    stats.bytes += len;
+}
+
+static void out_flush()
+{
+    if( out_used && fwrite( out_buffer, 1, out_used, out_fp ) != out_used )
+    {
+        perror( "write" );
+        exit( 1 );
+    }
+
+    out_used = 0;
+}
+
+/* dddmm.mmmmm, the minutes rounded before they are split off so that
+   59.999996 carries into the degrees instead of printing as 60.00000 */
+static void format_degrees( char *buffer, size_t size, double degrees, int width )
+{
+    int64_t units = ( int64_t )( degrees * 6000000.0 + 0.5 );  /* 1e-5 minutes */
+    int whole = ( int )( units / 6000000 );
+    int minutes = ( int )( units % 6000000 );
+
+    snprintf( buffer, size, "%0*d%02d.%05d", width, whole, minutes / 100000, minutes % 100000 );
+}
+
+static int parse_start( const char *str, int64_t *time_ms )
+{
+    int y, mo, d, h = 0, mi = 0, s = 0;
+
+    if( sscanf( str, "%d-%d-%dT%d:%d:%d", &y, &mo, &d, &h, &mi, &s ) < 3 )
+        return -1;
+
+    *time_ms = ( gps_days_from_civil( y, mo, d ) * 86400 + h * 3600 + mi * 60 + s ) * 1000;
+
+    return 0;
+}
+
+static uint64_t parse_size( const char *str )
+{
+    char *end;
+    double value = strtod( str, &end );
+
+    switch( *end )
+    {
+    case 'k': case 'K': value *= 1024.0; break;
+    case 'm': case 'M': value *= 1024.0 * 1024.0; break;
+    case 'g': case 'G': value *= 1024.0 * 1024.0 * 1024.0; break;
+    default: break;
+    }
+
+    return ( uint64_t )value;
+}
+
+/* "RMC,GGA,TXT:0.05" - optional probability after the colon */
+static int parse_mix( config_t *cfg, const char *str )
+{
+    char copy[ 256 ], *tok, *save;
+
+    strncpy( copy, str, sizeof( copy ) - 1 );
+    copy[ sizeof( copy ) - 1 ] = '\0';
+    cfg->num_mix = 0;
+
+    for( tok = strtok_r( copy, ",", &save ); tok; tok = strtok_r( NULL, ",", &save ) )
+    {
+        char *colon = strchr( tok, ':' );
+        int i;
+
+        if( cfg->num_mix == MAX_MIX )
+            return -1;
+
+        if( colon )
+            *colon++ = '\0';
+
+        for( i = 0; i < S_COUNT; i++ )
+        {
+            if( !strcmp( tok, sentence_names[ i ] ) )
+                break;
+        }
+
+        if( i == S_COUNT )
+        {
+            fprintf( stderr, "unknown sentence %s\n", tok );
+            return -1;
+        }
+
+        cfg->mix[ cfg->num_mix ].type = ( sentence_t )i;
+        cfg->mix[ cfg->num_mix ].probability = colon ? atof( colon ) : 1.0;
+        cfg->num_mix++;
+    }
+
+    return 0;
+}
+
+static int parse_constellations( config_t *cfg, const char *str )
+{
+    static const struct { const char *talker; int prn_base; } known[] =
+    {
+        { "GP", 1 }, { "GL", 65 }, { "GA", 1 }, { "GB", 1 }
+    };
+    char copy[ 64 ], *tok, *save;
+
+    strncpy( copy, str, sizeof( copy ) - 1 );
+    copy[ sizeof( copy ) - 1 ] = '\0';
+    cfg->num_constellations = 0;
+
+    for( tok = strtok_r( copy, ",", &save ); tok; tok = strtok_r( NULL, ",", &save ) )
+    {
+        constellation_t *c = &cfg->constellations[ cfg->num_constellations ];
+        size_t i;
+
+        for( i = 0; i < sizeof( known ) / sizeof( known[ 0 ] ); i++ )
+        {
+            if( !strcmp( tok, known[ i ].talker ) )
+                break;
+        }
+
+        if( i == sizeof( known ) / sizeof( known[ 0 ] ) ||
+            cfg->num_constellations == MAX_CONSTELLATIONS )
+        {
+            fprintf( stderr, "unknown constellation %s\n", tok );
+            return -1;
+        }
+
+        memcpy( c->talker, known[ i ].talker, 3 );
+        c->prn_base = known[ i ].prn_base;
+        cfg->num_constellations++;
+    }
+
+    return cfg->num_constellations ? 0 : -1;
+}
+
+/*
+ * Formats the sentence body, adds the checksum and line ending and then
+ * applies whatever errors the dice ask for.
+ */
+static void emit( const config_t *cfg, const char *fmt, ... )
+{
+    char line[ SENTENCE_MAX + 8 ];
+    uint8_t checksum = 0;
+    va_list args;
+    int len, i;
+
+    line[ 0 ] = '$';
+    va_start( args, fmt );
+    len = vsnprintf( &line[ 1 ], SENTENCE_MAX - 6, fmt, args ) + 1;
+    va_end( args );
+
+    if( len > SENTENCE_MAX - 6 )
+        len = SENTENCE_MAX - 6;
+
+    /* Cut after a random field, which then runs on to a full line as the
+       last one, with a valid checksum */
+    if( cfg->long_field > 0.0 && rng_uniform() < cfg->long_field )
+    {
+        int fields = 0;
+
+        for( i = 1; i < len; i++ )
+            fields += line[ i ] == ',';
+
+        if( fields > 0 )
+        {
+            int cut = rng_range( 1, fields );
+
+            for( i = 1; cut > 0; i++ )
+                cut -= line[ i ] == ',';
+
+            len = i;
+        }
+
+        while( len < LONG_LINE )
+            line[ len++ ] = ( char )( '0' + rng_range( 0, 9 ) );
+
+        stats.long_field++;
+    }
+
+    for( i = 1; i < len; i++ )
+        checksum ^= ( uint8_t )line[ i ];
+
+    if( cfg->bad_checksum > 0.0 && rng_uniform() < cfg->bad_checksum )
+    {
+        checksum ^= ( uint8_t )rng_range( 1, 255 );
+        stats.bad_checksum++;
+    }
+
+    len += sprintf( &line[ len ], "*%02X\r\n", checksum );
+
+    if( cfg->noise > 0.0 && rng_uniform() < cfg->noise )
+    {
+        int hits = rng_range( 1, 3 );
+
+        while( hits-- )
+            line[ rng_range( 1, len - 3 ) ] = ( char )rng_range( 0x20, 0x7e );
+
+        stats.noise++;
+    }
+
+    if( cfg->truncate > 0.0 && rng_uniform() < cfg->truncate )
+    {
+        len = rng_range( 1, len - 3 );
+        line[ len++ ] = '\r';
+        line[ len++ ] = '\n';
+        stats.truncated++;
+    }
+
+    if( cfg->drop_cr > 0.0 && rng_uniform() < cfg->drop_cr )
+    {
+        line[ len - 2 ] = '\n';
+        len--;
+        stats.drop_cr++;
+    }
+
+    out_write( line, len );
+    stats.sentences++;
+
+    /* Garbage between sentences, as seen after a baud rate glitch */
+    if( cfg->noise > 0.0 && rng_uniform() < cfg->noise )
+    {
+        char junk[ 16 ];
+        int n = rng_range( 1, sizeof( junk ) );
+
+        for( i = 0; i < n; i++ )
+            junk[ i ] = ( char )rng_range( 0, 255 );
+
+        out_write( junk, n );
+    }
+
+    if( cfg->ubx > 0.0 && rng_uniform() < cfg->ubx )
+        emit_ubx( cfg );
+}
+
+/* UBX NAV-PVT frame, interleaved the way a receiver with both protocols enabled does */
+static void emit_ubx( const config_t *cfg )
+{
+    uint8_t frame[ 6 + 92 + 2 ];
+    uint8_t *payload = &frame[ 6 ];
+    uint8_t ck_a = 0, ck_b = 0;
+    int32_t lat = ( int32_t )lround( cfg->lat * 1e7 );
+    int32_t lon = ( int32_t )lround( cfg->lon * 1e7 );
+    uint32_t itow = ( uint32_t )( cfg->time_ms % ( 7 * 86400000ll ) );
+    size_t i;
+
+    memset( frame, 0, sizeof( frame ) );
+    frame[ 0 ] = 0xB5;
+    frame[ 1 ] = 0x62;
+    frame[ 2 ] = 0x01;      /* NAV */
+    frame[ 3 ] = 0x07;      /* PVT */
+    frame[ 4 ] = 92;
+    frame[ 5 ] = 0;
+
+    for( i = 0; i < 4; i++ )
+    {
+        payload[ 0 + i ] = ( uint8_t )( itow >> ( 8 * i ) );
+        payload[ 24 + i ] = ( uint8_t )( ( uint32_t )lon >> ( 8 * i ) );
+        payload[ 28 + i ] = ( uint8_t )( ( uint32_t )lat >> ( 8 * i ) );
+    }
+
+    payload[ 20 ] = 3;      /* 3D fix */
+    payload[ 23 ] = ( uint8_t )cfg->num_sats;
+
+    for( i = 2; i < 6 + 92; i++ )
+    {
+        ck_a += frame[ i ];
+        ck_b += ck_a;
+    }
+
+    frame[ 6 + 92 ] = ck_a;
+    frame[ 6 + 92 + 1 ] = ck_b;
+
+    out_write( frame, sizeof( frame ) );
+    stats.ubx++;
+}
+
+static void satellites_init( config_t *cfg )
+{
+    int c, n = 0, i;
+
+    for( c = 0; c < cfg->num_constellations; c++ )
+    {
+        constellation_t *con = &cfg->constellations[ c ];
+
+        con->count = cfg->num_sats / cfg->num_constellations +
+                     ( c < cfg->num_sats % cfg->num_constellations );
+
+        for( i = 0; i < con->count && n < MAX_SATS; i++, n++ )
+        {
+            sats[ n ].prn = con->prn_base + i * 2 + rng_range( 0, 1 );
+            sats[ n ].azimuth = rng_uniform() * 360.0;
+            sats[ n ].elevation = 5.0 + rng_uniform() * 80.0;
+            sats[ n ].az_rate = ( rng_uniform() - 0.5 ) * 0.01;
+            sats[ n ].el_phase = rng_uniform() * 2.0 * M_PI;
+            sats[ n ].snr = rng_range( 20, 50 );
+        }
+    }
+}
+
+static void satellites_step( double dt )
+{
+    int i;
+
+    for( i = 0; i < MAX_SATS; i++ )
+    {
+        satellite_t *s = &sats[ i ];
+
+        s->azimuth = fmod( s->azimuth + s->az_rate * dt + 360.0, 360.0 );
+        s->el_phase += dt * 2.0 * M_PI / 43080.0;   /* half a sidereal day */
+        s->elevation = 45.0 + 40.0 * sin( s->el_phase );
+        s->snr += rng_range( -1, 1 );
+
+        if( s->snr < 15 )
+            s->snr = 15;
+        else if( s->snr > 52 )
+            s->snr = 52;
+
+        s->used = s->elevation > 10.0;
+    }
+}
+
+static void generate_epoch( const config_t *cfg )
+{
+    char time_str[ 16 ], lat_str[ 16 ], lon_str[ 16 ];
+    int64_t day = cfg->time_ms / 86400000ll;
+    int ms_of_day = ( int )( cfg->time_ms % 86400000ll );
+    int32_t year, month, mday;
+    int hh, mm, ss, cs;
+    double alat = fabs( cfg->lat ), alon = fabs( cfg->lon );
+    char ns = cfg->lat < 0 ? 'S' : 'N', ew = cfg->lon < 0 ? 'W' : 'E';
+    int used = 0, i, m, c, first;
+    double hdop, pdop, vdop;
+
+    gps_civil_from_days( day, &year, &month, &mday );
+    hh = ms_of_day / 3600000;
+    mm = ms_of_day / 60000 % 60;
+    ss = ms_of_day / 1000 % 60;
+    cs = ms_of_day / 10 % 100;
+
+    snprintf( time_str, sizeof( time_str ), "%02d%02d%02d.%02d", hh, mm, ss, cs );
+    format_degrees( lat_str, sizeof( lat_str ), alat, 2 );
+    format_degrees( lon_str, sizeof( lon_str ), alon, 3 );
+
+    for( i = 0; i < cfg->num_sats; i++ )
+        used += sats[ i ].used;
+
+    hdop = 0.6 + 6.0 / ( used + 1 ) + rng_uniform() * 0.2;
+    vdop = hdop * 1.4;
+    pdop = sqrt( hdop * hdop + vdop * vdop );
+
+    for( m = 0; m < cfg->num_mix; m++ )
+    {
+        const mix_entry_t *e = &cfg->mix[ m ];
+        const char *t = cfg->talker;
+
+        if( e->probability < 1.0 && rng_uniform() >= e->probability )
+            continue;
+
+        switch( e->type )
+        {
+        case S_RMC:
+            emit( cfg, "%sRMC,%s,A,%s,%c,%s,%c,%.3f,%.2f,%02d%02d%02d,3.1,W,A",
+                  t, time_str, lat_str, ns, lon_str, ew, cfg->speed, cfg->heading,
+                  mday, month, year % 100 );
+            break;
+        case S_VTG:
+            emit( cfg, "%sVTG,%.2f,T,%.2f,M,%.3f,N,%.3f,K,A", t, cfg->heading,
+                  fmod( cfg->heading + 3.1, 360.0 ), cfg->speed, cfg->speed * 1.852 );
+            break;
+        case S_GGA:
+            emit( cfg, "%sGGA,%s,%s,%c,%s,%c,1,%02d,%.2f,%.1f,M,46.9,M,,",
+                  t, time_str, lat_str, ns, lon_str, ew, used, hdop, cfg->alt );
+            break;
+        case S_GSA:
+            for( c = 0, first = 0; c < cfg->num_constellations; c++ )
+            {
+                const constellation_t *con = &cfg->constellations[ c ];
+                char prns[ 12 ][ 4 ];
+                int n = 0;
+
+                memset( prns, 0, sizeof( prns ) );
+
+                for( i = first; i < first + con->count && n < 12; i++ )
+                {
+                    if( sats[ i ].used )
+                        sprintf( prns[ n++ ], "%02d", sats[ i ].prn );
+                }
+
+                first += con->count;
+
+                emit( cfg, "%sGSA,A,3,%s,%s,%s,%s,%s,%s,%s,%s,%s,%s,%s,%s,%.2f,%.2f,%.2f",
+                      con->talker, prns[ 0 ], prns[ 1 ], prns[ 2 ], prns[ 3 ], prns[ 4 ],
+                      prns[ 5 ], prns[ 6 ], prns[ 7 ], prns[ 8 ], prns[ 9 ], prns[ 10 ],
+                      prns[ 11 ], pdop, hdop, vdop );
+            }
+            break;
+        case S_GSV:
+            for( c = 0, first = 0; c < cfg->num_constellations; c++ )
+            {
+                const constellation_t *con = &cfg->constellations[ c ];
+                int total = ( con->count + 3 ) / 4, s;
+
+                for( s = 0; s < total; s++ )
+                {
+                    char body[ 80 ];
+                    int pos = 0, k;
+
+                    for( k = 0; k < 4 && s * 4 + k < con->count; k++ )
+                    {
+                        const satellite_t *sat = &sats[ first + s * 4 + k ];
+
+                        pos += sprintf( &body[ pos ], ",%02d,%02d,%03d,%02d", sat->prn,
+                                        ( int )sat->elevation, ( int )sat->azimuth, sat->snr );
+                    }
+
+                    body[ pos ] = '\0';
+                    emit( cfg, "%sGSV,%d,%d,%02d%s", con->talker, total, s + 1,
+                          con->count, body );
+                }
+
+                first += con->count;
+            }
+            break;
+        case S_GLL:
+            emit( cfg, "%sGLL,%s,%c,%s,%c,%s,A,A", t, lat_str, ns, lon_str, ew, time_str );
+            break;
+        case S_ZDA:
+            emit( cfg, "%sZDA,%s,%02d,%02d,%04d,00,00", t, time_str, mday, month, year );
+            break;
+        case S_GST:
+            emit( cfg, "%sGST,%s,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f", t, time_str,
+                  hdop * 2.0, hdop * 1.5, hdop, rng_uniform() * 180.0,
+                  hdop * 1.2, hdop * 1.1, vdop * 1.6 );
+            break;
+        case S_GBS:
+            emit( cfg, "%sGBS,%s,%.1f,%.1f,%.1f,,,,", t, time_str,
+                  hdop * 1.2, hdop * 1.1, vdop * 1.6 );
+            break;
+        case S_GRS:
+            emit( cfg, "%sGRS,%s,1,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,,,,,,", t, time_str,
+                  rng_uniform() * 4 - 2, rng_uniform() * 4 - 2, rng_uniform() * 4 - 2,
+                  rng_uniform() * 4 - 2, rng_uniform() * 4 - 2, rng_uniform() * 4 - 2 );
+            break;
+        case S_DTM:
+            emit( cfg, "%sDTM,W84,,0.0,N,0.0,E,0.0,W84", t );
+            break;
+        case S_THS:
+            emit( cfg, "%sTHS,%.2f,A", t, cfg->heading );
+            break;
+        case S_TXT:
+            emit( cfg, "%sTXT,01,01,02,%s", t,
+                  txt_messages[ rng_next() % ( sizeof( txt_messages ) / sizeof( txt_messages[ 0 ] ) ) ] );
+            break;
+        case S_GPQ:
+            emit( cfg, "%sGPQ,%s", t, sentence_names[ rng_range( 0, S_GLL ) ] );
+            break;
+        default:
+            break;
+        }
+    }
+
+    stats.epochs++;
+}
+
+static void advance( config_t *cfg )
+{
+    double dt = 1.0 / cfg->rate;
+    double dist = cfg->speed * KNOTS_TO_MPS * dt;
+    double hdg = cfg->heading * DEG_TO_RAD;
+
+    cfg->lat += dist * cos( hdg ) / EARTH_RADIUS / DEG_TO_RAD;
+    cfg->lon += dist * sin( hdg ) / ( EARTH_RADIUS * cos( cfg->lat * DEG_TO_RAD ) ) / DEG_TO_RAD;
+
+    if( cfg->lat > 89.0 )
+        cfg->lat = 89.0;
+    else if( cfg->lat < -89.0 )
+        cfg->lat = -89.0;
+
+    if( cfg->lon > 180.0 )
+        cfg->lon -= 360.0;
+    else if( cfg->lon < -180.0 )
+        cfg->lon += 360.0;
+
+    cfg->heading += cfg->turn * dt + ( rng_uniform() - 0.5 ) * 2.0 * cfg->wander * dt;
+    cfg->heading = fmod( cfg->heading + 360.0, 360.0 );
+    cfg->alt += cfg->climb * dt;
+    cfg->time_ms += ( int64_t )llround( 1000.0 * dt );
+
+    satellites_step( dt );
+}
+
+static void usage( const char *name )
+{
+    fprintf( stderr,
+             "usage: %s [options]\n"
+             "Trajectory\n"
+             "  --lat DEG --lon DEG --alt M   start position ( 48.1173 11.5167 545.4 )\n"
+             "  --speed KNOTS                 ground speed ( 22.4 )\n"
+             "  --heading DEG                 initial heading ( 84.4 )\n"
+             "  --turn DEG/S                  constant turn rate ( 0 )\n"
+             "  --wander DEG/S                random heading change ( 0 )\n"
+             "  --climb M/S                   vertical speed ( 0 )\n"
+             "  --start YYYY-MM-DDTHH:MM:SS   first epoch ( 2015-08-25T12:00:00 )\n"
+             "Receiver\n"
+             "  --rate HZ                     epochs per second ( 1 )\n"
+             "  --constellations LIST         GP,GL,GA,GB ( GP )\n"
+             "  --sats N                      satellites in view ( 12 )\n"
+             "  --talker ID                   talker for position sentences ( GP )\n"
+             "  --mix LIST                    sentences and optional per epoch\n"
+             "                                probability, e.g. RMC,GGA,TXT:0.1\n"
+             "Errors ( probability per sentence )\n"
+             "  --bad-checksum P --truncate P --noise P --drop-cr P --long-field P\n"
+             "  --ubx P\n"
+             "Size and output\n"
+             "  --seed N                      PRNG seed ( 1 )\n"
+             "  --epochs N                    number of epochs ( 3600 )\n"
+             "  --bytes SIZE                  stop after SIZE bytes, K/M/G suffix\n"
+             "  -o, --output FILE             output file ( stdout )\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    enum
+    {
+        OPT_LAT = 256, OPT_LON, OPT_ALT, OPT_SPEED, OPT_HEADING, OPT_TURN, OPT_WANDER,
+        OPT_CLIMB, OPT_START, OPT_RATE, OPT_CONST, OPT_SATS, OPT_TALKER, OPT_MIX,
+        OPT_BAD, OPT_TRUNC, OPT_NOISE, OPT_DROPCR, OPT_LONG, OPT_UBX, OPT_SEED, OPT_EPOCHS, OPT_BYTES
+    };
+    static const struct option long_opts[] =
+    {
+        { "lat", required_argument, 0, OPT_LAT },
+        { "lon", required_argument, 0, OPT_LON },
+        { "alt", required_argument, 0, OPT_ALT },
+        { "speed", required_argument, 0, OPT_SPEED },
+        { "heading", required_argument, 0, OPT_HEADING },
+        { "turn", required_argument, 0, OPT_TURN },
+        { "wander", required_argument, 0, OPT_WANDER },
+        { "climb", required_argument, 0, OPT_CLIMB },
+        { "start", required_argument, 0, OPT_START },
+        { "rate", required_argument, 0, OPT_RATE },
+        { "constellations", required_argument, 0, OPT_CONST },
+        { "sats", required_argument, 0, OPT_SATS },
+        { "talker", required_argument, 0, OPT_TALKER },
+        { "mix", required_argument, 0, OPT_MIX },
+        { "bad-checksum", required_argument, 0, OPT_BAD },
+        { "truncate", required_argument, 0, OPT_TRUNC },
+        { "noise", required_argument, 0, OPT_NOISE },
+        { "drop-cr", required_argument, 0, OPT_DROPCR },
+        { "long-field", required_argument, 0, OPT_LONG },
+        { "ubx", required_argument, 0, OPT_UBX },
+        { "seed", required_argument, 0, OPT_SEED },
+        { "epochs", required_argument, 0, OPT_EPOCHS },
+        { "bytes", required_argument, 0, OPT_BYTES },
+        { "output", required_argument, 0, 'o' },
+        { "help", no_argument, 0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+    config_t cfg;
+    uint64_t epochs = 3600, max_bytes = 0, seed = 1, e;
+    int opt;
+
+    memset( &cfg, 0, sizeof( cfg ) );
+    cfg.lat = 48.1173;
+    cfg.lon = 11.5167;
+    cfg.alt = 545.4;
+    cfg.speed = 22.4;
+    cfg.heading = 84.4;
+    cfg.rate = 1.0;
+    cfg.num_sats = 12;
+    memcpy( cfg.talker, "GP", 3 );
+    parse_start( "2015-08-25T12:00:00", &cfg.time_ms );
+    parse_mix( &cfg, default_mix );
+    parse_constellations( &cfg, "GP" );
+    out_fp = stdout;
+
+    while( ( opt = getopt_long( argc, argv, "o:h", long_opts, NULL ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case OPT_LAT: cfg.lat = atof( optarg ); break;
+        case OPT_LON: cfg.lon = atof( optarg ); break;
+        case OPT_ALT: cfg.alt = atof( optarg ); break;
+        case OPT_SPEED: cfg.speed = atof( optarg ); break;
+        case OPT_HEADING: cfg.heading = atof( optarg ); break;
+        case OPT_TURN: cfg.turn = atof( optarg ); break;
+        case OPT_WANDER: cfg.wander = atof( optarg ); break;
+        case OPT_CLIMB: cfg.climb = atof( optarg ); break;
+        case OPT_RATE: cfg.rate = atof( optarg ); break;
+        case OPT_SATS: cfg.num_sats = atoi( optarg ); break;
+        case OPT_BAD: cfg.bad_checksum = atof( optarg ); break;
+        case OPT_TRUNC: cfg.truncate = atof( optarg ); break;
+        case OPT_NOISE: cfg.noise = atof( optarg ); break;
+        case OPT_DROPCR: cfg.drop_cr = atof( optarg ); break;
+        case OPT_LONG: cfg.long_field = atof( optarg ); break;
+        case OPT_UBX: cfg.ubx = atof( optarg ); break;
+        case OPT_SEED: seed = strtoull( optarg, NULL, 0 ); break;
+        case OPT_EPOCHS: epochs = strtoull( optarg, NULL, 0 ); break;
+        case OPT_BYTES: max_bytes = parse_size( optarg ); epochs = UINT64_MAX; break;
+        case OPT_TALKER:
+            if( strlen( optarg ) != 2 )
+            {
+                usage( argv[ 0 ] );
+                return 2;
+            }
+            memcpy( cfg.talker, optarg, 3 );
+            break;
+        case OPT_START:
+            if( parse_start( optarg, &cfg.time_ms ) )
+            {
+                usage( argv[ 0 ] );
+                return 2;
+            }
+            break;
+        case OPT_MIX:
+            if( parse_mix( &cfg, optarg ) )
+                return 2;
+            break;
+        case OPT_CONST:
+            if( parse_constellations( &cfg, optarg ) )
+                return 2;
+            break;
+        case 'o':
+            out_fp = fopen( optarg, "wb" );
+            if( out_fp == NULL )
+            {
+                perror( optarg );
+                return 1;
+            }
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( cfg.rate <= 0.0 || cfg.rate > 100.0 || cfg.num_sats < 1 || cfg.num_sats > MAX_SATS )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    /* Zero would lock xorshift at zero forever */
+    rng_state = seed ? seed * 0x9E3779B97F4A7C15ull : 0x9E3779B97F4A7C15ull;
+
+    satellites_init( &cfg );
+    satellites_step( 0.0 );
+
+    for( e = 0; e < epochs && ( max_bytes == 0 || stats.bytes < max_bytes ); e++ )
+    {
+        generate_epoch( &cfg );
+        advance( &cfg );
+    }
+
+    out_flush();
+
+    if( out_fp != stdout )
+        fclose( out_fp );
+
+    fprintf( stderr, "%llu epochs, %llu sentences, %llu bytes "
+             "( checksum %llu, truncated %llu, noise %llu, drop-cr %llu, long-field %llu, "
+             "ubx %llu )\n",
+             ( unsigned long long )stats.epochs, ( unsigned long long )stats.sentences,
+             ( unsigned long long )stats.bytes, ( unsigned long long )stats.bad_checksum,
+             ( unsigned long long )stats.truncated, ( unsigned long long )stats.noise,
+             ( unsigned long long )stats.drop_cr, ( unsigned long long )stats.long_field,
+             ( unsigned long long )stats.ubx );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,805 @@
+/*******************************************************************************
+* Title                 :   Stream Ingestion Worker
+* Filename              :   gps_ingest.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_ingest.c
+ * @brief One epoll loop decoding many NMEA streams into a fleet table.
+ *
+ * The tracks of all connections share one allocation of GPS_INGEST_ROWS
+ * rows each, so decoding must never grow them.  Every line closes at most
+ * one epoch and gps_log_line() decodes no line shorter than LINE_MIN, so a
+ * buffer is parsed in slices of at most GPS_INGEST_ROWS lines and the rows
+ * are dropped after each.
+ *
+ * Descriptors are level triggered and read once per wakeup, so a busy
+ * stream can't hold up the others.
+ *
+ * Receiver IDs map to units through a linear probing table of twice the
+ * units, which is only touched when a stream binds to a unit.  An entry
+ * leaves it when its unit goes to another ID, by backward shift, so no
+ * tombstones pile up.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE         /* SO_REUSEPORT */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "gps_ingest.h"
+#ifdef GPS_IO_URING
+#include "gps_uring.h"
+#endif
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define LINE_MIN        11      /**< $ttFFF,*hh */
+#define SLICE_BYTES     ( GPS_INGEST_ROWS * LINE_MIN )
+#define TAG_LISTEN      UINT64_MAX
+#define TAG_WAKE        ( UINT64_MAX - 1 )
+#define BACKLOG         1024
+#define URING_SQ        256
+#define URING_CQ        8192
+#define URING_BUFFERS   4096    /**< Of GPS_INGEST_BUFFER bytes */
+#define HELLO           "$PUNIT,"
+#define HELLO_MAX       24      /**< $PUNIT,4294967295*hh\r\n */
+#define NO_CONN         SIZE_MAX
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void *column( char *block, size_t *offset, size_t bytes );
+static int rows_alloc( gps_ingest_t *worker );
+static size_t map_home( const gps_ingest_t *worker, uint32_t id );
+static size_t *map_find( gps_ingest_t *worker, uint32_t id );
+static void map_remove( gps_ingest_t *worker, size_t *entry );
+static size_t unit_take( gps_ingest_t *worker );
+static int hello( const char *line, size_t size, uint32_t *id );
+static void conn_bind( gps_ingest_t *worker, size_t index, uint32_t id );
+static void conn_reset( gps_ingest_conn_t *conn );
+static void conn_close( gps_ingest_t *worker, size_t index );
+static size_t conn_decode( gps_ingest_t *worker, size_t index, const char *data,
+                           size_t size );
+static int conn_read( gps_ingest_t *worker, size_t index );
+static int watch( gps_ingest_t *worker, int fd, uint64_t tag );
+static void accept_all( gps_ingest_t *worker );
+#ifdef GPS_IO_URING
+static void conn_data( gps_ingest_t *worker, size_t index, const char *data,
+                       size_t size );
+static int uring_read( gps_ingest_t *worker, gps_uring_t *ring, size_t index );
+static int uring_accept( gps_uring_t *ring, int fd );
+static int uring_arm( gps_ingest_t *worker, gps_uring_t *ring, uint64_t *count );
+#endif
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* Hands out the next bytes of a block */
+static void *column( char *block, size_t *offset, size_t bytes )
+{
+    void *p = block + *offset;
+
+    *offset += bytes;
+    return p;
+}
+
+/* Points the track of every connection at its rows of one block */
+static int rows_alloc( gps_ingest_t *worker )
+{
+    gps_track_t c;
+    size_t rows = worker->size * GPS_INGEST_ROWS;
+    size_t row_bytes = sizeof( *c.time ) + sizeof( *c.latitude ) + sizeof( *c.longitude ) +
+                       sizeof( *c.altitude ) + sizeof( *c.speed ) + sizeof( *c.track ) +
+                       sizeof( *c.hdop ) + sizeof( *c.fields ) + sizeof( *c.quality ) +
+                       sizeof( *c.satellites );
+    char *p = malloc( rows * row_bytes );
+    size_t offset = 0, i;
+
+    if( p == NULL )
+        return -1;
+
+    worker->rows = p;
+
+    /* Widest columns first keeps every column aligned */
+    c.time = column( p, &offset, rows * sizeof( *c.time ) );
+    c.latitude = column( p, &offset, rows * sizeof( *c.latitude ) );
+    c.longitude = column( p, &offset, rows * sizeof( *c.longitude ) );
+    c.altitude = column( p, &offset, rows * sizeof( *c.altitude ) );
+    c.speed = column( p, &offset, rows * sizeof( *c.speed ) );
+    c.track = column( p, &offset, rows * sizeof( *c.track ) );
+    c.hdop = column( p, &offset, rows * sizeof( *c.hdop ) );
+    c.fields = column( p, &offset, rows * sizeof( *c.fields ) );
+    c.quality = column( p, &offset, rows * sizeof( *c.quality ) );
+    c.satellites = column( p, &offset, rows * sizeof( *c.satellites ) );
+
+    for( i = 0; i < worker->size; i++ )
+    {
+        gps_track_t *t = &worker->conn[ i ].log.track;
+        size_t first = i * GPS_INGEST_ROWS;
+
+        t->time = c.time + first;
+        t->latitude = c.latitude + first;
+        t->longitude = c.longitude + first;
+        t->altitude = c.altitude + first;
+        t->speed = c.speed + first;
+        t->track = c.track + first;
+        t->hdop = c.hdop + first;
+        t->fields = c.fields + first;
+        t->quality = c.quality + first;
+        t->satellites = c.satellites + first;
+        t->capacity = GPS_INGEST_ROWS;
+    }
+
+    return 0;
+}
+
+static size_t map_home( const gps_ingest_t *worker, uint32_t id )
+{
+    return ( size_t )( id * 2654435761u ) & worker->map_mask;
+}
+
+/* Entry of an ID, or the empty one where it would go */
+static size_t *map_find( gps_ingest_t *worker, uint32_t id )
+{
+    size_t i = map_home( worker, id );
+
+    while( worker->map[ i ] && worker->unit[ worker->map[ i ] - 1 ].id != id )
+        i = ( i + 1 ) & worker->map_mask;
+
+    return &worker->map[ i ];
+}
+
+/* Moves back the entries after it that would no longer be found */
+static void map_remove( gps_ingest_t *worker, size_t *entry )
+{
+    size_t mask = worker->map_mask;
+    size_t hole = entry - worker->map;
+    size_t i = hole;
+
+    for( ;; )
+    {
+        size_t home;
+
+        i = ( i + 1 ) & mask;
+
+        if( worker->map[ i ] == 0 )
+            break;
+
+        home = map_home( worker, worker->unit[ worker->map[ i ] - 1 ].id );
+
+        if( ( ( i - home ) & mask ) >= ( ( i - hole ) & mask ) )
+        {
+            worker->map[ hole ] = worker->map[ i ];
+            hole = i;
+        }
+    }
+
+    worker->map[ hole ] = 0;
+}
+
+/* A unit without an ID, else the one whose receiver went offline longest ago */
+static size_t unit_take( gps_ingest_t *worker )
+{
+    size_t best = 0, u;
+
+    if( worker->vacant_count )
+        return worker->vacant[ --worker->vacant_count ];
+
+    /* A connection binding has no unit, so one of them is offline */
+    for( u = 1; u < worker->size; u++ )
+    {
+        if( worker->unit[ u ].conn == NO_CONN &&
+            ( worker->unit[ best ].conn != NO_CONN ||
+              worker->fleet->slot[ worker->base + u ].fix.time <
+              worker->fleet->slot[ worker->base + best ].fix.time ) )
+            best = u;
+    }
+
+    map_remove( worker, map_find( worker, worker->unit[ best ].id ) );
+    worker->unit[ best ].id = 0;
+
+    return best;
+}
+
+/* $PUNIT,<id>*hh with a valid checksum and a non-zero ID */
+static int hello( const char *line, size_t size, uint32_t *id )
+{
+    gps_sentence_t type;
+    uint64_t value = 0;
+    size_t i = sizeof( HELLO ) - 1;
+
+    if( size > HELLO_MAX || size < i || memcmp( line, HELLO, i ) ||
+        !gps_log_check( line, size, &type ) )
+        return 0;
+
+    for( ; line[ i ] >= '0' && line[ i ] <= '9'; i++ )
+        value = value * 10 + ( uint64_t )( line[ i ] - '0' );
+
+    if( line[ i ] != '*' || value == 0 || value > UINT32_MAX )
+        return 0;
+
+    *id = ( uint32_t )value;
+
+    return 1;
+}
+
+/* Gives a connection the unit of its ID, taking it over if still online */
+static void conn_bind( gps_ingest_t *worker, size_t index, uint32_t id )
+{
+    size_t *entry = id ? map_find( worker, id ) : NULL;
+    size_t unit;
+
+    if( entry != NULL && *entry )
+    {
+        unit = *entry - 1;
+
+        if( worker->unit[ unit ].conn != NO_CONN )
+        {
+            worker->conn[ worker->unit[ unit ].conn ].unit = GPS_INGEST_REPLACED;
+            worker->stats.takeovers++;
+        }
+    }
+    else
+    {
+        unit = unit_take( worker );
+        worker->unit[ unit ].id = id;
+
+        if( id )
+            *map_find( worker, id ) = unit + 1;
+    }
+
+    worker->unit[ unit ].conn = index;
+    worker->conn[ index ].unit = unit;
+    gps_fleet_online( worker->fleet, worker->base + unit, id, 1 );
+}
+
+/* A fresh context that keeps its rows */
+static void conn_reset( gps_ingest_conn_t *conn )
+{
+    gps_track_t track = conn->log.track;
+
+    gps_log_init( &conn->log );
+    conn->log.track = track;
+    conn->log.track.count = 0;
+    conn->unit = GPS_INGEST_NO_UNIT;
+    conn->fill = 0;
+}
+
+static void conn_close( gps_ingest_t *worker, size_t index )
+{
+    gps_ingest_conn_t *conn = &worker->conn[ index ];
+    size_t unit = conn->unit;
+
+    epoll_ctl( worker->epoll, EPOLL_CTL_DEL, conn->fd, NULL );
+    close( conn->fd );
+    conn->fd = -1;
+    conn_reset( conn );
+
+    /* A unit without an ID is nobody's once offline */
+    if( unit < worker->size )
+    {
+        worker->unit[ unit ].conn = NO_CONN;
+        gps_fleet_online( worker->fleet, worker->base + unit, worker->unit[ unit ].id, 0 );
+
+        if( worker->unit[ unit ].id == 0 )
+            worker->vacant[ worker->vacant_count++ ] = unit;
+    }
+
+    worker->free[ worker->size - worker->open ] = index;
+    worker->open--;
+    worker->stats.closed++;
+}
+
+/* Parses the complete lines of data, returns the bytes used */
+static size_t conn_decode( gps_ingest_t *worker, size_t index, const char *data,
+                           size_t size )
+{
+    gps_ingest_conn_t *conn = &worker->conn[ index ];
+    gps_log_t *log = &conn->log;
+    const char *p = data;
+    const char *end = data + size;
+
+    /* The unit is picked by the first line, which may be a hello */
+    if( conn->unit == GPS_INGEST_NO_UNIT )
+    {
+        const char *nl = memchr( data, '\n', size );
+        uint32_t id = 0;
+
+        if( nl == NULL )
+            return 0;
+
+        if( hello( data, nl + 1 - data, &id ) )
+            p = nl + 1;
+
+        conn_bind( worker, index, id );
+    }
+
+    while( p < end )
+    {
+        size_t n = end - p < SLICE_BYTES ? ( size_t )( end - p ) : SLICE_BYTES;
+        size_t used = gps_log_parse( log, p, n );
+
+        /* A line longer than a slice */
+        if( used == 0 )
+        {
+            const char *nl = memchr( p + n, '\n', end - p - n );
+
+            if( nl == NULL )
+                break;
+
+            used = gps_log_parse( log, p, nl + 1 - p );
+        }
+
+        if( log->track.count )
+        {
+            gps_log_fix_t fix;
+
+            gps_track_get( &log->track, log->track.count - 1, &fix );
+
+            if( conn->unit < worker->size )
+                gps_fleet_publish( worker->fleet, worker->base + conn->unit, &fix );
+
+            gps_log_drop( log );
+        }
+
+        p += used;
+    }
+
+    worker->stats.lines += log->stats.lines;
+    worker->stats.epochs += log->stats.epochs;
+    log->stats.lines = 0;
+    log->stats.epochs = 0;
+
+    return p - data;
+}
+
+/* -1 when the stream ended */
+static int conn_read( gps_ingest_t *worker, size_t index )
+{
+    gps_ingest_conn_t *conn = &worker->conn[ index ];
+    ssize_t n = read( conn->fd, conn->buffer + conn->fill,
+                      GPS_INGEST_BUFFER - conn->fill );
+    size_t used;
+
+    if( n < 0 && ( errno == EAGAIN || errno == EINTR ) )
+        return 0;
+
+    /* Includes EIO of a pty whose other side closed */
+    if( n <= 0 )
+        return -1;
+
+    worker->stats.reads++;
+    worker->stats.bytes += n;
+    conn->fill += n;
+    used = conn_decode( worker, index, conn->buffer, conn->fill );
+
+    if( used == 0 && conn->fill == GPS_INGEST_BUFFER )
+    {
+        worker->stats.overlong++;
+        used = conn->fill;
+    }
+
+    memmove( conn->buffer, conn->buffer + used, conn->fill - used );
+    conn->fill -= used;
+
+    return 0;
+}
+
+static int watch( gps_ingest_t *worker, int fd, uint64_t tag )
+{
+    struct epoll_event ev;
+
+    ev.events = EPOLLIN;
+    ev.data.u64 = tag;
+
+    return epoll_ctl( worker->epoll, EPOLL_CTL_ADD, fd, &ev );
+}
+
+static void accept_all( gps_ingest_t *worker )
+{
+    int fd;
+
+    while( ( fd = accept( worker->listen, NULL, NULL ) ) >= 0 )
+    {
+        if( gps_ingest_add( worker, fd ) < 0 )
+        {
+            worker->stats.refused++;
+            close( fd );
+            continue;
+        }
+
+        worker->stats.accepted++;
+    }
+}
+
+int gps_ingest_init( gps_ingest_t *worker, gps_fleet_t *fleet, size_t shard )
+{
+    size_t i;
+
+    memset( worker, 0, sizeof( gps_ingest_t ) );
+    worker->listen = -1;
+    worker->wake = -1;
+    worker->fleet = fleet;
+    worker->size = fleet->per_shard;
+    worker->base = shard * fleet->per_shard;
+    worker->epoll = epoll_create1( 0 );
+    worker->conn = malloc( worker->size * sizeof( gps_ingest_conn_t ) );
+    worker->free = malloc( worker->size * sizeof( size_t ) );
+    worker->unit = malloc( worker->size * sizeof( gps_ingest_unit_t ) );
+    worker->vacant = malloc( worker->size * sizeof( size_t ) );
+
+    worker->map_mask = 1;
+
+    while( worker->map_mask < 2 * worker->size )
+        worker->map_mask *= 2;
+
+    worker->map = calloc( worker->map_mask, sizeof( size_t ) );
+    worker->map_mask--;
+
+    if( worker->epoll < 0 || worker->conn == NULL || worker->free == NULL ||
+        worker->unit == NULL || worker->vacant == NULL || worker->map == NULL )
+    {
+        int error = worker->epoll < 0 ? errno : ENOMEM;
+
+        gps_ingest_free( worker );
+        errno = error;
+        return -1;
+    }
+
+    for( i = 0; i < worker->size; i++ )
+    {
+        worker->conn[ i ].fd = -1;
+        worker->free[ i ] = worker->size - 1 - i;
+        worker->unit[ i ].id = 0;
+        worker->unit[ i ].conn = NO_CONN;
+        worker->vacant[ i ] = worker->size - 1 - i;
+    }
+
+    worker->vacant_count = worker->size;
+
+    if( rows_alloc( worker ) )
+    {
+        gps_ingest_free( worker );
+        errno = ENOMEM;
+        return -1;
+    }
+
+    for( i = 0; i < worker->size; i++ )
+        conn_reset( &worker->conn[ i ] );
+
+    worker->wake = eventfd( 0, 0 );
+
+    if( worker->wake < 0 || watch( worker, worker->wake, TAG_WAKE ) )
+    {
+        int error = errno;
+
+        gps_ingest_free( worker );
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+void gps_ingest_free( gps_ingest_t *worker )
+{
+    size_t i;
+
+    for( i = 0; worker->conn != NULL && worker->open > 0 && i < worker->size; i++ )
+    {
+        if( worker->conn[ i ].fd >= 0 )
+            conn_close( worker, i );
+    }
+
+    if( worker->listen >= 0 )
+        close( worker->listen );
+
+    if( worker->wake >= 0 )
+        close( worker->wake );
+
+    if( worker->epoll >= 0 )
+        close( worker->epoll );
+
+    free( worker->rows );
+    free( worker->conn );
+    free( worker->free );
+    free( worker->unit );
+    free( worker->vacant );
+    free( worker->map );
+    memset( worker, 0, sizeof( gps_ingest_t ) );
+    worker->listen = -1;
+    worker->wake = -1;
+    worker->epoll = -1;
+}
+
+int gps_ingest_listen( gps_ingest_t *worker, uint16_t port )
+{
+    struct sockaddr_in addr;
+    int one = 1;
+    int fd = socket( AF_INET, SOCK_STREAM, 0 );
+
+    if( fd < 0 )
+        return -1;
+
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_ANY );
+    addr.sin_port = htons( port );
+
+    if( setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) ) ||
+        setsockopt( fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof( one ) ) ||
+        bind( fd, ( struct sockaddr * )&addr, sizeof( addr ) ) ||
+        listen( fd, BACKLOG ) ||
+        fcntl( fd, F_SETFL, O_NONBLOCK ) ||
+        watch( worker, fd, TAG_LISTEN ) )
+    {
+        int error = errno;
+
+        close( fd );
+        errno = error;
+        return -1;
+    }
+
+    worker->listen = fd;
+
+    return 0;
+}
+
+long gps_ingest_add( gps_ingest_t *worker, int fd )
+{
+    size_t index;
+
+    if( worker->open == worker->size )
+    {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    index = worker->free[ worker->size - 1 - worker->open ];
+
+    if( fcntl( fd, F_SETFL, fcntl( fd, F_GETFL ) | O_NONBLOCK ) ||
+        watch( worker, fd, index ) )
+        return -1;
+
+    worker->conn[ index ].fd = fd;
+    worker->open++;
+
+    return ( long )index;
+}
+
+int gps_ingest_run( gps_ingest_t *worker )
+{
+    struct epoll_event events[ GPS_INGEST_EVENTS ];
+
+    for( ;; )
+    {
+        int stop = 0;
+        int n = epoll_wait( worker->epoll, events, GPS_INGEST_EVENTS, -1 );
+        int i;
+
+        if( n < 0 && errno == EINTR )
+            continue;
+
+        if( n < 0 )
+            return -1;
+
+        for( i = 0; i < n; i++ )
+        {
+            uint64_t tag = events[ i ].data.u64;
+
+            if( tag == TAG_WAKE )
+            {
+                uint64_t count;
+
+                stop = read( worker->wake, &count, sizeof( count ) ) == sizeof( count );
+            }
+            else if( tag == TAG_LISTEN )
+            {
+                accept_all( worker );
+            }
+            else if( conn_read( worker, ( size_t )tag ) )
+            {
+                conn_close( worker, ( size_t )tag );
+            }
+        }
+
+        if( stop )
+            return 0;
+    }
+}
+
+void gps_ingest_stop( gps_ingest_t *worker )
+{
+    uint64_t one = 1;
+
+    if( write( worker->wake, &one, sizeof( one ) ) != sizeof( one ) )
+        return;
+}
+
+#ifdef GPS_IO_URING
+/* Decodes a buffer the kernel filled, after the line left from the last */
+static void conn_data( gps_ingest_t *worker, size_t index, const char *data,
+                       size_t size )
+{
+    gps_ingest_conn_t *conn = &worker->conn[ index ];
+    size_t used;
+
+    worker->stats.reads++;
+    worker->stats.bytes += size;
+
+    if( conn->fill )
+    {
+        const char *nl = memchr( data, '\n', size );
+        size_t take = nl != NULL ? ( size_t )( nl + 1 - data ) : size;
+
+        if( conn->fill + take > GPS_INGEST_BUFFER )
+        {
+            worker->stats.overlong++;
+            conn->fill = 0;
+        }
+        else
+        {
+            memcpy( conn->buffer + conn->fill, data, take );
+            conn->fill += take;
+
+            if( nl != NULL )
+                conn->fill -= conn_decode( worker, index, conn->buffer, conn->fill );
+        }
+
+        data += take;
+        size -= take;
+
+        if( size == 0 )
+            return;
+    }
+
+    /* Only the unterminated line at the end is copied */
+    used = conn_decode( worker, index, data, size );
+    memcpy( conn->buffer, data + used, size - used );
+    conn->fill = size - used;
+}
+
+/* Queues the read of a connection, submitting once to make room, else closes it */
+static int uring_read( gps_ingest_t *worker, gps_uring_t *ring, size_t index )
+{
+    int fd = worker->conn[ index ].fd;
+
+    if( gps_uring_read_multishot( ring, fd, index ) == 0 ||
+        ( gps_uring_submit( ring, 0 ) == 0 && gps_uring_read_multishot( ring, fd, index ) == 0 ) )
+        return 0;
+
+    conn_close( worker, index );
+    return -1;
+}
+
+/* Queues the accepts, submitting once to make room */
+static int uring_accept( gps_uring_t *ring, int fd )
+{
+    if( gps_uring_accept_multishot( ring, fd, TAG_LISTEN ) == 0 )
+        return 0;
+
+    return gps_uring_submit( ring, 0 ) || gps_uring_accept_multishot( ring, fd, TAG_LISTEN );
+}
+
+/* Reads of the open connections, accepts and the stop request */
+static int uring_arm( gps_ingest_t *worker, gps_uring_t *ring, uint64_t *count )
+{
+    size_t i;
+
+    for( i = 0; i < worker->size; i++ )
+    {
+        if( worker->conn[ i ].fd >= 0 &&
+            gps_uring_read_multishot( ring, worker->conn[ i ].fd, i ) )
+            return -1;
+    }
+
+    if( worker->listen >= 0 && gps_uring_accept_multishot( ring, worker->listen, TAG_LISTEN ) )
+        return -1;
+
+    return gps_uring_read( ring, worker->wake, count, sizeof( *count ), TAG_WAKE );
+}
+
+int gps_ingest_run_uring( gps_ingest_t *worker )
+{
+    gps_uring_t ring;
+    uint64_t count;
+    int probed = 0;
+    int stop = 0;
+    int error = 0;
+
+    if( gps_uring_init( &ring, URING_SQ, URING_CQ, URING_BUFFERS, GPS_INGEST_BUFFER ) )
+        return -1;
+
+    if( uring_arm( worker, &ring, &count ) )
+        error = errno;
+
+    while( !stop && !error )
+    {
+        struct io_uring_cqe *cqe;
+
+        if( gps_uring_submit( &ring, 1 ) )
+        {
+            error = errno;
+            break;
+        }
+
+        while( ( cqe = gps_uring_peek( &ring ) ) != NULL )
+        {
+            uint64_t tag = cqe->user_data;
+            int more = ( cqe->flags & IORING_CQE_F_MORE ) != 0;
+            int res = cqe->res;
+
+            /* Kernels before 6.7 don't know the opcode, which only the
+               first read can tell, later it's the connection's error */
+            if( res == -EINVAL && !probed && tag != TAG_WAKE )
+            {
+                error = EINVAL;
+            }
+            else if( tag == TAG_WAKE )
+            {
+                stop = 1;
+            }
+            else if( tag == TAG_LISTEN )
+            {
+                long index = res >= 0 ? gps_ingest_add( worker, res ) : -1;
+
+                if( res >= 0 && index < 0 )
+                {
+                    worker->stats.refused++;
+                    close( res );
+                }
+                else if( res >= 0 )
+                {
+                    worker->stats.accepted++;
+                    uring_read( worker, &ring, ( size_t )index );
+                }
+
+                if( !more && uring_accept( &ring, worker->listen ) )
+                    error = errno;
+            }
+            else
+            {
+                const char *data = gps_uring_buffer( &ring, cqe );
+
+                probed = 1;
+
+                if( res > 0 && data != NULL )
+                    conn_data( worker, ( size_t )tag, data, res );
+
+                gps_uring_recycle( &ring, cqe );
+
+                /* Out of buffers ends a multishot read without closing */
+                if( res <= 0 && res != -ENOBUFS )
+                    conn_close( worker, ( size_t )tag );
+                else if( !more )
+                    uring_read( worker, &ring, ( size_t )tag );
+            }
+
+            gps_uring_advance( &ring );
+        }
+    }
+
+    gps_uring_free( &ring );
+
+    if( error )
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+#endif
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,188 @@
+/****************************************************************************
+* Title                 :   Stream Ingestion Worker
+* Filename              :   gps_ingest.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*****************************************************************************/
+/**
+ * @file gps_ingest.h
+ * @brief One epoll loop decoding many NMEA streams into a fleet table
+ *
+ * A worker owns a pool of connections allocated up front, each with its
+ * read buffer and a gps_log_t context, and as many fleet units.  Lines
+ * are decoded with gps_log_parse() straight out of the
+ * buffer read() filled, and the last epoch closed is published.  An epoch
+ * closes when the next one starts, so it reaches the table one epoch late.
+ *
+ * Streams are sockets the worker accepts on its own listening socket, or
+ * descriptors handed to it, socketpairs or ptys for example.
+ *
+ * A stream may start with a hello, $PUNIT,<id>*hh with a receiver ID from
+ * 1 to 4294967295.  The worker keeps the unit of every ID it has seen, so
+ * a receiver that reconnects to it gets its unit back, and a connection
+ * of an ID still online takes the unit over from the old one.  Streams
+ * without a hello get a unit nobody has, or the one offline longest.  Run one
+ * worker per core, each with gps_ingest_listen() on the same port: with
+ * SO_REUSEPORT the kernel spreads the connections over them.
+ *
+ * @code
+ * gps_ingest_init( &worker, &fleet, shard );
+ * gps_ingest_listen( &worker, 10110 );
+ * gps_ingest_run( &worker );              // until gps_ingest_stop()
+ * gps_ingest_free( &worker );
+ * @endcode
+ */
+#ifndef GPS_INGEST_H_
+#define GPS_INGEST_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "gps_log.h"
+#include "gps_fleet.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_INGEST_BUFFER   4096    /**< Read buffer of a connection */
+#define GPS_INGEST_ROWS     64      /**< Track rows of a connection */
+#define GPS_INGEST_EVENTS   256     /**< Events taken per epoll_wait */
+#define GPS_INGEST_NO_UNIT  SIZE_MAX        /**< Before the first line */
+#define GPS_INGEST_REPLACED ( SIZE_MAX - 1 )  /**< After a takeover of its unit */
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Stream of a unit
+ */
+typedef struct
+{
+    int fd;                     /**< -1 when free */
+    size_t unit;                /**< In the shard, or GPS_INGEST_NO_UNIT or
+                                     GPS_INGEST_REPLACED */
+    size_t fill;
+    gps_log_t log;
+    char buffer[ GPS_INGEST_BUFFER ];
+} gps_ingest_conn_t;
+
+/**
+ * @struct Receiver of a unit, known to the worker only
+ */
+typedef struct
+{
+    uint32_t id;                /**< 0 without */
+    size_t conn;                /**< Connection, SIZE_MAX when offline */
+} gps_ingest_unit_t;
+
+/**
+ * @struct Counters of a worker, only approximate when read by another thread
+ */
+typedef struct
+{
+    uint64_t accepted;
+    uint64_t refused;           /**< The pool was full */
+    uint64_t closed;
+    uint64_t takeovers;         /**< Connections a newer one of their ID replaced */
+    uint64_t reads;
+    uint64_t bytes;
+    uint64_t lines;
+    uint64_t epochs;
+    uint64_t overlong;          /**< Buffers without a line end, dropped */
+} gps_ingest_stats_t;
+
+/**
+ * @struct Worker
+ */
+typedef struct
+{
+    int epoll;
+    int listen;                 /**< -1 without */
+    int wake;                   /**< eventfd of gps_ingest_stop() */
+    gps_fleet_t *fleet;
+    size_t base;                /**< Unit of the first connection */
+    size_t size;
+    size_t open;
+    gps_ingest_conn_t *conn;
+    size_t *free;               /**< Stack of free connections */
+    gps_ingest_unit_t *unit;    /**< Of the shard */
+    size_t *vacant;             /**< Stack of units without an ID, offline */
+    size_t vacant_count;
+    size_t *map;                /**< Open addressing of ID to unit + 1 */
+    size_t map_mask;
+    void *rows;                 /**< Columns of all tracks */
+    gps_ingest_stats_t stats;
+} gps_ingest_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Worker for the units of a shard of the fleet
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_ingest_init( gps_ingest_t *worker, gps_fleet_t *fleet, size_t shard );
+
+/**
+ * @brief Closes the connections and releases the pool
+ */
+void gps_ingest_free( gps_ingest_t *worker );
+
+/**
+ * @brief Accepts TCP connections on port, shared with other workers
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_ingest_listen( gps_ingest_t *worker, uint16_t port );
+
+/**
+ * @brief Decodes a connected descriptor, before gps_ingest_run()
+ *
+ * Its unit is picked when the first line arrives.
+ *
+ * @return long - its connection or -1 with errno set, ENOSPC when the
+ * pool is full
+ */
+long gps_ingest_add( gps_ingest_t *worker, int fd );
+
+/**
+ * @brief Runs the loop until gps_ingest_stop()
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_ingest_run( gps_ingest_t *worker );
+
+#ifdef GPS_IO_URING
+/**
+ * @brief gps_ingest_run() on io_uring, without a system call per read
+ *
+ * Every connection has one multishot read into buffers of a ring shared
+ * by the worker, and is decoded straight from the buffer the kernel
+ * filled.  Only a line split between two buffers is copied.
+ *
+ * @return int - 0 or -1 with errno set, EINVAL or ENOSYS when the kernel
+ * has no multishot reads, where gps_ingest_run() still works
+ */
+int gps_ingest_run_uring( gps_ingest_t *worker );
+#endif
+
+/**
+ * @brief Makes gps_ingest_run() or gps_ingest_run_uring() return, from any
+ * thread
+ */
+void gps_ingest_stop( gps_ingest_t *worker );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_INGEST_H_ */
+
+/*** End of File **************************************************************/
@@ -0,0 +1,416 @@
+/*******************************************************************************
+* Title                 :   gpsd JSON Server
+* Filename              :   gps_jsond.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_jsond.c
+ * @brief Serves a receiver to gpsd clients on the local machine.
+ *
+ * Reads the receiver a burst at a time and speaks enough of the gpsd
+ * protocol for dashboards and gpsd client libraries: VERSION when a client
+ * connects, ?WATCH, ?DEVICES, ?VERSION and ?POLL.  Every epoch goes to
+ * the watching clients as a TPV object, and as a SKY object too when it
+ * had GSV sentences.  Both are formatted with gps_json.
+ *
+ * It listens on 127.0.0.1 port -p, 2947 as gpsd by default, and on the
+ * Unix socket -u if given.  -d names the device in the objects, the
+ * source by default.  A client that can't take a whole object is
+ * dropped.  Commands are answered between bursts.
+ *
+ * @code
+ * gps_jsond -b 9600 /dev/ttyUSB0 &
+ * gpspipe -w
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "gps_parser.h"
+#include "gps_json.h"
+#include "gps_serial.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define CLIENTS_MAX     64
+#define COMMAND_MAX     256
+#define POLL_MAX        ( 2 * GPS_JSON_MAX + 128 )
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    int fd;                     /* -1 when free */
+    int watch;
+    size_t fill;
+    char command[ COMMAND_MAX ];
+} client_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static client_t clients[ CLIENTS_MAX ];
+static const char *device;
+static char tpv[ GPS_JSON_MAX ];
+static char sky[ GPS_JSON_MAX ];
+static uint16_t tpv_size;
+static uint16_t sky_size;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-b baud] [-p port] [-u socket] [-d device] source\n", name );
+}
+
+static int tcp_listen( long port )
+{
+    struct sockaddr_in addr;
+    int fd = socket( AF_INET, SOCK_STREAM, 0 );
+    int one = 1;
+
+    if( fd < 0 )
+        return -1;
+
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    addr.sin_port = htons( ( uint16_t )port );
+
+    if( setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) ) ||
+        bind( fd, ( struct sockaddr * )&addr, sizeof( addr ) ) || listen( fd, 16 ) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    return fd;
+}
+
+static int unix_listen( const char *path )
+{
+    struct sockaddr_un addr;
+    int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+
+    if( fd < 0 )
+        return -1;
+
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sun_family = AF_UNIX;
+    strncpy( addr.sun_path, path, sizeof( addr.sun_path ) - 1 );
+    unlink( path );
+
+    if( bind( fd, ( struct sockaddr * )&addr, sizeof( addr ) ) || listen( fd, 16 ) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    return fd;
+}
+
+static void client_drop( client_t *c )
+{
+    close( c->fd );
+    c->fd = -1;
+}
+
+/* All of it or the client goes */
+static void client_send( client_t *c, const char *data, size_t size )
+{
+    if( c->fd >= 0 && send( c->fd, data, size, MSG_DONTWAIT ) != ( ssize_t )size )
+        client_drop( c );
+}
+
+static void client_text( client_t *c, const char *text )
+{
+    client_send( c, text, strlen( text ) );
+}
+
+static void send_devices( client_t *c )
+{
+    char text[ GPS_JSON_MAX ];
+
+    client_send( c, text, gps_json_devices( text, sizeof( text ), device ) );
+}
+
+/* The last TPV and SKY without their CR LF */
+static void send_poll( client_t *c )
+{
+    char text[ POLL_MAX ];
+    int n = snprintf( text, sizeof( text ), "{\"class\":\"POLL\",\"active\":1,\"tpv\":[%.*s],"
+                      "\"sky\":[%.*s]}\r\n", tpv_size ? tpv_size - 2 : 0, tpv,
+                      sky_size ? sky_size - 2 : 0, sky );
+
+    client_send( c, text, ( size_t )n < sizeof( text ) ? ( size_t )n : sizeof( text ) - 1 );
+}
+
+static void client_command( client_t *c, const char *command )
+{
+    if( strncmp( command, "?WATCH", 6 ) == 0 )
+    {
+        c->watch = strstr( command, "\"enable\":false" ) == NULL;
+
+        if( c->watch )
+            send_devices( c );
+
+        client_text( c, c->watch ? "{\"class\":\"WATCH\",\"enable\":true,\"json\":true}\r\n"
+                                 : "{\"class\":\"WATCH\",\"enable\":false}\r\n" );
+    }
+    else if( strncmp( command, "?DEVICES", 8 ) == 0 )
+    {
+        send_devices( c );
+    }
+    else if( strncmp( command, "?POLL", 5 ) == 0 )
+    {
+        send_poll( c );
+    }
+    else if( strncmp( command, "?VERSION", 8 ) == 0 )
+    {
+        client_text( c, "{\"class\":\"VERSION\",\"release\":\"gps_jsond\",\"rev\":\"1\","
+                        "\"proto_major\":3,\"proto_minor\":14}\r\n" );
+    }
+    else
+    {
+        client_text( c, "{\"class\":\"ERROR\",\"message\":\"Unrecognized request\"}\r\n" );
+    }
+}
+
+/* Commands end with ';' or a line end */
+static void client_read( client_t *c )
+{
+    ssize_t n = recv( c->fd, c->command + c->fill, COMMAND_MAX - 1 - c->fill, MSG_DONTWAIT );
+    size_t i, start = 0;
+
+    if( n <= 0 )
+    {
+        if( n == 0 || ( errno != EAGAIN && errno != EINTR ) )
+            client_drop( c );
+
+        return;
+    }
+
+    c->fill += n;
+
+    for( i = 0; i < c->fill && c->fd >= 0; i++ )
+    {
+        if( c->command[ i ] == ';' || c->command[ i ] == '\n' )
+        {
+            const char *command;
+
+            c->command[ i ] = '\0';
+            command = c->command + start + strspn( c->command + start, " \r\n" );
+            start = i + 1;
+
+            if( *command )
+                client_command( c, command );
+        }
+    }
+
+    memmove( c->command, c->command + start, c->fill - start );
+    c->fill -= start;
+
+    /* A command longer than the buffer */
+    if( c->fill == COMMAND_MAX - 1 )
+        c->fill = 0;
+}
+
+static void client_accept( int listener )
+{
+    int fd = accept( listener, NULL, NULL );
+    int i;
+
+    if( fd < 0 )
+        return;
+
+    for( i = 0; i < CLIENTS_MAX && clients[ i ].fd >= 0; i++ )
+        ;
+
+    if( i == CLIENTS_MAX )
+    {
+        close( fd );
+        return;
+    }
+
+    memset( &clients[ i ], 0, sizeof( client_t ) );
+    clients[ i ].fd = fd;
+    client_command( &clients[ i ], "?VERSION" );
+}
+
+static void publish( const gps_epoch_t *epoch )
+{
+    int i;
+
+    tpv_size = gps_json_tpv( tpv, sizeof( tpv ), device, epoch );
+
+#ifdef GSV
+    if( epoch->sentences & ( 1u << GPS_SENTENCE_GSV ) )
+    {
+        const gsv_t *gsv = gps_gsv_message( 1 );
+        const uint8_t *used = NULL;
+
+#ifdef GSA
+        used = gps_gsa_sat_prn();
+#endif
+        sky_size = gps_json_sky( sky, sizeof( sky ), device, epoch, gsv,
+                                 gsv->num_sentences, used, used ? 12 : 0 );
+    }
+#endif
+
+    for( i = 0; i < CLIENTS_MAX; i++ )
+    {
+        if( clients[ i ].fd < 0 || !clients[ i ].watch )
+            continue;
+
+        client_send( &clients[ i ], tpv, tpv_size );
+
+        if( epoch->sentences & ( 1u << GPS_SENTENCE_GSV ) )
+            client_send( &clients[ i ], sky, sky_size );
+    }
+}
+
+int main( int argc, char **argv )
+{
+    static gps_serial_t port;
+    const char *path = NULL;
+    struct pollfd fds[ 3 + CLIENTS_MAX ];
+    int listeners[ 2 ] = { -1, -1 };
+    long baud = 0, tcp_port = 2947;
+    uint32_t last = 0;
+    gps_epoch_t epoch;
+    int opt, fd, i;
+
+    while( ( opt = getopt( argc, argv, "b:p:u:d:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'b':
+            baud = strtol( optarg, NULL, 10 );
+            break;
+        case 'p':
+            tcp_port = strtol( optarg, NULL, 10 );
+            break;
+        case 'u':
+            path = optarg;
+            break;
+        case 'd':
+            device = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind != argc - 1 || tcp_port < 0 || tcp_port > 65535 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    if( device == NULL )
+        device = argv[ optind ];
+
+    fd = strcmp( argv[ optind ], "-" ) == 0 ? STDIN_FILENO
+                                            : open( argv[ optind ], O_RDWR | O_NOCTTY );
+
+    if( fd < 0 || gps_serial_setup( &port, fd, baud ) )
+    {
+        perror( argv[ optind ] );
+        return 1;
+    }
+
+    if( tcp_port && ( listeners[ 0 ] = tcp_listen( tcp_port ) ) < 0 )
+    {
+        perror( "tcp" );
+        return 1;
+    }
+
+    if( path != NULL && ( listeners[ 1 ] = unix_listen( path ) ) < 0 )
+    {
+        perror( path );
+        return 1;
+    }
+
+    signal( SIGPIPE, SIG_IGN );
+
+    for( i = 0; i < CLIENTS_MAX; i++ )
+        clients[ i ].fd = -1;
+
+    for( ;; )
+    {
+        int n = 0;
+
+        fds[ n ].fd = port.fd;
+        fds[ n++ ].events = POLLIN;
+        fds[ n ].fd = listeners[ 0 ];
+        fds[ n++ ].events = POLLIN;
+        fds[ n ].fd = listeners[ 1 ];
+        fds[ n++ ].events = POLLIN;
+
+        for( i = 0; i < CLIENTS_MAX; i++ )
+        {
+            fds[ n ].fd = clients[ i ].fd;
+            fds[ n++ ].events = POLLIN;
+        }
+
+        if( poll( fds, n, -1 ) < 0 && errno != EINTR )
+            break;
+
+        if( fds[ 0 ].revents )
+        {
+            if( gps_serial_burst( &port, 0 ) < 0 )
+                break;
+
+            gps_serial_put( &port );
+
+            if( gps_last_epoch( &epoch ) != last )
+            {
+                last = epoch.epoch;
+                publish( &epoch );
+            }
+        }
+
+        for( i = 1; i < 3; i++ )
+        {
+            if( fds[ i ].revents & POLLIN )
+                client_accept( fds[ i ].fd );
+        }
+
+        for( i = 0; i < CLIENTS_MAX; i++ )
+        {
+            if( clients[ i ].fd >= 0 && fds[ 3 + i ].fd == clients[ i ].fd &&
+                fds[ 3 + i ].revents )
+                client_read( &clients[ i ] );
+        }
+    }
+
+    if( errno != EIO )
+        perror( argv[ optind ] );
+
+    if( path != NULL )
+        unlink( path );
+
+    fprintf( stderr, "%u epochs served\n", last );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,1225 @@
+/*******************************************************************************
+* Title                 :   NMEA Log Parser
+* Filename              :   gps_log.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_log.c
+ * @brief Bulk decoding of recorded NMEA into a columnar track.
+ *
+ * The hot loop finds each line with memchr and looks at the formatter
+ * before anything else, so sentences the track doesn't use cost one
+ * memchr.  RMC and GGA are checksummed eight bytes at a time and their
+ * fields are decoded straight from the line with a cursor.
+ *
+ * A chunk of a larger log can't know the epoch open before it or the date
+ * of the rows it starts with.  It keeps the sentences before its first
+ * time (lead) and its first epoch (head) aside, leaves its rows up to the
+ * first RMC date undated, and chunk_stitch() finishes both in order.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE             /* madvise() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include "gps_parser.h"
+#include "gps_log.h"
+#include "gps_export.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define MS_PER_DAY      86400000
+#define HALF_DAY        43200000
+#define TRACK_MIN_ROWS  4096
+#define MAX_DECIMALS    15
+#define CHUNK_MIN_BYTES ( 1u << 20 )
+#define CHUNKS_PER_THREAD 8
+#define STREAM_PER_THREAD ( CHUNKS_PER_THREAD * CHUNK_MIN_BYTES )
+
+/* gps_log_t.chunk */
+#define CHUNK_NONE      0       /**< A whole log */
+#define CHUNK_LEAD      1       /**< No time seen yet */
+#define CHUNK_HEAD      2       /**< In its first epoch */
+#define CHUNK_BODY      3       /**< First epoch closed */
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+/* Workers take the next chunk from a shared counter, so a thread that
+   finishes early keeps taking work from the slower ones */
+typedef struct
+{
+    const char *data;
+    const size_t *bounds;       /* count + 1 chunk offsets */
+    gps_log_t *chunks;
+    size_t count;
+    size_t next;
+    pthread_mutex_t lock;
+} pool_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+/* Multiplying is several times faster than dividing, and the last bit of
+   a double is below anything a receiver reports */
+static const double inv_pow10[ MAX_DECIMALS + 1 ] =
+{
+    1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10, 1e-11,
+    1e-12, 1e-13, 1e-14, 1e-15
+};
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int is_digit( char c );
+static int hex_digit( char c );
+static const char *next_field( const char *p );
+static uint32_t field_uint( const char **pp, int *present );
+static uint64_t field_mantissa( const char **pp, int *decimals, int *present );
+static double field_float( const char **pp, int *present );
+static int32_t field_time( const char **pp );
+static int32_t field_date( const char **pp );
+static int field_degrees( const char **pp, double *degrees );
+static int checksum_ok( const char *line, const char *star );
+static void epoch_begin( gps_log_t *log, int32_t tod );
+static void epoch_close( gps_log_t *log );
+static void epoch_merge( gps_log_epoch_t *e, const gps_log_epoch_t *later );
+static int32_t epoch_day( gps_log_t *log, int32_t day, int32_t tod );
+static void date_backfill( gps_log_t *log, int32_t day, int32_t tod );
+static void decode_rmc( gps_log_t *log, const char *p );
+static void decode_gga( gps_log_t *log, const char *p );
+static void parse_all( gps_log_t *log, const char *data, size_t size );
+static size_t chunk_start( const char *data, size_t size, size_t offset );
+static void chunk_stitch( gps_log_t *log, gps_log_t *chunk );
+static int parse_pool( gps_log_t *log, const char *data, size_t size,
+                       size_t chunk, int threads );
+static void *pool_worker( void *arg );
+static int stream_map( gps_log_t *log, const char *data, size_t size, int threads,
+                       gps_log_sink_t sink, void *context );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* Columns are grown separately so that realloc can move large ones by
+   remapping instead of copying */
+int gps_track_reserve( gps_track_t *track, size_t rows )
+{
+    size_t capacity = track->capacity ? track->capacity * 2 : TRACK_MIN_ROWS;
+    void *p;
+
+    if( rows <= track->capacity )
+        return 0;
+
+    while( capacity < rows )
+        capacity *= 2;
+
+    rows = capacity;
+
+#define GROW( COLUMN )                                                      \
+    p = realloc( track->COLUMN, rows * sizeof( *track->COLUMN ) );          \
+    if( p == NULL )                                                         \
+        return -1;                                                          \
+    track->COLUMN = p;
+
+    GROW( time );
+    GROW( latitude );
+    GROW( longitude );
+    GROW( altitude );
+    GROW( speed );
+    GROW( track );
+    GROW( hdop );
+    GROW( quality );
+    GROW( satellites );
+    GROW( fields );
+#undef GROW
+
+    track->capacity = rows;
+
+    return 0;
+}
+
+static int is_digit( char c )
+{
+    return ( unsigned char )( c - '0' ) < 10;
+}
+
+/* 0 to 15, or -1 for anything but [0-9A-Fa-f] */
+static int hex_digit( char c )
+{
+    if( is_digit( c ) )
+        return c - '0';
+
+    c |= 0x20;
+
+    return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+/* Fields end at ',' or at the '*' of a validated line, which is never passed */
+static const char *next_field( const char *p )
+{
+    while( *p != ',' && *p != '*' )
+        p++;
+
+    return *p == ',' ? p + 1 : p;
+}
+
+static uint32_t field_uint( const char **pp, int *present )
+{
+    const char *p = *pp;
+    uint32_t value = 0;
+
+    while( is_digit( *p ) )
+        value = value * 10 + ( uint32_t )( *p++ - '0' );
+
+    *present = p != *pp;
+    *pp = next_field( p );
+
+    return value;
+}
+
+/* Digits of a decimal number without its point, *decimals after it */
+static uint64_t field_mantissa( const char **pp, int *decimals, int *present )
+{
+    const char *p = *pp;
+    uint64_t mantissa = 0;
+    int frac = 0;
+
+    while( is_digit( *p ) )
+        mantissa = mantissa * 10 + ( uint64_t )( *p++ - '0' );
+
+    if( *p == '.' )
+    {
+        p++;
+
+        while( is_digit( *p ) )
+        {
+            if( frac < MAX_DECIMALS )
+            {
+                mantissa = mantissa * 10 + ( uint64_t )( *p - '0' );
+                frac++;
+            }
+
+            p++;
+        }
+    }
+
+    *present = p != *pp;
+    *decimals = frac;
+    *pp = next_field( p );
+
+    return mantissa;
+}
+
+static double field_float( const char **pp, int *present )
+{
+    int negative = **pp == '-';
+    int decimals;
+    double value;
+
+    *pp += negative;
+    value = ( double )field_mantissa( pp, &decimals, present ) * inv_pow10[ decimals ];
+
+    return negative ? -value : value;
+}
+
+/* hhmmss[.sss] as ms since midnight, -1 when empty or malformed */
+static int32_t field_time( const char **pp )
+{
+    const char *p = *pp;
+    int32_t ms = 0;
+    int32_t scale = 100;
+
+    if( !is_digit( p[ 0 ] ) || !is_digit( p[ 1 ] ) || !is_digit( p[ 2 ] ) ||
+        !is_digit( p[ 3 ] ) || !is_digit( p[ 4 ] ) || !is_digit( p[ 5 ] ) )
+    {
+        *pp = next_field( p );
+        return -1;
+    }
+
+    if( p[ 6 ] == '.' )
+    {
+        const char *f = p + 7;
+
+        while( is_digit( *f ) && scale )
+        {
+            ms += ( *f++ - '0' ) * scale;
+            scale /= 10;
+        }
+    }
+
+    *pp = next_field( p + 6 );
+
+    return ( ( ( p[ 0 ] - '0' ) * 10 + ( p[ 1 ] - '0' ) ) * 3600 +
+             ( ( p[ 2 ] - '0' ) * 10 + ( p[ 3 ] - '0' ) ) * 60 +
+             ( p[ 4 ] - '0' ) * 10 + ( p[ 5 ] - '0' ) ) * 1000 + ms;
+}
+
+/* ddmmyy as days since 1970, -1 when empty */
+static int32_t field_date( const char **pp )
+{
+    const char *p = *pp;
+    int i;
+
+    for( i = 0; i < 6; i++ )
+    {
+        if( !is_digit( p[ i ] ) )
+        {
+            *pp = next_field( p );
+            return -1;
+        }
+    }
+
+    *pp = next_field( p + 6 );
+
+    return ( int32_t )gps_days_from_civil( 2000 + ( p[ 4 ] - '0' ) * 10 + ( p[ 5 ] - '0' ),
+                                           ( p[ 2 ] - '0' ) * 10 + ( p[ 3 ] - '0' ),
+                                           ( p[ 0 ] - '0' ) * 10 + ( p[ 1 ] - '0' ) );
+}
+
+/* ( d )ddmm.mmmm and its hemisphere field */
+static int field_degrees( const char **pp, double *degrees )
+{
+    const char *p = *pp;
+    uint32_t whole = 0, frac = 0;
+    int decimals = 0, present;
+    double value;
+    char hemisphere;
+
+    while( is_digit( *p ) )
+        whole = whole * 10 + ( uint32_t )( *p++ - '0' );
+
+    if( *p == '.' )
+    {
+        p++;
+
+        while( is_digit( *p ) )
+        {
+            if( decimals < 9 )
+            {
+                frac = frac * 10 + ( uint32_t )( *p - '0' );
+                decimals++;
+            }
+
+            p++;
+        }
+    }
+
+    present = p != *pp;
+    p = next_field( p );
+    hemisphere = *p;
+    *pp = next_field( p );
+
+    if( !present )
+        return 0;
+
+    value = whole / 100 + ( whole % 100 + frac * inv_pow10[ decimals ] ) * ( 1.0 / 60.0 );
+    *degrees = ( hemisphere == 'S' || hemisphere == 'W' ) ? -value : value;
+
+    return 1;
+}
+
+/* XOR of everything between '$' and '*', folded from 64 bit words */
+static int checksum_ok( const char *line, const char *star )
+{
+    const char *p = line + 1;
+    uint64_t acc = 0;
+    uint8_t sum;
+    int high, low;
+
+    while( star - p >= 8 )
+    {
+        uint64_t word;
+
+        memcpy( &word, p, 8 );
+        acc ^= word;
+        p += 8;
+    }
+
+    acc ^= acc >> 32;
+    acc ^= acc >> 16;
+    acc ^= acc >> 8;
+    sum = ( uint8_t )acc;
+
+    while( p < star )
+        sum ^= ( uint8_t )*p++;
+
+    high = hex_digit( star[ 1 ] );
+    low = hex_digit( star[ 2 ] );
+
+    return high >= 0 && low >= 0 && sum == ( ( high << 4 ) | low );
+}
+
+static void epoch_begin( gps_log_t *log, int32_t tod )
+{
+    if( tod < 0 || tod == log->open.tod )
+        return;
+
+    if( log->open.tod >= 0 )
+    {
+        epoch_close( log );
+    }
+    else if( log->chunk == CHUNK_LEAD )
+    {
+        /* Belongs to whatever epoch was open before the chunk */
+        log->lead = log->open;
+        log->chunk = CHUNK_HEAD;
+    }
+
+    memset( &log->open, 0, sizeof( log->open ) );
+    log->open.tod = tod;
+    log->open.day = -1;
+}
+
+static void epoch_close( gps_log_t *log )
+{
+    gps_log_epoch_t *e = &log->open;
+    gps_track_t *t = &log->track;
+    int32_t day;
+    size_t row;
+
+    /* It may continue the previous chunk's last epoch */
+    if( log->chunk == CHUNK_HEAD )
+    {
+        log->head = *e;
+        log->chunk = CHUNK_BODY;
+        e->tod = -1;
+        return;
+    }
+
+    if( t->count == t->capacity && gps_track_reserve( t, t->count + 1 ) )
+    {
+        log->error = ENOMEM;
+        return;
+    }
+
+    day = epoch_day( log, e->day, e->tod );
+
+    if( day >= 0 )
+        e->fields |= GPS_EPOCH_DATE;
+
+    row = t->count++;
+    t->time[ row ] = ( int64_t )( day >= 0 ? day : 0 ) * MS_PER_DAY + e->tod;
+    t->latitude[ row ] = e->latitude;
+    t->longitude[ row ] = e->longitude;
+    t->altitude[ row ] = e->altitude;
+    t->speed[ row ] = e->speed;
+    t->track[ row ] = e->track;
+    t->hdop[ row ] = e->hdop;
+    t->quality[ row ] = e->quality;
+    t->satellites[ row ] = e->satellites;
+    t->fields[ row ] = e->fields | GPS_EPOCH_TIME;
+
+    log->stats.epochs++;
+    e->tod = -1;
+}
+
+/* Applies the sentences of a later part of the same epoch */
+static void epoch_merge( gps_log_epoch_t *e, const gps_log_epoch_t *later )
+{
+    uint16_t fields = later->fields;
+
+    if( fields & GPS_EPOCH_POSITION )
+    {
+        e->latitude = later->latitude;
+        e->longitude = later->longitude;
+    }
+
+    if( fields & GPS_EPOCH_ALTITUDE )
+        e->altitude = later->altitude;
+
+    if( fields & GPS_EPOCH_SPEED )
+        e->speed = later->speed;
+
+    if( fields & GPS_EPOCH_TRACK )
+        e->track = later->track;
+
+    if( fields & GPS_EPOCH_HDOP )
+        e->hdop = later->hdop;
+
+    if( fields & GPS_EPOCH_QUALITY )
+        e->quality = later->quality;
+
+    if( fields & GPS_EPOCH_SATS )
+        e->satellites = later->satellites;
+
+    if( later->day >= 0 )
+        e->day = later->day;
+
+    e->fields |= fields;
+}
+
+/* Date of a closing epoch: its own, else the last one, rolled over when the
+   time goes back by half a day.  Returns -1 while no date is known. */
+static int32_t epoch_day( gps_log_t *log, int32_t day, int32_t tod )
+{
+    if( day < 0 && log->day >= 0 )
+    {
+        day = log->day;
+
+        if( tod + HALF_DAY < log->last_tod )
+            day++;
+    }
+
+    if( day < 0 )
+    {
+        log->undated++;
+        return -1;
+    }
+
+    /* A chunk's undated rows are dated by chunk_stitch() */
+    if( log->undated && log->chunk == CHUNK_NONE )
+        date_backfill( log, day, tod );
+
+    log->day = day;
+    log->last_tod = tod;
+
+    return day;
+}
+
+/* Dates the leading rows back from the first dated epoch */
+static void date_backfill( gps_log_t *log, int32_t day, int32_t tod )
+{
+    gps_track_t *t = &log->track;
+    size_t i = log->undated;
+
+    while( i-- > 0 )
+    {
+        int32_t row_tod = ( int32_t )t->time[ i ];
+
+        if( row_tod > tod + HALF_DAY )
+            day--;
+
+        t->time[ i ] = ( int64_t )day * MS_PER_DAY + row_tod;
+        t->fields[ i ] |= GPS_EPOCH_DATE;
+        tod = row_tod;
+    }
+
+    log->undated = 0;
+}
+
+/* time, status, lat, N/S, lon, E/W, speed, track, date */
+static void decode_rmc( gps_log_t *log, const char *p )
+{
+    gps_log_epoch_t *e = &log->open;
+    double lat = 0, lon = 0;
+    int has_lat, has_lon, present;
+    int32_t day;
+    float speed, track;
+    char status;
+
+    epoch_begin( log, field_time( &p ) );
+    status = *p;
+    p = next_field( p );
+    has_lat = field_degrees( &p, &lat );
+    has_lon = field_degrees( &p, &lon );
+
+    if( status == 'A' )
+    {
+        e->fields |= GPS_EPOCH_STATUS;
+
+        if( has_lat && has_lon )
+        {
+            e->latitude = lat;
+            e->longitude = lon;
+            e->fields |= GPS_EPOCH_POSITION;
+        }
+
+        speed = ( float )field_float( &p, &present );
+
+        if( present )
+        {
+            e->speed = speed;
+            e->fields |= GPS_EPOCH_SPEED;
+        }
+
+        track = ( float )field_float( &p, &present );
+
+        if( present )
+        {
+            e->track = track;
+            e->fields |= GPS_EPOCH_TRACK;
+        }
+    }
+    else
+    {
+        p = next_field( next_field( p ) );
+    }
+
+    day = field_date( &p );
+
+    if( day >= 0 )
+        e->day = day;
+}
+
+/* time, lat, N/S, lon, E/W, quality, satellites, hdop, altitude */
+static void decode_gga( gps_log_t *log, const char *p )
+{
+    gps_log_epoch_t *e = &log->open;
+    double lat = 0, lon = 0;
+    int has_lat, has_lon, present;
+    uint32_t quality, sats;
+    float hdop, altitude;
+
+    epoch_begin( log, field_time( &p ) );
+    has_lat = field_degrees( &p, &lat );
+    has_lon = field_degrees( &p, &lon );
+    quality = field_uint( &p, &present );
+
+    if( !present )
+        return;
+
+    e->quality = ( uint8_t )quality;
+    e->fields |= GPS_EPOCH_QUALITY;
+
+    sats = field_uint( &p, &present );
+
+    if( present )
+    {
+        e->satellites = ( uint8_t )sats;
+        e->fields |= GPS_EPOCH_SATS;
+    }
+
+    hdop = ( float )field_float( &p, &present );
+
+    if( present )
+    {
+        e->hdop = hdop;
+        e->fields |= GPS_EPOCH_HDOP;
+    }
+
+    if( quality == 0 )
+        return;
+
+    if( has_lat && has_lon )
+    {
+        e->latitude = lat;
+        e->longitude = lon;
+        e->fields |= GPS_EPOCH_POSITION;
+    }
+
+    altitude = ( float )field_float( &p, &present );
+
+    if( present )
+    {
+        e->altitude = altitude;
+        e->fields |= GPS_EPOCH_ALTITUDE;
+    }
+}
+
+static void parse_all( gps_log_t *log, const char *data, size_t size )
+{
+    size_t used = gps_log_parse( log, data, size );
+
+    if( used < size )
+    {
+        gps_log_line( log, data + used, size - used );
+        log->stats.bytes += size - used;
+    }
+}
+
+/* A '$' right after a newline starts a line however the log is framed */
+static size_t chunk_start( const char *data, size_t size, size_t offset )
+{
+    if( offset == 0 )
+        return 0;
+
+    while( offset < size )
+    {
+        const char *nl = memchr( data + offset - 1, '\n', size - offset + 1 );
+
+        if( nl == NULL )
+            break;
+
+        offset = nl + 1 - data;
+
+        if( offset < size && data[ offset ] == '$' )
+            return offset;
+
+        offset++;
+    }
+
+    return size;
+}
+
+/* Continues the single context parse with a decoded chunk */
+static void chunk_stitch( gps_log_t *log, gps_log_t *chunk )
+{
+    gps_track_t *t = &log->track;
+    const gps_track_t *c = &chunk->track;
+    const gps_log_epoch_t *head;
+    size_t base, lead, i;
+
+    log->stats.bytes += chunk->stats.bytes;
+    log->stats.lines += chunk->stats.lines;
+    log->stats.decoded += chunk->stats.decoded;
+    log->stats.skipped += chunk->stats.skipped;
+    log->stats.invalid += chunk->stats.invalid;
+    log->stats.epochs += chunk->stats.epochs;
+
+    if( chunk->error )
+        log->error = chunk->error;
+
+    if( chunk->chunk == CHUNK_LEAD )
+    {
+        epoch_merge( &log->open, &chunk->open );
+        return;
+    }
+
+    epoch_merge( &log->open, &chunk->lead );
+    head = chunk->chunk == CHUNK_HEAD ? &chunk->open : &chunk->head;
+
+    if( head->tod == log->open.tod )
+    {
+        epoch_merge( &log->open, head );
+    }
+    else
+    {
+        if( log->open.tod >= 0 )
+            epoch_close( log );
+
+        log->open = *head;
+    }
+
+    if( chunk->chunk == CHUNK_HEAD )
+        return;
+
+    epoch_close( log );
+    log->open = chunk->open;
+
+    if( c->count == 0 )
+        return;
+
+    base = t->count;
+
+    if( gps_track_append( t, c, 0, c->count ) )
+    {
+        log->error = ENOMEM;
+        return;
+    }
+
+    /* Rows up to and including the chunk's first date are dated as one
+       context would have; from there on the chunk's own dates are right */
+    lead = chunk->undated < c->count ? chunk->undated + 1 : chunk->undated;
+
+    for( i = base; i < base + lead; i++ )
+    {
+        int32_t tod = ( int32_t )( t->time[ i ] % MS_PER_DAY );
+        int32_t day = -1;
+
+        if( t->fields[ i ] & GPS_EPOCH_DATE )
+            day = ( int32_t )( t->time[ i ] / MS_PER_DAY );
+
+        day = epoch_day( log, day, tod );
+
+        if( day >= 0 )
+        {
+            t->time[ i ] = ( int64_t )day * MS_PER_DAY + tod;
+            t->fields[ i ] |= GPS_EPOCH_DATE;
+        }
+    }
+
+    if( chunk->day >= 0 )
+    {
+        log->day = chunk->day;
+        log->last_tod = chunk->last_tod;
+    }
+}
+
+static int parse_pool( gps_log_t *log, const char *data, size_t size,
+                       size_t chunk, int threads )
+{
+    size_t count = ( size + chunk - 1 ) / chunk;
+    size_t *bounds = malloc( ( count + 1 ) * sizeof( size_t ) );
+    pthread_t *workers = malloc( threads * sizeof( pthread_t ) );
+    int started = 0;
+    pool_t pool;
+    size_t i;
+
+    pool.chunks = calloc( count, sizeof( gps_log_t ) );
+
+    if( bounds == NULL || workers == NULL || pool.chunks == NULL )
+    {
+        free( bounds );
+        free( workers );
+        free( pool.chunks );
+        errno = ENOMEM;
+        return -1;
+    }
+
+    for( i = 0; i < count; i++ )
+        bounds[ i ] = chunk_start( data, size, i * chunk );
+
+    bounds[ count ] = size;
+    pool.data = data;
+    pool.bounds = bounds;
+    pool.count = count;
+    pool.next = 0;
+    pthread_mutex_init( &pool.lock, NULL );
+
+    /* The calling thread is a worker too; fewer threads only take longer */
+    while( started < threads - 1 &&
+           pthread_create( &workers[ started ], NULL, pool_worker, &pool ) == 0 )
+        started++;
+
+    pool_worker( &pool );
+
+    while( started > 0 )
+        pthread_join( workers[ --started ], NULL );
+
+    for( i = 0; i < count; i++ )
+    {
+        chunk_stitch( log, &pool.chunks[ i ] );
+        gps_log_free( &pool.chunks[ i ] );
+    }
+
+    pthread_mutex_destroy( &pool.lock );
+    free( pool.chunks );
+    free( workers );
+    free( bounds );
+
+    return 0;
+}
+
+static void *pool_worker( void *arg )
+{
+    pool_t *pool = arg;
+
+    for( ;; )
+    {
+        gps_log_t *chunk;
+        size_t i;
+
+        pthread_mutex_lock( &pool->lock );
+        i = pool->next++;
+        pthread_mutex_unlock( &pool->lock );
+
+        if( i >= pool->count )
+            break;
+
+        chunk = &pool->chunks[ i ];
+        gps_log_init( chunk );
+        chunk->chunk = CHUNK_LEAD;
+        parse_all( chunk, pool->data + pool->bounds[ i ],
+                   pool->bounds[ i + 1 ] - pool->bounds[ i ] );
+    }
+
+    return NULL;
+}
+
+int gps_track_write_csv( const gps_track_t *track, const char *path )
+{
+    gps_export_t *exp = malloc( sizeof( gps_export_t ) );
+    int fd = open( path, O_WRONLY | O_CREAT | O_TRUNC, 0666 );
+    int result = -1;
+    int error;
+
+    if( exp != NULL && fd >= 0 && gps_export_open( exp, fd, GPS_EXPORT_CSV ) == 0 &&
+        gps_export_track( exp, track, 0, track->count ) == 0 )
+        result = gps_export_close( exp );
+
+    error = exp == NULL ? ENOMEM : errno;
+    free( exp );
+
+    if( fd >= 0 && close( fd ) && result == 0 )
+        return -1;
+
+    errno = error;
+
+    return result;
+}
+
+void gps_log_init( gps_log_t *log )
+{
+    memset( log, 0, sizeof( gps_log_t ) );
+    log->open.tod = -1;
+    log->open.day = -1;
+    log->lead.day = -1;
+    log->head.day = -1;
+    log->day = -1;
+}
+
+int gps_track_append( gps_track_t *track, const gps_track_t *from,
+                      size_t first, size_t rows )
+{
+    size_t base = track->count;
+
+    if( gps_track_reserve( track, base + rows ) )
+        return -1;
+
+#define APPEND( COLUMN )                                                    \
+    memcpy( track->COLUMN + base, from->COLUMN + first,                     \
+            rows * sizeof( *from->COLUMN ) );
+
+    APPEND( time );
+    APPEND( latitude );
+    APPEND( longitude );
+    APPEND( altitude );
+    APPEND( speed );
+    APPEND( track );
+    APPEND( hdop );
+    APPEND( quality );
+    APPEND( satellites );
+    APPEND( fields );
+#undef APPEND
+
+    track->count += rows;
+
+    return 0;
+}
+
+void gps_track_free( gps_track_t *track )
+{
+    free( track->time );
+    free( track->latitude );
+    free( track->longitude );
+    free( track->altitude );
+    free( track->speed );
+    free( track->track );
+    free( track->hdop );
+    free( track->quality );
+    free( track->satellites );
+    free( track->fields );
+    memset( track, 0, sizeof( gps_track_t ) );
+}
+
+void gps_track_get( const gps_track_t *track, size_t row, gps_log_fix_t *fix )
+{
+    fix->time = track->time[ row ];
+    fix->latitude = track->latitude[ row ];
+    fix->longitude = track->longitude[ row ];
+    fix->altitude = track->altitude[ row ];
+    fix->speed = track->speed[ row ];
+    fix->track = track->track[ row ];
+    fix->hdop = track->hdop[ row ];
+    fix->quality = track->quality[ row ];
+    fix->satellites = track->satellites[ row ];
+    fix->fields = track->fields[ row ];
+}
+
+void gps_log_fix_epoch( gps_log_fix_t *fix, const gps_epoch_t *epoch )
+{
+    int64_t time = ( ( epoch->time.hour * 60 + epoch->time.minute ) * 60 +
+                     epoch->time.second ) * 1000 + epoch->time.ms;
+
+    if( epoch->fields & GPS_EPOCH_DATE )
+        time += gps_days_from_civil( ( int32_t )epoch->date.yy, epoch->date.mo,
+                                     epoch->date.md ) * MS_PER_DAY;
+
+    fix->time = time;
+    fix->latitude = epoch->latitude;
+    fix->longitude = epoch->longitude;
+    fix->altitude = ( float )epoch->altitude;
+    fix->speed = ( float )epoch->speed;
+    fix->track = ( float )epoch->track;
+    fix->hdop = epoch->hdop;
+    fix->quality = ( uint8_t )epoch->quality;
+    fix->satellites = epoch->num_sats;
+    fix->fields = epoch->fields;
+}
+
+void gps_log_free( gps_log_t *log )
+{
+    gps_track_free( &log->track );
+}
+
+gps_sentence_t gps_log_stamp( const char *line, size_t length, int32_t *tod,
+                              int32_t *day )
+{
+    const char *end = line + length;
+    const char *p = line + 7;
+    int rmc;
+
+    while( end > line && ( end[ -1 ] == '\n' || end[ -1 ] == '\r' ) )
+        end--;
+
+    if( end - line < 11 || line[ 0 ] != '$' || line[ 6 ] != ',' || end[ -3 ] != '*' )
+        return GPS_SENTENCE_UNKNOWN;
+
+    rmc = line[ 3 ] == 'R' && line[ 4 ] == 'M' && line[ 5 ] == 'C';
+
+    if( ( !rmc && !( line[ 3 ] == 'G' && line[ 4 ] == 'G' && line[ 5 ] == 'A' ) ) ||
+        !checksum_ok( line, end - 3 ) )
+        return GPS_SENTENCE_UNKNOWN;
+
+    *tod = field_time( &p );
+    *day = -1;
+
+    if( *tod < 0 )
+        return GPS_SENTENCE_UNKNOWN;
+
+    if( !rmc )
+        return GPS_SENTENCE_GGA;
+
+    /* status, lat, N/S, lon, E/W, speed, track */
+    for( rmc = 0; rmc < 7; rmc++ )
+        p = next_field( p );
+
+    *day = field_date( &p );
+
+    return GPS_SENTENCE_RMC;
+}
+
+int gps_log_check( const char *line, size_t length, gps_sentence_t *type )
+{
+    const char *end = line + length;
+    int i;
+
+    while( end > line && ( end[ -1 ] == '\n' || end[ -1 ] == '\r' ) )
+        end--;
+
+    *type = GPS_SENTENCE_UNKNOWN;
+
+    if( end - line < 4 || line[ 0 ] != '$' || end[ -3 ] != '*' ||
+        !checksum_ok( line, end - 3 ) )
+        return 0;
+
+    if( end - line >= 10 && line[ 6 ] == ',' && line[ 1 ] != 'P' )
+    {
+        for( i = GPS_SENTENCE_UNKNOWN + 1; i < GPS_SENTENCE_COUNT; i++ )
+        {
+            if( memcmp( line + 3, gps_sentence_name( ( gps_sentence_t )i ), 3 ) == 0 )
+            {
+                *type = ( gps_sentence_t )i;
+                break;
+            }
+        }
+    }
+
+    return 1;
+}
+
+void gps_log_drop( gps_log_t *log )
+{
+    log->track.count = 0;
+    log->undated = 0;
+}
+
+void gps_log_line( gps_log_t *log, const char *line, size_t length )
+{
+    const char *end = line + length;
+    const char *star;
+
+    log->stats.lines++;
+
+    while( end > line && ( end[ -1 ] == '\n' || end[ -1 ] == '\r' ) )
+        end--;
+
+    /* $ttFFF,...*hh */
+    if( end - line < 11 || line[ 0 ] != '$' || line[ 6 ] != ',' )
+    {
+        log->stats.invalid++;
+        return;
+    }
+
+    if( !( line[ 3 ] == 'R' && line[ 4 ] == 'M' && line[ 5 ] == 'C' ) &&
+        !( line[ 3 ] == 'G' && line[ 4 ] == 'G' && line[ 5 ] == 'A' ) )
+    {
+        log->stats.skipped++;
+        return;
+    }
+
+    star = end - 3;
+
+    /* The field cursor stops at the first '*', so it never runs past this one */
+    if( *star != '*' || !checksum_ok( line, star ) )
+    {
+        log->stats.invalid++;
+        return;
+    }
+
+    log->stats.decoded++;
+
+    if( line[ 3 ] == 'R' )
+        decode_rmc( log, line + 7 );
+    else
+        decode_gga( log, line + 7 );
+}
+
+size_t gps_log_parse( gps_log_t *log, const char *data, size_t size )
+{
+    const char *p = data;
+    const char *end = data + size;
+
+    while( p < end )
+    {
+        const char *nl = memchr( p, '\n', end - p );
+
+        if( nl == NULL )
+            break;
+
+        gps_log_line( log, p, nl + 1 - p );
+        p = nl + 1;
+    }
+
+    log->stats.bytes += p - data;
+
+    return p - data;
+}
+
+int gps_log_parse_file_threads( gps_log_t *log, const char *path, int threads )
+{
+    struct stat st;
+    const char *data;
+    int result;
+    int fd = open( path, O_RDONLY );
+
+    if( fd < 0 )
+        return -1;
+
+    if( fstat( fd, &st ) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    if( st.st_size == 0 )
+    {
+        close( fd );
+        return 0;
+    }
+
+    data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+
+    if( data == MAP_FAILED )
+        return -1;
+
+    posix_madvise( ( void * )data, st.st_size,
+                   threads > 1 ? POSIX_MADV_WILLNEED : POSIX_MADV_SEQUENTIAL );
+    result = gps_log_parse_threads( log, data, st.st_size, threads );
+    munmap( ( void * )data, st.st_size );
+
+    return result;
+}
+
+/* Windows end at a line start, so each is a complete log continuing the
+   one before */
+static int stream_map( gps_log_t *log, const char *data, size_t size, int threads,
+                       gps_log_sink_t sink, void *context )
+{
+    size_t window = ( size_t )threads * STREAM_PER_THREAD;
+    size_t page = ( size_t )sysconf( _SC_PAGESIZE );
+    size_t start = 0, waiting = 0;
+
+    while( start < size )
+    {
+        size_t end = start + window < size ? chunk_start( data, size, start + window ) : size;
+        size_t done;
+
+        /* Read ahead of the threads while they decode this one */
+        if( end < size )
+            posix_madvise( ( void * )( data + end / page * page ),
+                           size - end < window ? size - end : window, POSIX_MADV_WILLNEED );
+
+        if( gps_log_parse_threads( log, data + start, end - start, threads ) )
+            return -1;
+
+        /* Undated rows wait one window for an RMC date, after that they go
+           on with the time of day only, a log without RMC would else stay
+           whole in the track */
+        if( log->track.count > 0 && ( log->undated == 0 || waiting > 0 ) )
+        {
+            if( sink( context, &log->track ) )
+                return -1;
+
+            gps_log_drop( log );
+        }
+
+        waiting = log->undated;
+
+        done = end / page * page;
+
+        /* posix_madvise() ignores DONTNEED on glibc; the map is read only,
+           so dropped pages are only read again from the file */
+        if( done > start / page * page )
+            madvise( ( void * )( data + start / page * page ),
+                     done - start / page * page, MADV_DONTNEED );
+
+        start = end;
+    }
+
+    return 0;
+}
+
+int gps_log_stream_file( gps_log_t *log, const char *path, int threads,
+                         gps_log_sink_t sink, void *context )
+{
+    struct stat st;
+    const char *data;
+    int result;
+    int fd = open( path, O_RDONLY );
+
+    if( fd < 0 )
+        return -1;
+
+    if( fstat( fd, &st ) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    if( st.st_size == 0 )
+    {
+        close( fd );
+        return 0;
+    }
+
+    data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+
+    if( data == MAP_FAILED )
+        return -1;
+
+    posix_madvise( ( void * )data, st.st_size, POSIX_MADV_SEQUENTIAL );
+    result = stream_map( log, data, st.st_size, threads < 1 ? 1 : threads, sink, context );
+    munmap( ( void * )data, st.st_size );
+
+    return result;
+}
+
+int gps_log_parse_file( gps_log_t *log, const char *path )
+{
+    return gps_log_parse_file_threads( log, path, 1 );
+}
+
+int gps_log_parse_threads( gps_log_t *log, const char *data, size_t size,
+                           int threads )
+{
+    size_t chunk = threads > 1 ? size / ( ( size_t )threads * CHUNKS_PER_THREAD ) : size;
+
+    if( chunk < CHUNK_MIN_BYTES )
+        chunk = CHUNK_MIN_BYTES;
+
+    if( threads <= 1 || size <= chunk )
+        parse_all( log, data, size );
+    else if( parse_pool( log, data, size, chunk, threads ) )
+        return -1;
+
+    if( log->error )
+    {
+        errno = log->error;
+        return -1;
+    }
+
+    return 0;
+}
+
+void gps_log_finish( gps_log_t *log )
+{
+    if( log->open.tod >= 0 )
+        epoch_close( log );
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
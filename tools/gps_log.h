@@ -0,0 +1,299 @@
+/****************************************************************************
+* Title                 :   NMEA Log Parser
+* Filename              :   gps_log.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_log.h
+ * @brief Bulk decoding of recorded NMEA into a columnar track
+ *
+ * Unlike gps_put / gps_parse this works on whole blocks of a log, keeps all
+ * of its state in a gps_log_t and decodes only what a track needs:
+ * RMC and GGA, merged into one row per epoch.  Lines are framed and
+ * decoded in place, so a memory mapped file is never copied.
+ *
+ * @code
+ * gps_log_t log;
+ *
+ * gps_log_init( &log );
+ * gps_log_parse_file( &log, "day.nmea" );
+ * gps_log_finish( &log );
+ *
+ * for( i = 0; i < log.track.count; i++ )
+ *     printf( "%f %f\n", log.track.latitude[ i ], log.track.longitude[ i ] );
+ *
+ * gps_log_free( &log );
+ * @endcode
+ *
+ * Epochs close when the UTC time changes.  The date comes from RMC; epochs
+ * decoded before the first RMC are dated back from it, later ones roll
+ * over at midnight.
+ *
+ * gps_log_parse_threads() splits a log into chunks at sentence starts and
+ * decodes them in parallel, one context per chunk.  The chunks are then
+ * stitched in order, replaying what a single context would have done at
+ * each boundary, so the track is the same as with one thread.
+ */
+#ifndef GPS_LOG_H_
+#define GPS_LOG_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "gps_defs.h"
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct One epoch per row, one array per column
+ */
+typedef struct
+{
+    size_t count;
+    size_t capacity;
+    int64_t *time;          /**< UTC ms since 1970 */
+    double *latitude;       /**< Degrees, south negative */
+    double *longitude;      /**< Degrees, west negative */
+    float *altitude;        /**< m above mean sea level */
+    float *speed;           /**< Knots */
+    float *track;           /**< Degrees true */
+    float *hdop;
+    uint8_t *quality;       /**< GGA fix quality */
+    uint8_t *satellites;
+    uint16_t *fields;       /**< GPS_EPOCH_* bits of the valid columns */
+} gps_track_t;
+
+/**
+ * @struct One row of a track
+ */
+typedef struct
+{
+    int64_t time;           /**< UTC ms since 1970 */
+    double latitude;        /**< Degrees, south negative */
+    double longitude;       /**< Degrees, west negative */
+    float altitude;         /**< m above mean sea level */
+    float speed;            /**< Knots */
+    float track;            /**< Degrees true */
+    float hdop;
+    uint8_t quality;        /**< GGA fix quality */
+    uint8_t satellites;
+    uint16_t fields;        /**< GPS_EPOCH_* bits of the valid members */
+} gps_log_fix_t;
+
+/**
+ * @struct Counters of one log
+ */
+typedef struct
+{
+    uint64_t bytes;
+    uint64_t lines;
+    uint64_t decoded;       /**< RMC and GGA */
+    uint64_t skipped;       /**< Other sentences, not checked */
+    uint64_t invalid;       /**< Framing or checksum */
+    uint64_t epochs;
+} gps_log_stats_t;
+
+/**
+ * @struct Open epoch
+ */
+typedef struct
+{
+    int32_t tod;            /**< ms since midnight, -1 before the first */
+    int32_t day;            /**< Days since 1970, -1 without RMC */
+    double latitude;
+    double longitude;
+    float altitude;
+    float speed;
+    float track;
+    float hdop;
+    uint8_t quality;
+    uint8_t satellites;
+    uint16_t fields;
+} gps_log_epoch_t;
+
+/**
+ * @struct Parser context, one per log or per thread
+ */
+typedef struct
+{
+    gps_track_t track;
+    gps_log_stats_t stats;
+    gps_log_epoch_t open;
+    int32_t day;            /**< Date of the last closed epoch, -1 unknown */
+    int32_t last_tod;
+    size_t undated;         /**< Leading rows still waiting for a date */
+    int error;              /**< Set when the track couldn't grow */
+    int chunk;              /**< How far a chunk of a larger log got */
+    gps_log_epoch_t lead;   /**< Chunk: sentences before its first time */
+    gps_log_epoch_t head;   /**< Chunk: its first epoch, merged when stitched */
+} gps_log_t;
+
+/**
+ * @brief Takes the rows of gps_log_stream_file() as they are decoded
+ *
+ * @return int - 0 to go on, else the stream stops
+ */
+typedef int ( *gps_log_sink_t )( void *context, const gps_track_t *track );
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Grows every column of a track to at least rows
+ *
+ * @return int - 0 or -1 when out of memory, the rows are kept either way
+ */
+int gps_track_reserve( gps_track_t *track, size_t rows );
+
+/**
+ * @brief Appends rows first to first + rows - 1 of another track
+ *
+ * @return int - 0 or -1 when out of memory
+ */
+int gps_track_append( gps_track_t *track, const gps_track_t *from,
+                      size_t first, size_t rows );
+
+/**
+ * @brief Releases the columns of a track
+ */
+void gps_track_free( gps_track_t *track );
+
+/**
+ * @brief Copies a row of a track
+ */
+void gps_track_get( const gps_track_t *track, size_t row, gps_log_fix_t *fix );
+
+/**
+ * @brief Converts an epoch of gps_last_epoch() into a fix
+ *
+ * Without GPS_EPOCH_DATE in fields the time is ms of the UTC day.
+ */
+void gps_log_fix_epoch( gps_log_fix_t *fix, const gps_epoch_t *epoch );
+
+/**
+ * @brief Writes a track as CSV with a header row
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_track_write_csv( const gps_track_t *track, const char *path );
+
+/**
+ * @brief Clears a context
+ */
+void gps_log_init( gps_log_t *log );
+
+/**
+ * @brief Releases the track of a context
+ */
+void gps_log_free( gps_log_t *log );
+
+/**
+ * @brief Decodes the complete lines of a block
+ *
+ * @param log - context
+ * @param data - log text
+ * @param size - bytes in data
+ *
+ * @return size_t - bytes consumed, the rest is an unterminated line to be
+ * passed again with more data
+ */
+size_t gps_log_parse( gps_log_t *log, const char *data, size_t size );
+
+/**
+ * @brief Forgets the rows of the track and keeps decoding
+ *
+ * For a context that follows a live stream and takes every epoch as it
+ * closes.  Rows still waiting for a date are forgotten too, later ones are
+ * dated from the last date seen.
+ */
+void gps_log_drop( gps_log_t *log );
+
+/**
+ * @brief Decodes a single line, with or without its terminator
+ */
+void gps_log_line( gps_log_t *log, const char *line, size_t length );
+
+/**
+ * @brief Time of an RMC or GGA line with a valid checksum
+ *
+ * @param tod - ms since midnight
+ * @param day - days since 1970 from RMC, -1 for GGA or without a date
+ *
+ * @return gps_sentence_t - GPS_SENTENCE_RMC, GPS_SENTENCE_GGA or
+ * GPS_SENTENCE_UNKNOWN for every other line and lines without a time
+ */
+gps_sentence_t gps_log_stamp( const char *line, size_t length, int32_t *tod,
+                              int32_t *day );
+
+/**
+ * @brief Checks the framing and checksum of a line of any talker
+ *
+ * @param type - formatter of a valid line, GPS_SENTENCE_UNKNOWN for
+ * proprietary and other sentences
+ *
+ * @return int - 1 for $...*hh with a correct checksum, else 0
+ */
+int gps_log_check( const char *line, size_t length, gps_sentence_t *type );
+
+/**
+ * @brief Memory maps a file and decodes all of it
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_log_parse_file( gps_log_t *log, const char *path );
+
+/**
+ * @brief Decodes a complete log, tail line included, on several threads
+ *
+ * @param log - context
+ * @param data - log text
+ * @param size - bytes in data
+ * @param threads - workers including the calling thread
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_log_parse_threads( gps_log_t *log, const char *data, size_t size,
+                           int threads );
+
+/**
+ * @brief gps_log_parse_file() on several threads
+ */
+int gps_log_parse_file_threads( gps_log_t *log, const char *path, int threads );
+
+/**
+ * @brief Decodes a file window by window and passes the rows on
+ *
+ * Each window of 8 MB per thread is decoded as gps_log_parse_file_threads()
+ * would, the dated rows go to sink and are dropped.  Pages already decoded
+ * are released from the map.  Rows before the first RMC wait in the track
+ * for the window after, and go to sink without GPS_EPOCH_DATE, their time
+ * of day only, when it brings no date either.  A log without RMC is thus
+ * streamed too, and the track holds at most the rows of a few windows
+ * whatever the size of the file.  The rows of the epoch still open after
+ * the last file are left for gps_log_finish().
+ *
+ * @return int - 0 or -1 with errno set, the errno of sink when it stopped
+ */
+int gps_log_stream_file( gps_log_t *log, const char *path, int threads,
+                         gps_log_sink_t sink, void *context );
+
+/**
+ * @brief Closes the open epoch and dates rows still without a date
+ */
+void gps_log_finish( gps_log_t *log );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_LOG_H_ */
+
+/*** End of File **************************************************************/
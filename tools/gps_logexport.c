@@ -0,0 +1,150 @@
+/*******************************************************************************
+* Title                 :   Log Export CLI
+* Filename              :   gps_logexport.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_logexport.c
+ * @brief Converts recorded NMEA logs to CSV, GPX or GeoJSON in one pass.
+ *
+ * The logs are decoded as gps_logparse decodes them, one track across all
+ * files, but window by window with gps_log_stream_file(), and every window
+ * of rows is exported before the next is decoded.  Memory stays the same
+ * for any size of log.  -f picks the format, -i and -m decimate to a fix
+ * every so many seconds and meters, -j sets the threads.  The output is
+ * -o or stdout, the counters go to stderr.
+ *
+ * @code
+ * gps_logexport -f gpx -i 5 -o trip.gpx day1.nmea day2.nmea
+ * gps_logexport -f geojson -m 10 day.nmea > trip.geojson
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "gps_log.h"
+#include "gps_export.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int export_rows( void *context, const gps_track_t *track )
+{
+    return gps_export_track( context, track, 0, track->count );
+}
+
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-f csv|gpx|geojson] [-i seconds] [-m meters] [-j threads] "
+             "[-o output] log.nmea ...\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    static gps_export_t exp;
+    gps_export_format_t format = GPS_EXPORT_CSV;
+    const char *output = NULL;
+    long threads = sysconf( _SC_NPROCESSORS_ONLN );
+    double interval = 0, distance = 0;
+    uint64_t start, elapsed;
+    gps_log_t log;
+    int opt, fd = STDOUT_FILENO, result = 0, i;
+
+    while( ( opt = getopt( argc, argv, "f:i:m:j:o:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'f':
+            if( gps_export_format( optarg, &format ) )
+            {
+                usage( argv[ 0 ] );
+                return 2;
+            }
+            break;
+        case 'i':
+            interval = strtod( optarg, NULL );
+            break;
+        case 'm':
+            distance = strtod( optarg, NULL );
+            break;
+        case 'j':
+            threads = strtol( optarg, NULL, 10 );
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( threads < 1 )
+        threads = 1;
+
+    if( optind >= argc || interval < 0 || distance < 0 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    if( output != NULL && ( fd = open( output, O_WRONLY | O_CREAT | O_TRUNC, 0666 ) ) < 0 )
+    {
+        perror( output );
+        return 1;
+    }
+
+    gps_log_init( &log );
+    gps_export_open( &exp, fd, format );
+    exp.interval = ( int64_t )( interval * 1000 + 0.5 );
+    exp.distance = distance;
+    start = gps_clock_ns();
+
+    for( i = optind; i < argc && result == 0; i++ )
+    {
+        result = gps_log_stream_file( &log, argv[ i ], ( int )threads, export_rows, &exp );
+
+        if( result )
+            fprintf( stderr, "%s: %s\n", exp.error ? ( output ? output : "stdout" ) : argv[ i ],
+                     strerror( errno ) );
+    }
+
+    if( result == 0 )
+    {
+        gps_log_finish( &log );
+        result = gps_export_track( &exp, &log.track, 0, log.track.count ) ||
+                 gps_export_close( &exp );
+
+        if( result )
+            perror( output ? output : "stdout" );
+    }
+
+    elapsed = gps_clock_ns() - start;
+
+    fprintf( stderr, "%llu bytes, %llu epochs, %llu rows written, %llu bytes out\n",
+             ( unsigned long long )log.stats.bytes, ( unsigned long long )log.stats.epochs,
+             ( unsigned long long )exp.written, ( unsigned long long )exp.bytes );
+    fprintf( stderr, "%.3f s, %.1f MB/s\n", elapsed / 1e9,
+             elapsed ? log.stats.bytes * 1e3 / elapsed : 0.0 );
+
+    gps_log_free( &log );
+
+    if( output != NULL && close( fd ) && result == 0 )
+    {
+        perror( output );
+        result = 1;
+    }
+
+    return result ? 1 : 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,125 @@
+/*******************************************************************************
+* Title                 :   NMEA Log Parser CLI
+* Filename              :   gps_logparse.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_logparse.c
+ * @brief Decodes recorded NMEA logs into one track and reports throughput.
+ *
+ * The files are memory mapped and parsed in order into a single track, so
+ * consecutive logs of one receiver continue each other.  -j sets the
+ * number of threads, by default one per online CPU.  -s writes the track
+ * as a gps_store file.
+ *
+ * @code
+ * gps_logparse day1.nmea day2.nmea
+ * gps_logparse -j 1 -o track.csv day1.nmea
+ * gps_logparse -s day.gpst day1.nmea
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "gps_log.h"
+#include "gps_store.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-j threads] [-o track.csv] [-s track.gpst] log.nmea ...\n",
+             name );
+}
+
+int main( int argc, char **argv )
+{
+    const char *csv = NULL;
+    const char *store = NULL;
+    long threads = sysconf( _SC_NPROCESSORS_ONLN );
+    gps_log_t log;
+    uint64_t start, elapsed;
+    int opt, i;
+
+    while( ( opt = getopt( argc, argv, "j:o:s:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'j':
+            threads = strtol( optarg, NULL, 10 );
+            break;
+        case 'o':
+            csv = optarg;
+            break;
+        case 's':
+            store = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( threads < 1 )
+        threads = 1;
+
+    if( optind >= argc )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    gps_log_init( &log );
+    start = gps_clock_ns();
+
+    for( i = optind; i < argc; i++ )
+    {
+        if( gps_log_parse_file_threads( &log, argv[ i ], ( int )threads ) )
+        {
+            fprintf( stderr, "%s: %s\n", argv[ i ], strerror( errno ) );
+            gps_log_free( &log );
+            return 1;
+        }
+    }
+
+    gps_log_finish( &log );
+    elapsed = gps_clock_ns() - start;
+
+    printf( "bytes      %llu\n", ( unsigned long long )log.stats.bytes );
+    printf( "lines      %llu ( %llu decoded, %llu skipped, %llu invalid )\n",
+            ( unsigned long long )log.stats.lines, ( unsigned long long )log.stats.decoded,
+            ( unsigned long long )log.stats.skipped, ( unsigned long long )log.stats.invalid );
+    printf( "epochs     %llu\n", ( unsigned long long )log.stats.epochs );
+    printf( "threads    %ld\n", threads );
+    printf( "time       %.3f s, %.1f MB/s\n", elapsed / 1e9,
+            elapsed ? log.stats.bytes * 1e3 / elapsed : 0.0 );
+
+    if( csv != NULL && gps_track_write_csv( &log.track, csv ) )
+    {
+        perror( csv );
+        gps_log_free( &log );
+        return 1;
+    }
+
+    if( store != NULL && gps_store_write( store, &log.track ) )
+    {
+        perror( store );
+        gps_log_free( &log );
+        return 1;
+    }
+
+    gps_log_free( &log );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,147 @@
+/*******************************************************************************
+* Title                 :   Log Time Index CLI
+* Filename              :   gps_logseek.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_logseek.c
+ * @brief Keeps the time index of NMEA logs up to date and seeks in them.
+ *
+ * The index of every log is its name with .tidx appended.  Each run only
+ * reads the lines appended since the last one.  -i sets the seconds
+ * between entries.  -t prints the offset to parse from for a time in ms
+ * since 1970, as in the CSV of gps_logparse, and the line found there.
+ *
+ * @code
+ * gps_logseek day.nmea
+ * gps_logseek -t 1440524580000 day.nmea
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "gps_seek.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define SUFFIX          ".tidx"
+#define LINE_MAX_BYTES  256
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-i seconds] [-t time_ms] log.nmea ...\n", name );
+}
+
+/* The offset of time and the line there */
+static int find( const char *log, const char *index, int64_t time )
+{
+    char line[ LINE_MAX_BYTES ] = "";
+    uint64_t offset;
+    gps_seek_t seek;
+    FILE *f;
+
+    if( gps_seek_open( &seek, index ) )
+        return -1;
+
+    offset = gps_seek_find( &seek, time );
+    gps_seek_close( &seek );
+
+    f = fopen( log, "rb" );
+
+    if( f == NULL )
+        return -1;
+
+    if( fseek( f, ( long )offset, SEEK_SET ) == 0 && fgets( line, sizeof( line ), f ) )
+        line[ strcspn( line, "\r\n" ) ] = '\0';
+
+    fclose( f );
+    printf( "%s: %lld at %llu %s\n", log, ( long long )time,
+            ( unsigned long long )offset, line );
+
+    return 0;
+}
+
+int main( int argc, char **argv )
+{
+    double interval = GPS_SEEK_INTERVAL / 1000.0;
+    const char *at = NULL;
+    int opt, i;
+
+    while( ( opt = getopt( argc, argv, "i:t:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'i':
+            interval = strtod( optarg, NULL );
+            break;
+        case 't':
+            at = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind >= argc || interval < 0.001 || interval > 86400 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    for( i = optind; i < argc; i++ )
+    {
+        size_t length = strlen( argv[ i ] );
+        char *index = malloc( length + sizeof( SUFFIX ) );
+        gps_seek_stats_t stats;
+        int result;
+
+        if( index == NULL )
+        {
+            perror( argv[ i ] );
+            return 1;
+        }
+
+        memcpy( index, argv[ i ], length );
+        memcpy( index + length, SUFFIX, sizeof( SUFFIX ) );
+        result = gps_seek_update( argv[ i ], index, ( uint32_t )( interval * 1000 + 0.5 ),
+                                  &stats );
+
+        if( result == 0 && at == NULL )
+        {
+            printf( "%s: %llu bytes read, %llu entries added, %llu dates corrected%s\n",
+                    index, ( unsigned long long )stats.bytes,
+                    ( unsigned long long )stats.added,
+                    ( unsigned long long )stats.corrected,
+                    stats.rebuilt ? ", rebuilt" : "" );
+        }
+        else if( result == 0 )
+        {
+            result = find( argv[ i ], index, strtoll( at, NULL, 10 ) );
+        }
+
+        if( result )
+        {
+            fprintf( stderr, "%s: %s\n", index, strerror( errno ) );
+            free( index );
+            return 1;
+        }
+
+        free( index );
+    }
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
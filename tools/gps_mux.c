@@ -0,0 +1,376 @@
+/*******************************************************************************
+* Title                 :   NMEA Multiplexer
+* Filename              :   gps_mux.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_mux.c
+ * @brief Merges the NMEA of several receivers into one stream.
+ *
+ * The source of every type is worked out again when a feed starts, as the
+ * time moved on, and when a line changes the fix of its source or is the
+ * first of its type within the timeout.  Lines to forward are gathered as iovecs into
+ * the buffer they were read into, adjacent ones merged, and written when
+ * the iovecs run out and at the end of each feed.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include "gps_log.h"
+#include "gps_mux.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int alive( const gps_mux_t *mux, const gps_mux_source_t *src, int type,
+                  int64_t now );
+static void owners_update( gps_mux_t *mux, int64_t now );
+static int fix_of( const char *line, const char *end, gps_sentence_t type );
+static void flush( gps_mux_t *mux );
+static void forward( gps_mux_t *mux, const char *line, size_t length );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int alive( const gps_mux_t *mux, const gps_mux_source_t *src, int type,
+                  int64_t now )
+{
+    return src->seen[ type ] >= 0 && now - src->seen[ type ] <= mux->timeout;
+}
+
+/* Of the sources sending a type, the best priority with a fix first */
+static void owners_update( gps_mux_t *mux, int64_t now )
+{
+    int changed = 0;
+    int t, s;
+
+    for( t = 0; t < GPS_SENTENCE_COUNT; t++ )
+    {
+        int best = -1;
+        int best_fix = 0;
+
+        for( s = 0; s < mux->sources; s++ )
+        {
+            const gps_mux_source_t *src = &mux->source[ s ];
+            int fix = src->fix != GPS_MUX_FIX_INVALID;
+
+            if( !( src->types & GPS_MUX_TYPE( t ) ) || !alive( mux, src, t, now ) )
+                continue;
+
+            if( best < 0 || fix > best_fix ||
+                ( fix == best_fix && src->priority < mux->source[ best ].priority ) )
+            {
+                best = s;
+                best_fix = fix;
+            }
+        }
+
+        if( mux->owner[ t ] != best )
+        {
+            changed |= mux->owner[ t ] >= 0 && best >= 0;
+            mux->owner[ t ] = best;
+        }
+    }
+
+    mux->failovers += changed;
+}
+
+/* Status of RMC or quality of GGA, -1 when empty or another type */
+static int fix_of( const char *line, const char *end, gps_sentence_t type )
+{
+    int field = type == GPS_SENTENCE_RMC ? 2 : type == GPS_SENTENCE_GGA ? 6 : 0;
+    const char *p = line;
+
+    if( field == 0 )
+        return -1;
+
+    while( field-- > 0 )
+    {
+        p = memchr( p, ',', end - p );
+
+        if( p == NULL )
+            return -1;
+
+        p++;
+    }
+
+    if( type == GPS_SENTENCE_RMC && ( *p == 'A' || *p == 'V' ) )
+        return *p == 'A' ? GPS_MUX_FIX_VALID : GPS_MUX_FIX_INVALID;
+
+    if( type == GPS_SENTENCE_GGA && *p >= '0' && *p <= '9' )
+        return *p != '0' ? GPS_MUX_FIX_VALID : GPS_MUX_FIX_INVALID;
+
+    return -1;
+}
+
+static void flush( gps_mux_t *mux )
+{
+    struct iovec *iov = mux->iov;
+    int count = mux->iovs;
+
+    mux->iovs = 0;
+
+    while( count > 0 && mux->error == 0 )
+    {
+        ssize_t n = writev( mux->out, iov, count );
+
+        if( n < 0 )
+        {
+            if( errno != EINTR )
+                mux->error = errno;
+
+            continue;
+        }
+
+        /* Partial write, skip what went out */
+        while( count > 0 && ( size_t )n >= iov->iov_len )
+        {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+
+        if( count > 0 )
+        {
+            iov->iov_base = ( char * )iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+}
+
+static void forward( gps_mux_t *mux, const char *line, size_t length )
+{
+    if( mux->iovs > 0 )
+    {
+        struct iovec *last = &mux->iov[ mux->iovs - 1 ];
+
+        if( ( const char * )last->iov_base + last->iov_len == line )
+        {
+            last->iov_len += length;
+            return;
+        }
+    }
+
+    if( mux->iovs == GPS_MUX_IOV )
+        flush( mux );
+
+    mux->iov[ mux->iovs ].iov_base = ( void * )line;
+    mux->iov[ mux->iovs ].iov_len = length;
+    mux->iovs++;
+}
+
+void gps_mux_init( gps_mux_t *mux, int out, int64_t timeout )
+{
+    int t;
+
+    mux->sources = 0;
+    mux->out = out;
+    mux->error = 0;
+    mux->timeout = timeout;
+    mux->failovers = 0;
+    mux->iovs = 0;
+
+    for( t = 0; t < GPS_SENTENCE_COUNT; t++ )
+        mux->owner[ t ] = -1;
+}
+
+int gps_mux_add( gps_mux_t *mux, int fd, int priority, uint32_t types )
+{
+    gps_mux_source_t *src;
+    int t;
+
+    if( mux->sources == GPS_MUX_SOURCES )
+    {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    src = &mux->source[ mux->sources ];
+    memset( &src->stats, 0, sizeof( gps_mux_stats_t ) );
+    src->fd = fd;
+    src->priority = priority;
+    src->types = types;
+    src->fix = GPS_MUX_FIX_UNKNOWN;
+
+    for( t = 0; t < GPS_SENTENCE_COUNT; t++ )
+        src->seen[ t ] = -1;
+
+    src->eof = 0;
+    src->skip = 0;
+    src->fill = 0;
+
+    return mux->sources++;
+}
+
+size_t gps_mux_feed( gps_mux_t *mux, int source, const char *data, size_t size,
+                     int64_t now )
+{
+    gps_mux_source_t *src = &mux->source[ source ];
+    const char *p = data;
+    const char *end = data + size;
+    const char *nl;
+
+    owners_update( mux, now );
+
+    while( p < end && ( nl = memchr( p, '\n', end - p ) ) != NULL )
+    {
+        size_t length = nl + 1 - p;
+        gps_sentence_t type;
+        int fix;
+
+        src->stats.lines++;
+
+        if( !gps_log_check( p, length, &type ) )
+        {
+            src->stats.invalid++;
+            p = nl + 1;
+            continue;
+        }
+
+        fix = fix_of( p, nl, type );
+
+        if( !alive( mux, src, type, now ) || ( fix >= 0 && fix != src->fix ) )
+        {
+            src->seen[ type ] = now;
+
+            if( fix >= 0 )
+                src->fix = fix;
+
+            owners_update( mux, now );
+        }
+
+        src->seen[ type ] = now;
+
+        if( !( src->types & GPS_MUX_TYPE( type ) ) )
+        {
+            src->stats.filtered++;
+        }
+        else if( mux->owner[ type ] != source )
+        {
+            src->stats.standby++;
+        }
+        else
+        {
+            forward( mux, p, length );
+            src->stats.forwarded++;
+            src->stats.bytes += length;
+        }
+
+        p = nl + 1;
+    }
+
+    flush( mux );
+
+    return p - data;
+}
+
+int gps_mux_read( gps_mux_t *mux, int source, int64_t now )
+{
+    gps_mux_source_t *src = &mux->source[ source ];
+    ssize_t n;
+    size_t used;
+
+    do
+    {
+        n = read( src->fd, src->buffer + src->fill, GPS_MUX_BUFFER - src->fill );
+    }
+    while( n < 0 && errno == EINTR );
+
+    /* A pty reads EIO once its other side is closed */
+    if( n == 0 || ( n < 0 && errno == EIO ) )
+    {
+        src->eof = 1;
+        return 0;
+    }
+
+    if( n < 0 )
+        return -1;
+
+    if( src->skip )
+    {
+        char *nl = memchr( src->buffer, '\n', n );
+
+        if( nl == NULL )
+            return ( int )n;
+
+        src->skip = 0;
+        memmove( src->buffer, nl + 1, src->buffer + n - ( nl + 1 ) );
+        src->fill = src->buffer + n - ( nl + 1 );
+    }
+    else
+    {
+        src->fill += n;
+    }
+
+    used = gps_mux_feed( mux, source, src->buffer, src->fill, now );
+
+    if( used == 0 && src->fill == GPS_MUX_BUFFER )
+    {
+        src->stats.overlong++;
+        src->skip = 1;
+        used = src->fill;
+    }
+
+    memmove( src->buffer, src->buffer + used, src->fill - used );
+    src->fill -= used;
+
+    if( mux->error )
+    {
+        errno = mux->error;
+        return -1;
+    }
+
+    return ( int )n;
+}
+
+int gps_mux_run( gps_mux_t *mux )
+{
+    struct pollfd fds[ GPS_MUX_SOURCES ];
+    int index[ GPS_MUX_SOURCES ];
+
+    for( ;; )
+    {
+        int count = 0;
+        int64_t now;
+        int s;
+
+        for( s = 0; s < mux->sources; s++ )
+        {
+            if( mux->source[ s ].eof )
+                continue;
+
+            fds[ count ].fd = mux->source[ s ].fd;
+            fds[ count ].events = POLLIN;
+            index[ count++ ] = s;
+        }
+
+        if( count == 0 )
+            return 0;
+
+        if( poll( fds, count, -1 ) < 0 )
+        {
+            if( errno == EINTR )
+                continue;
+
+            return -1;
+        }
+
+        now = ( int64_t )( gps_clock_ns() / 1000000 );
+
+        for( s = 0; s < count; s++ )
+        {
+            if( fds[ s ].revents && gps_mux_read( mux, index[ s ], now ) < 0 &&
+                errno != EAGAIN )
+                return -1;
+        }
+    }
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
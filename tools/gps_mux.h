@@ -0,0 +1,168 @@
+/****************************************************************************
+* Title                 :   NMEA Multiplexer
+* Filename              :   gps_mux.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_mux.h
+ * @brief Merges the NMEA of several receivers into one stream
+ *
+ * Every source has a priority and the sentence types it may forward.  Of
+ * the sources that have a type, the lines of only one reach the output:
+ * the best priority among those with a fix, or among all when none has
+ * one.  A source loses its fix with an RMC of status V or a GGA of
+ * quality 0 and gets it back with the next valid one.  A source only
+ * counts for the types it has sent within the timeout.  Sources without
+ * RMC or GGA, a compass sending THS for example, count as having a fix.
+ *
+ * Lines are framed in the read buffer of their source and checked with
+ * gps_log_check().  Valid ones are written out with writev() from where
+ * they were read, byte for byte, terminator included.  Lines longer than
+ * the buffer are dropped.
+ *
+ * @code
+ * gps_mux_init( &mux, STDOUT_FILENO, GPS_MUX_TIMEOUT );
+ * gps_mux_add( &mux, primary, 0, GPS_MUX_ALL );
+ * gps_mux_add( &mux, backup, 1, GPS_MUX_ALL );
+ * gps_mux_add( &mux, compass, 2, GPS_MUX_TYPE( GPS_SENTENCE_THS ) );
+ * gps_mux_run( &mux );
+ * @endcode
+ */
+#ifndef GPS_MUX_H_
+#define GPS_MUX_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include "gps_defs.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_MUX_SOURCES     8
+#define GPS_MUX_BUFFER      16384   /**< Read buffer of a source */
+#define GPS_MUX_IOV         64      /**< Lines gathered per writev */
+#define GPS_MUX_TIMEOUT     2000    /**< Default ms a type counts */
+
+#define GPS_MUX_TYPE( type )    ( 1u << ( type ) )
+#define GPS_MUX_ALL             ( ( 1u << GPS_SENTENCE_COUNT ) - 1 )
+
+/* gps_mux_source_t.fix */
+#define GPS_MUX_FIX_UNKNOWN 0       /**< No RMC or GGA yet */
+#define GPS_MUX_FIX_VALID   1
+#define GPS_MUX_FIX_INVALID 2
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Lines of a source
+ */
+typedef struct
+{
+    uint64_t lines;             /**< Complete lines read */
+    uint64_t bytes;             /**< Bytes forwarded */
+    uint64_t forwarded;
+    uint64_t filtered;          /**< Type not forwarded by the source */
+    uint64_t standby;           /**< Held back for a better source */
+    uint64_t invalid;           /**< Framing or checksum */
+    uint64_t overlong;          /**< Longer than the buffer */
+} gps_mux_stats_t;
+
+/**
+ * @struct Input
+ */
+typedef struct
+{
+    int fd;
+    int priority;               /**< Lower is preferred */
+    uint32_t types;             /**< GPS_MUX_TYPE() of the types forwarded */
+    int fix;                    /**< GPS_MUX_FIX_* */
+    int64_t seen[ GPS_SENTENCE_COUNT ]; /**< ms of the last of a type */
+    int eof;
+    int skip;                   /**< Dropping an overlong line */
+    size_t fill;
+    gps_mux_stats_t stats;
+    char buffer[ GPS_MUX_BUFFER ];
+} gps_mux_source_t;
+
+/**
+ * @struct Multiplexer
+ */
+typedef struct
+{
+    gps_mux_source_t source[ GPS_MUX_SOURCES ];
+    int sources;
+    int out;
+    int error;                  /**< errno of the first failed write */
+    int64_t timeout;
+    int owner[ GPS_SENTENCE_COUNT ];    /**< Source of each type, -1 none */
+    uint64_t failovers;         /**< Times a type changed source */
+    struct iovec iov[ GPS_MUX_IOV ];
+    int iovs;
+} gps_mux_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Empty multiplexer writing to out
+ *
+ * @param timeout - ms after which a source no longer counts for a type
+ */
+void gps_mux_init( gps_mux_t *mux, int out, int64_t timeout );
+
+/**
+ * @brief Adds a source
+ *
+ * @param priority - lower is preferred, equal ones in the order added
+ * @param types - GPS_MUX_TYPE() of each type, GPS_SENTENCE_UNKNOWN for
+ * proprietary and other sentences
+ *
+ * @return int - index of the source, -1 when all are used
+ */
+int gps_mux_add( gps_mux_t *mux, int fd, int priority, uint32_t types );
+
+/**
+ * @brief Forwards the complete lines of a block read from a source
+ *
+ * The lines are written before it returns, so data may be reused.
+ *
+ * @param now - ms, only compared with the timeout
+ *
+ * @return size_t - bytes consumed, the rest is an unterminated line to be
+ * passed again with more data
+ */
+size_t gps_mux_feed( gps_mux_t *mux, int source, const char *data, size_t size,
+                     int64_t now );
+
+/**
+ * @brief Reads what a source has and forwards its complete lines
+ *
+ * @return int - bytes read, 0 at the end of the source or -1 with errno
+ * set, also when writing failed
+ */
+int gps_mux_read( gps_mux_t *mux, int source, int64_t now );
+
+/**
+ * @brief Polls the sources until all of them end
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_mux_run( gps_mux_t *mux );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_MUX_H_ */
+
+/*** End of File **************************************************************/
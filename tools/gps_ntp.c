@@ -0,0 +1,204 @@
+/*******************************************************************************
+* Title                 :   NTP Shared Memory Reference Clock
+* Filename              :   gps_ntp.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_ntp.c
+ * @brief SysV shared memory samples for chronyd and ntpd.
+ *
+ * Written the way gpsd writes them: valid cleared, count incremented,
+ * the times, count incremented again and valid set, with full fences in
+ * between.  The reader throws the sample away when count changed while it
+ * copied.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _DEFAULT_SOURCE             /* shmget() flags */
+#include <string.h>
+#include <errno.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include "gps_log.h"
+#include "gps_ntp.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define NS_PER_S        1000000000ll
+#define NS_PER_DAY      ( 86400ll * NS_PER_S )
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int64_t realtime_ns( void );
+static int64_t epoch_utc( const gps_epoch_t *epoch, int64_t receive );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int64_t realtime_ns( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_REALTIME, &ts );
+    return ( int64_t )ts.tv_sec * NS_PER_S + ts.tv_nsec;
+}
+
+/* The UTC day of the system clock when the epoch has no date */
+static int64_t epoch_utc( const gps_epoch_t *epoch, int64_t receive )
+{
+    gps_log_fix_t fix;
+    int64_t utc, day;
+
+    gps_log_fix_epoch( &fix, epoch );
+    utc = fix.time * 1000000ll;
+
+    if( epoch->fields & GPS_EPOCH_DATE )
+        return utc;
+
+    /* The day that puts it nearest to receive */
+    day = ( receive - utc + NS_PER_DAY / 2 ) / NS_PER_DAY;
+
+    return day * NS_PER_DAY + utc;
+}
+
+int gps_ntp_open( gps_ntp_t *ntp, int unit )
+{
+    void *shm;
+    int id;
+
+    memset( ntp, 0, sizeof( gps_ntp_t ) );
+    id = shmget( ( key_t )( GPS_NTP_KEY + unit ), sizeof( gps_ntp_shm_t ),
+                 IPC_CREAT | ( unit < 2 ? 0600 : 0666 ) );
+
+    if( id < 0 )
+        return -1;
+
+    shm = shmat( id, NULL, 0 );
+
+    if( shm == ( void * )-1 )
+        return -1;
+
+    ntp->shm = shm;
+    ntp->id = id;
+    ntp->unit = unit;
+    ntp->precision = GPS_NTP_PRECISION;
+
+    return 0;
+}
+
+void gps_ntp_close( gps_ntp_t *ntp )
+{
+    if( ntp->shm != NULL )
+        shmdt( ntp->shm );
+
+    memset( ntp, 0, sizeof( gps_ntp_t ) );
+}
+
+int gps_ntp_sample( gps_ntp_t *ntp, const gps_epoch_t *epoch, uint64_t arrival )
+{
+    gps_ntp_shm_t *shm = ntp->shm;
+    int64_t receive, utc;
+
+    if( !( epoch->fields & GPS_EPOCH_TIME ) )
+    {
+        ntp->rejected++;
+        errno = EINVAL;
+        return -1;
+    }
+
+    if( ( ( epoch->fields & GPS_EPOCH_STATUS ) &&
+          ( epoch->status == RMC_VOID || epoch->status == RMC_NOT_VALID ) ) ||
+        ( ( epoch->fields & GPS_EPOCH_QUALITY ) && epoch->quality == INVALID ) )
+    {
+        ntp->rejected++;
+        errno = EAGAIN;
+        return -1;
+    }
+
+    /* The system clock at arrival, both clocks read back to back */
+    receive = realtime_ns();
+    receive -= ( int64_t )gps_clock_ns() - ( int64_t )arrival;
+    utc = epoch_utc( epoch, receive );
+
+    ntp->delay[ ntp->samples % GPS_NTP_WINDOW ] = receive - utc;
+    ntp->samples++;
+    receive -= ntp->offset;
+
+    if( shm == NULL )
+        return 0;
+
+    shm->valid = 0;
+    shm->count++;
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    shm->mode = 1;
+    shm->clock_sec = ( time_t )( utc / NS_PER_S );
+    shm->clock_usec = ( int )( utc % NS_PER_S / 1000 );
+    shm->clock_nsec = ( unsigned )( utc % NS_PER_S );
+    shm->receive_sec = ( time_t )( receive / NS_PER_S );
+    shm->receive_usec = ( int )( receive % NS_PER_S / 1000 );
+    shm->receive_nsec = ( unsigned )( receive % NS_PER_S );
+    shm->leap = 0;
+    shm->precision = ntp->precision;
+    shm->nsamples = 3;
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    shm->count++;
+    shm->valid = 1;
+
+    return 0;
+}
+
+int64_t gps_ntp_delay( const gps_ntp_t *ntp )
+{
+    int64_t sorted[ GPS_NTP_WINDOW ];
+    size_t count = ntp->samples < GPS_NTP_WINDOW ? ( size_t )ntp->samples : GPS_NTP_WINDOW;
+    size_t i, j;
+
+    if( count == 0 )
+        return 0;
+
+    /* Insertion sort, the window is small */
+    for( i = 0; i < count; i++ )
+    {
+        int64_t delay = ntp->delay[ i ];
+
+        for( j = i; j > 0 && sorted[ j - 1 ] > delay; j-- )
+            sorted[ j ] = sorted[ j - 1 ];
+
+        sorted[ j ] = delay;
+    }
+
+    return sorted[ count / 2 ];
+}
+
+int gps_ntp_read( gps_ntp_t *ntp, gps_ntp_sample_t *sample )
+{
+    gps_ntp_shm_t *shm = ntp->shm;
+    gps_ntp_shm_t copy;
+    int count;
+
+    if( !shm->valid )
+        return 0;
+
+    count = shm->count;
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    memcpy( &copy, ( const void * )shm, sizeof( copy ) );
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+
+    if( copy.mode == 1 && count != shm->count )
+        return 0;
+
+    shm->valid = 0;
+    sample->clock = ( int64_t )copy.clock_sec * NS_PER_S + copy.clock_nsec;
+    sample->receive = ( int64_t )copy.receive_sec * NS_PER_S + copy.receive_nsec;
+    sample->leap = copy.leap;
+    sample->precision = copy.precision;
+
+    return 1;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,167 @@
+/****************************************************************************
+* Title                 :   NTP Shared Memory Reference Clock
+* Filename              :   gps_ntp.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_ntp.h
+ * @brief Feeds epoch times to chronyd or ntpd through the SHM refclock
+ *
+ * Each sample pairs the UTC time of an epoch, from RMC, ZDA or GGA, with
+ * the system clock at the arrival of its first byte.  The segment is the
+ * one ntpd's type 28 driver and chrony's "refclock SHM" read, key
+ * 0x4e545030 plus the unit, written in mode 1 with its count as a
+ * sequence lock.
+ *
+ * The arrival comes after the UTC second by a delay the receiver adds
+ * before it starts talking, plus the first chars and the wakeup.  Taking
+ * the first byte of the burst, not of the sentence that carried the time,
+ * leaves out the sentences the receiver sends before it, whose length
+ * changes from epoch to epoch.  What is left is about fixed.  offset is
+ * taken off every receive time to compensate it.  gps_ntp_delay() is the
+ * median delay of the last GPS_NTP_WINDOW samples.  It is only the delay
+ * while the system clock is right, synchronised over the network for
+ * example, so calibrate once and keep the value, as chrony's offset
+ * option would.
+ *
+ * @code
+ * gps_ntp_open( &ntp, 0 );                          // refclock SHM 0
+ * ntp.offset = 128000000;                           // 128 ms, calibrated
+ *
+ * while( gps_serial_burst( &port, -1 ) > 0 )
+ * {
+ *     gps_serial_put( &port );
+ *     if( gps_last_epoch( &epoch ) != last )
+ *         gps_ntp_sample( &ntp, &epoch, port.first );
+ * }
+ * @endcode
+ */
+#ifndef GPS_NTP_H_
+#define GPS_NTP_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "gps_parser.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_NTP_KEY         0x4e545030  /**< "NTP0", the key of unit 0 */
+#define GPS_NTP_WINDOW      64          /**< Delays gps_ntp_delay() looks at */
+#define GPS_NTP_PRECISION   -10         /**< log2 s, about a ms */
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Segment as ntpd's struct shmTime lays it out
+ */
+typedef struct
+{
+    int mode;                   /**< 1, count guards the sample */
+    volatile int count;         /**< Incremented before and after writing */
+    time_t clock_sec;           /**< UTC of the receiver */
+    int clock_usec;
+    time_t receive_sec;         /**< System clock at that time */
+    int receive_usec;
+    int leap;
+    int precision;
+    int nsamples;
+    volatile int valid;         /**< Set by the writer, cleared by the reader */
+    unsigned clock_nsec;
+    unsigned receive_nsec;
+    int dummy[ 8 ];
+} gps_ntp_shm_t;
+
+/**
+ * @struct A sample as the reader takes it
+ */
+typedef struct
+{
+    int64_t clock;              /**< ns since 1970 UTC, from the receiver */
+    int64_t receive;            /**< ns since 1970 of the system clock */
+    int leap;
+    int precision;
+} gps_ntp_sample_t;
+
+/**
+ * @struct Writer or reader of a unit
+ */
+typedef struct
+{
+    gps_ntp_shm_t *shm;
+    int id;                     /**< shmget() id */
+    int unit;
+    int precision;              /**< Written with each sample, may be changed */
+    int64_t offset;             /**< ns taken off every receive time */
+    uint64_t samples;
+    uint64_t rejected;          /**< Epochs without a valid fix or time */
+    int64_t delay[ GPS_NTP_WINDOW ];    /**< Arrival minus UTC, ns */
+} gps_ntp_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Attaches the segment of unit, creating it if need be
+ *
+ * As ntpd does, units 0 and 1 are created readable by root only and the
+ * others by everyone.
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_ntp_open( gps_ntp_t *ntp, int unit );
+
+/**
+ * @brief Detaches the segment, it stays for the reader
+ */
+void gps_ntp_close( gps_ntp_t *ntp );
+
+/**
+ * @brief Writes the sample of an epoch
+ *
+ * An epoch without a date takes the UTC day from the system clock.
+ * Epochs the receiver marks as without a fix are rejected, their time may
+ * come from its real time clock.  A zeroed ntp without a segment only
+ * records the delay, for calibrating before anything is published.
+ *
+ * @param arrival - CLOCK_MONOTONIC ns of the epoch's first byte, the
+ * first of gps_serial_t or the first_byte of the epoch with GPS_TIMESTAMPS
+ *
+ * @return int - 0 or -1 with errno set, EINVAL for an epoch without time
+ * and EAGAIN without a fix
+ */
+int gps_ntp_sample( gps_ntp_t *ntp, const gps_epoch_t *epoch, uint64_t arrival );
+
+/**
+ * @brief Median arrival delay of the last samples
+ *
+ * @return int64_t - ns, 0 before the first sample
+ */
+int64_t gps_ntp_delay( const gps_ntp_t *ntp );
+
+/**
+ * @brief Takes the sample as chronyd and ntpd do, for testing and
+ * monitoring
+ *
+ * @return int - 1 with sample filled and the segment marked read, 0 when
+ * there is no new sample or it was being written
+ */
+int gps_ntp_read( gps_ntp_t *ntp, gps_ntp_sample_t *sample );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_NTP_H_ */
+
+/*** End of File **************************************************************/
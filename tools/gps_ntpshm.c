@@ -0,0 +1,160 @@
+/*******************************************************************************
+* Title                 :   NTP Reference Clock Driver
+* Filename              :   gps_ntpshm.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_ntpshm.c
+ * @brief Disciplines the system clock from a receiver through chronyd.
+ *
+ * Reads the receiver a burst at a time and writes the time of every epoch
+ * with a fix to the SHM refclock -u, 0 by default.  -o is the arrival
+ * delay to compensate, in ms.  -c measures it instead: after that many
+ * samples the median delay becomes the offset and is printed, and only
+ * then are compensated samples written.  Only calibrate while the system
+ * clock is right, synchronised over the network, and pass the result with
+ * -o afterwards.  -v prints every sample.
+ *
+ * @code
+ * # chrony.conf:  refclock SHM 0 refid GPS precision 1e-3 poll 2
+ * gps_ntpshm -b 9600 -c 64 /dev/ttyUSB0
+ * gps_ntpshm -b 9600 -o 128.4 /dev/ttyUSB0
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "gps_parser.h"
+#include "gps_serial.h"
+#include "gps_ntp.h"
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-b baud] [-u unit] [-o offset_ms | -c samples] [-v] "
+             "source\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    static gps_serial_t port;
+    uint32_t last = 0;
+    long baud = 0, calibrate = 0;
+    int unit = 0, verbose = 0, opt, fd;
+    double offset = 0;
+    gps_epoch_t epoch;
+    gps_ntp_t ntp;
+
+    while( ( opt = getopt( argc, argv, "b:u:o:c:vh" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'b':
+            baud = strtol( optarg, NULL, 10 );
+            break;
+        case 'u':
+            unit = ( int )strtol( optarg, NULL, 10 );
+            break;
+        case 'o':
+            offset = strtod( optarg, NULL );
+            break;
+        case 'c':
+            calibrate = strtol( optarg, NULL, 10 );
+            break;
+        case 'v':
+            verbose = 1;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind != argc - 1 || calibrate < 0 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    fd = strcmp( argv[ optind ], "-" ) == 0 ? STDIN_FILENO
+                                            : open( argv[ optind ], O_RDWR | O_NOCTTY );
+
+    if( fd < 0 || gps_serial_setup( &port, fd, baud ) )
+    {
+        perror( argv[ optind ] );
+        return 1;
+    }
+
+    if( gps_ntp_open( &ntp, unit ) )
+    {
+        perror( "shmget" );
+        return 1;
+    }
+
+    /* Attached again once the offset is known, uncompensated samples would
+       pull the clock by the whole delay */
+    if( calibrate )
+    {
+        gps_ntp_close( &ntp );
+        ntp.precision = GPS_NTP_PRECISION;
+    }
+
+    ntp.offset = ( int64_t )( offset * 1e6 );
+
+    while( gps_serial_burst( &port, -1 ) > 0 )
+    {
+        gps_serial_put( &port );
+
+        if( gps_last_epoch( &epoch ) == last )
+            continue;
+
+        last = epoch.epoch;
+
+        if( gps_ntp_sample( &ntp, &epoch, port.first ) )
+            continue;
+
+        if( verbose )
+            printf( "%02u:%02u:%02u.%03u delay %.3f ms\n", epoch.time.hour,
+                    epoch.time.minute, epoch.time.second, epoch.time.ms,
+                    ntp.delay[ ( ntp.samples - 1 ) % GPS_NTP_WINDOW ] / 1e6 );
+
+        if( ntp.shm == NULL && ntp.samples == ( uint64_t )calibrate )
+        {
+            int64_t delay = gps_ntp_delay( &ntp );
+
+            printf( "offset %.3f ms after %ld samples\n", delay / 1e6, calibrate );
+
+            if( gps_ntp_open( &ntp, unit ) )
+            {
+                perror( "shmget" );
+                return 1;
+            }
+
+            ntp.offset = delay;
+        }
+
+        fflush( stdout );
+    }
+
+    if( errno != EIO )
+        perror( argv[ optind ] );
+
+    fprintf( stderr, "%llu samples, %llu epochs without a fix, delay %.3f ms\n",
+             ( unsigned long long )ntp.samples, ( unsigned long long )ntp.rejected,
+             gps_ntp_delay( &ntp ) / 1e6 );
+    gps_ntp_close( &ntp );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
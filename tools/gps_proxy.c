@@ -0,0 +1,186 @@
+/*******************************************************************************
+* Title                 :   NMEA Multiplexer CLI
+* Filename              :   gps_proxy.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_proxy.c
+ * @brief Merges receivers, ptys or pipes into one NMEA stream.
+ *
+ * Sources are given best first and may list the types they forward after
+ * an '=', "other" for proprietary and unknown sentences.  -o writes to a
+ * file, device or fifo instead of stdout.  -t sets the ms after which a
+ * source no longer counts for a type it stopped sending.  Sources that
+ * are ttys are put in raw mode with gps_serial_setup(), at -b baud if
+ * given.  The counts of every source are printed when all of them end.
+ *
+ * @code
+ * gps_proxy -b 9600 -o /dev/ttyUSB3 /dev/ttyUSB0 /dev/ttyUSB1 /dev/ttyUSB2=THS
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include "gps_parser.h"
+#include "gps_mux.h"
+#include "gps_serial.h"
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-b baud] [-o output] [-t timeout_ms] source[=TYPE,...] ...\n",
+             name );
+}
+
+/* GPS_MUX_TYPE() bits of a list such as GGA,RMC,other, 0 when not valid */
+static uint32_t types_parse( const char *list )
+{
+    uint32_t types = 0;
+
+    while( *list )
+    {
+        size_t length = strcspn( list, "," );
+        int t;
+
+        if( length == 5 && memcmp( list, "other", 5 ) == 0 )
+        {
+            types |= GPS_MUX_TYPE( GPS_SENTENCE_UNKNOWN );
+        }
+        else
+        {
+            for( t = GPS_SENTENCE_UNKNOWN + 1; t < GPS_SENTENCE_COUNT; t++ )
+            {
+                if( length == 3 &&
+                    memcmp( list, gps_sentence_name( ( gps_sentence_t )t ), 3 ) == 0 )
+                    break;
+            }
+
+            if( t == GPS_SENTENCE_COUNT )
+                return 0;
+
+            types |= GPS_MUX_TYPE( t );
+        }
+
+        list += length;
+
+        if( *list == ',' )
+            list++;
+    }
+
+    return types;
+}
+
+int main( int argc, char **argv )
+{
+    static gps_mux_t mux;
+    static gps_serial_t port;
+    const char *output = NULL;
+    int64_t timeout = GPS_MUX_TIMEOUT;
+    long baud = 0;
+    int opt, out, i, result;
+
+    while( ( opt = getopt( argc, argv, "b:o:t:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'b':
+            baud = strtol( optarg, NULL, 10 );
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 't':
+            timeout = strtoll( optarg, NULL, 10 );
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind >= argc || argc - optind > GPS_MUX_SOURCES || timeout <= 0 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    /* A consumer that goes away ends the run with EPIPE */
+    signal( SIGPIPE, SIG_IGN );
+
+    out = output == NULL ? STDOUT_FILENO
+                         : open( output, O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644 );
+
+    if( out < 0 )
+    {
+        perror( output );
+        return 1;
+    }
+
+    gps_mux_init( &mux, out, timeout );
+
+    for( i = optind; i < argc; i++ )
+    {
+        char *types = strchr( argv[ i ], '=' );
+        uint32_t mask = GPS_MUX_ALL;
+        int fd;
+
+        if( types != NULL )
+        {
+            *types++ = '\0';
+            mask = types_parse( types );
+
+            if( mask == 0 )
+            {
+                fprintf( stderr, "%s: unknown sentence types %s\n", argv[ i ], types );
+                return 2;
+            }
+        }
+
+        fd = strcmp( argv[ i ], "-" ) == 0 ? STDIN_FILENO
+                                           : open( argv[ i ], O_RDONLY | O_NOCTTY );
+
+        if( fd < 0 || ( isatty( fd ) && gps_serial_setup( &port, fd, baud ) ) )
+        {
+            perror( argv[ i ] );
+            return 1;
+        }
+
+        gps_mux_add( &mux, fd, i - optind, mask );
+    }
+
+    result = gps_mux_run( &mux );
+
+    if( result )
+        perror( "gps_proxy" );
+
+    for( i = 0; i < mux.sources; i++ )
+    {
+        const gps_mux_stats_t *st = &mux.source[ i ].stats;
+
+        fprintf( stderr, "%s: %llu lines, %llu forwarded, %llu standby, "
+                 "%llu filtered, %llu invalid, %llu overlong\n",
+                 argv[ optind + i ], ( unsigned long long )st->lines,
+                 ( unsigned long long )st->forwarded,
+                 ( unsigned long long )st->standby,
+                 ( unsigned long long )st->filtered,
+                 ( unsigned long long )st->invalid,
+                 ( unsigned long long )st->overlong );
+    }
+
+    fprintf( stderr, "%llu failovers\n", ( unsigned long long )mux.failovers );
+
+    return result ? 1 : 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
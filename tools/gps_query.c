@@ -0,0 +1,538 @@
+/*******************************************************************************
+* Title                 :   Track Queries
+* Filename              :   gps_query.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_query.c
+ * @brief Time range, bounding box and position at time queries on stores.
+ *
+ * The box test runs on the stored 1e-7 degree integers.  It is written
+ * as one branch free pass over the coordinate columns, which the compiler
+ * turns into SIMD compares.  A second pass compacts the matching row
+ * numbers.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "gps_query.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define ROWS            GPS_STORE_BLOCK_ROWS
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+/* Closest positioned row on one side of a time, in stored units */
+typedef struct
+{
+    int found;
+    int64_t time;
+    int64_t latitude;
+    int64_t longitude;
+    int64_t altitude;
+    uint16_t fields;
+} nearest_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int64_t fixed( double degrees );
+static size_t first_block( const gps_store_t *store, int64_t time );
+static size_t lower_bound( const int64_t *times, size_t rows, int64_t time );
+static int block_decode( gps_query_t *query, size_t block );
+static int track_gather( gps_track_t *out, const gps_track_t *from,
+                         const uint16_t *rows, size_t count );
+static size_t select_box( const int64_t *restrict latitude,
+                          const int64_t *restrict longitude,
+                          const uint16_t *restrict fields, size_t rows,
+                          const int32_t *bounds, uint8_t *restrict keep );
+static size_t select_time( const int64_t *restrict times, size_t rows,
+                           int64_t from, int64_t to, uint8_t *restrict keep );
+static size_t compact( const uint8_t *keep, size_t rows, uint16_t *selected );
+static int block_nearest( gps_query_t *query, size_t block, int64_t time,
+                          nearest_t *before, nearest_t *after );
+static void nearest_take( nearest_t *side, const int64_t *values, size_t row,
+                          uint16_t fields );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* Clamped so that the unsigned range tests can't wrap */
+static int64_t fixed( double degrees )
+{
+    if( degrees > 180 )
+        degrees = 180;
+    else if( degrees < -180 )
+        degrees = -180;
+
+    degrees *= GPS_STORE_DEGREES;
+
+    return ( int64_t )( degrees < 0 ? degrees - 0.5 : degrees + 0.5 );
+}
+
+/* First block that can hold time or later, 0 unless the store is sorted */
+static size_t first_block( const gps_store_t *store, int64_t time )
+{
+    size_t low = 0, high = store->blocks;
+
+    if( !( store->header->flags & GPS_STORE_SORTED ) )
+        return 0;
+
+    while( low < high )
+    {
+        size_t middle = low + ( high - low ) / 2;
+
+        if( store->index[ middle ].max_time < time )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+static size_t lower_bound( const int64_t *times, size_t rows, int64_t time )
+{
+    size_t low = 0, high = rows;
+
+    while( low < high )
+    {
+        size_t middle = low + ( high - low ) / 2;
+
+        if( times[ middle ] < time )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+static int block_decode( gps_query_t *query, size_t block )
+{
+    query->block.count = 0;
+    query->stats.blocks++;
+
+    return gps_store_read_block( query->store, block, &query->block );
+}
+
+static int track_gather( gps_track_t *out, const gps_track_t *from,
+                         const uint16_t *rows, size_t count )
+{
+    size_t base = out->count;
+    size_t i;
+
+    if( gps_track_reserve( out, base + count ) )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+#define GATHER( COLUMN )                                                    \
+    for( i = 0; i < count; i++ )                                            \
+        out->COLUMN[ base + i ] = from->COLUMN[ rows[ i ] ];
+
+    GATHER( time );
+    GATHER( latitude );
+    GATHER( longitude );
+    GATHER( altitude );
+    GATHER( speed );
+    GATHER( track );
+    GATHER( hdop );
+    GATHER( quality );
+    GATHER( satellites );
+    GATHER( fields );
+#undef GATHER
+
+    out->count += count;
+
+    return 0;
+}
+
+/* bounds are south, north, west, east.  Unsigned differences test both ends
+   of a range with one compare. */
+static size_t select_box( const int64_t *restrict latitude,
+                          const int64_t *restrict longitude,
+                          const uint16_t *restrict fields, size_t rows,
+                          const int32_t *bounds, uint8_t *restrict keep )
+{
+    uint32_t south = ( uint32_t )bounds[ 0 ];
+    uint32_t height = ( uint32_t )bounds[ 1 ] - south;
+    uint32_t west = ( uint32_t )bounds[ 2 ];
+    uint32_t width = ( uint32_t )bounds[ 3 ] - west;
+    size_t i, count = 0;
+
+    for( i = 0; i < rows; i++ )
+    {
+        uint32_t lat = ( uint32_t )latitude[ i ] - south;
+        uint32_t lon = ( uint32_t )longitude[ i ] - west;
+
+        keep[ i ] = ( lat <= height ) & ( lon <= width ) &
+                    ( ( fields[ i ] & GPS_EPOCH_POSITION ) != 0 );
+        count += keep[ i ];
+    }
+
+    return count;
+}
+
+static size_t select_time( const int64_t *restrict times, size_t rows,
+                           int64_t from, int64_t to, uint8_t *restrict keep )
+{
+    size_t i, count = 0;
+
+    for( i = 0; i < rows; i++ )
+    {
+        keep[ i ] &= ( times[ i ] >= from ) & ( times[ i ] <= to );
+        count += keep[ i ];
+    }
+
+    return count;
+}
+
+static size_t compact( const uint8_t *keep, size_t rows, uint16_t *selected )
+{
+    size_t i, count = 0;
+
+    for( i = 0; i < rows; i++ )
+    {
+        selected[ count ] = ( uint16_t )i;
+        count += keep[ i ];
+    }
+
+    return count;
+}
+
+static void nearest_take( nearest_t *side, const int64_t *values, size_t row,
+                          uint16_t fields )
+{
+    side->found = 1;
+    side->time = values[ row ];
+    side->latitude = values[ ROWS + row ];
+    side->longitude = values[ 2 * ROWS + row ];
+    side->altitude = values[ 3 * ROWS + row ];
+    side->fields = fields;
+}
+
+static int block_nearest( gps_query_t *query, size_t block, int64_t time,
+                          nearest_t *before, nearest_t *after )
+{
+    const gps_store_t *store = query->store;
+    const uint16_t *fields = gps_store_fields( store, block );
+    size_t rows = store->index[ block ].rows;
+    int64_t *values = query->values;
+    size_t i;
+
+    query->stats.blocks++;
+
+    if( gps_store_stream( store, block, GPS_STORE_TIME, values ) ||
+        gps_store_stream( store, block, GPS_STORE_LATITUDE, values + ROWS ) ||
+        gps_store_stream( store, block, GPS_STORE_LONGITUDE, values + 2 * ROWS ) ||
+        gps_store_stream( store, block, GPS_STORE_ALTITUDE, values + 3 * ROWS ) )
+        return -1;
+
+    for( i = 0; i < rows; i++ )
+    {
+        if( !( fields[ i ] & GPS_EPOCH_POSITION ) )
+            continue;
+
+        if( values[ i ] <= time && ( !before->found || values[ i ] > before->time ) )
+            nearest_take( before, values, i, fields[ i ] );
+
+        if( values[ i ] >= time && ( !after->found || values[ i ] < after->time ) )
+            nearest_take( after, values, i, fields[ i ] );
+    }
+
+    return 0;
+}
+
+int gps_query_init( gps_query_t *query, const gps_store_t *store )
+{
+    memset( query, 0, sizeof( gps_query_t ) );
+    query->store = store;
+    query->values = malloc( 4 * ROWS * sizeof( int64_t ) );
+    query->rows = malloc( ROWS * ( sizeof( uint16_t ) + 1 ) );
+
+    if( query->values == NULL || query->rows == NULL ||
+        gps_track_reserve( &query->block, ROWS ) )
+    {
+        gps_query_free( query );
+        errno = ENOMEM;
+        return -1;
+    }
+
+    return 0;
+}
+
+void gps_query_free( gps_query_t *query )
+{
+    gps_track_free( &query->block );
+    free( query->values );
+    free( query->rows );
+    memset( query, 0, sizeof( gps_query_t ) );
+}
+
+int gps_query_time( gps_query_t *query, int64_t from, int64_t to,
+                    gps_track_t *out )
+{
+    const gps_store_t *store = query->store;
+    int sorted = ( store->header->flags & GPS_STORE_SORTED ) != 0;
+    size_t first = out->count;
+    size_t b;
+
+    query->stats.queries++;
+
+    for( b = first_block( store, from ); b < store->blocks; b++ )
+    {
+        const gps_store_block_t *entry = &store->index[ b ];
+        const int64_t *times;
+        size_t rows = entry->rows;
+        size_t low, high;
+
+        if( entry->min_time > to )
+        {
+            if( sorted )
+                break;
+
+            continue;
+        }
+
+        if( rows == 0 || entry->max_time < from )
+            continue;
+
+        /* Every row matches */
+        if( entry->min_time >= from && entry->max_time <= to )
+        {
+            query->stats.blocks++;
+
+            if( gps_store_read_block( store, b, out ) )
+                return -1;
+
+            continue;
+        }
+
+        if( block_decode( query, b ) )
+            return -1;
+
+        times = query->block.time;
+
+        if( entry->flags & GPS_STORE_SORTED )
+        {
+            low = lower_bound( times, rows, from );
+            high = to == INT64_MAX ? rows : lower_bound( times, rows, to + 1 );
+
+            if( gps_track_append( out, &query->block, low, high - low ) )
+            {
+                errno = ENOMEM;
+                return -1;
+            }
+        }
+        else
+        {
+            uint8_t *keep = ( uint8_t * )( query->rows + ROWS );
+
+            memset( keep, 1, rows );
+            select_time( times, rows, from, to, keep );
+
+            if( track_gather( out, &query->block, query->rows,
+                              compact( keep, rows, query->rows ) ) )
+                return -1;
+        }
+    }
+
+    query->stats.rows += out->count - first;
+
+    return 0;
+}
+
+int gps_query_box( gps_query_t *query, const gps_query_box_t *box,
+                   int64_t from, int64_t to, gps_track_t *out )
+{
+    const gps_store_t *store = query->store;
+    int sorted = ( store->header->flags & GPS_STORE_SORTED ) != 0;
+    uint8_t *keep = ( uint8_t * )( query->rows + ROWS );
+    size_t first = out->count;
+    int32_t bounds[ 4 ];
+    size_t b;
+
+    bounds[ 0 ] = ( int32_t )fixed( box->south );
+    bounds[ 1 ] = ( int32_t )fixed( box->north );
+    bounds[ 2 ] = ( int32_t )fixed( box->west );
+    bounds[ 3 ] = ( int32_t )fixed( box->east );
+    query->stats.queries++;
+
+    if( bounds[ 0 ] > bounds[ 1 ] || bounds[ 2 ] > bounds[ 3 ] )
+        return 0;
+
+    for( b = first_block( store, from ); b < store->blocks; b++ )
+    {
+        const gps_store_block_t *entry = &store->index[ b ];
+        const uint16_t *fields;
+        size_t rows = entry->rows;
+        size_t count;
+
+        if( entry->min_time > to )
+        {
+            if( sorted )
+                break;
+
+            continue;
+        }
+
+        /* An empty bounding box fails the first two tests */
+        if( entry->max_time < from ||
+            entry->min_latitude > bounds[ 1 ] || entry->max_latitude < bounds[ 0 ] ||
+            entry->min_longitude > bounds[ 3 ] || entry->max_longitude < bounds[ 2 ] )
+            continue;
+
+        fields = gps_store_fields( store, b );
+
+        if( entry->min_latitude >= bounds[ 0 ] && entry->max_latitude <= bounds[ 1 ] &&
+            entry->min_longitude >= bounds[ 2 ] && entry->max_longitude <= bounds[ 3 ] )
+        {
+            size_t i;
+
+            /* Inside the box, only the rows without a position are left out */
+            for( i = 0; i < rows; i++ )
+                keep[ i ] = ( fields[ i ] & GPS_EPOCH_POSITION ) != 0;
+        }
+        else
+        {
+            if( gps_store_stream( store, b, GPS_STORE_LATITUDE, query->values ) ||
+                gps_store_stream( store, b, GPS_STORE_LONGITUDE, query->values + ROWS ) )
+                return -1;
+
+            if( !select_box( query->values, query->values + ROWS, fields, rows,
+                             bounds, keep ) )
+                continue;
+        }
+
+        if( entry->min_time < from || entry->max_time > to )
+        {
+            if( gps_store_stream( store, b, GPS_STORE_TIME, query->values ) )
+                return -1;
+
+            select_time( query->values, rows, from, to, keep );
+        }
+
+        count = compact( keep, rows, query->rows );
+
+        if( count == 0 )
+            continue;
+
+        if( block_decode( query, b ) ||
+            track_gather( out, &query->block, query->rows, count ) )
+            return -1;
+    }
+
+    query->stats.rows += out->count - first;
+
+    return 0;
+}
+
+int gps_query_at( gps_query_t *query, int64_t time, int64_t max_gap,
+                  gps_query_fix_t *fix )
+{
+    const gps_store_t *store = query->store;
+    int64_t low = max_gap > 0 && time > INT64_MIN + max_gap ? time - max_gap : INT64_MIN;
+    int64_t high = max_gap > 0 && time < INT64_MAX - max_gap ? time + max_gap : INT64_MAX;
+    nearest_t before, after;
+    double f, d;
+    size_t b;
+
+    memset( &before, 0, sizeof( before ) );
+    memset( &after, 0, sizeof( after ) );
+    query->stats.queries++;
+
+    if( store->header->flags & GPS_STORE_SORTED )
+    {
+        size_t start = first_block( store, time );
+
+        /* Later blocks only hold later fixes and earlier ones earlier fixes,
+           so each side stops at the first block that has one */
+        for( b = start; b < store->blocks && !after.found; b++ )
+        {
+            const gps_store_block_t *entry = &store->index[ b ];
+
+            if( entry->min_time > high )
+                break;
+
+            if( entry->min_latitude <= entry->max_latitude &&
+                block_nearest( query, b, time, &before, &after ) )
+                return -1;
+        }
+
+        /* start itself only has later fixes if the forward pass skipped it */
+        for( b = start; b-- > 0 && !before.found; )
+        {
+            const gps_store_block_t *entry = &store->index[ b ];
+
+            if( entry->max_time < low )
+                break;
+
+            if( entry->min_latitude <= entry->max_latitude &&
+                block_nearest( query, b, time, &before, &after ) )
+                return -1;
+        }
+    }
+    else
+    {
+        for( b = 0; b < store->blocks; b++ )
+        {
+            const gps_store_block_t *entry = &store->index[ b ];
+
+            if( entry->max_time < low || entry->min_time > high ||
+                entry->min_latitude > entry->max_latitude )
+                continue;
+
+            if( block_nearest( query, b, time, &before, &after ) )
+                return -1;
+        }
+    }
+
+    if( !before.found || !after.found ||
+        ( max_gap > 0 && after.time - before.time > max_gap ) )
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    f = after.time > before.time ? ( double )( time - before.time ) / ( after.time - before.time ) : 0;
+    d = ( double )( after.longitude - before.longitude );
+
+    /* The short way round across the antimeridian */
+    if( d > 180 * GPS_STORE_DEGREES )
+        d -= 360 * GPS_STORE_DEGREES;
+    else if( d < -180 * GPS_STORE_DEGREES )
+        d += 360 * GPS_STORE_DEGREES;
+
+    fix->time = time;
+    fix->latitude = ( before.latitude + f * ( after.latitude - before.latitude ) ) / GPS_STORE_DEGREES;
+    fix->longitude = ( before.longitude + f * d ) / GPS_STORE_DEGREES;
+    fix->fields = GPS_EPOCH_POSITION;
+    fix->altitude = 0;
+
+    if( fix->longitude > 180 )
+        fix->longitude -= 360;
+    else if( fix->longitude <= -180 )
+        fix->longitude += 360;
+
+    if( before.fields & after.fields & GPS_EPOCH_ALTITUDE )
+    {
+        fix->altitude = ( float )( ( before.altitude + f * ( after.altitude - before.altitude ) ) /
+                                   GPS_STORE_UNITS );
+        fix->fields |= GPS_EPOCH_ALTITUDE;
+    }
+
+    query->stats.rows++;
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
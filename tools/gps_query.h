@@ -0,0 +1,138 @@
+/****************************************************************************
+* Title                 :   Track Queries
+* Filename              :   gps_query.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_query.h
+ * @brief Time range, bounding box and position at time queries on stores
+ *
+ * Queries first check the index, and skip every block whose time range or
+ * bounding box can't match.  Then they decode only the streams they test.
+ * Whole blocks are read when every row matches.  Sorted blocks are binary
+ * searched by time.
+ *
+ * @code
+ * gps_query_box_t box = { 48.10, 11.50, 48.20, 11.60 };
+ * gps_query_fix_t fix;
+ * gps_query_t query;
+ *
+ * gps_query_init( &query, &store );
+ * gps_query_time( &query, from, to, &track );
+ * gps_query_box( &query, &box, from, to, &track );
+ * gps_query_at( &query, when, 10000, &fix );
+ * gps_query_free( &query );
+ * @endcode
+ */
+#ifndef GPS_QUERY_H_
+#define GPS_QUERY_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stdint.h>
+#include "gps_store.h"
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Area in degrees, west not above east
+ */
+typedef struct
+{
+    double south;
+    double west;
+    double north;
+    double east;
+} gps_query_box_t;
+
+/**
+ * @struct Position at a time, interpolated between the fixes around it
+ */
+typedef struct
+{
+    int64_t time;               /**< UTC ms since 1970 */
+    double latitude;
+    double longitude;
+    float altitude;
+    uint16_t fields;            /**< POSITION, ALTITUDE when both fixes had it */
+} gps_query_fix_t;
+
+/**
+ * @struct Work done by the queries of a context
+ */
+typedef struct
+{
+    uint64_t queries;
+    uint64_t blocks;            /**< Blocks that passed the index and were decoded */
+    uint64_t rows;              /**< Rows returned */
+} gps_query_stats_t;
+
+/**
+ * @struct Query context, one per thread
+ */
+typedef struct
+{
+    const gps_store_t *store;
+    gps_query_stats_t stats;
+    gps_track_t block;          /**< Last decoded block */
+    int64_t *values;            /**< Decoded streams, GPS_STORE_BLOCK_ROWS each */
+    uint16_t *rows;             /**< Selected rows of a block */
+} gps_query_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Prepares a context for queries on an open store
+ *
+ * @return int - 0 or -1 when out of memory
+ */
+int gps_query_init( gps_query_t *query, const gps_store_t *store );
+
+/**
+ * @brief Releases the buffers of a context
+ */
+void gps_query_free( gps_query_t *query );
+
+/**
+ * @brief Appends the rows from from to to, both included
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_query_time( gps_query_t *query, int64_t from, int64_t to,
+                    gps_track_t *out );
+
+/**
+ * @brief Appends the positioned rows inside a box and a time range
+ *
+ * @param from, to - INT64_MIN and INT64_MAX for all of the store
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_query_box( gps_query_t *query, const gps_query_box_t *box,
+                   int64_t from, int64_t to, gps_track_t *out );
+
+/**
+ * @brief Interpolates the position at a time
+ *
+ * @param max_gap - ms the fixes around time may be apart, 0 for any
+ *
+ * @return int - 0 or -1 with errno ENOENT when there are no such fixes
+ */
+int gps_query_at( gps_query_t *query, int64_t time, int64_t max_gap,
+                  gps_query_fix_t *fix );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_QUERY_H_ */
+
+/*** End of File **************************************************************/
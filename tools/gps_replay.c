@@ -0,0 +1,746 @@
+/*******************************************************************************
+* Title                 :   Fleet Replay
+* Filename              :   gps_replay.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_replay.c
+ * @brief Replays recorded NMEA as a fleet of receivers, sped up or not.
+ *
+ * Every file is an NMEA log or a gps_store track, which is encoded back to
+ * RMC and GGA.  It is cut into epochs at each new RMC or GGA time, and -k
+ * units replay each file.  An epoch is written in one piece when its UTC
+ * time comes, relative to the first epoch and divided by -x, so -x 100
+ * replays at a hundred times real time.  The units of a file start spread
+ * over one second of its time, as independent receivers would.  -l loops
+ * the logs until -d seconds have passed.
+ *
+ * The next epoch of every unit waits in a timer wheel of 1 ms ticks.  -t
+ * connects every unit to host:port over TCP, gps_fleetd for example, and
+ * -m pty gives every unit a pty and prints the names of their slaves.
+ * Over TCP a unit starts with a $PUNIT hello of its number from 1, so
+ * gps_fleetd gives it back its unit when a replay is restarted.
+ * Every -i seconds, and at the end, the epochs and sentences per second
+ * the schedule asked for are reported with the ones written, with how
+ * late epochs went out.  An epoch that is still unwritten when the next
+ * one is due, because the reader doesn't keep up, is an overrun and the
+ * rest of it is dropped, as a UART would.
+ *
+ * @code
+ * gps_replay -x 10 -k 1000 -t 127.0.0.1:10110 day*.nmea
+ * gps_replay -x 1 -m pty -l drive.gpst
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _XOPEN_SOURCE 700           /* posix_openpt() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netdb.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include "gps_encode.h"
+#include "gps_log.h"
+#include "gps_store.h"
+#include "gps_wheel.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define TICK_NS         1000000ll   /* 1 ms */
+#define MS_PER_DAY      86400000ll
+#define SOURCES_MAX     1024
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+/* A log cut into epochs */
+typedef struct
+{
+    char *text;
+    size_t size;
+    size_t epochs;
+    size_t *offset;             /* epochs + 1, where each starts */
+    uint64_t *lines;            /* epochs + 1, lines before each */
+    int64_t *time;              /* ms after the first epoch */
+    int64_t span;               /* ms of one pass, for looping */
+} source_t;
+
+typedef struct
+{
+    gps_wheel_timer_t timer;    /* First, the wheel hands it back */
+    const source_t *source;
+    int fd;
+    int slave;                  /* Of a pty, kept open so it stays raw */
+    int64_t start;              /* ns of the first epoch */
+    uint64_t index;             /* Epochs begun, loops included */
+    int64_t due;                /* ns of epoch index */
+    size_t rest;                /* Unwritten bytes of the current epoch */
+    size_t end;
+    uint64_t lines;             /* Of the current epoch */
+} unit_t;
+
+typedef struct
+{
+    uint64_t epochs;
+    uint64_t lines;
+    uint64_t bytes;
+    uint64_t overruns;
+    uint64_t closed;
+    int64_t late;               /* ns summed over epochs */
+    int64_t late_max;
+} totals_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static double scale = 1;
+static int loop;
+static totals_t totals;
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-x scale] [-k units] [-l] [-d seconds] [-i seconds] "
+             "-t host:port | -m pty  log.nmea|track.gpst ...\n", name );
+}
+
+static void location( double degrees, azmuth_t positive, azmuth_t negative,
+                      int valid, location_t *loc )
+{
+    double magnitude = fabs( degrees );
+
+    loc->degrees = ( uint8_t )magnitude;
+    loc->minutes = ( magnitude - loc->degrees ) * 60;
+    loc->azmuth = !valid ? UNKNOWN : degrees < 0 ? negative : positive;
+}
+
+/* RMC and GGA of every row */
+static char *track_text( const gps_track_t *track, size_t *size )
+{
+    char *text = malloc( track->count * 2 * GPS_ENCODE_MAX + 1 );
+    size_t row, n = 0;
+
+    if( text == NULL )
+        return NULL;
+
+    for( row = 0; row < track->count; row++ )
+    {
+        int64_t day = track->time[ row ] / MS_PER_DAY;
+        int64_t tod = track->time[ row ] % MS_PER_DAY;
+        int position = ( track->fields[ row ] & GPS_EPOCH_POSITION ) != 0;
+        int32_t year, month, mday;
+        utc_time_t time;
+        TimeStruct date;
+        location_t lat, lon;
+        gga_t gga;
+        rmc_t rmc;
+
+        memset( &date, 0, sizeof( date ) );
+        memset( &gga, 0, sizeof( gga ) );
+        memset( &rmc, 0, sizeof( rmc ) );
+        time.hour = ( uint8_t )( tod / 3600000 );
+        time.minute = ( uint8_t )( tod / 60000 % 60 );
+        time.second = ( uint8_t )( tod / 1000 % 60 );
+        time.ms = ( uint16_t )( tod % 1000 );
+        gps_civil_from_days( day, &year, &month, &mday );
+        date.md = ( unsigned char )mday;
+        date.mo = ( unsigned char )month;
+        date.yy = ( unsigned int )year;
+        location( track->latitude[ row ], NORTH, SOUTH, position, &lat );
+        location( track->longitude[ row ], EAST, WEST, position, &lon );
+
+        gga.fix = ( fix_t )track->quality[ row ];
+        gga.num_sats = track->satellites[ row ] > 15 ? 15 : track->satellites[ row ];
+        gga.horizontal = track->hdop[ row ];
+        gga.altitude = track->altitude[ row ];
+        rmc.status = gga.fix != INVALID && position ? RMC_ACTIVE : RMC_VOID;
+        rmc.speed = track->speed[ row ];
+        rmc.track = track->track[ row ];
+
+        n += gps_encode_rmc( text + n, &time, &date, &lat, &lon, &rmc );
+        n += gps_encode_gga( text + n, &time, &lat, &lon, &gga );
+    }
+
+    *size = n;
+
+    return text;
+}
+
+/* Reads a log, or a store re-encoded */
+static char *source_text( const char *path, size_t *size )
+{
+    gps_store_t store;
+    struct stat st;
+    char *text;
+    int fd;
+
+    if( gps_store_open( &store, path ) == 0 )
+    {
+        gps_track_t track;
+
+        memset( &track, 0, sizeof( track ) );
+        text = gps_store_read( &store, &track ) ? NULL : track_text( &track, size );
+        gps_store_close( &store );
+        gps_track_free( &track );
+
+        return text;
+    }
+
+    fd = open( path, O_RDONLY );
+
+    if( fd < 0 || fstat( fd, &st ) || ( text = malloc( st.st_size + 1 ) ) == NULL )
+    {
+        if( fd >= 0 )
+            close( fd );
+
+        return NULL;
+    }
+
+    *size = 0;
+
+    while( *size < ( size_t )st.st_size )
+    {
+        ssize_t got = read( fd, text + *size, st.st_size - *size );
+
+        if( got <= 0 )
+            break;
+
+        *size += got;
+    }
+
+    close( fd );
+
+    return text;
+}
+
+/* Drops the whole index when a column cannot grow */
+static int source_grow( source_t *s, size_t capacity )
+{
+    size_t *offset = realloc( s->offset, capacity * sizeof( size_t ) );
+    uint64_t *lines;
+    int64_t *time;
+
+    if( offset )
+        s->offset = offset;
+
+    lines = realloc( s->lines, capacity * sizeof( uint64_t ) );
+
+    if( lines )
+        s->lines = lines;
+
+    time = realloc( s->time, capacity * sizeof( int64_t ) );
+
+    if( time )
+        s->time = time;
+
+    if( offset && lines && time )
+        return 0;
+
+    free( s->offset );
+    free( s->lines );
+    free( s->time );
+    s->offset = NULL;
+    s->lines = NULL;
+    s->time = NULL;
+
+    return -1;
+}
+
+/* A new epoch at every new RMC or GGA time, later lines go with it */
+static int source_index( source_t *s )
+{
+    size_t capacity = 1024, pos = 0, n = 0;
+    int64_t carry = 0, current = 0, first = 0;
+    uint64_t lines = 0;
+    int timed = 0;
+
+    s->offset = malloc( capacity * sizeof( size_t ) );
+    s->lines = malloc( capacity * sizeof( uint64_t ) );
+    s->time = malloc( capacity * sizeof( int64_t ) );
+
+    while( pos < s->size && s->offset && s->lines && s->time )
+    {
+        const char *line = s->text + pos;
+        const char *eol = memchr( line, '\n', s->size - pos );
+        size_t length = eol ? ( size_t )( eol - line ) + 1 : s->size - pos;
+        int32_t tod, day;
+
+        if( gps_log_stamp( line, length, &tod, &day ) != GPS_SENTENCE_UNKNOWN )
+        {
+            int64_t t;
+
+            /* Past midnight */
+            if( timed && tod + carry < current - MS_PER_DAY / 2 )
+                carry += MS_PER_DAY;
+
+            t = tod + carry;
+
+            if( !timed )
+                first = t;
+
+            if( !timed || t > current )
+            {
+                /* Leading lines without a time go with the first epoch */
+                s->offset[ n ] = n ? pos : 0;
+                s->lines[ n ] = n ? lines : 0;
+                s->time[ n ] = t - first;
+                current = t;
+                timed = 1;
+
+                if( ++n == capacity )
+                {
+                    capacity *= 2;
+                    source_grow( s, capacity );
+                }
+            }
+        }
+
+        lines++;
+        pos += length;
+    }
+
+    if( s->offset == NULL || s->lines == NULL || s->time == NULL || n == 0 )
+    {
+        errno = s->offset && s->lines && s->time ? EINVAL : ENOMEM;
+        return -1;
+    }
+
+    s->epochs = n;
+    s->offset[ n ] = s->size;
+    s->lines[ n ] = lines;
+
+    /* One more interval after the last epoch before starting over */
+    s->span = s->time[ n - 1 ] + ( n > 1 ? s->time[ n - 1 ] - s->time[ n - 2 ] : 1000 );
+
+    return 0;
+}
+
+/* The first tick at or after ns */
+static uint64_t tick( int64_t ns )
+{
+    return ( uint64_t )( ( ns + TICK_NS - 1 ) / TICK_NS );
+}
+
+static int64_t due( const unit_t *u, uint64_t index )
+{
+    const source_t *s = u->source;
+    int64_t ms = ( int64_t )( index / s->epochs ) * s->span + s->time[ index % s->epochs ];
+
+    return u->start + ( int64_t )( ms * 1e6 / scale );
+}
+
+/* Epochs and lines the schedule asked of a unit by now */
+static void target( const unit_t *u, int64_t now, uint64_t *epochs, uint64_t *lines )
+{
+    const source_t *s = u->source;
+    int64_t ms = ( int64_t )( ( now - u->start ) / 1e6 * scale );
+    uint64_t passes;
+    size_t low = 0, high;
+
+    *epochs = *lines = 0;
+
+    if( ms < 0 )
+        return;
+
+    passes = ( uint64_t )( ms / s->span );
+    ms -= ( int64_t )passes * s->span;
+
+    if( !loop && passes > 0 )
+    {
+        *epochs = s->epochs;
+        *lines = s->lines[ s->epochs ];
+        return;
+    }
+
+    /* Epochs with a time up to ms */
+    high = s->epochs;
+
+    while( low < high )
+    {
+        size_t mid = ( low + high ) / 2;
+
+        if( s->time[ mid ] <= ms )
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    *epochs = passes * s->epochs + low;
+    *lines = passes * s->lines[ s->epochs ] + s->lines[ low ];
+}
+
+/* Writes what the reader takes of the current epoch */
+static void unit_flush( unit_t *u )
+{
+    ssize_t n = write( u->fd, u->source->text + u->rest, u->end - u->rest );
+
+    if( n < 0 && errno != EAGAIN && errno != EINTR )
+    {
+        close( u->fd );
+        u->fd = -1;
+        totals.closed++;
+        return;
+    }
+
+    if( n > 0 )
+    {
+        u->rest += n;
+        totals.bytes += n;
+    }
+
+    if( u->rest == u->end && u->lines )
+    {
+        totals.epochs++;
+        totals.lines += u->lines;
+        u->lines = 0;
+    }
+}
+
+/* Fires when the next epoch is due or the current one can go on */
+static void unit_fire( gps_wheel_t *wheel, unit_t *u, int64_t now )
+{
+    const source_t *s = u->source;
+
+    if( u->rest < u->end )
+        unit_flush( u );
+
+    if( u->fd >= 0 && now >= u->due )
+    {
+        size_t e = u->index % s->epochs;
+
+        if( u->rest < u->end )
+            totals.overruns++;
+
+        u->rest = s->offset[ e ];
+        u->end = s->offset[ e + 1 ];
+        u->lines = s->lines[ e + 1 ] - s->lines[ e ];
+        totals.late += now - u->due;
+
+        if( now - u->due > totals.late_max )
+            totals.late_max = now - u->due;
+
+        unit_flush( u );
+        u->index++;
+        u->due = due( u, u->index );
+    }
+
+    if( u->fd < 0 || ( !loop && u->index == s->epochs && u->rest == u->end ) )
+        return;
+
+    /* Retried on the next tick while the reader is full */
+    gps_wheel_add( wheel, &u->timer, u->rest < u->end && u->due > now + TICK_NS
+                                     ? ( uint64_t )( now / TICK_NS + 1 ) : tick( u->due ) );
+}
+
+/* Connects and says which unit it is, $PUNIT,<id>*hh */
+static int tcp_open( const char *address, long id )
+{
+    char host[ 256 ], hello[ 32 ];
+    uint8_t sum = 0;
+    int n, k;
+    const char *colon = strrchr( address, ':' );
+    struct addrinfo hints, *info;
+    int fd;
+
+    if( colon == NULL || colon - address >= ( long )sizeof( host ) )
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memcpy( host, address, colon - address );
+    host[ colon - address ] = '\0';
+    memset( &hints, 0, sizeof( hints ) );
+    hints.ai_socktype = SOCK_STREAM;
+
+    if( getaddrinfo( host, colon + 1, &hints, &info ) )
+    {
+        errno = EHOSTUNREACH;
+        return -1;
+    }
+
+    fd = socket( info->ai_family, info->ai_socktype, info->ai_protocol );
+
+    n = sprintf( hello, "$PUNIT,%ld", id );
+
+    for( k = 1; k < n; k++ )
+        sum ^= ( uint8_t )hello[ k ];
+
+    n += sprintf( hello + n, "*%02X\r\n", sum );
+
+    if( fd >= 0 && ( connect( fd, info->ai_addr, info->ai_addrlen ) ||
+                     write( fd, hello, n ) != n ) )
+    {
+        close( fd );
+        fd = -1;
+    }
+
+    freeaddrinfo( info );
+
+    return fd;
+}
+
+static int pty_open( unit_t *u )
+{
+    struct termios tio;
+    int master = posix_openpt( O_RDWR | O_NOCTTY );
+
+    if( master < 0 )
+        return -1;
+
+    if( grantpt( master ) || unlockpt( master ) ||
+        ( u->slave = open( ptsname( master ), O_RDWR | O_NOCTTY ) ) < 0 )
+    {
+        int error = errno;
+
+        close( master );
+        errno = error;
+        return -1;
+    }
+
+    tcgetattr( u->slave, &tio );
+    tio.c_iflag &= ~( IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON );
+    tio.c_oflag &= ~OPOST;
+    tio.c_lflag &= ~( ECHO | ECHONL | ICANON | ISIG | IEXTEN );
+    tio.c_cflag = ( tio.c_cflag & ~( CSIZE | PARENB ) ) | CS8;
+    tcsetattr( u->slave, TCSANOW, &tio );
+
+    return master;
+}
+
+static void report( const unit_t *units, long count, int64_t now, double seconds,
+                    uint64_t *last_target, uint64_t *last_lines, const totals_t *last )
+{
+    uint64_t epochs = 0, lines = 0;
+    uint64_t sent = totals.epochs - last->epochs;
+    long i;
+
+    for( i = 0; i < count; i++ )
+    {
+        uint64_t e, l;
+
+        target( &units[ i ], now, &e, &l );
+        epochs += e;
+        lines += l;
+    }
+
+    printf( "%10.0f %10.0f %10.0f %10.0f %10.1f %10.2f %10.2f %8llu\n",
+            ( epochs - *last_target ) / seconds, sent / seconds,
+            ( lines - *last_lines ) / seconds, ( totals.lines - last->lines ) / seconds,
+            ( totals.bytes - last->bytes ) / seconds / 1e6,
+            sent ? ( totals.late - last->late ) / 1e6 / sent : 0.0, totals.late_max / 1e6,
+            ( unsigned long long )( totals.overruns - last->overruns ) );
+    fflush( stdout );
+
+    *last_target = epochs;
+    *last_lines = lines;
+}
+
+int main( int argc, char **argv )
+{
+    static source_t sources[ SOURCES_MAX ];
+    static gps_wheel_t wheel;
+    const char *address = NULL, *mode = NULL;
+    double duration = 0, interval = 1;
+    uint64_t last_target = 0, last_lines = 0, want_epochs = 0, want_lines = 0;
+    int64_t begin, next_report, now;
+    long copies = 1, count, i, k;
+    struct rlimit limit;
+    totals_t last;
+    unit_t *units;
+    int opt, s, files;
+
+    while( ( opt = getopt( argc, argv, "x:k:ld:i:t:m:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'x':
+            scale = strtod( optarg, NULL );
+            break;
+        case 'k':
+            copies = strtol( optarg, NULL, 10 );
+            break;
+        case 'l':
+            loop = 1;
+            break;
+        case 'd':
+            duration = strtod( optarg, NULL );
+            break;
+        case 'i':
+            interval = strtod( optarg, NULL );
+            break;
+        case 't':
+            address = optarg;
+            break;
+        case 'm':
+            mode = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    files = argc - optind;
+
+    if( files < 1 || files > SOURCES_MAX || scale <= 0 || copies < 1 || interval <= 0 ||
+        ( address == NULL ) == ( mode == NULL || strcmp( mode, "pty" ) ) )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    for( s = 0; s < files; s++ )
+    {
+        sources[ s ].text = source_text( argv[ optind + s ], &sources[ s ].size );
+
+        if( sources[ s ].text == NULL || source_index( &sources[ s ] ) )
+        {
+            fprintf( stderr, "%s: %s\n", argv[ optind + s ],
+                     errno == EINVAL ? "no RMC or GGA time" : strerror( errno ) );
+            return 1;
+        }
+    }
+
+    if( getrlimit( RLIMIT_NOFILE, &limit ) == 0 )
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit( RLIMIT_NOFILE, &limit );
+    }
+
+    signal( SIGPIPE, SIG_IGN );
+    count = files * copies;
+    units = calloc( count, sizeof( unit_t ) );
+
+    if( units == NULL )
+    {
+        perror( "calloc" );
+        return 1;
+    }
+
+    for( i = 0; i < count; i++ )
+    {
+        unit_t *u = &units[ i ];
+
+        u->source = &sources[ i / copies ];
+        u->slave = -1;
+        u->fd = address ? tcp_open( address, i + 1 ) : pty_open( u );
+
+        if( u->fd < 0 )
+        {
+            fprintf( stderr, "unit %ld: %s: %s\n", i, address ? address : "pty",
+                     strerror( errno ) );
+            return 1;
+        }
+
+        fcntl( u->fd, F_SETFL, fcntl( u->fd, F_GETFL ) | O_NONBLOCK );
+
+        if( mode != NULL )
+            printf( "%ld %s %s\n", i, ptsname( u->fd ), argv[ optind + i / copies ] );
+    }
+
+    fflush( stdout );
+    fprintf( stderr, "%ld units from %d logs at %gx\n", count, files, scale );
+    printf( "%10s %10s %10s %10s %10s %10s %10s %8s\n", "target/s", "epochs/s",
+            "target/s", "lines/s", "MB/s", "late ms", "max ms", "overrun" );
+
+    /* Units of a log start spread over one second of its time */
+    begin = ( int64_t )gps_clock_ns() + 100 * TICK_NS;
+    gps_wheel_init( &wheel, ( uint64_t )( begin / TICK_NS ) );
+
+    for( i = 0; i < count; i++ )
+    {
+        k = i % copies;
+        units[ i ].start = begin + ( int64_t )( k * 1e9 / copies / scale );
+        units[ i ].due = due( &units[ i ], 0 );
+        gps_wheel_add( &wheel, &units[ i ].timer, tick( units[ i ].due ) );
+    }
+
+    memset( &last, 0, sizeof( last ) );
+    next_report = begin + ( int64_t )( interval * 1e9 );
+
+    while( wheel.pending &&
+           ( duration <= 0 || ( int64_t )gps_clock_ns() - begin < duration * 1e9 ) )
+    {
+        struct timespec ts;
+        gps_wheel_timer_t *timer, *next;
+        int64_t wake;
+
+        now = ( int64_t )gps_clock_ns();
+
+        for( timer = gps_wheel_advance( &wheel, ( uint64_t )( now / TICK_NS ) ); timer;
+             timer = next )
+        {
+            next = timer->next;
+            unit_fire( &wheel, ( unit_t * )timer, now );
+        }
+
+        if( now >= next_report )
+        {
+            report( units, count, now, interval, &last_target, &last_lines, &last );
+            last = totals;
+            next_report += ( int64_t )( interval * 1e9 );
+        }
+
+        wake = ( now / TICK_NS + 1 ) * TICK_NS;
+        ts.tv_sec = ( time_t )( wake / 1000000000ll );
+        ts.tv_nsec = ( long )( wake % 1000000000ll );
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL );
+    }
+
+    now = ( int64_t )gps_clock_ns();
+
+    for( i = 0; i < count; i++ )
+    {
+        uint64_t e, l;
+
+        target( &units[ i ], now, &e, &l );
+        want_epochs += e;
+        want_lines += l;
+    }
+
+    printf( "%llu of %llu epochs, %llu of %llu sentences ( %.1f%% ), %.1f MB, "
+            "%llu overruns, %llu units closed\n",
+            ( unsigned long long )totals.epochs, ( unsigned long long )want_epochs,
+            ( unsigned long long )totals.lines, ( unsigned long long )want_lines,
+            want_lines ? totals.lines * 100.0 / want_lines : 100.0, totals.bytes / 1e6,
+            ( unsigned long long )totals.overruns, ( unsigned long long )totals.closed );
+
+    for( i = 0; i < count; i++ )
+    {
+        if( units[ i ].fd >= 0 )
+            close( units[ i ].fd );
+
+        if( units[ i ].slave >= 0 )
+            close( units[ i ].slave );
+    }
+
+    free( units );
+
+    for( s = 0; s < files; s++ )
+    {
+        free( sources[ s ].text );
+        free( sources[ s ].offset );
+        free( sources[ s ].lines );
+        free( sources[ s ].time );
+    }
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
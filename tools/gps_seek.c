@@ -0,0 +1,397 @@
+/*******************************************************************************
+* Title                 :   Log Time Index
+* Filename              :   gps_seek.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_seek.c
+ * @brief Sparse time index of raw NMEA logs, kept in a sidecar file.
+ *
+ * An update maps the log, reads the lines after the indexed part and only
+ * writes the new entries, then the header.  An update that fails before
+ * the header is written leaves a file that no longer checks, which the
+ * next update builds again.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gps_log.h"
+#include "gps_seek.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define MAGIC           "GPSSEEK"
+#define MS_PER_DAY      86400000ll
+#define ROLLOVER_MS     600000      /**< Date changes this close to midnight */
+#define TAIL_BYTES      64
+#define ENTRIES_MIN     1024
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static uint64_t tail_hash( const char *data, uint64_t covered );
+static int64_t rollover( int64_t time, int64_t last, int32_t tod );
+static int entry_add( gps_seek_t *seek, size_t *capacity, int64_t time,
+                      uint64_t offset );
+static int sample( gps_seek_t *seek, size_t *capacity, int64_t time,
+                   int32_t tod, gps_seek_stats_t *stats );
+static int scan( gps_seek_t *seek, const char *data, size_t size,
+                 gps_seek_stats_t *stats );
+static int seek_write( const gps_seek_t *seek, const char *index, size_t first,
+                       int create );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* FNV-1a of the bytes just before covered */
+static uint64_t tail_hash( const char *data, uint64_t covered )
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    uint64_t i = covered > TAIL_BYTES ? covered - TAIL_BYTES : 0;
+
+    for( ; i < covered; i++ )
+        hash = ( hash ^ ( uint8_t )data[ i ] ) * 0x100000001b3ull;
+
+    return hash;
+}
+
+/*
+ * Day to add to an RMC time whose date changed before or after its time
+ * of day did.  Then time lands just after the last one.
+ */
+static int64_t rollover( int64_t time, int64_t last, int32_t tod )
+{
+    if( tod >= ROLLOVER_MS && tod < MS_PER_DAY - ROLLOVER_MS )
+        return 0;
+
+    if( time < last && time + MS_PER_DAY >= last &&
+        time + MS_PER_DAY - last < ROLLOVER_MS )
+        return MS_PER_DAY;
+
+    if( time - MS_PER_DAY >= last && time - MS_PER_DAY - last < ROLLOVER_MS )
+        return -MS_PER_DAY;
+
+    return 0;
+}
+
+static int entry_add( gps_seek_t *seek, size_t *capacity, int64_t time,
+                      uint64_t offset )
+{
+    if( seek->header.entries == *capacity )
+    {
+        size_t grown = *capacity ? *capacity * 2 : ENTRIES_MIN;
+        gps_seek_entry_t *entries = realloc( seek->entries,
+                                             grown * sizeof( gps_seek_entry_t ) );
+
+        if( entries == NULL )
+            return -1;
+
+        seek->entries = entries;
+        *capacity = grown;
+    }
+
+    seek->entries[ seek->header.entries ].time = time;
+    seek->entries[ seek->header.entries ].offset = offset;
+    seek->header.entries++;
+
+    return 0;
+}
+
+/* An entry for the first time of every interval and of every segment */
+static int sample( gps_seek_t *seek, size_t *capacity, int64_t time,
+                   int32_t tod, gps_seek_stats_t *stats )
+{
+    gps_seek_header_t *h = &seek->header;
+    int64_t shift = h->last_time < 0 ? 0 : rollover( time, h->last_time, tod );
+    uint64_t offset = h->epoch_offset;
+
+    if( shift )
+    {
+        time += shift;
+        stats->corrected++;
+    }
+
+    if( h->last_time < 0 || time < h->last_time )
+    {
+        h->segments++;
+        offset |= GPS_SEEK_SEGMENT;
+    }
+    else if( time / h->interval ==
+             seek->entries[ h->entries - 1 ].time / h->interval )
+    {
+        h->last_time = time;
+        return 0;
+    }
+
+    h->last_time = time;
+    stats->added++;
+
+    return entry_add( seek, capacity, time, offset );
+}
+
+/* Complete lines after the indexed part */
+static int scan( gps_seek_t *seek, const char *data, size_t size,
+                 gps_seek_stats_t *stats )
+{
+    gps_seek_header_t *h = &seek->header;
+    size_t capacity = h->entries;
+    const char *p = data + h->covered;
+    const char *end = data + size;
+    const char *nl;
+
+    while( p < end && ( nl = memchr( p, '\n', end - p ) ) != NULL )
+    {
+        int32_t tod, day;
+        gps_sentence_t kind = gps_log_stamp( p, nl + 1 - p, &tod, &day );
+
+        if( kind != GPS_SENTENCE_UNKNOWN )
+        {
+            if( tod != h->epoch_tod )
+            {
+                h->epoch_tod = tod;
+                h->epoch_offset = p - data;
+            }
+
+            if( kind == GPS_SENTENCE_RMC && day >= 0 &&
+                sample( seek, &capacity, day * MS_PER_DAY + tod, tod, stats ) )
+                return -1;
+        }
+
+        p = nl + 1;
+    }
+
+    stats->bytes += ( p - data ) - h->covered;
+    h->covered = p - data;
+    h->tail = tail_hash( data, h->covered );
+
+    return 0;
+}
+
+/* The entries from first on, then the header */
+static int seek_write( const gps_seek_t *seek, const char *index, size_t first,
+                       int create )
+{
+    size_t count = seek->header.entries - first;
+    FILE *f = fopen( index, create ? "wb" : "r+b" );
+    int error;
+
+    if( f == NULL )
+        return -1;
+
+    error = fseek( f, sizeof( gps_seek_header_t ) + first * sizeof( gps_seek_entry_t ), SEEK_SET ) ||
+            fwrite( seek->entries + first, sizeof( gps_seek_entry_t ), count, f ) != count ||
+            fflush( f ) ||
+            fseek( f, 0, SEEK_SET ) ||
+            fwrite( &seek->header, sizeof( gps_seek_header_t ), 1, f ) != 1;
+
+    if( fclose( f ) || error )
+        return -1;
+
+    return 0;
+}
+
+int gps_seek_update( const char *log, const char *index, uint32_t interval,
+                     gps_seek_stats_t *stats )
+{
+    gps_seek_stats_t unused;
+    gps_seek_t seek;
+    struct stat st;
+    const char *data = NULL;
+    size_t first;
+    int fd, opened, create, result;
+
+    if( stats == NULL )
+        stats = &unused;
+
+    memset( stats, 0, sizeof( gps_seek_stats_t ) );
+
+    if( interval == 0 )
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    fd = open( log, O_RDONLY );
+
+    if( fd < 0 )
+        return -1;
+
+    if( fstat( fd, &st ) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    if( st.st_size > 0 )
+    {
+        void *map = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+        if( map == MAP_FAILED )
+        {
+            close( fd );
+            return -1;
+        }
+
+        data = map;
+        posix_madvise( map, st.st_size, POSIX_MADV_SEQUENTIAL );
+    }
+
+    close( fd );
+
+    result = gps_seek_open( &seek, index );
+    opened = result == 0 || errno != ENOENT;
+    create = result || seek.header.interval != interval ||
+             seek.header.covered > ( uint64_t )st.st_size ||
+             seek.header.tail != tail_hash( data, seek.header.covered );
+
+    if( create )
+    {
+        stats->rebuilt = opened;
+        gps_seek_close( &seek );
+        memcpy( seek.header.magic, MAGIC, sizeof( seek.header.magic ) );
+        seek.header.version = GPS_SEEK_VERSION;
+        seek.header.interval = interval;
+        seek.header.last_time = -1;
+        seek.header.epoch_tod = -1;
+    }
+
+    first = seek.header.entries;
+    result = scan( &seek, data, st.st_size, stats );
+
+    if( result == 0 )
+        result = seek_write( &seek, index, first, create );
+
+    if( data != NULL )
+        munmap( ( void * )data, st.st_size );
+
+    gps_seek_close( &seek );
+
+    return result;
+}
+
+int gps_seek_open( gps_seek_t *seek, const char *index )
+{
+    FILE *f = fopen( index, "rb" );
+    gps_seek_header_t *h = &seek->header;
+    size_t i, segments = 0;
+    long size;
+
+    memset( seek, 0, sizeof( gps_seek_t ) );
+
+    if( f == NULL )
+        return -1;
+
+    if( fseek( f, 0, SEEK_END ) || ( size = ftell( f ) ) < 0 || fseek( f, 0, SEEK_SET ) ||
+        fread( h, sizeof( gps_seek_header_t ), 1, f ) != 1 ||
+        memcmp( h->magic, MAGIC, sizeof( h->magic ) ) ||
+        h->version != GPS_SEEK_VERSION || h->interval == 0 ||
+        ( uint64_t )size != sizeof( gps_seek_header_t ) + h->entries * sizeof( gps_seek_entry_t ) )
+    {
+        fclose( f );
+        memset( seek, 0, sizeof( gps_seek_t ) );
+        errno = EINVAL;
+        return -1;
+    }
+
+    seek->entries = malloc( h->entries * sizeof( gps_seek_entry_t ) + 1 );
+    seek->segments = malloc( h->segments * sizeof( size_t ) + 1 );
+
+    if( seek->entries == NULL || seek->segments == NULL )
+    {
+        fclose( f );
+        gps_seek_close( seek );
+        errno = ENOMEM;
+        return -1;
+    }
+
+    if( fread( seek->entries, sizeof( gps_seek_entry_t ), h->entries, f ) != h->entries )
+    {
+        fclose( f );
+        gps_seek_close( seek );
+        errno = EINVAL;
+        return -1;
+    }
+
+    fclose( f );
+
+    for( i = 0; i < h->entries; i++ )
+    {
+        if( !( seek->entries[ i ].offset & GPS_SEEK_SEGMENT ) )
+            continue;
+
+        if( segments == h->segments )
+            break;
+
+        seek->segments[ segments++ ] = i;
+    }
+
+    if( i < h->entries || segments != h->segments ||
+        ( h->entries && !( seek->entries[ 0 ].offset & GPS_SEEK_SEGMENT ) ) )
+    {
+        gps_seek_close( seek );
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
+
+void gps_seek_close( gps_seek_t *seek )
+{
+    free( seek->entries );
+    free( seek->segments );
+    memset( seek, 0, sizeof( gps_seek_t ) );
+}
+
+uint64_t gps_seek_find( const gps_seek_t *seek, int64_t time )
+{
+    const gps_seek_entry_t *e = seek->entries;
+    int64_t interval = seek->header.interval;
+    size_t after = seek->header.entries;
+    size_t s;
+
+    for( s = 0; s < seek->header.segments; s++ )
+    {
+        size_t lo = seek->segments[ s ];
+        size_t hi = s + 1 < seek->header.segments ? seek->segments[ s + 1 ]
+                                                  : seek->header.entries;
+
+        /* Times after the last entry stay in its interval */
+        if( e[ lo ].time <= time && time < ( e[ hi - 1 ].time / interval + 1 ) * interval )
+        {
+            while( hi - lo > 1 )
+            {
+                size_t mid = lo + ( hi - lo ) / 2;
+
+                if( e[ mid ].time <= time )
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+
+            return e[ lo ].offset & ~GPS_SEEK_SEGMENT;
+        }
+
+        if( e[ lo ].time > time &&
+            ( after == seek->header.entries || e[ lo ].time < e[ after ].time ) )
+            after = lo;
+    }
+
+    if( after < seek->header.entries )
+        return e[ after ].offset & ~GPS_SEEK_SEGMENT;
+
+    return seek->header.covered;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,154 @@
+/****************************************************************************
+* Title                 :   Log Time Index
+* Filename              :   gps_seek.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_seek.h
+ * @brief Sparse time index of raw NMEA logs, kept in a sidecar file
+ *
+ * The index samples the RMC date and time every interval and records the
+ * byte offset of the epoch it belongs to.  That is the line of its first
+ * RMC or GGA, so parsing from there sees the whole epoch.
+ *
+ * @code
+ * header | entry 0 | entry 1 | ...
+ * @endcode
+ *
+ * The header also keeps how much of the log is indexed and the state of
+ * the scan there, so a log that keeps growing is indexed by reading only
+ * the lines appended since.  A log that no longer ends the same way where
+ * the index stopped is indexed again from the start.
+ *
+ * Receivers don't all change the date and the time at the same moment.
+ * A date that changes just before or just after midnight is moved by a
+ * day.  Any other time going back, a receiver reset or logs of several
+ * runs joined together, starts a new segment.  Times only grow within a
+ * segment.
+ *
+ * @code
+ * gps_seek_update( "day.nmea", "day.nmea.tidx", 10000, &stats );
+ *
+ * gps_seek_open( &seek, "day.nmea.tidx" );
+ * offset = gps_seek_find( &seek, when );
+ * gps_seek_close( &seek );
+ * @endcode
+ */
+#ifndef GPS_SEEK_H_
+#define GPS_SEEK_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_SEEK_VERSION        1
+#define GPS_SEEK_INTERVAL       10000   /**< Default ms between entries */
+#define GPS_SEEK_SEGMENT        ( 1ull << 63 )  /**< Offset flag, new segment */
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct First 64 bytes of an index
+ */
+typedef struct
+{
+    char magic[ 8 ];            /**< "GPSSEEK" */
+    uint32_t version;
+    uint32_t interval;          /**< ms between entries */
+    uint64_t entries;
+    uint64_t covered;           /**< Log bytes indexed, up to a line end */
+    uint64_t tail;              /**< Hash of the last log bytes indexed */
+    int64_t last_time;          /**< Last RMC time, -1 before the first */
+    uint64_t epoch_offset;      /**< Start of the last epoch */
+    int32_t epoch_tod;          /**< Time of the last epoch, -1 before it */
+    uint32_t segments;
+} gps_seek_header_t;
+
+/**
+ * @struct Sample of the log
+ */
+typedef struct
+{
+    int64_t time;               /**< UTC ms since 1970 */
+    uint64_t offset;            /**< Line of the first sentence of its epoch,
+                                     GPS_SEEK_SEGMENT set when a segment
+                                     starts with it */
+} gps_seek_entry_t;
+
+/**
+ * @struct Work done by one update
+ */
+typedef struct
+{
+    uint64_t bytes;             /**< Log bytes read */
+    uint64_t added;             /**< Entries added */
+    uint64_t corrected;         /**< RMC dates moved by a day */
+    int rebuilt;                /**< The index didn't match the log */
+} gps_seek_stats_t;
+
+/**
+ * @struct Index read into memory
+ */
+typedef struct
+{
+    gps_seek_header_t header;
+    gps_seek_entry_t *entries;
+    size_t *segments;           /**< First entry of every segment */
+} gps_seek_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates the index of a log or adds the lines appended since
+ *
+ * @param interval - ms between entries, an index with another interval is
+ * built again
+ * @param stats - NULL or filled with the work done
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_seek_update( const char *log, const char *index, uint32_t interval,
+                     gps_seek_stats_t *stats );
+
+/**
+ * @brief Reads an index and checks it
+ *
+ * @return int - 0 or -1 with errno set, EINVAL for a damaged file
+ */
+int gps_seek_open( gps_seek_t *seek, const char *index );
+
+/**
+ * @brief Releases an index
+ */
+void gps_seek_close( gps_seek_t *seek );
+
+/**
+ * @brief Offset to parse from to see time
+ *
+ * The first segment that covers time is searched for the last entry not
+ * after it.  When none does, the earliest entry after time is used.
+ *
+ * @return uint64_t - log offset, the end of the indexed part when all of
+ * it is earlier
+ */
+uint64_t gps_seek_find( const gps_seek_t *seek, int64_t time );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_SEEK_H_ */
+
+/*** End of File **************************************************************/
@@ -0,0 +1,302 @@
+/*******************************************************************************
+* Title                 :   Serial Port
+* Filename              :   gps_serial.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_serial.c
+ * @brief termios set up and burst reads of a receiver.
+ *
+ * ASYNC_LOW_LATENCY goes through TIOCSSERIAL, which only Linux has and
+ * which ptys and many USB adapters refuse; the port works without it.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _DEFAULT_SOURCE             /* CRTSCTS, B460800 and up */
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+#include "gps_parser.h"
+#include "gps_serial.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define RATES   ( sizeof( rates ) / sizeof( rates[ 0 ] ) )
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+typedef struct
+{
+    long baud;
+    speed_t speed;
+} rate_t;
+
+/******************************************************************************
+* Module Variable Definitions
+*******************************************************************************/
+static const rate_t rates[] =
+{
+    { 4800, B4800 }, { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 },
+    { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+#ifdef B460800
+    { 460800, B460800 },
+#endif
+#ifdef B921600
+    { 921600, B921600 },
+#endif
+};
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int low_latency( int fd );
+static int wait_input( int fd, int timeout );
+static int burst_read( gps_serial_t *port );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int low_latency( int fd )
+{
+#if defined( __linux__ ) && defined( TIOCSSERIAL )
+    struct serial_struct serial;
+
+    if( ioctl( fd, TIOCGSERIAL, &serial ) )
+        return 0;
+
+    serial.flags |= ASYNC_LOW_LATENCY;
+
+    return ioctl( fd, TIOCSSERIAL, &serial ) == 0;
+#else
+    ( void )fd;
+    return 0;
+#endif
+}
+
+/* 1 when input is there, 0 after timeout ms, -1 on errors */
+static int wait_input( int fd, int timeout )
+{
+    struct pollfd pfd;
+    int n;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    do
+    {
+        n = poll( &pfd, 1, timeout );
+    }
+    while( n < 0 && errno == EINTR );
+
+    return n;
+}
+
+int gps_serial_setup( gps_serial_t *port, int fd, long baud )
+{
+    struct termios tio;
+    speed_t speed;
+    size_t i;
+
+    memset( port, 0, sizeof( gps_serial_t ) );
+    port->fd = fd;
+
+    /* Pipes and sockets are read as they are */
+    if( tcgetattr( fd, &tio ) )
+    {
+        port->gap = GPS_SERIAL_GAP_MIN;
+        return errno == ENOTTY ? 0 : -1;
+    }
+
+    tio.c_iflag &= ~( IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL |
+                      IXON | IXOFF | IXANY );
+    tio.c_oflag &= ~OPOST;
+    tio.c_lflag &= ~( ECHO | ECHONL | ICANON | ISIG | IEXTEN );
+    tio.c_cflag &= ~( CSIZE | PARENB | CSTOPB );
+#ifdef CRTSCTS
+    tio.c_cflag &= ~CRTSCTS;
+#endif
+    tio.c_cflag |= CS8 | CLOCAL | CREAD;
+    tio.c_cc[ VMIN ] = 1;
+    tio.c_cc[ VTIME ] = 0;
+
+    if( baud )
+    {
+        for( i = 0; i < RATES && rates[ i ].baud != baud; i++ )
+            ;
+
+        if( i == RATES )
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        cfsetispeed( &tio, rates[ i ].speed );
+        cfsetospeed( &tio, rates[ i ].speed );
+    }
+
+    if( tcsetattr( fd, TCSANOW, &tio ) )
+        return -1;
+
+    tcflush( fd, TCIFLUSH );
+    speed = cfgetispeed( &tio );
+
+    for( i = 0; i < RATES; i++ )
+    {
+        if( rates[ i ].speed == speed )
+            port->baud = rates[ i ].baud;
+    }
+
+    /* 10 bits a char */
+    port->gap = GPS_SERIAL_GAP_MIN;
+
+    if( port->baud &&
+        GPS_SERIAL_GAP_CHARS * 10000 / port->baud + 1 > GPS_SERIAL_GAP_MIN )
+        port->gap = ( int )( GPS_SERIAL_GAP_CHARS * 10000 / port->baud + 1 );
+
+    port->low_latency = low_latency( fd );
+
+    return 0;
+}
+
+int gps_serial_open( gps_serial_t *port, const char *path, long baud )
+{
+    int fd = open( path, O_RDWR | O_NOCTTY );
+
+    if( fd < 0 )
+        return -1;
+
+    if( gps_serial_setup( port, fd, baud ) )
+    {
+        int error = errno;
+
+        close( fd );
+        port->fd = -1;
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+void gps_serial_close( gps_serial_t *port )
+{
+    if( port->fd >= 0 )
+        close( port->fd );
+
+    port->fd = -1;
+}
+
+/* Reads until the line is idle for the gap, 0 when input is pending */
+static int burst_read( gps_serial_t *port )
+{
+    size_t start = port->fill;
+    int n = 1;
+
+    do
+    {
+        ssize_t got = read( port->fd, port->buffer + port->fill,
+                            GPS_SERIAL_BUFFER - port->fill );
+
+        if( got < 0 && ( errno == EINTR || errno == EAGAIN ) )
+            continue;
+
+        /* A hung up tty reads as end of file, after what it sent last */
+        if( got == 0 && port->fill > start )
+            return 0;
+
+        if( got == 0 )
+            errno = EIO;
+
+        if( got <= 0 )
+            return -1;
+
+        port->last = gps_clock_ns();
+        port->fill += got;
+        port->stats.reads++;
+        port->stats.bytes += got;
+
+        if( port->fill == GPS_SERIAL_BUFFER )
+        {
+            port->stats.split++;
+            return 0;
+        }
+
+        n = wait_input( port->fd, port->gap );
+    }
+    while( n > 0 );
+
+    return n;
+}
+
+int gps_serial_burst( gps_serial_t *port, int timeout )
+{
+    /* The unterminated line of the last burst */
+    memmove( port->buffer, port->buffer + port->size, port->fill - port->size );
+    port->fill -= port->size;
+    port->size = 0;
+
+    /* A burst without a line end is waited on, it was cut short */
+    while( port->size == 0 )
+    {
+        int n = wait_input( port->fd, timeout );
+
+        if( n <= 0 )
+            return n;
+
+        port->first = gps_clock_ns();
+
+        if( burst_read( port ) )
+            return -1;
+
+        port->stats.bursts++;
+        port->size = port->fill;
+
+        while( port->size > 0 && port->buffer[ port->size - 1 ] != '\n' )
+            port->size--;
+
+        if( port->size == 0 && port->fill == GPS_SERIAL_BUFFER )
+        {
+            port->stats.overlong++;
+            port->fill = 0;
+        }
+    }
+
+    return ( int )port->size;
+}
+
+void gps_serial_put( const gps_serial_t *port )
+{
+    const char *p = port->buffer;
+    const char *end = port->buffer + port->size;
+
+    while( p < end )
+    {
+        const char *line = p;
+
+        p = ( const char * )memchr( p, '\n', end - p ) + 1;
+#ifdef GPS_TIMESTAMPS
+        gps_put_block_ts( line, ( uint16_t )( p - line ), port->first );
+#else
+        while( line < p )
+            gps_put( *line++ );
+#endif
+        gps_parse();
+    }
+
+    if( port->size )
+        gps_epoch_flush();
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,148 @@
+/****************************************************************************
+* Title                 :   Serial Port
+* Filename              :   gps_serial.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_serial.h
+ * @brief Opens a receiver on a tty and reads it one epoch at a time
+ *
+ * The port is put in raw mode, 8N1 without flow control, and on Linux
+ * asked for ASYNC_LOW_LATENCY, which drivers that know it use to pass
+ * received bytes up at once instead of on the next tick.
+ *
+ * A receiver sends the sentences of an epoch back to back and then stays
+ * quiet until the next one.  gps_serial_burst() sleeps until the first
+ * byte of an epoch and then reads until the line has been idle for the
+ * gap, so the whole epoch is decoded in one wakeup and without waiting
+ * for the next one.  The gap is timed with poll(): VTIME only counts
+ * tenths of a second and VMIN no more than 255 bytes, less than an epoch,
+ * so the port is set to VMIN 1 and VTIME 0 and read() returns what has
+ * arrived.
+ *
+ * USB adapters pass data up when their latency timer expires, after 16 ms
+ * by default on FTDI ones.  Raise gap above it, or lower the timer in
+ * /sys/bus/usb-serial/devices/.../latency_timer.
+ *
+ * @code
+ * gps_serial_open( &port, "/dev/ttyUSB0", 9600 );
+ *
+ * while( gps_serial_burst( &port, -1 ) > 0 )
+ * {
+ *     gps_serial_put( &port );                          // gps_put / gps_parse
+ *     gps_log_parse( &log, port.buffer, port.size );    // or bulk decoding
+ * }
+ *
+ * gps_serial_close( &port );
+ * @endcode
+ */
+#ifndef GPS_SERIAL_H_
+#define GPS_SERIAL_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_SERIAL_BUFFER       8192    /**< Largest burst */
+#define GPS_SERIAL_GAP_CHARS    20      /**< Idle chars that end a burst */
+#define GPS_SERIAL_GAP_MIN      5       /**< Shortest gap in ms */
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Reads of a port
+ */
+typedef struct
+{
+    uint64_t reads;
+    uint64_t bytes;
+    uint64_t bursts;
+    uint64_t split;             /**< Bursts cut short by a full buffer */
+    uint64_t overlong;          /**< Buffers without a line end, dropped */
+} gps_serial_stats_t;
+
+/**
+ * @struct Port
+ */
+typedef struct
+{
+    int fd;
+    long baud;                  /**< 0 when not a standard rate */
+    int low_latency;            /**< The driver took ASYNC_LOW_LATENCY */
+    int gap;                    /**< Idle ms ending a burst, may be changed */
+    uint64_t first;             /**< CLOCK_MONOTONIC ns of the first read of the burst */
+    uint64_t last;              /**< ns of its last read */
+    size_t size;                /**< Bytes of complete lines in buffer */
+    size_t fill;                /**< Bytes in buffer, the rest an unterminated line */
+    gps_serial_stats_t stats;
+    char buffer[ GPS_SERIAL_BUFFER ];
+} gps_serial_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opens a tty and sets it up with gps_serial_setup()
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_serial_open( gps_serial_t *port, const char *path, long baud );
+
+/**
+ * @brief Sets up a tty already open, the slave of a pty for example
+ *
+ * Input waiting from before is dropped.  The gap is GPS_SERIAL_GAP_CHARS
+ * at the baud rate, at least GPS_SERIAL_GAP_MIN.  A descriptor that is not
+ * a tty, a pipe or a socket, is left as it is and read with that gap.
+ *
+ * @param baud - bits per second, 0 keeps the current rate
+ *
+ * @return int - 0 or -1 with errno set, EINVAL for a rate termios lacks
+ */
+int gps_serial_setup( gps_serial_t *port, int fd, long baud );
+
+/**
+ * @brief Closes the tty
+ */
+void gps_serial_close( gps_serial_t *port );
+
+/**
+ * @brief Reads the next burst
+ *
+ * The complete lines of the burst are the first size bytes of buffer.  An
+ * unterminated line is kept for the next burst.
+ *
+ * @param timeout - ms to wait for the first byte, -1 for ever
+ *
+ * @return int - size, 0 when the timeout expired or -1 with errno set, EIO
+ * once the device or the other side of a pty is gone
+ */
+int gps_serial_burst( gps_serial_t *port, int timeout );
+
+/**
+ * @brief Feeds the lines of the burst to gps_put() and gps_parse()
+ *
+ * gps_parse() runs after every line, so none is overwritten.  The burst
+ * is taken as a whole epoch, which gps_epoch_flush() publishes at once.
+ * With GPS_TIMESTAMPS the bytes are stamped with first.
+ */
+void gps_serial_put( const gps_serial_t *port );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_SERIAL_H_ */
+
+/*** End of File **************************************************************/
@@ -0,0 +1,315 @@
+/*******************************************************************************
+* Title                 :   Shared Memory Fix Ring
+* Filename              :   gps_shm.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_shm.c
+ * @brief Epochs published through POSIX shared memory.
+ *
+ * In the mapping an entry's sequence is twice its number, and one less
+ * while it is written, so the seqlock and the entry number share a word.
+ * Readers get the number itself.  Entries are copied as 64 bit words with
+ * relaxed atomics, as in the fleet table, so a copy that overlaps a write
+ * is thrown away and never a data race.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _DEFAULT_SOURCE             /* syscall() */
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "gps_shm.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define STATIC_ASSERT( COND, NAME ) typedef char static_assert_##NAME[ ( COND ) ? 1 : -1 ]
+
+#define MASK    ( GPS_SHM_ENTRIES - 1 )
+#define WORDS   ( sizeof( gps_shm_entry_t ) / sizeof( uint64_t ) )
+
+STATIC_ASSERT( ( GPS_SHM_ENTRIES & MASK ) == 0, entries_power_of_two );
+STATIC_ASSERT( sizeof( gps_shm_entry_t ) % sizeof( uint64_t ) == 0, entry_of_words );
+STATIC_ASSERT( offsetof( gps_shm_ring_t, entry ) == 64, header_is_a_line );
+STATIC_ASSERT( offsetof( gps_shm_entry_t, sequence ) == 0, sequence_is_word_0 );
+
+/******************************************************************************
+* Module Typedefs
+*******************************************************************************/
+/* A word of a shared entry, may alias its fields */
+typedef uint64_t __attribute__(( may_alias )) word_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int compatible( const gps_shm_ring_t *ring );
+static int entry_copy( const gps_shm_entry_t *from, gps_shm_entry_t *to, uint64_t number );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int compatible( const gps_shm_ring_t *ring )
+{
+    return ring->version == GPS_SHM_VERSION && ring->entries == GPS_SHM_ENTRIES &&
+           ring->entry_bytes == sizeof( gps_shm_entry_t );
+}
+
+/* 1 when entry number was copied whole, 0 when it was being written over */
+static int entry_copy( const gps_shm_entry_t *from, gps_shm_entry_t *to, uint64_t number )
+{
+    const word_t *source = ( const word_t * )from;
+    uint64_t words[ WORDS ];
+    uint64_t before, after;
+    size_t i;
+
+    before = __atomic_load_n( &from->sequence, __ATOMIC_ACQUIRE );
+
+    if( before != number * 2 )
+        return 0;
+
+    for( i = 1; i < WORDS; i++ )
+        words[ i ] = __atomic_load_n( &source[ i ], __ATOMIC_RELAXED );
+
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    after = __atomic_load_n( &from->sequence, __ATOMIC_RELAXED );
+    words[ 0 ] = number;
+    memcpy( to, words, sizeof( words ) );
+
+    return before == after;
+}
+
+int gps_shm_create( gps_shm_t *shm, const char *name )
+{
+    gps_shm_ring_t *ring;
+    struct stat st;
+    int fd;
+
+    memset( shm, 0, sizeof( gps_shm_t ) );
+    shm->fd = -1;
+    fd = shm_open( name, O_RDWR | O_CREAT, 0644 );
+
+    if( fd < 0 )
+        return -1;
+
+    /* Before anything is written, a second publisher would start the ring over */
+    if( flock( fd, LOCK_EX | LOCK_NB ) ||
+        fstat( fd, &st ) ||
+        ( ( size_t )st.st_size < sizeof( gps_shm_ring_t ) &&
+          ftruncate( fd, sizeof( gps_shm_ring_t ) ) ) )
+    {
+        int error = errno == EWOULDBLOCK ? EEXIST : errno;
+
+        close( fd );
+        errno = error;
+        return -1;
+    }
+
+    ring = mmap( NULL, sizeof( gps_shm_ring_t ), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+
+    if( ring == MAP_FAILED )
+    {
+        int error = errno;
+
+        close( fd );
+        errno = error;
+        return -1;
+    }
+
+    /* A ring of another layout is started over, readers see EPROTO */
+    if( __atomic_load_n( &ring->magic, __ATOMIC_ACQUIRE ) != GPS_SHM_MAGIC ||
+        !compatible( ring ) )
+    {
+        __atomic_store_n( &ring->magic, 0, __ATOMIC_RELEASE );
+        memset( ( char * )ring + sizeof( uint32_t ), 0,
+                sizeof( gps_shm_ring_t ) - sizeof( uint32_t ) );
+        ring->version = GPS_SHM_VERSION;
+        ring->entries = GPS_SHM_ENTRIES;
+        ring->entry_bytes = sizeof( gps_shm_entry_t );
+        __atomic_store_n( &ring->magic, GPS_SHM_MAGIC, __ATOMIC_RELEASE );
+    }
+
+    shm->ring = ring;
+    shm->writer = 1;
+    shm->fd = fd;
+    shm->next = ring->head + 1;
+
+    return 0;
+}
+
+int gps_shm_attach( gps_shm_t *shm, const char *name )
+{
+    gps_shm_ring_t *ring;
+    struct stat st;
+    uint64_t head;
+    int fd;
+
+    memset( shm, 0, sizeof( gps_shm_t ) );
+    shm->fd = -1;
+    fd = shm_open( name, O_RDONLY, 0 );
+
+    if( fd < 0 )
+        return -1;
+
+    if( fstat( fd, &st ) || ( size_t )st.st_size < sizeof( gps_shm_ring_t ) )
+    {
+        close( fd );
+        errno = EAGAIN;
+        return -1;
+    }
+
+    ring = mmap( NULL, sizeof( gps_shm_ring_t ), PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+
+    if( ring == MAP_FAILED )
+        return -1;
+
+    if( __atomic_load_n( &ring->magic, __ATOMIC_ACQUIRE ) != GPS_SHM_MAGIC ||
+        !compatible( ring ) )
+    {
+        int error = ring->magic == 0 ? EAGAIN : EPROTO;
+
+        munmap( ring, sizeof( gps_shm_ring_t ) );
+        errno = error;
+        return -1;
+    }
+
+    head = __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE );
+    shm->ring = ring;
+    shm->next = head ? head : 1;
+
+    return 0;
+}
+
+void gps_shm_detach( gps_shm_t *shm )
+{
+    if( shm->ring != NULL )
+        munmap( shm->ring, sizeof( gps_shm_ring_t ) );
+
+    /* Closing drops the lock */
+    if( shm->fd >= 0 )
+        close( shm->fd );
+
+    memset( shm, 0, sizeof( gps_shm_t ) );
+    shm->fd = -1;
+}
+
+uint64_t gps_shm_publish( gps_shm_t *shm, const gps_log_fix_t *fix,
+                          const gps_shm_sat_t *sat, size_t count )
+{
+    gps_shm_ring_t *ring = shm->ring;
+    uint64_t number = ring->head + 1;
+    gps_shm_entry_t *slot = &ring->entry[ ( number - 1 ) & MASK ];
+    gps_shm_entry_t entry;
+    word_t *dest = ( word_t * )slot;
+    uint64_t words[ WORDS ];
+    size_t i;
+
+    if( count > GPS_SHM_SATS )
+        count = GPS_SHM_SATS;
+
+    memset( &entry, 0, sizeof( entry ) );
+    entry.published = gps_clock_ns();
+    entry.fix = *fix;
+    entry.sats = ( uint32_t )count;
+
+    if( count )
+        memcpy( entry.sat, sat, count * sizeof( gps_shm_sat_t ) );
+
+    memcpy( words, &entry, sizeof( words ) );
+
+    __atomic_store_n( &slot->sequence, number * 2 - 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    for( i = 1; i < WORDS; i++ )
+        __atomic_store_n( &dest[ i ], words[ i ], __ATOMIC_RELAXED );
+
+    __atomic_store_n( &slot->sequence, number * 2, __ATOMIC_RELEASE );
+    __atomic_store_n( &ring->head, number, __ATOMIC_RELEASE );
+    __atomic_add_fetch( &ring->futex, 1, __ATOMIC_RELEASE );
+    syscall( SYS_futex, &ring->futex, FUTEX_WAKE, INT_MAX, NULL, NULL, 0 );
+    shm->next = number + 1;
+
+    return number;
+}
+
+int gps_shm_read( gps_shm_t *shm, gps_shm_entry_t *entry )
+{
+    const gps_shm_ring_t *ring = shm->ring;
+
+    for( ;; )
+    {
+        uint64_t head = __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE );
+
+        if( shm->next > head )
+            return 0;
+
+        /* Written over, on to the oldest still there */
+        if( head - shm->next >= GPS_SHM_ENTRIES )
+        {
+            shm->missed += head - GPS_SHM_ENTRIES + 1 - shm->next;
+            shm->next = head - GPS_SHM_ENTRIES + 1;
+        }
+
+        if( entry_copy( &ring->entry[ ( shm->next - 1 ) & MASK ], entry, shm->next ) )
+        {
+            shm->next++;
+            return 1;
+        }
+    }
+}
+
+int gps_shm_latest( gps_shm_t *shm, gps_shm_entry_t *entry )
+{
+    uint64_t head = __atomic_load_n( &shm->ring->head, __ATOMIC_ACQUIRE );
+
+    if( head == 0 )
+        return 0;
+
+    shm->next = head;
+
+    return gps_shm_read( shm, entry );
+}
+
+int gps_shm_wait( gps_shm_t *shm, gps_shm_entry_t *entry, int timeout )
+{
+    uint64_t deadline = gps_clock_ns() + ( uint64_t )( timeout < 0 ? 0 : timeout ) * 1000000ull;
+
+    for( ;; )
+    {
+        uint32_t futex = __atomic_load_n( &shm->ring->futex, __ATOMIC_ACQUIRE );
+        struct timespec left;
+        uint64_t now;
+        int result = gps_shm_read( shm, entry );
+
+        if( result )
+            return result;
+
+        now = gps_clock_ns();
+
+        if( timeout >= 0 && now >= deadline )
+            return 0;
+
+        left.tv_sec = ( deadline - now ) / 1000000000ull;
+        left.tv_nsec = ( deadline - now ) % 1000000000ull;
+
+        /* Returns at once when an entry came after futex was read */
+        if( syscall( SYS_futex, &shm->ring->futex, FUTEX_WAIT, futex,
+                     timeout < 0 ? NULL : &left, NULL, 0 ) &&
+            errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT )
+            return -1;
+    }
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,184 @@
+/****************************************************************************
+* Title                 :   Shared Memory Fix Ring
+* Filename              :   gps_shm.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*****************************************************************************/
+/**
+ * @file gps_shm.h
+ * @brief One process decodes the receiver, any number of others read
+ *
+ * The publisher keeps a ring of the last GPS_SHM_ENTRIES epochs in a POSIX
+ * shared memory object, each with the fix and the satellites in view.
+ * Readers map it read only and copy entries out without a system call.
+ * Every entry has a sequence number, the count of entries published
+ * before it plus one, odd while it is written over.  A reader copies an
+ * entry between two reads of its sequence, as with a seqlock, and keeps
+ * the copy when both are the number it expected.  A reader that falls
+ * more than the ring behind skips to the oldest entry still there and
+ * counts the ones it missed.
+ *
+ * Readers that have nothing to do sleep on a futex in the header, which
+ * the publisher wakes after each entry.  A reader can't write to the
+ * mapping, so the publisher always makes that one call.
+ *
+ * @code
+ * gps_shm_create( &shm, "/gps0" );                  // publisher
+ * gps_shm_publish( &shm, &fix, sats, count );
+ *
+ * gps_shm_attach( &shm, "/gps0" );                  // readers
+ * while( gps_shm_wait( &shm, &entry, -1 ) > 0 )
+ *     printf( "%f %f\n", entry.fix.latitude, entry.fix.longitude );
+ * @endcode
+ */
+#ifndef GPS_SHM_H_
+#define GPS_SHM_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "gps_log.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_SHM_ENTRIES     64          /**< Epochs kept, a power of two */
+#define GPS_SHM_SATS        32          /**< Satellites of an entry */
+#define GPS_SHM_MAGIC       0x47505352u /**< "GPSR" */
+#define GPS_SHM_VERSION     1
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Satellite in view
+ */
+typedef struct
+{
+    uint16_t azimuth;           /**< Degrees true */
+    uint8_t prn;
+    uint8_t elevation;          /**< Degrees */
+    uint8_t snr;                /**< dBHz, 0 when not tracked */
+    uint8_t reserved[ 3 ];
+} gps_shm_sat_t;
+
+/**
+ * @struct One epoch
+ */
+typedef struct
+{
+    uint64_t sequence;          /**< Entries published up to this one */
+    uint64_t published;         /**< CLOCK_MONOTONIC ns of the publisher */
+    gps_log_fix_t fix;
+    uint32_t sats;              /**< Entries of sat used */
+    uint32_t reserved;
+    gps_shm_sat_t sat[ GPS_SHM_SATS ];
+} gps_shm_entry_t;
+
+/**
+ * @struct Layout of the shared memory object
+ */
+typedef struct
+{
+    uint32_t magic;             /**< Written last when created */
+    uint32_t version;
+    uint32_t entries;
+    uint32_t entry_bytes;
+    uint64_t head;              /**< Entries published */
+    uint32_t futex;             /**< Changes with every entry */
+    uint32_t reserved[ 9 ];     /**< Up to a cache line */
+    gps_shm_entry_t entry[ GPS_SHM_ENTRIES ];
+} gps_shm_ring_t;
+
+/**
+ * @struct Publisher or reader of a ring
+ */
+typedef struct
+{
+    gps_shm_ring_t *ring;
+    int writer;
+    int fd;                     /**< Publisher's, locked while it runs, else -1 */
+    uint64_t next;              /**< Sequence the reader expects next */
+    uint64_t missed;            /**< Entries written over before they were read */
+} gps_shm_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates the ring name, or takes over the one a publisher left
+ *
+ * A ring of the same layout goes on from its last entry, so readers that
+ * stay attached across a restart of the publisher see no gap.  The
+ * publisher holds an flock() on the object until gps_shm_detach() or its
+ * exit, crashes included, so only one publishes at a time.
+ *
+ * @param name - "/name" as for shm_open()
+ *
+ * @return int - 0 or -1 with errno set, EEXIST while another publisher
+ * holds the ring
+ */
+int gps_shm_create( gps_shm_t *shm, const char *name );
+
+/**
+ * @brief Maps the ring name read only
+ *
+ * The first entry read is the latest one published.
+ *
+ * @return int - 0 or -1 with errno set, EPROTO for another layout and
+ * EAGAIN while the publisher is still setting it up
+ */
+int gps_shm_attach( gps_shm_t *shm, const char *name );
+
+/**
+ * @brief Unmaps the ring, the object stays for others
+ */
+void gps_shm_detach( gps_shm_t *shm );
+
+/**
+ * @brief Writes an epoch and wakes the readers
+ *
+ * @param sat - count satellites, more than GPS_SHM_SATS are dropped
+ *
+ * @return uint64_t - sequence of the entry
+ */
+uint64_t gps_shm_publish( gps_shm_t *shm, const gps_log_fix_t *fix,
+                          const gps_shm_sat_t *sat, size_t count );
+
+/**
+ * @brief Copies the next entry, if there is one
+ *
+ * @return int - 1 with entry filled, 0 when the reader is up to date
+ */
+int gps_shm_read( gps_shm_t *shm, gps_shm_entry_t *entry );
+
+/**
+ * @brief Copies the latest entry and continues reading after it
+ *
+ * @return int - 1 with entry filled, 0 before the first
+ */
+int gps_shm_latest( gps_shm_t *shm, gps_shm_entry_t *entry );
+
+/**
+ * @brief gps_shm_read(), sleeping until the next entry when up to date
+ *
+ * @param timeout - ms, -1 for ever
+ *
+ * @return int - 1 with entry filled, 0 after timeout ms or -1 with errno
+ * set
+ */
+int gps_shm_wait( gps_shm_t *shm, gps_shm_entry_t *entry, int timeout );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_SHM_H_ */
+
+/*** End of File **************************************************************/
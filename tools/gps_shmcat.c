@@ -0,0 +1,89 @@
+/*******************************************************************************
+* Title                 :   Shared Memory Reader
+* Filename              :   gps_shmcat.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_shmcat.c
+ * @brief Prints the epochs gps_shmpub publishes, one CSV row each.
+ *
+ * Waits on the ring -n, /gps0 by default, and prints every epoch from the
+ * latest on with the satellites in view and the µs it took to get here.
+ * -1 prints the latest epoch and exits.
+ *
+ * @code
+ * gps_shmcat -n /gps0
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "gps_shm.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+int main( int argc, char **argv )
+{
+    const char *name = "/gps0";
+    gps_shm_entry_t entry;
+    gps_shm_t shm;
+    int once = 0, opt, result;
+
+    while( ( opt = getopt( argc, argv, "n:1h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'n':
+            name = optarg;
+            break;
+        case '1':
+            once = 1;
+            break;
+        default:
+            fprintf( stderr, "usage: %s [-n /name] [-1]\n", argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( gps_shm_attach( &shm, name ) )
+    {
+        perror( name );
+        return 1;
+    }
+
+    printf( "sequence,time_ms,latitude,longitude,altitude,speed,track,hdop,"
+            "quality,satellites,in_view,latency_us\n" );
+
+    do
+    {
+        result = once ? gps_shm_latest( &shm, &entry ) : gps_shm_wait( &shm, &entry, -1 );
+
+        if( result > 0 )
+        {
+            printf( "%llu,%lld,%.7f,%.7f,%.1f,%.2f,%.1f,%.1f,%u,%u,%u,%.1f\n",
+                    ( unsigned long long )entry.sequence, ( long long )entry.fix.time,
+                    entry.fix.latitude, entry.fix.longitude, entry.fix.altitude,
+                    entry.fix.speed, entry.fix.track, entry.fix.hdop,
+                    entry.fix.quality, entry.fix.satellites, entry.sats,
+                    ( gps_clock_ns() - entry.published ) / 1e3 );
+            fflush( stdout );
+        }
+    }
+    while( result > 0 && !once );
+
+    if( result < 0 )
+        perror( name );
+
+    gps_shm_detach( &shm );
+
+    return result < 0 ? 1 : 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
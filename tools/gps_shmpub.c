@@ -0,0 +1,151 @@
+/*******************************************************************************
+* Title                 :   Shared Memory Publisher
+* Filename              :   gps_shmpub.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux
+*******************************************************************************/
+/**
+ * @file gps_shmpub.c
+ * @brief Decodes one receiver for every process on the machine.
+ *
+ * Reads the receiver a burst at a time with gps_serial, decodes it with
+ * the parser and publishes each epoch with the satellites in view to the
+ * shared memory ring -n, /gps0 by default.  -b sets the baud rate of a
+ * tty.  The source may also be a pipe or - for stdin.  gps_shmcat and
+ * anything built on gps_shm.h read the ring.
+ *
+ * @code
+ * gps_shmpub -b 9600 /dev/ttyUSB0 &
+ * gps_shmcat
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "gps_parser.h"
+#include "gps_serial.h"
+#include "gps_shm.h"
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-b baud] [-n /name] source\n", name );
+}
+
+/* Satellites of the last GSV messages */
+static size_t satellites( gps_shm_sat_t *sat )
+{
+    size_t count = 0;
+#ifdef GSV
+    gsv_t *first = gps_gsv_message( 1 );
+    uint8_t m;
+    int k;
+
+    if( first == 0 )
+        return 0;
+
+    for( m = 1; m <= first->num_sentences && m <= MAX_GSV_SENTENCES; m++ )
+    {
+        gsv_t *gsv = gps_gsv_message( m );
+
+        for( k = 0; k < 4 && count < first->num_sats && count < GPS_SHM_SATS; k++ )
+        {
+            memset( &sat[ count ], 0, sizeof( gps_shm_sat_t ) );
+            sat[ count ].prn = gsv->sat_info[ k ].sat_prn_num;
+            sat[ count ].elevation = gsv->sat_info[ k ].elevation;
+            sat[ count ].azimuth = gsv->sat_info[ k ].azimuth;
+            sat[ count ].snr = gsv->sat_info[ k ].snr;
+            count++;
+        }
+    }
+#else
+    ( void )sat;
+#endif
+
+    return count;
+}
+
+int main( int argc, char **argv )
+{
+    static gps_serial_t port;
+    gps_shm_sat_t sat[ GPS_SHM_SATS ];
+    const char *name = "/gps0";
+    uint32_t published = 0;
+    gps_epoch_t epoch;
+    gps_log_fix_t fix;
+    gps_shm_t shm;
+    long baud = 0;
+    int opt, fd;
+
+    while( ( opt = getopt( argc, argv, "b:n:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'b':
+            baud = strtol( optarg, NULL, 10 );
+            break;
+        case 'n':
+            name = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind != argc - 1 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    fd = strcmp( argv[ optind ], "-" ) == 0 ? STDIN_FILENO
+                                            : open( argv[ optind ], O_RDWR | O_NOCTTY );
+
+    if( fd < 0 || gps_serial_setup( &port, fd, baud ) )
+    {
+        perror( argv[ optind ] );
+        return 1;
+    }
+
+    if( gps_shm_create( &shm, name ) )
+    {
+        if( errno == EEXIST )
+            fprintf( stderr, "%s: another publisher is running\n", name );
+        else
+            perror( name );
+
+        return 1;
+    }
+
+    while( gps_serial_burst( &port, -1 ) > 0 )
+    {
+        gps_serial_put( &port );
+
+        if( gps_last_epoch( &epoch ) == published )
+            continue;
+
+        published = epoch.epoch;
+        gps_log_fix_epoch( &fix, &epoch );
+        gps_shm_publish( &shm, &fix, sat, satellites( sat ) );
+    }
+
+    if( errno != EIO )
+        perror( argv[ optind ] );
+
+    fprintf( stderr, "%u epochs published to %s\n", published, name );
+    gps_shm_detach( &shm );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
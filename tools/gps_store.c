@@ -0,0 +1,613 @@
+/*******************************************************************************
+* Title                 :   Track Store
+* Filename              :   gps_store.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_store.c
+ * @brief Compact columnar files of decoded epochs.
+ *
+ * Every varint stream starts from zero, so a block decodes without its
+ * neighbours.  Blocks are padded to eight bytes to keep the in place
+ * columns and the index aligned in the map.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gps_store.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define MAGIC           "GPSTRACK"
+#define VARINT_MAX      10
+#define BLOCK_MAX       ( GPS_STORE_BLOCK_ROWS * ( 4 + GPS_STORE_STREAMS * VARINT_MAX ) + 8 )
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int64_t fixed( double value, double units );
+static uint8_t *varint_put( uint8_t *p, int64_t value );
+static uint8_t *stream_put( uint8_t *p, const int64_t *values, size_t rows );
+static int stream_get( const uint8_t *p, const uint8_t *end, size_t rows,
+                       int64_t *values );
+static size_t block_encode( const gps_track_t *track, size_t first, size_t rows,
+                            uint8_t *out, gps_store_block_t *entry );
+static int block_write( gps_store_writer_t *writer, const gps_track_t *track,
+                        size_t first, size_t rows );
+static int store_check( const gps_store_t *store );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static int64_t fixed( double value, double units )
+{
+    value *= units;
+
+    return ( int64_t )( value < 0 ? value - 0.5 : value + 0.5 );
+}
+
+/* Zig-zag keeps small negative deltas small */
+static uint8_t *varint_put( uint8_t *p, int64_t value )
+{
+    uint64_t v = ( ( uint64_t )value << 1 ) ^ ( uint64_t )( value >> 63 );
+
+    while( v >= 0x80 )
+    {
+        *p++ = ( uint8_t )( v | 0x80 );
+        v >>= 7;
+    }
+
+    *p++ = ( uint8_t )v;
+
+    return p;
+}
+
+static uint8_t *stream_put( uint8_t *p, const int64_t *values, size_t rows )
+{
+    int64_t previous = 0;
+    size_t i;
+
+    for( i = 0; i < rows; i++ )
+    {
+        p = varint_put( p, values[ i ] - previous );
+        previous = values[ i ];
+    }
+
+    return p;
+}
+
+/* Decodes rows deltas and sums them up, -1 if the stream runs past end */
+static int stream_get( const uint8_t *p, const uint8_t *end, size_t rows,
+                       int64_t *values )
+{
+    int64_t previous = 0;
+    size_t i;
+
+    for( i = 0; i < rows; i++ )
+    {
+        uint64_t v;
+
+        if( p < end && *p < 0x80 )
+        {
+            v = *p++;
+        }
+        else
+        {
+            int shift = 0;
+
+            v = 0;
+
+            do
+            {
+                if( p == end || shift > 63 )
+                    return -1;
+
+                v |= ( uint64_t )( *p & 0x7f ) << shift;
+                shift += 7;
+            } while( *p++ & 0x80 );
+        }
+
+        previous += ( int64_t )( v >> 1 ) ^ -( int64_t )( v & 1 );
+        values[ i ] = previous;
+    }
+
+    return 0;
+}
+
+static size_t block_encode( const gps_track_t *track, size_t first, size_t rows,
+                            uint8_t *out, gps_store_block_t *entry )
+{
+    int64_t values[ GPS_STORE_BLOCK_ROWS ];
+    uint8_t *p = out;
+    size_t i, k;
+
+    memset( entry, 0, sizeof( gps_store_block_t ) );
+    entry->rows = ( uint32_t )rows;
+    entry->min_time = INT64_MAX;
+    entry->max_time = INT64_MIN;
+    entry->min_latitude = INT32_MAX;
+    entry->max_latitude = INT32_MIN;
+    entry->min_longitude = INT32_MAX;
+    entry->max_longitude = INT32_MIN;
+    entry->flags = GPS_STORE_SORTED;
+
+    memcpy( p, track->fields + first, rows * sizeof( uint16_t ) );
+    p += rows * sizeof( uint16_t );
+    memcpy( p, track->quality + first, rows );
+    p += rows;
+    memcpy( p, track->satellites + first, rows );
+    p += rows;
+
+    for( k = 0; k < GPS_STORE_STREAMS; k++ )
+    {
+        entry->stream[ k ] = ( uint32_t )( p - out );
+
+        for( i = 0; i < rows; i++ )
+        {
+            size_t row = first + i;
+
+            switch( k )
+            {
+            case GPS_STORE_TIME:
+                values[ i ] = track->time[ row ];
+
+                if( i && values[ i ] < values[ i - 1 ] )
+                    entry->flags &= ~GPS_STORE_SORTED;
+
+                if( values[ i ] < entry->min_time )
+                    entry->min_time = values[ i ];
+
+                if( values[ i ] > entry->max_time )
+                    entry->max_time = values[ i ];
+                break;
+            case GPS_STORE_LATITUDE:
+                values[ i ] = fixed( track->latitude[ row ], GPS_STORE_DEGREES );
+
+                if( track->fields[ row ] & GPS_EPOCH_POSITION )
+                {
+                    if( values[ i ] < entry->min_latitude )
+                        entry->min_latitude = ( int32_t )values[ i ];
+
+                    if( values[ i ] > entry->max_latitude )
+                        entry->max_latitude = ( int32_t )values[ i ];
+                }
+                break;
+            case GPS_STORE_LONGITUDE:
+                values[ i ] = fixed( track->longitude[ row ], GPS_STORE_DEGREES );
+
+                if( track->fields[ row ] & GPS_EPOCH_POSITION )
+                {
+                    if( values[ i ] < entry->min_longitude )
+                        entry->min_longitude = ( int32_t )values[ i ];
+
+                    if( values[ i ] > entry->max_longitude )
+                        entry->max_longitude = ( int32_t )values[ i ];
+                }
+                break;
+            case GPS_STORE_ALTITUDE:
+                values[ i ] = fixed( track->altitude[ row ], GPS_STORE_UNITS );
+                break;
+            case GPS_STORE_SPEED:
+                values[ i ] = fixed( track->speed[ row ], GPS_STORE_UNITS );
+                break;
+            case GPS_STORE_TRACK:
+                values[ i ] = fixed( track->track[ row ], GPS_STORE_UNITS );
+                break;
+            default:
+                values[ i ] = fixed( track->hdop[ row ], GPS_STORE_UNITS );
+                break;
+            }
+        }
+
+        p = stream_put( p, values, rows );
+    }
+
+    while( ( p - out ) % 8 )
+        *p++ = 0;
+
+    entry->bytes = ( uint32_t )( p - out );
+
+    return p - out;
+}
+
+/* Encodes and writes one block, returns 0 or an errno value */
+static int block_write( gps_store_writer_t *writer, const gps_track_t *track,
+                        size_t first, size_t rows )
+{
+    gps_store_header_t *header = &writer->header;
+    gps_store_block_t *entry;
+    size_t bytes;
+
+    if( header->blocks == writer->capacity )
+    {
+        size_t capacity = writer->capacity ? writer->capacity * 2 : 64;
+        void *index = realloc( writer->index, capacity * sizeof( gps_store_block_t ) );
+
+        if( index == NULL )
+            return ENOMEM;
+
+        writer->index = index;
+        writer->capacity = capacity;
+    }
+
+    entry = &writer->index[ header->blocks ];
+    bytes = block_encode( track, first, rows, writer->buffer, entry );
+    entry->offset = header->index;
+
+    if( !( entry->flags & GPS_STORE_SORTED ) ||
+        ( header->rows && entry->min_time < header->max_time ) )
+        header->flags &= ~( uint64_t )GPS_STORE_SORTED;
+
+    if( entry->min_time < header->min_time )
+        header->min_time = entry->min_time;
+
+    if( entry->max_time > header->max_time )
+        header->max_time = entry->max_time;
+
+    if( fwrite( writer->buffer, bytes, 1, writer->file ) != 1 )
+        return errno;
+
+    header->index += bytes;
+    header->rows += rows;
+    header->blocks++;
+
+    return 0;
+}
+
+/* Everything gps_store_read_block() relies on */
+static int store_check( const gps_store_t *store )
+{
+    const gps_store_header_t *header = ( const gps_store_header_t * )store->map;
+    const gps_store_block_t *index;
+    size_t b, k;
+
+    if( memcmp( header->magic, MAGIC, sizeof( header->magic ) ) ||
+        header->version != GPS_STORE_VERSION ||
+        header->block_rows != GPS_STORE_BLOCK_ROWS ||
+        header->index % 8 || header->index > store->size ||
+        header->blocks > ( store->size - header->index ) / sizeof( gps_store_block_t ) )
+        return -1;
+
+    index = ( const gps_store_block_t * )( store->map + header->index );
+
+    for( b = 0; b < header->blocks; b++ )
+    {
+        const gps_store_block_t *entry = &index[ b ];
+
+        if( entry->offset % 8 || entry->offset > header->index ||
+            entry->bytes > header->index - entry->offset ||
+            entry->rows > GPS_STORE_BLOCK_ROWS ||
+            entry->stream[ 0 ] < entry->rows * 4 )
+            return -1;
+
+        for( k = 0; k < GPS_STORE_STREAMS; k++ )
+        {
+            uint32_t end = k + 1 < GPS_STORE_STREAMS ? entry->stream[ k + 1 ] : entry->bytes;
+
+            if( entry->stream[ k ] > end )
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+int gps_store_write( const char *path, const gps_track_t *track )
+{
+    gps_store_writer_t writer;
+
+    if( gps_store_create( &writer, path ) )
+        return -1;
+
+    gps_store_append( &writer, track );
+
+    return gps_store_finish( &writer );
+}
+
+int gps_store_create( gps_store_writer_t *writer, const char *path )
+{
+    gps_store_header_t *header = &writer->header;
+
+    memset( writer, 0, sizeof( gps_store_writer_t ) );
+    memcpy( header->magic, MAGIC, sizeof( header->magic ) );
+    header->version = GPS_STORE_VERSION;
+    header->block_rows = GPS_STORE_BLOCK_ROWS;
+    header->index = sizeof( gps_store_header_t );
+    header->min_time = INT64_MAX;
+    header->max_time = INT64_MIN;
+    header->flags = GPS_STORE_SORTED;
+
+    writer->buffer = malloc( BLOCK_MAX );
+
+    if( writer->buffer == NULL )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    writer->file = fopen( path, "wb" );
+
+    /* The header is written again by gps_store_finish() */
+    if( writer->file == NULL ||
+        fwrite( header, sizeof( gps_store_header_t ), 1, writer->file ) != 1 )
+    {
+        int error = errno;
+
+        if( writer->file != NULL )
+            fclose( writer->file );
+
+        free( writer->buffer );
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+int gps_store_append( gps_store_writer_t *writer, const gps_track_t *track )
+{
+    gps_track_t *pending = &writer->pending;
+    size_t first = 0;
+
+    if( writer->error )
+    {
+        errno = writer->error;
+        return -1;
+    }
+
+    /* Fills the unfinished block first, then encodes straight from track */
+    if( pending->count )
+    {
+        size_t rows = GPS_STORE_BLOCK_ROWS - pending->count;
+
+        if( rows > track->count )
+            rows = track->count;
+
+        if( gps_track_append( pending, track, 0, rows ) )
+            writer->error = ENOMEM;
+        else if( pending->count == GPS_STORE_BLOCK_ROWS )
+            writer->error = block_write( writer, pending, 0, GPS_STORE_BLOCK_ROWS );
+
+        pending->count %= GPS_STORE_BLOCK_ROWS;
+        first = rows;
+    }
+
+    while( !writer->error && track->count - first >= GPS_STORE_BLOCK_ROWS )
+    {
+        writer->error = block_write( writer, track, first, GPS_STORE_BLOCK_ROWS );
+        first += GPS_STORE_BLOCK_ROWS;
+    }
+
+    if( !writer->error && first < track->count &&
+        gps_track_append( pending, track, first, track->count - first ) )
+        writer->error = ENOMEM;
+
+    if( writer->error )
+    {
+        errno = writer->error;
+        return -1;
+    }
+
+    return 0;
+}
+
+int gps_store_finish( gps_store_writer_t *writer )
+{
+    gps_store_header_t *header = &writer->header;
+    FILE *file = writer->file;
+    int error = writer->error;
+
+    if( !error && writer->pending.count )
+        error = block_write( writer, &writer->pending, 0, writer->pending.count );
+
+    if( !error &&
+        ( fwrite( writer->index, sizeof( gps_store_block_t ), header->blocks, file ) != header->blocks ||
+          fseek( file, 0, SEEK_SET ) ||
+          fwrite( header, sizeof( gps_store_header_t ), 1, file ) != 1 ) )
+        error = errno;
+
+    if( fclose( file ) && !error )
+        error = errno;
+
+    gps_track_free( &writer->pending );
+    free( writer->index );
+    free( writer->buffer );
+    memset( writer, 0, sizeof( gps_store_writer_t ) );
+
+    if( error )
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+int gps_store_open( gps_store_t *store, const char *path )
+{
+    struct stat st;
+    void *map;
+    int fd = open( path, O_RDONLY );
+
+    memset( store, 0, sizeof( gps_store_t ) );
+
+    if( fd < 0 )
+        return -1;
+
+    if( fstat( fd, &st ) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    if( ( size_t )st.st_size < sizeof( gps_store_header_t ) )
+    {
+        close( fd );
+        errno = EINVAL;
+        return -1;
+    }
+
+    map = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+
+    if( map == MAP_FAILED )
+        return -1;
+
+    store->map = map;
+    store->size = st.st_size;
+
+    if( store_check( store ) )
+    {
+        gps_store_close( store );
+        errno = EINVAL;
+        return -1;
+    }
+
+    store->header = map;
+    store->index = ( const gps_store_block_t * )( store->map + store->header->index );
+    store->blocks = store->header->blocks;
+    posix_madvise( map, st.st_size, POSIX_MADV_WILLNEED );
+
+    return 0;
+}
+
+void gps_store_close( gps_store_t *store )
+{
+    if( store->map != NULL )
+        munmap( ( void * )store->map, store->size );
+
+    memset( store, 0, sizeof( gps_store_t ) );
+}
+
+int gps_store_read_block( const gps_store_t *store, size_t block,
+                          gps_track_t *track )
+{
+    const gps_store_block_t *entry = &store->index[ block ];
+    const uint8_t *base = store->map + entry->offset;
+    int64_t values[ GPS_STORE_BLOCK_ROWS ];
+    size_t rows = entry->rows;
+    size_t row = track->count;
+    size_t i, k;
+
+    if( gps_track_reserve( track, row + rows ) )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    for( k = 0; k < GPS_STORE_STREAMS; k++ )
+    {
+        uint32_t end = k + 1 < GPS_STORE_STREAMS ? entry->stream[ k + 1 ] : entry->bytes;
+        int64_t *out = k == GPS_STORE_TIME ? track->time + row : values;
+
+        if( stream_get( base + entry->stream[ k ], base + end, rows, out ) )
+        {
+            errno = EINVAL;
+            return -1;
+        }
+
+        switch( k )
+        {
+        case GPS_STORE_TIME:
+            break;
+        case GPS_STORE_LATITUDE:
+            for( i = 0; i < rows; i++ )
+                track->latitude[ row + i ] = values[ i ] / GPS_STORE_DEGREES;
+            break;
+        case GPS_STORE_LONGITUDE:
+            for( i = 0; i < rows; i++ )
+                track->longitude[ row + i ] = values[ i ] / GPS_STORE_DEGREES;
+            break;
+        case GPS_STORE_ALTITUDE:
+            for( i = 0; i < rows; i++ )
+                track->altitude[ row + i ] = ( float )( values[ i ] / ( double )GPS_STORE_UNITS );
+            break;
+        case GPS_STORE_SPEED:
+            for( i = 0; i < rows; i++ )
+                track->speed[ row + i ] = ( float )( values[ i ] / ( double )GPS_STORE_UNITS );
+            break;
+        case GPS_STORE_TRACK:
+            for( i = 0; i < rows; i++ )
+                track->track[ row + i ] = ( float )( values[ i ] / ( double )GPS_STORE_UNITS );
+            break;
+        default:
+            for( i = 0; i < rows; i++ )
+                track->hdop[ row + i ] = ( float )( values[ i ] / ( double )GPS_STORE_UNITS );
+            break;
+        }
+    }
+
+    memcpy( track->fields + row, gps_store_fields( store, block ), rows * sizeof( uint16_t ) );
+    memcpy( track->quality + row, gps_store_quality( store, block ), rows );
+    memcpy( track->satellites + row, gps_store_satellites( store, block ), rows );
+    track->count += rows;
+
+    return 0;
+}
+
+int gps_store_stream( const gps_store_t *store, size_t block,
+                      gps_store_stream_t stream, int64_t *values )
+{
+    const gps_store_block_t *entry = &store->index[ block ];
+    const uint8_t *base = store->map + entry->offset;
+    uint32_t end = stream + 1 < GPS_STORE_STREAMS ? entry->stream[ stream + 1 ] : entry->bytes;
+
+    if( stream_get( base + entry->stream[ stream ], base + end, entry->rows, values ) )
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
+
+int gps_store_read( const gps_store_t *store, gps_track_t *track )
+{
+    size_t b;
+
+    if( gps_track_reserve( track, track->count + store->header->rows ) )
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    for( b = 0; b < store->blocks; b++ )
+    {
+        if( gps_store_read_block( store, b, track ) )
+            return -1;
+    }
+
+    return 0;
+}
+
+const uint16_t *gps_store_fields( const gps_store_t *store, size_t block )
+{
+    return ( const uint16_t * )( store->map + store->index[ block ].offset );
+}
+
+const uint8_t *gps_store_quality( const gps_store_t *store, size_t block )
+{
+    const gps_store_block_t *entry = &store->index[ block ];
+
+    return store->map + entry->offset + entry->rows * sizeof( uint16_t );
+}
+
+const uint8_t *gps_store_satellites( const gps_store_t *store, size_t block )
+{
+    const gps_store_block_t *entry = &store->index[ block ];
+
+    return store->map + entry->offset + entry->rows * ( sizeof( uint16_t ) + 1 );
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,229 @@
+/****************************************************************************
+* Title                 :   Track Store
+* Filename              :   gps_store.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_store.h
+ * @brief Compact columnar files of decoded epochs
+ *
+ * A store holds a gps_track_t in blocks of GPS_STORE_BLOCK_ROWS rows:
+ *
+ * @code
+ * header | block 0 | block 1 | ... | index of gps_store_block_t
+ * @endcode
+ *
+ * Each block starts with the fields, quality and satellites columns as
+ * plain arrays, which are read in place.  Time, position, altitude, speed,
+ * track and HDOP follow as separate streams of zig-zag varint deltas.
+ * Positions are stored in 1e-7 degrees.  Altitude, speed, track and HDOP
+ * are stored in hundredths.
+ *
+ * The index keeps the time range and the bounding box of every block, so
+ * readers skip blocks without touching them.  The file is little endian
+ * and read through a memory map.
+ *
+ * Large stores are written in parts with gps_store_create(),
+ * gps_store_append() and gps_store_finish().
+ *
+ * @code
+ * gps_store_write( "day.gpst", &log.track );
+ *
+ * gps_store_open( &store, "day.gpst" );
+ * for( i = 0; i < store.blocks; i++ )
+ *     if( store.index[ i ].max_time >= from )
+ *         gps_store_read_block( &store, i, &track );
+ * gps_store_close( &store );
+ * @endcode
+ */
+#ifndef GPS_STORE_H_
+#define GPS_STORE_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "gps_log.h"
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_STORE_VERSION       1
+#define GPS_STORE_BLOCK_ROWS    4096
+#define GPS_STORE_DEGREES       1e7     /**< Position units per degree */
+#define GPS_STORE_UNITS         100     /**< Units of the float columns */
+#define GPS_STORE_SORTED        0x01    /**< Flag, times never go back */
+
+/** Varint streams of a block, in file order */
+typedef enum
+{
+    GPS_STORE_TIME = 0,
+    GPS_STORE_LATITUDE,
+    GPS_STORE_LONGITUDE,
+    GPS_STORE_ALTITUDE,
+    GPS_STORE_SPEED,
+    GPS_STORE_TRACK,
+    GPS_STORE_HDOP,
+    GPS_STORE_STREAMS
+} gps_store_stream_t;
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct First 64 bytes of a store
+ */
+typedef struct
+{
+    char magic[ 8 ];            /**< "GPSTRACK" */
+    uint32_t version;
+    uint32_t block_rows;
+    uint64_t rows;
+    uint64_t blocks;
+    uint64_t index;             /**< File offset of the block index */
+    int64_t min_time;
+    int64_t max_time;
+    uint64_t flags;             /**< GPS_STORE_SORTED for the whole file */
+} gps_store_header_t;
+
+/**
+ * @struct Index entry of one block
+ *
+ * The bounding box covers the rows with GPS_EPOCH_POSITION.  It's empty,
+ * min above max, when there are none.
+ */
+typedef struct
+{
+    uint64_t offset;            /**< File offset of the block */
+    uint32_t bytes;
+    uint32_t rows;
+    int64_t min_time;           /**< UTC ms since 1970 */
+    int64_t max_time;
+    int32_t min_latitude;       /**< 1e-7 degrees */
+    int32_t max_latitude;
+    int32_t min_longitude;
+    int32_t max_longitude;
+    uint32_t stream[ GPS_STORE_STREAMS ];   /**< Offsets in the block */
+    uint32_t flags;             /**< GPS_STORE_SORTED within the block */
+} gps_store_block_t;
+
+/**
+ * @struct Store being written
+ */
+typedef struct
+{
+    void *file;
+    gps_store_header_t header;
+    gps_store_block_t *index;
+    size_t capacity;            /**< Index entries allocated */
+    gps_track_t pending;        /**< Rows of the unfinished block */
+    uint8_t *buffer;
+    int error;
+} gps_store_writer_t;
+
+/**
+ * @struct Open store
+ */
+typedef struct
+{
+    const uint8_t *map;
+    size_t size;
+    const gps_store_header_t *header;
+    const gps_store_block_t *index;
+    size_t blocks;
+} gps_store_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Writes a track to a new store
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_store_write( const char *path, const gps_track_t *track );
+
+/**
+ * @brief Starts a store that is written in parts
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_store_create( gps_store_writer_t *writer, const char *path );
+
+/**
+ * @brief Appends the rows of a track, full blocks are written right away
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_store_append( gps_store_writer_t *writer, const gps_track_t *track );
+
+/**
+ * @brief Writes the last block and the index and closes the file
+ *
+ * @return int - 0 or -1 with errno set, also for an earlier failed append
+ */
+int gps_store_finish( gps_store_writer_t *writer );
+
+/**
+ * @brief Maps a store and checks its header and index
+ *
+ * @return int - 0 or -1 with errno set, EINVAL for a damaged file
+ */
+int gps_store_open( gps_store_t *store, const char *path );
+
+/**
+ * @brief Unmaps a store
+ */
+void gps_store_close( gps_store_t *store );
+
+/**
+ * @brief Decodes one block and appends its rows to a track
+ *
+ * @return int - 0 or -1 with errno set, EINVAL for a damaged block
+ */
+int gps_store_read_block( const gps_store_t *store, size_t block,
+                          gps_track_t *track );
+
+/**
+ * @brief Decodes a single stream of a block in its stored units
+ *
+ * @param values - GPS_STORE_BLOCK_ROWS values at most
+ *
+ * @return int - 0 or -1 with errno EINVAL for a damaged block
+ */
+int gps_store_stream( const gps_store_t *store, size_t block,
+                      gps_store_stream_t stream, int64_t *values );
+
+/**
+ * @brief Decodes every block into a track
+ */
+int gps_store_read( const gps_store_t *store, gps_track_t *track );
+
+/**
+ * @brief In place columns of a block, GPS_EPOCH_* bits of every row
+ */
+const uint16_t *gps_store_fields( const gps_store_t *store, size_t block );
+
+/**
+ * @brief In place columns of a block, GGA fix quality of every row
+ */
+const uint8_t *gps_store_quality( const gps_store_t *store, size_t block );
+
+/**
+ * @brief In place columns of a block, satellites of every row
+ */
+const uint8_t *gps_store_satellites( const gps_store_t *store, size_t block );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_STORE_H_ */
+
+/*** End of File **************************************************************/
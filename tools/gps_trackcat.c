@@ -0,0 +1,128 @@
+/*******************************************************************************
+* Title                 :   Track Store CLI
+* Filename              :   gps_trackcat.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_trackcat.c
+ * @brief Reads gps_store files back, reports their size and scan speed.
+ *
+ * Every store is decoded -r times and the fastest pass is reported.  -o
+ * writes the decoded rows as the same CSV as gps_logparse.
+ *
+ * @code
+ * gps_trackcat day.gpst
+ * gps_trackcat -o track.csv day.gpst
+ * @endcode
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "gps_store.h"
+#include "gps_clock.h"
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+static void usage( const char *name )
+{
+    fprintf( stderr, "usage: %s [-r repeat] [-o track.csv] track.gpst ...\n", name );
+}
+
+int main( int argc, char **argv )
+{
+    const char *csv = NULL;
+    gps_track_t track;
+    uint64_t bytes = 0, best = 0;
+    long repeat = 3, r;
+    int opt, i;
+
+    while( ( opt = getopt( argc, argv, "r:o:h" ) ) != -1 )
+    {
+        switch( opt )
+        {
+        case 'r':
+            repeat = strtol( optarg, NULL, 10 );
+            break;
+        case 'o':
+            csv = optarg;
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if( optind >= argc || repeat < 1 )
+    {
+        usage( argv[ 0 ] );
+        return 2;
+    }
+
+    memset( &track, 0, sizeof( track ) );
+
+    for( i = optind; i < argc; i++ )
+    {
+        gps_store_t store;
+        uint64_t fastest = UINT64_MAX;
+        size_t first = track.count;
+
+        if( gps_store_open( &store, argv[ i ] ) )
+        {
+            fprintf( stderr, "%s: %s\n", argv[ i ], strerror( errno ) );
+            gps_track_free( &track );
+            return 1;
+        }
+
+        /* Later passes overwrite the rows of the first one */
+        for( r = 0; r < repeat; r++ )
+        {
+            uint64_t start = gps_clock_ns();
+
+            track.count = first;
+
+            if( gps_store_read( &store, &track ) )
+            {
+                fprintf( stderr, "%s: %s\n", argv[ i ], strerror( errno ) );
+                gps_store_close( &store );
+                gps_track_free( &track );
+                return 1;
+            }
+
+            start = gps_clock_ns() - start;
+
+            if( start < fastest )
+                fastest = start;
+        }
+
+        bytes += store.size;
+        best += fastest;
+        gps_store_close( &store );
+    }
+
+    printf( "bytes      %llu\n", ( unsigned long long )bytes );
+    printf( "rows       %llu ( %.1f bytes per row )\n", ( unsigned long long )track.count,
+            track.count ? ( double )bytes / track.count : 0.0 );
+    printf( "scan       %.3f s, %.1f M rows/s\n", best / 1e9,
+            best ? track.count * 1e3 / best : 0.0 );
+
+    if( csv != NULL && gps_track_write_csv( &track, csv ) )
+    {
+        perror( csv );
+        gps_track_free( &track );
+        return 1;
+    }
+
+    gps_track_free( &track );
+
+    return 0;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
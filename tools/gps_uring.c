@@ -0,0 +1,301 @@
+/*******************************************************************************
+* Title                 :   io_uring Rings
+* Filename              :   gps_uring.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux 6.7 or later
+*******************************************************************************/
+/**
+ * @file gps_uring.c
+ * @brief The few io_uring calls the ingestion workers use, without liburing.
+ *
+ * The kernel reads the submission tail and writes the completion tail
+ * while the process runs, so those are read with acquire and written with
+ * release ordering.  Older UAPI headers lack the multishot read opcode,
+ * which is defined here.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE         /* syscall() */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "gps_uring.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define OP_READ_MULTISHOT   49      /**< IORING_OP_READ_MULTISHOT, Linux 6.7 */
+#define BUFFER_GROUP        0
+
+#define LOAD( p )           __atomic_load_n( ( p ), __ATOMIC_ACQUIRE )
+#define STORE( p, v )       __atomic_store_n( ( p ), ( v ), __ATOMIC_RELEASE )
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static struct io_uring_sqe *sqe_get( gps_uring_t *ring );
+static void buffer_add( gps_uring_t *ring, uint16_t bid );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* A cleared entry, submitting first when the queue is full */
+static struct io_uring_sqe *sqe_get( gps_uring_t *ring )
+{
+    struct io_uring_sqe *sqe;
+    unsigned index;
+
+    if( ring->sq_local - LOAD( ring->sq_head ) == ring->sq_entries &&
+        gps_uring_submit( ring, 0 ) )
+        return NULL;
+
+    if( ring->sq_local - LOAD( ring->sq_head ) == ring->sq_entries )
+    {
+        errno = EBUSY;
+        return NULL;
+    }
+
+    index = ring->sq_local & ring->sq_mask;
+    sqe = &ring->sqes[ index ];
+    memset( sqe, 0, sizeof( struct io_uring_sqe ) );
+    ring->sq_array[ index ] = index;
+    ring->sq_local++;
+
+    return sqe;
+}
+
+static void buffer_add( gps_uring_t *ring, uint16_t bid )
+{
+    struct io_uring_buf *buf = &ring->br->bufs[ ring->br_tail & ring->br_mask ];
+
+    buf->addr = ( uint64_t )( uintptr_t )( ring->buffers + ( size_t )bid * ring->buffer_bytes );
+    buf->len = ( uint32_t )ring->buffer_bytes;
+    buf->bid = bid;
+    ring->br_tail++;
+    STORE( &ring->br->tail, ring->br_tail );
+}
+
+int gps_uring_init( gps_uring_t *ring, unsigned sq_entries, unsigned cq_entries,
+                    unsigned buffers, size_t buffer_bytes )
+{
+    struct io_uring_params p;
+    struct io_uring_buf_reg reg;
+    char *sq, *cq;
+    unsigned i;
+
+    memset( ring, 0, sizeof( gps_uring_t ) );
+    ring->fd = -1;
+    memset( &p, 0, sizeof( p ) );
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = cq_entries;
+    ring->fd = ( int )syscall( __NR_io_uring_setup, sq_entries, &p );
+
+    if( ring->fd < 0 )
+        return -1;
+
+    ring->sq_bytes = p.sq_off.array + p.sq_entries * sizeof( unsigned );
+    ring->cq_bytes = p.cq_off.cqes + p.cq_entries * sizeof( struct io_uring_cqe );
+    ring->sqe_bytes = p.sq_entries * sizeof( struct io_uring_sqe );
+
+    if( p.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        if( ring->cq_bytes > ring->sq_bytes )
+            ring->sq_bytes = ring->cq_bytes;
+
+        ring->cq_bytes = 0;
+    }
+
+    ring->sq_map = mmap( NULL, ring->sq_bytes, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING );
+    ring->cq_map = ring->cq_bytes == 0 ? ring->sq_map :
+                   mmap( NULL, ring->cq_bytes, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING );
+    ring->sqes = mmap( NULL, ring->sqe_bytes, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES );
+
+    /* Provided buffer rings must be page aligned */
+    ring->br_bytes = buffers * sizeof( struct io_uring_buf );
+    ring->br = mmap( NULL, ring->br_bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    ring->buffers = malloc( buffers * buffer_bytes );
+
+    if( ring->sq_map == MAP_FAILED || ring->cq_map == MAP_FAILED ||
+        ring->sqes == MAP_FAILED || ring->br == MAP_FAILED || ring->buffers == NULL )
+    {
+        int error = ring->buffers == NULL ? ENOMEM : errno;
+
+        gps_uring_free( ring );
+        errno = error;
+        return -1;
+    }
+
+    sq = ring->sq_map;
+    cq = ring->cq_map;
+    ring->sq_head = ( unsigned * )( sq + p.sq_off.head );
+    ring->sq_tail = ( unsigned * )( sq + p.sq_off.tail );
+    ring->sq_array = ( unsigned * )( sq + p.sq_off.array );
+    ring->sq_mask = *( unsigned * )( sq + p.sq_off.ring_mask );
+    ring->sq_entries = p.sq_entries;
+    ring->sq_local = *ring->sq_tail;
+    ring->cq_head = ( unsigned * )( cq + p.cq_off.head );
+    ring->cq_tail = ( unsigned * )( cq + p.cq_off.tail );
+    ring->cq_mask = *( unsigned * )( cq + p.cq_off.ring_mask );
+    ring->cqes = ( struct io_uring_cqe * )( cq + p.cq_off.cqes );
+
+    memset( &reg, 0, sizeof( reg ) );
+    reg.ring_addr = ( uint64_t )( uintptr_t )ring->br;
+    reg.ring_entries = buffers;
+    reg.bgid = BUFFER_GROUP;
+
+    if( syscall( __NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1 ) )
+    {
+        int error = errno;
+
+        gps_uring_free( ring );
+        errno = error;
+        return -1;
+    }
+
+    ring->br_mask = buffers - 1;
+    ring->buffer_bytes = buffer_bytes;
+
+    for( i = 0; i < buffers; i++ )
+        buffer_add( ring, ( uint16_t )i );
+
+    return 0;
+}
+
+void gps_uring_free( gps_uring_t *ring )
+{
+    if( ring->fd >= 0 )
+        close( ring->fd );
+
+    if( ring->sq_map != NULL && ring->sq_map != MAP_FAILED )
+        munmap( ring->sq_map, ring->sq_bytes );
+
+    if( ring->cq_bytes && ring->cq_map != NULL && ring->cq_map != MAP_FAILED )
+        munmap( ring->cq_map, ring->cq_bytes );
+
+    if( ring->sqes != NULL && ring->sqes != MAP_FAILED )
+        munmap( ring->sqes, ring->sqe_bytes );
+
+    if( ring->br != NULL && ring->br != MAP_FAILED )
+        munmap( ring->br, ring->br_bytes );
+
+    free( ring->buffers );
+    memset( ring, 0, sizeof( gps_uring_t ) );
+    ring->fd = -1;
+}
+
+int gps_uring_read_multishot( gps_uring_t *ring, int fd, uint64_t user_data )
+{
+    struct io_uring_sqe *sqe = sqe_get( ring );
+
+    if( sqe == NULL )
+        return -1;
+
+    sqe->opcode = OP_READ_MULTISHOT;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = user_data;
+
+    return 0;
+}
+
+int gps_uring_accept_multishot( gps_uring_t *ring, int fd, uint64_t user_data )
+{
+    struct io_uring_sqe *sqe = sqe_get( ring );
+
+    if( sqe == NULL )
+        return -1;
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = user_data;
+
+    return 0;
+}
+
+int gps_uring_read( gps_uring_t *ring, int fd, void *data, unsigned size,
+                    uint64_t user_data )
+{
+    struct io_uring_sqe *sqe = sqe_get( ring );
+
+    if( sqe == NULL )
+        return -1;
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = ( uint64_t )( uintptr_t )data;
+    sqe->len = size;
+    sqe->user_data = user_data;
+
+    return 0;
+}
+
+int gps_uring_submit( gps_uring_t *ring, int wait )
+{
+    unsigned submit = ring->sq_local - *ring->sq_tail;
+    unsigned flags = 0;
+    long result;
+
+    if( wait && LOAD( ring->cq_tail ) != *ring->cq_head )
+        wait = 0;
+
+    if( submit == 0 && !wait )
+        return 0;
+
+    if( wait )
+        flags |= IORING_ENTER_GETEVENTS;
+
+    STORE( ring->sq_tail, ring->sq_local );
+
+    do
+    {
+        result = syscall( __NR_io_uring_enter, ring->fd, submit, wait ? 1 : 0,
+                          flags, NULL, 0 );
+    }
+    while( result < 0 && errno == EINTR );
+
+    return result < 0 ? -1 : 0;
+}
+
+struct io_uring_cqe *gps_uring_peek( gps_uring_t *ring )
+{
+    unsigned head = *ring->cq_head;
+
+    if( head == LOAD( ring->cq_tail ) )
+        return NULL;
+
+    return &ring->cqes[ head & ring->cq_mask ];
+}
+
+void gps_uring_advance( gps_uring_t *ring )
+{
+    STORE( ring->cq_head, *ring->cq_head + 1 );
+}
+
+const char *gps_uring_buffer( const gps_uring_t *ring,
+                              const struct io_uring_cqe *cqe )
+{
+    if( !( cqe->flags & IORING_CQE_F_BUFFER ) )
+        return NULL;
+
+    return ring->buffers +
+           ( size_t )( cqe->flags >> IORING_CQE_BUFFER_SHIFT ) * ring->buffer_bytes;
+}
+
+void gps_uring_recycle( gps_uring_t *ring, const struct io_uring_cqe *cqe )
+{
+    if( cqe->flags & IORING_CQE_F_BUFFER )
+        buffer_add( ring, ( uint16_t )( cqe->flags >> IORING_CQE_BUFFER_SHIFT ) );
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,153 @@
+/****************************************************************************
+* Title                 :   io_uring Rings
+* Filename              :   gps_uring.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only, Linux 6.7 or later
+*****************************************************************************/
+/**
+ * @file gps_uring.h
+ * @brief The few io_uring calls the ingestion workers use, without liburing
+ *
+ * One ring with its submission and completion queues mapped, and one ring
+ * of provided buffers.  Multishot reads pick a buffer from it for every
+ * completion, so a stream keeps being read without a request per read.
+ * Completions are taken straight from the mapped queue; the only system
+ * call is gps_uring_submit(), which also waits when nothing completed.
+ *
+ * @code
+ * gps_uring_init( &ring, 256, 8192, 1024, 4096 );
+ * gps_uring_read_multishot( &ring, fd, index );
+ *
+ * for( ;; )
+ * {
+ *     gps_uring_submit( &ring, 1 );
+ *
+ *     while( ( cqe = gps_uring_peek( &ring ) ) != NULL )
+ *     {
+ *         ...gps_uring_buffer( &ring, cqe )...
+ *         gps_uring_recycle( &ring, cqe );
+ *         gps_uring_advance( &ring );
+ *     }
+ * }
+ * @endcode
+ */
+#ifndef GPS_URING_H_
+#define GPS_URING_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Mapped ring and its provided buffers
+ */
+typedef struct
+{
+    int fd;
+    void *sq_map;
+    void *cq_map;
+    size_t sq_bytes;
+    size_t cq_bytes;
+    struct io_uring_sqe *sqes;
+    size_t sqe_bytes;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_local;          /**< Tail of the queued entries */
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+    struct io_uring_buf_ring *br;
+    size_t br_bytes;
+    unsigned br_mask;
+    uint16_t br_tail;
+    char *buffers;
+    size_t buffer_bytes;
+} gps_uring_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sets up a ring and registers buffers of group 0
+ *
+ * @param buffers - a power of two
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_uring_init( gps_uring_t *ring, unsigned sq_entries, unsigned cq_entries,
+                    unsigned buffers, size_t buffer_bytes );
+
+/**
+ * @brief Closes the ring, which ends its requests, and frees the buffers
+ */
+void gps_uring_free( gps_uring_t *ring );
+
+/**
+ * @brief Queues reads of fd into buffers of group 0 until it ends
+ *
+ * @return int - 0 or -1 when the submission queue couldn't be emptied
+ */
+int gps_uring_read_multishot( gps_uring_t *ring, int fd, uint64_t user_data );
+
+/**
+ * @brief Queues accepts on a listening socket until it fails
+ */
+int gps_uring_accept_multishot( gps_uring_t *ring, int fd, uint64_t user_data );
+
+/**
+ * @brief Queues a single read into data
+ */
+int gps_uring_read( gps_uring_t *ring, int fd, void *data, unsigned size,
+                    uint64_t user_data );
+
+/**
+ * @brief Submits the queued requests
+ *
+ * @param wait - also waits for a completion when none is there
+ *
+ * @return int - 0 or -1 with errno set
+ */
+int gps_uring_submit( gps_uring_t *ring, int wait );
+
+/**
+ * @brief Next completion, NULL when there is none
+ */
+struct io_uring_cqe *gps_uring_peek( gps_uring_t *ring );
+
+/**
+ * @brief Consumes the completion gps_uring_peek() returned
+ */
+void gps_uring_advance( gps_uring_t *ring );
+
+/**
+ * @brief Data of a completion that picked a buffer, NULL for others
+ */
+const char *gps_uring_buffer( const gps_uring_t *ring,
+                              const struct io_uring_cqe *cqe );
+
+/**
+ * @brief Gives the buffer of a completion back to the kernel
+ */
+void gps_uring_recycle( gps_uring_t *ring, const struct io_uring_cqe *cqe );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_URING_H_ */
+
+/*** End of File **************************************************************/
@@ -0,0 +1,110 @@
+/*******************************************************************************
+* Title                 :   Timer Wheel
+* Filename              :   gps_wheel.c
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*******************************************************************************/
+/**
+ * @file gps_wheel.c
+ * @brief Single level hashed timer wheel.
+ *
+ * Slots hold unsorted lists.  A timer due in a later turn of the wheel
+ * is skipped when its slot is walked, so a timer is looked at about once
+ * per turn until it fires.
+ */
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <string.h>
+#include "gps_wheel.h"
+
+/******************************************************************************
+* Module Preprocessor Constants
+*******************************************************************************/
+#define STATIC_ASSERT( COND, NAME ) typedef char static_assert_##NAME[ ( COND ) ? 1 : -1 ]
+
+#define MASK    ( GPS_WHEEL_SLOTS - 1 )
+
+STATIC_ASSERT( ( GPS_WHEEL_SLOTS & MASK ) == 0, slots_power_of_two );
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static gps_wheel_timer_t *slot_expire( gps_wheel_t *wheel, size_t slot, uint64_t now,
+                                       gps_wheel_timer_t *expired );
+
+/******************************************************************************
+* Function Definitions
+*******************************************************************************/
+/* Moves the timers of slot due by now onto expired */
+static gps_wheel_timer_t *slot_expire( gps_wheel_t *wheel, size_t slot, uint64_t now,
+                                       gps_wheel_timer_t *expired )
+{
+    gps_wheel_timer_t **link = &wheel->slot[ slot ];
+
+    while( *link != NULL )
+    {
+        gps_wheel_timer_t *timer = *link;
+
+        if( timer->expires > now )
+        {
+            link = &timer->next;
+            continue;
+        }
+
+        *link = timer->next;
+        timer->next = expired;
+        expired = timer;
+        wheel->pending--;
+    }
+
+    return expired;
+}
+
+void gps_wheel_init( gps_wheel_t *wheel, uint64_t now )
+{
+    memset( wheel, 0, sizeof( gps_wheel_t ) );
+    wheel->now = now;
+}
+
+void gps_wheel_add( gps_wheel_t *wheel, gps_wheel_timer_t *timer, uint64_t expires )
+{
+    size_t slot;
+
+    if( expires <= wheel->now )
+        expires = wheel->now + 1;
+
+    slot = ( size_t )( expires & MASK );
+    timer->expires = expires;
+    timer->next = wheel->slot[ slot ];
+    wheel->slot[ slot ] = timer;
+    wheel->pending++;
+}
+
+gps_wheel_timer_t *gps_wheel_advance( gps_wheel_t *wheel, uint64_t now )
+{
+    gps_wheel_timer_t *expired = NULL;
+    uint64_t tick;
+
+    if( now <= wheel->now )
+        return NULL;
+
+    if( now - wheel->now >= GPS_WHEEL_SLOTS )
+    {
+        size_t slot;
+
+        for( slot = 0; slot < GPS_WHEEL_SLOTS; slot++ )
+            expired = slot_expire( wheel, slot, now, expired );
+    }
+    else
+    {
+        for( tick = wheel->now + 1; tick <= now; tick++ )
+            expired = slot_expire( wheel, ( size_t )( tick & MASK ), now, expired );
+    }
+
+    wheel->now = now;
+
+    return expired;
+}
+
+/*************** END OF FUNCTIONS ***************************************************************************/
@@ -0,0 +1,102 @@
+/****************************************************************************
+* Title                 :   Timer Wheel
+* Filename              :   gps_wheel.h
+* Origin Date           :   10/19/2026
+* Notes                 :   Host only
+*****************************************************************************/
+/**
+ * @file gps_wheel.h
+ * @brief Hashed timer wheel for many timers of about the same period
+ *
+ * Time is counted in ticks of the caller's choosing.  A timer goes in the
+ * slot of its expiry tick modulo GPS_WHEEL_SLOTS and stays there across
+ * turns of the wheel until that tick is reached.  Adding a timer and
+ * firing it are O(1), and advancing one tick only walks one slot, so
+ * thousands of units each with its next epoch pending cost no more per
+ * tick than the ones that fall due.  Timers are embedded in the caller's
+ * structures and nothing is allocated.
+ *
+ * @code
+ * gps_wheel_init( &wheel, 0 );
+ * gps_wheel_add( &wheel, &unit->timer, due / TICK_NS );
+ *
+ * for( timer = gps_wheel_advance( &wheel, now / TICK_NS ); timer; timer = next )
+ * {
+ *     next = timer->next;
+ *     fire( ( unit_t * )timer );                        // timer is the first member
+ * }
+ * @endcode
+ */
+#ifndef GPS_WHEEL_H_
+#define GPS_WHEEL_H_
+
+/******************************************************************************
+* Includes
+*******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+* Preprocessor Constants
+*******************************************************************************/
+#define GPS_WHEEL_SLOTS     1024        /**< Ticks per turn, a power of two */
+
+/******************************************************************************
+* Typedefs
+*******************************************************************************/
+/**
+ * @struct Timer, a member of the caller's structure
+ */
+typedef struct gps_wheel_timer
+{
+    struct gps_wheel_timer *next;
+    uint64_t expires;           /**< Tick */
+} gps_wheel_timer_t;
+
+/**
+ * @struct Wheel
+ */
+typedef struct
+{
+    uint64_t now;               /**< Last tick advanced to */
+    size_t pending;             /**< Timers in the wheel */
+    gps_wheel_timer_t *slot[ GPS_WHEEL_SLOTS ];
+} gps_wheel_t;
+
+/******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Empties the wheel and sets its time
+ */
+void gps_wheel_init( gps_wheel_t *wheel, uint64_t now );
+
+/**
+ * @brief Adds a timer that isn't in the wheel
+ *
+ * A timer expiring at or before the wheel's time fires with the next
+ * advance.
+ */
+void gps_wheel_add( gps_wheel_t *wheel, gps_wheel_timer_t *timer, uint64_t expires );
+
+/**
+ * @brief Advances to now and takes out the timers that expired
+ *
+ * A wheel that fell behind by more than a turn walks every slot once.
+ *
+ * @return gps_wheel_timer_t * - the expired timers linked through next,
+ * NULL if none
+ */
+gps_wheel_timer_t *gps_wheel_advance( gps_wheel_t *wheel, uint64_t now );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* GPS_WHEEL_H_ */
+
+/*** End of File **************************************************************/